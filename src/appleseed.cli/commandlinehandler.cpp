@@ -69,6 +69,11 @@ CommandLineHandler::CommandLineHandler()
             .set_flags(OptionHandler::Repeatable)
             .set_exact_value_count(1));
 
+    parser().add_option_handler(
+        &m_server
+            .add_name("--server")
+            .set_description("keep the project loaded and render it on demand, reading commands from standard input"));
+
     parser().add_option_handler(
         &m_threads
             .add_name("--threads")
@@ -59,6 +59,7 @@ class CommandLineHandler
     // General options.
     foundation::ValueOptionHandler<std::string>     m_configuration;
     foundation::ValueOptionHandler<std::string>     m_params;
+    foundation::FlagOptionHandler                   m_server;
 
     // Aliases for rendering options.
     foundation::ValueOptionHandler<std::string>     m_threads;  // std::string because we need to handle 'auto'
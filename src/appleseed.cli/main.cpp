@@ -31,6 +31,7 @@
 #include "commandlinehandler.h"
 #include "houdinitilecallbacks.h"
 #include "progresstilecallback.h"
+#include "renderserver.h"
 #include "stdouttilecallback.h"
 
 // appleseed.shared headers.
@@ -72,6 +73,7 @@
 // Standard headers.
 #include <cstddef>
 #include <cstdlib>
+#include <iostream>
 #include <memory>
 #include <string>
 
@@ -663,6 +665,34 @@ namespace
         return true;
     }
 
+    bool serve(const string& project_filename)
+    {
+        // Load the project.
+        auto_release_ptr<Project> project = load_project(project_filename);
+        if (project.get() == 0)
+            return false;
+
+        // Retrieve the rendering parameters.
+        ParamArray params;
+        if (!configure_project(project.ref(), params))
+            return false;
+
+        // Create the tile callback factory.
+        auto_ptr<ITileCallbackFactory> tile_callback_factory;
+        if (project->get_display() == nullptr && !is_progressive_render(params))
+            tile_callback_factory.reset(new ProgressTileCallbackFactory(g_logger));
+
+        // Keep the project and the renderer alive while commands are processed.
+        RenderServer server(
+            project.ref(),
+            params,
+            tile_callback_factory.get(),
+            g_cl.m_output.is_set() ? g_cl.m_output.value() : string(),
+            g_logger);
+
+        return server.run(cin, cout);
+    }
+
     bool benchmark_render(const string& project_filename)
     {
         // Configure our logger.
@@ -781,6 +811,8 @@ int main(int argc, const char* argv[])
 
         if (g_cl.m_benchmark_mode.is_set())
             success = success && benchmark_render(project_filename);
+        else if (g_cl.m_server.is_set())
+            success = success && serve(project_filename);
         else success = success && render(project_filename);
     }
 
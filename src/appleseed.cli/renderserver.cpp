@@ -0,0 +1,516 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "renderserver.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/camera.h"
+#include "renderer/api/frame.h"
+#include "renderer/api/project.h"
+#include "renderer/api/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/timers.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// Boost headers.
+#include "boost/bind.hpp"
+#include "boost/thread/condition_variable.hpp"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+namespace appleseed {
+namespace cli {
+
+namespace
+{
+    struct Command
+    {
+        enum Type
+        {
+            Set,
+            Frame,
+            Camera,
+            Transform,
+            Output,
+            Render,
+            Abort,
+            Quit,
+            Invalid
+        };
+
+        Type        m_type;
+        string      m_args;
+    };
+
+    Command parse_command(const string& line)
+    {
+        const string trimmed = trim_both(line);
+        const string::size_type space_pos = trimmed.find_first_of(" \t");
+        const string name = trimmed.substr(0, space_pos);
+
+        Command command;
+        command.m_args = space_pos == string::npos ? string() : trim_left(trimmed.substr(space_pos));
+
+        if (name == "set")              command.m_type = Command::Set;
+        else if (name == "frame")       command.m_type = Command::Frame;
+        else if (name == "camera")      command.m_type = Command::Camera;
+        else if (name == "transform")   command.m_type = Command::Transform;
+        else if (name == "output")      command.m_type = Command::Output;
+        else if (name == "render")      command.m_type = Command::Render;
+        else if (name == "abort")       command.m_type = Command::Abort;
+        else if (name == "quit")        command.m_type = Command::Quit;
+        else
+        {
+            command.m_type = Command::Invalid;
+            command.m_args = name;
+        }
+
+        return command;
+    }
+
+    // Return the rendering status that applies a command received while rendering.
+    IRendererController::Status get_command_status(const Command::Type type)
+    {
+        switch (type)
+        {
+          case Command::Transform:
+            return IRendererController::RestartRendering;
+
+          case Command::Set:
+          case Command::Frame:
+          case Command::Camera:
+            return IRendererController::ReinitializeRendering;
+
+          case Command::Abort:
+          case Command::Quit:
+            return IRendererController::AbortRendering;
+
+          default:
+            return IRendererController::ContinueRendering;
+        }
+    }
+
+    // Rank rendering statuses by how disruptive they are.
+    int get_status_rank(const IRendererController::Status status)
+    {
+        switch (status)
+        {
+          case IRendererController::RestartRendering: return 1;
+          case IRendererController::ReinitializeRendering: return 2;
+          case IRendererController::AbortRendering: return 3;
+          default: return 0;
+        }
+    }
+
+    // Split an assignment of the form name=value.
+    bool split_assignment(const string& s, string& name, string& value)
+    {
+        const string::size_type equal_pos = s.find_first_of('=');
+
+        if (equal_pos == string::npos || equal_pos == 0)
+            return false;
+
+        name = trim_both(s.substr(0, equal_pos));
+        value = trim_both(s.substr(equal_pos + 1));
+
+        return true;
+    }
+
+    void set_frame_parameter(Project& project, const string& key, const string& value)
+    {
+        const Frame* frame = project.get_frame();
+        assert(frame);
+
+        ParamArray params = frame->get_parameters();
+        params.insert(key, value);
+
+        auto_release_ptr<Frame> new_frame(FrameFactory::create(frame->get_name(), params));
+
+        project.set_frame(new_frame);
+    }
+}
+
+
+//
+// RenderServer class implementation.
+//
+
+struct RenderServer::Impl
+  : public DefaultRendererController
+{
+    Project&                            m_project;
+    Logger&                             m_logger;
+    string                              m_output_filename;
+    MasterRenderer                      m_renderer;
+    ostream*                            m_output;
+    size_t                              m_failed_render_count;
+
+    // Commands received but not yet executed, filled by the reader thread.
+    boost::mutex                        m_mutex;
+    boost::condition_variable           m_event;
+    deque<Command>                      m_commands;
+    bool                                m_input_ended;
+
+    // Rendering status implied by pending commands, read by the rendering threads.
+    mutable volatile uint32             m_status;
+
+    Impl(
+        Project&                        project,
+        const ParamArray&               params,
+        ITileCallbackFactory*           tile_callback_factory,
+        const string&                   output_filename,
+        Logger&                         logger)
+      : m_project(project)
+      , m_logger(logger)
+      , m_output_filename(output_filename)
+      , m_renderer(project, params, this, tile_callback_factory)
+      , m_output(0)
+      , m_failed_render_count(0)
+      , m_input_ended(false)
+      , m_status(ContinueRendering)
+    {
+    }
+
+    virtual void on_rendering_begin() override
+    {
+        // Apply the edits received before rendering (re)starts.
+        apply_pending_edits(false);
+    }
+
+    virtual void on_frame_begin() override
+    {
+        // Apply the edits that only require restarting rendering.
+        apply_pending_edits(true);
+    }
+
+    virtual Status get_status() const override
+    {
+        return static_cast<Status>(atomic_read(&m_status));
+    }
+
+    void read_commands(istream& input)
+    {
+        string line;
+
+        while (getline(input, line))
+        {
+            if (trim_both(line).empty())
+                continue;
+
+            const Command command = parse_command(line);
+
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_commands.push_back(command);
+            update_status();
+            m_event.notify_one();
+
+            if (command.m_type == Command::Quit)
+                return;
+        }
+
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_input_ended = true;
+        m_event.notify_one();
+    }
+
+    // Wait for the next command. Return false if there are no more commands.
+    bool pop_command(Command& command)
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        while (m_commands.empty() && !m_input_ended)
+            m_event.wait(lock);
+
+        if (m_commands.empty())
+            return false;
+
+        command = m_commands.front();
+        m_commands.pop_front();
+        update_status();
+
+        return true;
+    }
+
+    // Recompute the rendering status from the commands received before the next render command.
+    // The mutex must be held.
+    void update_status()
+    {
+        Status status = ContinueRendering;
+
+        for (size_t i = 0; i < m_commands.size(); ++i)
+        {
+            const Command::Type type = m_commands[i].m_type;
+
+            if (type == Command::Render)
+                break;
+
+            const Status command_status = get_command_status(type);
+            if (get_status_rank(command_status) > get_status_rank(status))
+                status = command_status;
+        }
+
+        atomic_write(&m_status, static_cast<uint32>(status));
+    }
+
+    // Apply the edits at the front of the command queue.
+    void apply_pending_edits(const bool transforms_only)
+    {
+        while (true)
+        {
+            Command command;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                if (m_commands.empty())
+                    break;
+
+                const Command::Type type = m_commands.front().m_type;
+
+                const bool is_edit =
+                    transforms_only
+                        ? type == Command::Transform
+                        : type != Command::Render && type != Command::Abort && type != Command::Quit;
+
+                if (!is_edit)
+                    break;
+
+                command = m_commands.front();
+                m_commands.pop_front();
+                update_status();
+            }
+
+            execute(command);
+        }
+    }
+
+    bool render()
+    {
+        Stopwatch<DefaultWallclockTimer> stopwatch;
+        stopwatch.start();
+
+        const bool success = m_renderer.render();
+
+        stopwatch.measure();
+
+        if (!success)
+            return false;
+
+        LOG_INFO(
+            m_logger,
+            "rendering finished in %s.",
+            pretty_time(stopwatch.get_seconds(), 3).c_str());
+
+        write_frame();
+
+        return true;
+    }
+
+    void write_frame() const
+    {
+        const Frame* frame = m_project.get_frame();
+
+        if (!m_output_filename.empty())
+        {
+            LOG_INFO(m_logger, "writing frame to disk...");
+            frame->write_main_image(m_output_filename.c_str());
+            frame->write_aov_images(m_output_filename.c_str());
+        }
+        else
+        {
+            const string output_filename =
+                frame->get_parameters().get_optional<string>("output_filename");
+
+            if (!output_filename.empty())
+            {
+                LOG_INFO(m_logger, "writing frame to disk...");
+                frame->write_main_image(output_filename.c_str());
+            }
+        }
+    }
+
+    // Execute a command. Return false when the server must exit.
+    bool execute(const Command& command)
+    {
+        string error;
+
+        switch (command.m_type)
+        {
+          case Command::Set:
+            {
+                string path, value;
+                if (split_assignment(command.m_args, path, value))
+                    m_renderer.get_parameters().insert_path(path.c_str(), value);
+                else error = "expected name=value";
+            }
+            break;
+
+          case Command::Frame:
+            {
+                string name, value;
+                if (split_assignment(command.m_args, name, value))
+                    set_frame_parameter(m_project, name, value);
+                else error = "expected name=value";
+            }
+            break;
+
+          case Command::Camera:
+            if (m_project.get_scene()->cameras().get_by_name(command.m_args.c_str()))
+                set_frame_parameter(m_project, "camera", command.m_args);
+            else error = "camera \"" + command.m_args + "\" does not exist";
+            break;
+
+          case Command::Transform:
+            error = set_camera_transform(command.m_args);
+            break;
+
+          case Command::Output:
+            m_output_filename = command.m_args;
+            break;
+
+          case Command::Render:
+            if (!render())
+            {
+                ++m_failed_render_count;
+                error = "rendering failed or was aborted";
+            }
+            break;
+
+          case Command::Abort:
+            // Nothing to abort since no rendering is in progress.
+            break;
+
+          case Command::Quit:
+            break;
+
+          case Command::Invalid:
+            error = "unknown command \"" + command.m_args + "\"";
+            break;
+
+          assert_otherwise;
+        }
+
+        if (error.empty())
+            *m_output << "ok" << endl;
+        else
+        {
+            LOG_ERROR(m_logger, "render server: %s.", error.c_str());
+            *m_output << "error " << error << endl;
+        }
+
+        return command.m_type != Command::Quit;
+    }
+
+    string set_camera_transform(const string& args)
+    {
+        Camera* camera = m_project.get_uncached_active_camera();
+        if (camera == 0)
+            return "no active camera";
+
+        vector<double> values;
+        tokenize(args, Blanks, values);
+
+        if (values.size() != 16)
+            return "expected 16 matrix coefficients";
+
+        Matrix4d matrix;
+        for (size_t i = 0; i < 16; ++i)
+            matrix[i] = values[i];
+
+        if (abs(det(matrix)) < 1.0e-12)
+            return "singular matrix";
+
+        camera->transform_sequence().clear();
+        camera->transform_sequence().set_transform(0.0f, Transformd::from_local_to_parent(matrix));
+
+        return string();
+    }
+};
+
+RenderServer::RenderServer(
+    Project&                    project,
+    const ParamArray&           params,
+    ITileCallbackFactory*       tile_callback_factory,
+    const string&               output_filename,
+    Logger&                     logger)
+  : impl(new Impl(project, params, tile_callback_factory, output_filename, logger))
+{
+}
+
+RenderServer::~RenderServer()
+{
+    delete impl;
+}
+
+bool RenderServer::run(
+    istream&                    input,
+    ostream&                    output)
+{
+    impl->m_output = &output;
+
+    LOG_INFO(impl->m_logger, "render server ready, waiting for commands...");
+
+    // Read commands in a separate thread so that they can be applied while rendering.
+    boost::thread reader(boost::bind(&Impl::read_commands, impl, boost::ref(input)));
+
+    Command command;
+    while (impl->pop_command(command))
+    {
+        if (!impl->execute(command))
+            break;
+    }
+
+    reader.join();
+
+    return impl->m_failed_render_count == 0;
+}
+
+}   // namespace cli
+}   // namespace appleseed
@@ -0,0 +1,101 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_CLI_RENDERSERVER_H
+#define APPLESEED_CLI_RENDERSERVER_H
+
+// appleseed.renderer headers.
+#include "renderer/api/rendering.h"
+#include "renderer/api/utility.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// Standard headers.
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+// Forward declarations.
+namespace foundation    { class Logger; }
+namespace renderer      { class Project; }
+
+namespace appleseed {
+namespace cli {
+
+//
+// A render server that keeps a project resident in memory, along with everything the
+// renderer builds from it (trace context, OSL shading system, texture caches), and
+// executes commands read from an input stream, one command per line:
+//
+//   set <path>=<value>                 set a rendering parameter
+//   frame <name>=<value>               set a frame parameter (resolution, crop_window, etc.)
+//   camera <name>                      set the active camera
+//   transform <m00> <m01> ... <m33>    set the transform of the active camera
+//   output <filename>                  set the output file, or disable writing if empty
+//   render                             render the project and write the output file
+//   abort                              abort the render in progress
+//   quit                               exit the server
+//
+// Commands are acknowledged on the output stream with a line starting with "ok" or "error".
+//
+// Commands received while rendering are applied through the renderer controller: camera
+// transforms restart rendering, other edits reinitialize it; "abort" and "quit" abort it.
+//
+
+class RenderServer
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    RenderServer(
+        renderer::Project&                  project,
+        const renderer::ParamArray&         params,
+        renderer::ITileCallbackFactory*     tile_callback_factory,
+        const std::string&                  output_filename,
+        foundation::Logger&                 logger);
+
+    // Destructor.
+    ~RenderServer();
+
+    // Execute commands until the "quit" command is received or the input stream ends.
+    // Return true if all renders succeeded.
+    bool run(
+        std::istream&                       input,
+        std::ostream&                       output);
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}       // namespace cli
+}       // namespace appleseed
+
+#endif  // !APPLESEED_CLI_RENDERSERVER_H
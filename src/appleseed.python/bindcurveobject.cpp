@@ -0,0 +1,199 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.python headers.
+#include "dict2dict.h"
+#include "gillocks.h"
+#include "pybuffer.h"
+
+// appleseed.renderer headers.
+#include "renderer/api/object.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/python.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+
+namespace bpy = boost::python;
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+// Work around a regression in Visual Studio 2015 Update 3.
+#if defined(_MSC_VER) && _MSC_VER == 1900
+namespace boost
+{
+    template <> CurveObject const volatile* get_pointer<CurveObject const volatile>(CurveObject const volatile* p) { return p; }
+}
+#endif
+
+namespace
+{
+    auto_release_ptr<CurveObject> create_curve_obj(
+        const string&       name,
+        const bpy::dict&    params)
+    {
+        return CurveObjectFactory::create(name.c_str(), bpy_dict_to_param_array(params));
+    }
+
+    //
+    // Bulk accessors.
+    //
+    // Curves are read from or written to two buffers of floating-point values: one with
+    // the control points of the curves (three values per control point) and one with the
+    // widths of the curves at their control points (one value per control point).
+    //
+
+    // Return the number of curves described by a pair of buffers.
+    template <typename CurveType>
+    size_t get_curve_count(
+        const PyBufferView&     points_view,
+        const PyBufferView&     widths_view)
+    {
+        const size_t N = CurveType::Degree + 1;
+
+        points_view.check_float_items(N * 3);
+        widths_view.check_float_items(N);
+
+        const size_t count = widths_view.get_item_count() / N;
+
+        if (points_view.get_item_count() / (N * 3) != count)
+        {
+            PyErr_SetString(PyExc_ValueError, "Control point and width buffers have different curve counts");
+            bpy::throw_error_already_set();
+        }
+
+        return count;
+    }
+
+    template <typename CurveType>
+    void read_curves(
+        CurveObject*            object,
+        const bpy::object&      points,
+        const bpy::object&      widths,
+        size_t                  (CurveObject::*push_curve)(const CurveType&))
+    {
+        const size_t N = CurveType::Degree + 1;
+
+        const PyBufferView points_view(points, PyBufferView::ReadOnly);
+        const PyBufferView widths_view(widths, PyBufferView::ReadOnly);
+        const size_t count = get_curve_count<CurveType>(points_view, widths_view);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GVector3 ctrl_pts[N];
+            GScalar width[N];
+
+            for (size_t j = 0; j < N; ++j)
+                points_view.read_items((i * N + j) * 3, 3, &ctrl_pts[j][0]);
+
+            widths_view.read_items(i * N, N, width);
+
+            (object->*push_curve)(CurveType(ctrl_pts, width));
+        }
+    }
+
+    template <typename CurveType>
+    void write_curves(
+        const CurveObject*      object,
+        const bpy::object&      points,
+        const bpy::object&      widths,
+        const size_t            count,
+        const CurveType&        (CurveObject::*get_curve)(const size_t) const)
+    {
+        const size_t N = CurveType::Degree + 1;
+
+        PyBufferView points_view(points, PyBufferView::Writable);
+        PyBufferView widths_view(widths, PyBufferView::Writable);
+
+        if (get_curve_count<CurveType>(points_view, widths_view) < count)
+        {
+            PyErr_SetString(PyExc_IndexError, "Buffer size is smaller than data size");
+            bpy::throw_error_already_set();
+        }
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const CurveType& curve = (object->*get_curve)(i);
+
+            for (size_t j = 0; j < N; ++j)
+            {
+                points_view.write_items((i * N + j) * 3, 3, &curve.get_control_point(j)[0]);
+
+                const GScalar width = curve.get_width(j);
+                widths_view.write_items(i * N + j, 1, &width);
+            }
+        }
+    }
+
+    void push_curves1_from(CurveObject* object, const bpy::object& points, const bpy::object& widths)
+    {
+        read_curves<Curve1Type>(object, points, widths, &CurveObject::push_curve1);
+    }
+
+    void push_curves3_from(CurveObject* object, const bpy::object& points, const bpy::object& widths)
+    {
+        read_curves<Curve3Type>(object, points, widths, &CurveObject::push_curve3);
+    }
+
+    void copy_curves1_to(const CurveObject* object, const bpy::object& points, const bpy::object& widths)
+    {
+        write_curves<Curve1Type>(object, points, widths, object->get_curve1_count(), &CurveObject::get_curve1);
+    }
+
+    void copy_curves3_to(const CurveObject* object, const bpy::object& points, const bpy::object& widths)
+    {
+        write_curves<Curve3Type>(object, points, widths, object->get_curve3_count(), &CurveObject::get_curve3);
+    }
+}
+
+void bind_curve_object()
+{
+    bpy::class_<CurveObject, auto_release_ptr<CurveObject>, bpy::bases<Object>, boost::noncopyable>("CurveObject", bpy::no_init)
+        .def("__init__", bpy::make_constructor(create_curve_obj))
+
+        .def("reserve_curves1", &CurveObject::reserve_curves1)
+        .def("reserve_curves3", &CurveObject::reserve_curves3)
+        .def("get_curve1_count", &CurveObject::get_curve1_count)
+        .def("get_curve3_count", &CurveObject::get_curve3_count)
+
+        .def("push_curves1_from", push_curves1_from)
+        .def("push_curves3_from", push_curves3_from)
+        .def("copy_curves1_to", copy_curves1_to)
+        .def("copy_curves3_to", copy_curves3_to)
+        ;
+
+    boost::python::implicitly_convertible<auto_release_ptr<CurveObject>, auto_release_ptr<Object>>();
+}
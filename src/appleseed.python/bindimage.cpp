@@ -27,6 +27,10 @@
 // THE SOFTWARE.
 //
 
+// appleseed.python headers.
+#include "gillocks.h"
+#include "pybuffer.h"
+
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
@@ -42,6 +46,7 @@
 // Standard headers.
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <string>
 
 namespace bpy = boost::python;
@@ -77,12 +82,29 @@ namespace
             bpy::throw_error_already_set();
         }
 
+        ScopedGILUnlock unlock;
+
         std::copy(
             tile.get_storage(),
             tile.get_storage() + tile.get_size(),
             reinterpret_cast<uint8*>(array));
     }
 
+    void copy_tile_data_from_py_buffer(Tile& tile, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+
+        if (view.get_size() != tile.get_size())
+        {
+            PyErr_SetString(PyExc_ValueError, "Buffer size does not match data size");
+            bpy::throw_error_already_set();
+        }
+
+        ScopedGILUnlock unlock;
+
+        std::memcpy(tile.get_storage(), view.get_data(), tile.get_size());
+    }
+
     bpy::list blender_tile_data(const Tile& tile)
     {
         bpy::list pixels;
@@ -107,6 +129,87 @@ namespace
         return pixels;
     }
 
+    // Copy the pixels of an image to or from a buffer, in scanline order and in the
+    // pixel format of the image. Tiles are visited one after the other.
+    template <typename ImageType, typename CopyRow>
+    void copy_image_rows(ImageType& image, const CopyRow& copy_row)
+    {
+        const CanvasProperties& props = image.properties();
+        const size_t row_stride = props.m_canvas_width * props.m_pixel_size;
+
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+            {
+                const Tile& tile = image.tile(tx, ty);
+                const size_t tile_row_size = tile.get_width() * props.m_pixel_size;
+                const size_t x0 = tx * props.m_tile_width;
+                const size_t y0 = ty * props.m_tile_height;
+
+                for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+                {
+                    copy_row(
+                        tile.pixel(0, y),
+                        (y0 + y) * row_stride + x0 * props.m_pixel_size,
+                        tile_row_size);
+                }
+            }
+        }
+    }
+
+    struct CopyRowToBuffer
+    {
+        uint8* m_buffer;
+
+        void operator()(const uint8* row, const size_t offset, const size_t size) const
+        {
+            std::memcpy(m_buffer + offset, row, size);
+        }
+    };
+
+    struct CopyRowFromBuffer
+    {
+        const uint8* m_buffer;
+
+        void operator()(uint8* row, const size_t offset, const size_t size) const
+        {
+            std::memcpy(row, m_buffer + offset, size);
+        }
+    };
+
+    void check_image_buffer_size(const Image* image, const PyBufferView& view)
+    {
+        const CanvasProperties& props = image->properties();
+
+        if (view.get_size() != props.m_pixel_count * props.m_pixel_size)
+        {
+            PyErr_SetString(PyExc_ValueError, "Buffer size does not match data size");
+            bpy::throw_error_already_set();
+        }
+    }
+
+    void copy_image_data_to_py_buffer(const Image* image, const bpy::object& buffer)
+    {
+        PyBufferView view(buffer, PyBufferView::Writable);
+        check_image_buffer_size(image, view);
+
+        ScopedGILUnlock unlock;
+
+        const CopyRowToBuffer copy_row = { static_cast<uint8*>(view.get_data()) };
+        copy_image_rows(*image, copy_row);
+    }
+
+    void copy_image_data_from_py_buffer(Image* image, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        check_image_buffer_size(image, view);
+
+        ScopedGILUnlock unlock;
+
+        const CopyRowFromBuffer copy_row = { static_cast<const uint8*>(view.get_data()) };
+        copy_image_rows(*image, copy_row);
+    }
+
     Image* copy_image(const Image* source)
     {
         return new Image(*source);
@@ -165,6 +268,7 @@ void bind_image()
         .def("get_pixel_count", &Tile::get_pixel_count)
         .def("get_size", &Tile::get_size)
         .def("copy_data_to", copy_tile_data_to_py_buffer)   // todo: maybe this needs a better name
+        .def("copy_data_from", copy_tile_data_from_py_buffer)
 
         .def("blender_tile_data", blender_tile_data)
         ;
@@ -176,6 +280,8 @@ void bind_image()
         .def("__deepcopy__", copy_image, bpy::return_value_policy<bpy::manage_new_object>())
         .def("properties", &Image::properties, bpy::return_value_policy<bpy::reference_existing_object>())
         .def("tile", image_get_tile, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("copy_data_to", copy_image_data_to_py_buffer)
+        .def("copy_data_from", copy_image_data_from_py_buffer)
         ;
 
     const Image& (ImageStack::*image_stack_get_image)(const size_t) const = &ImageStack::get_image;
@@ -41,7 +41,9 @@
 // Standard headers.
 #include <cstddef>
 #include <cstdio>
+#include <map>
 #include <string>
+#include <utility>
 
 namespace bpy = boost::python;
 using namespace foundation;
@@ -92,27 +94,76 @@ namespace boost
 
 namespace
 {
+    // Log targets written in Python that are attached to a logger. Holding a reference
+    // to them keeps them alive for as long as the logger may call them.
+    typedef std::map<std::pair<Logger*, ILogTargetWrap*>, bpy::object> PythonLogTargetMap;
+    PythonLogTargetMap g_python_log_targets;
 
     Logger* get_global_logger()
     {
         return &global_logger();
     }
 
+    // Detach all log targets written in Python before the interpreter is finalized,
+    // since loggers and their writer threads outlive it.
+    void remove_python_log_targets()
+    {
+        PythonLogTargetMap targets;
+        targets.swap(g_python_log_targets);
+
+        {
+            ScopedGILUnlock unlock;
+
+            for (PythonLogTargetMap::const_iterator i = targets.begin(), e = targets.end(); i != e; ++i)
+                i->first.first->remove_target(i->first.second);
+        }
+    }
+
+    // The following functions may wait for the logger's writer thread, which
+    // may itself be waiting for the GIL to call a log target written in Python.
+
+    void logger_reset_all_formats(Logger* logger)
+    {
+        ScopedGILUnlock unlock;
+        logger->reset_all_formats();
+    }
+
+    void logger_reset_format(Logger* logger, const LogMessage::Category category)
+    {
+        ScopedGILUnlock unlock;
+        logger->reset_format(category);
+    }
+
     void logger_set_all_formats(Logger* logger, const std::string& format)
     {
+        ScopedGILUnlock unlock;
         logger->set_all_formats(format);
     }
 
     void logger_set_format(Logger* logger, const LogMessage::Category category, const std::string& format)
     {
+        ScopedGILUnlock unlock;
         logger->set_format(category, format);
     }
 
+    std::string logger_get_format(Logger* logger, const LogMessage::Category category)
+    {
+        ScopedGILUnlock unlock;
+        return logger->get_format(category);
+    }
+
     void logger_add_target(Logger* logger, bpy::object target)
     {
         ILogTargetWrap* p = bpy::extract<ILogTargetWrap*>(target);
         assert(p);
 
+        const std::pair<Logger*, ILogTargetWrap*> key(logger, p);
+        if (g_python_log_targets.find(key) != g_python_log_targets.end())
+            return;
+
+        g_python_log_targets[key] = target;
+
+        ScopedGILUnlock unlock;
         logger->add_target(p);
     }
 
@@ -121,7 +172,23 @@ namespace
         ILogTargetWrap* p = bpy::extract<ILogTargetWrap*>(target);
         assert(p);
 
-        logger->remove_target(p);
+        const std::pair<Logger*, ILogTargetWrap*> key(logger, p);
+        if (g_python_log_targets.find(key) == g_python_log_targets.end())
+            return;
+
+        {
+            ScopedGILUnlock unlock;
+            logger->remove_target(p);
+        }
+
+        // The target is no longer called by the logger and may now be destroyed.
+        g_python_log_targets.erase(key);
+    }
+
+    void logger_flush(Logger* logger)
+    {
+        ScopedGILUnlock unlock;
+        logger->flush();
     }
 }
 
@@ -143,14 +210,17 @@ void bind_logger()
         .def("set_enabled", &Logger::set_enabled)
         .def("set_verbosity_level", &Logger::set_verbosity_level)
         .def("get_verbosity_level", &Logger::get_verbosity_level)
-        .def("reset_all_formats", &Logger::reset_all_formats)
-        .def("reset_format", &Logger::reset_format)
+        .def("reset_all_formats", logger_reset_all_formats)
+        .def("reset_format", logger_reset_format)
         .def("set_all_formats", logger_set_all_formats)
         .def("set_format", logger_set_format)
-        .def("get_format", &Logger::get_format)
+        .def("get_format", logger_get_format)
         .def("add_target", logger_add_target)
         .def("remove_target", logger_remove_target)
+        .def("flush", logger_flush)
         ;
 
     bpy::def("global_logger", &get_global_logger, bpy::return_value_policy<bpy::reference_existing_object>());
+
+    bpy::import("atexit").attr("register")(bpy::make_function(&remove_python_log_targets));
 }
@@ -30,12 +30,15 @@
 // appleseed.python headers.
 #include "bindentitycontainers.h"
 #include "dict2dict.h"
+#include "gillocks.h"
+#include "pybuffer.h"
 
 // appleseed.renderer headers.
 #include "renderer/api/object.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/python.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/searchpaths.h"
 
 // Standard headers.
@@ -74,6 +77,289 @@ namespace
         object->get_triangle(index) = triangle;
     }
 
+    //
+    // Bulk accessors.
+    //
+    // Vertices, vertex normals and vertex poses are read from or written to buffers of
+    // floating-point values (three per vector), texture coordinates to buffers of
+    // floating-point values (two per vector), and triangles to buffers of integers.
+    // Triangle buffers have 3 (vertices), 4 (vertices and material), 7 (vertices,
+    // normals and material) or 10 (vertices, normals, texture coordinates and material)
+    // columns; the column count is given by the last dimension of the buffer and
+    // defaults to 3 for one-dimensional buffers.
+    //
+
+    void check_buffer_capacity(const PyBufferView& view, const size_t item_count)
+    {
+        if (view.get_item_count() < item_count)
+        {
+            PyErr_SetString(PyExc_IndexError, "Buffer size is smaller than data size");
+            bpy::throw_error_already_set();
+        }
+    }
+
+    size_t get_triangle_buffer_columns(const PyBufferView& view)
+    {
+        const size_t inner_dimension = view.get_inner_dimension();
+        const size_t columns = inner_dimension > 0 ? inner_dimension : 3;
+
+        if (columns != 3 && columns != 4 && columns != 7 && columns != 10)
+        {
+            PyErr_SetString(PyExc_ValueError, "Triangle buffers must have 3, 4, 7 or 10 columns");
+            bpy::throw_error_already_set();
+        }
+
+        view.check_integer_items(columns);
+
+        return columns;
+    }
+
+    void push_vertices_from(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        view.check_float_items(3);
+
+        ScopedGILUnlock unlock;
+
+        const size_t count = view.get_item_count() / 3;
+        object->reserve_vertices(object->get_vertex_count() + count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GVector3 v;
+            view.read_items(i * 3, 3, &v[0]);
+            object->push_vertex(v);
+        }
+    }
+
+    void push_vertex_normals_from(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        view.check_float_items(3);
+
+        ScopedGILUnlock unlock;
+
+        const size_t count = view.get_item_count() / 3;
+        object->reserve_vertex_normals(object->get_vertex_normal_count() + count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GVector3 n;
+            view.read_items(i * 3, 3, &n[0]);
+            object->push_vertex_normal(n);
+        }
+    }
+
+    void push_tex_coords_from(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        view.check_float_items(2);
+
+        ScopedGILUnlock unlock;
+
+        const size_t count = view.get_item_count() / 2;
+        object->reserve_tex_coords(object->get_tex_coords_count() + count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GVector2 uv;
+            view.read_items(i * 2, 2, &uv[0]);
+            object->push_tex_coords(uv);
+        }
+    }
+
+    // Return true if the vertex, vertex normal and texture coordinate indices of a triangle
+    // read from a buffer with a given number of columns all reference existing features.
+    bool are_valid_triangle_indices(
+        const MeshObject*   object,
+        const size_t        c[],
+        const size_t        columns)
+    {
+        const size_t vertex_count = object->get_vertex_count();
+
+        if (c[0] >= vertex_count || c[1] >= vertex_count || c[2] >= vertex_count)
+            return false;
+
+        if (columns >= 7)
+        {
+            const size_t normal_count = object->get_vertex_normal_count();
+
+            if (c[3] >= normal_count || c[4] >= normal_count || c[5] >= normal_count)
+                return false;
+        }
+
+        if (columns == 10)
+        {
+            const size_t tex_coord_count = object->get_tex_coords_count();
+
+            if (c[6] >= tex_coord_count || c[7] >= tex_coord_count || c[8] >= tex_coord_count)
+                return false;
+        }
+
+        return true;
+    }
+
+    void push_triangles_from(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        const size_t columns = get_triangle_buffer_columns(view);
+        const size_t count = view.get_item_count() / columns;
+        bool valid = true;
+
+        {
+            ScopedGILUnlock unlock;
+
+            // Validate all triangles before modifying the mesh.
+            for (size_t i = 0; valid && i < count; ++i)
+            {
+                size_t c[10];
+                view.read_items(i * columns, columns, c);
+                valid = are_valid_triangle_indices(object, c, columns);
+            }
+
+            if (valid)
+            {
+                object->reserve_triangles(object->get_triangle_count() + count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t c[10];
+                    view.read_items(i * columns, columns, c);
+
+                    switch (columns)
+                    {
+                      case 3: object->push_triangle(Triangle(c[0], c[1], c[2])); break;
+                      case 4: object->push_triangle(Triangle(c[0], c[1], c[2], c[3])); break;
+                      case 7: object->push_triangle(Triangle(c[0], c[1], c[2], c[3], c[4], c[5], c[6])); break;
+                      default: object->push_triangle(Triangle(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9])); break;
+                    }
+                }
+            }
+        }
+
+        if (!valid)
+        {
+            PyErr_SetString(PyExc_IndexError, "Triangle references a vertex, vertex normal or texture coordinate that does not exist");
+            bpy::throw_error_already_set();
+        }
+    }
+
+    void set_vertex_poses_from(
+        MeshObject*         object,
+        const bpy::object&  buffer,
+        const size_t        motion_segment_index)
+    {
+        const PyBufferView view(buffer, PyBufferView::ReadOnly);
+        view.check_float_items(3);
+
+        const size_t count = object->get_vertex_count();
+
+        if (view.get_item_count() != count * 3)
+        {
+            PyErr_SetString(PyExc_ValueError, "Buffer size does not match vertex count");
+            bpy::throw_error_already_set();
+        }
+
+        if (motion_segment_index >= object->get_motion_segment_count())
+        {
+            PyErr_SetString(PyExc_IndexError, "Invalid motion segment index");
+            bpy::throw_error_already_set();
+        }
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GVector3 v;
+            view.read_items(i * 3, 3, &v[0]);
+            object->set_vertex_pose(i, motion_segment_index, v);
+        }
+    }
+
+    void copy_vertices_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBufferView view(buffer, PyBufferView::Writable);
+        view.check_float_items(3);
+
+        const size_t count = object->get_vertex_count();
+        check_buffer_capacity(view, count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            view.write_items(i * 3, 3, &object->get_vertex(i)[0]);
+    }
+
+    void copy_vertex_normals_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBufferView view(buffer, PyBufferView::Writable);
+        view.check_float_items(3);
+
+        const size_t count = object->get_vertex_normal_count();
+        check_buffer_capacity(view, count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const GVector3 n = object->get_vertex_normal(i);
+            view.write_items(i * 3, 3, &n[0]);
+        }
+    }
+
+    void copy_tex_coords_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBufferView view(buffer, PyBufferView::Writable);
+        view.check_float_items(2);
+
+        const size_t count = object->get_tex_coords_count();
+        check_buffer_capacity(view, count * 2);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const GVector2 uv = object->get_tex_coords(i);
+            view.write_items(i * 2, 2, &uv[0]);
+        }
+    }
+
+    void copy_triangles_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBufferView view(buffer, PyBufferView::Writable);
+        const size_t columns = get_triangle_buffer_columns(view);
+
+        const size_t count = object->get_triangle_count();
+        check_buffer_capacity(view, count * columns);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Triangle& t = object->get_triangle(i);
+
+            uint32 c[10];
+            size_t k = 0;
+
+            c[k++] = t.m_v0; c[k++] = t.m_v1; c[k++] = t.m_v2;
+
+            if (columns >= 7)
+            {
+                c[k++] = t.m_n0; c[k++] = t.m_n1; c[k++] = t.m_n2;
+            }
+
+            if (columns == 10)
+            {
+                c[k++] = t.m_a0; c[k++] = t.m_a1; c[k++] = t.m_a2;
+            }
+
+            if (columns >= 4)
+                c[k++] = t.m_pa;
+
+            view.write_items(i * columns, columns, c);
+        }
+    }
+
     bpy::list read_mesh_objects(
         const bpy::list&    search_paths,
         const string&       base_object_name,
@@ -122,6 +408,16 @@ namespace
         return MeshObjectWriter::write(*object, object_name.c_str(), filename.c_str());
     }
 
+    void compute_smooth_vertex_normals_all_threads(MeshObject& object)
+    {
+        compute_smooth_vertex_normals(object);
+    }
+
+    void compute_smooth_vertex_tangents_all_threads(MeshObject& object)
+    {
+        compute_smooth_vertex_tangents(object);
+    }
+
     auto_release_ptr<MeshObject> create_mesh_prim(
         const string&       name,
         const bpy::dict&    params)
@@ -163,7 +459,7 @@ void bind_mesh_object()
         .def("reserve_vertex_normals", &MeshObject::reserve_vertex_normals)
         .def("push_vertex_normal", &MeshObject::push_vertex_normal)
         .def("get_vertex_normal_count", &MeshObject::get_vertex_normal_count)
-        .def("get_vertex_normal", &MeshObject::get_vertex_normal, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("get_vertex_normal", &MeshObject::get_vertex_normal)
 
         .def("reserve_tex_coords", &MeshObject::reserve_tex_coords)
         .def("push_tex_coords", &MeshObject::push_tex_coords)
@@ -193,6 +489,17 @@ void bind_mesh_object()
 
         .def("reserve_material_slots", &MeshObject::reserve_material_slots)
         .def("push_material_slot", &MeshObject::push_material_slot)
+
+        .def("push_vertices_from", push_vertices_from)
+        .def("push_vertex_normals_from", push_vertex_normals_from)
+        .def("push_tex_coords_from", push_tex_coords_from)
+        .def("push_triangles_from", push_triangles_from)
+        .def("set_vertex_poses_from", set_vertex_poses_from)
+
+        .def("copy_vertices_to", copy_vertices_to)
+        .def("copy_vertex_normals_to", copy_vertex_normals_to)
+        .def("copy_tex_coords_to", copy_tex_coords_to)
+        .def("copy_triangles_to", copy_triangles_to)
         ;
 
     boost::python::implicitly_convertible<auto_release_ptr<MeshObject>, auto_release_ptr<Object>>();
@@ -205,7 +512,7 @@ void bind_mesh_object()
         .def("write", write_mesh_object).staticmethod("write")
         ;
 
-    bpy::def("compute_smooth_vertex_normals", compute_smooth_vertex_normals);
-    bpy::def("compute_smooth_vertex_tangents", compute_smooth_vertex_tangents);
+    bpy::def("compute_smooth_vertex_normals", compute_smooth_vertex_normals_all_threads);
+    bpy::def("compute_smooth_vertex_tangents", compute_smooth_vertex_tangents_all_threads);
     bpy::def("create_primitive_mesh", create_mesh_prim);
 }
@@ -42,6 +42,7 @@ void bind_bsdf();
 void bind_bssrdf();
 void bind_camera();
 void bind_color();
+void bind_curve_object();
 void bind_display();
 void bind_edf();
 void bind_entity();
@@ -100,6 +101,7 @@ BOOST_PYTHON_MODULE(_appleseedpython)
     bind_light();
     bind_object();
     bind_mesh_object();
+    bind_curve_object();
     bind_assembly();
 
     bind_camera();
@@ -0,0 +1,145 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "pybuffer.h"
+
+namespace bpy = boost::python;
+
+namespace
+{
+    void raise(PyObject* type, const char* message)
+    {
+        PyErr_SetString(type, message);
+        bpy::throw_error_already_set();
+    }
+}
+
+PyBufferView::PyBufferView(const bpy::object& obj, const Access access)
+{
+    const int flags =
+        access == Writable
+            ? PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE
+            : PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+
+    if (PyObject_GetBuffer(obj.ptr(), &m_buffer, flags) != 0)
+        bpy::throw_error_already_set();
+
+    // Skip native and little-endian byte order prefixes.
+    const char* format = m_buffer.format ? m_buffer.format : "B";
+    if (*format == '@' || *format == '=' || *format == '<')
+        ++format;
+
+    m_kind = 0;
+
+    if (format[0] != '\0' && format[1] == '\0')
+    {
+        switch (format[0])
+        {
+          case 'f': case 'd':
+            m_kind = 'f';
+            break;
+
+          case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+            m_kind = 'i';
+            break;
+
+          case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N':
+            m_kind = 'u';
+            break;
+        }
+    }
+
+    // Items whose size does not match their format are not accessible as typed values.
+    if ((m_kind == 'f' && m_buffer.itemsize != 4 && m_buffer.itemsize != 8) ||
+        (m_kind != 'f' && m_buffer.itemsize != 1 && m_buffer.itemsize != 2 &&
+                          m_buffer.itemsize != 4 && m_buffer.itemsize != 8))
+        m_kind = 0;
+}
+
+PyBufferView::~PyBufferView()
+{
+    PyBuffer_Release(&m_buffer);
+}
+
+bool PyBufferView::has_float_items() const
+{
+    return m_kind == 'f';
+}
+
+bool PyBufferView::has_integer_items() const
+{
+    return m_kind == 'i' || m_kind == 'u';
+}
+
+size_t PyBufferView::get_size() const
+{
+    return static_cast<size_t>(m_buffer.len);
+}
+
+const void* PyBufferView::get_data() const
+{
+    return m_buffer.buf;
+}
+
+void* PyBufferView::get_data()
+{
+    return m_buffer.buf;
+}
+
+size_t PyBufferView::get_item_count() const
+{
+    return static_cast<size_t>(m_buffer.len / m_buffer.itemsize);
+}
+
+size_t PyBufferView::get_inner_dimension() const
+{
+    return
+        m_buffer.ndim > 1 && m_buffer.shape != 0
+            ? static_cast<size_t>(m_buffer.shape[m_buffer.ndim - 1])
+            : 0;
+}
+
+void PyBufferView::check_float_items(const size_t multiple) const
+{
+    if (!has_float_items())
+        raise(PyExc_TypeError, "Buffer items must be floating-point values");
+
+    if (get_item_count() % multiple != 0)
+        raise(PyExc_ValueError, "Buffer size does not match the expected layout");
+}
+
+void PyBufferView::check_integer_items(const size_t multiple) const
+{
+    if (!has_integer_items())
+        raise(PyExc_TypeError, "Buffer items must be integers");
+
+    if (get_item_count() % multiple != 0)
+        raise(PyExc_ValueError, "Buffer size does not match the expected layout");
+}
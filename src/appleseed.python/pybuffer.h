@@ -0,0 +1,201 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_PYTHON_PYBUFFER_H
+#define APPLESEED_PYTHON_PYBUFFER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/python.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+// This class gives access to the memory of a Python object supporting the
+// buffer protocol, such as a NumPy array, a memoryview or a bytearray.
+// The memory must be C-contiguous. Items of numeric formats can be read and
+// written as typed values. Neither items nor raw memory require holding
+// Python's global interpreter lock.
+class PyBufferView
+  : public foundation::NonCopyable
+{
+  public:
+    enum Access
+    {
+        ReadOnly,
+        Writable
+    };
+
+    // Acquire the buffer of a Python object. Raise a Python exception on failure.
+    PyBufferView(const boost::python::object& obj, const Access access);
+
+    // Release the buffer.
+    ~PyBufferView();
+
+    // Return the size of the buffer in bytes, and its raw memory.
+    size_t get_size() const;
+    const void* get_data() const;
+    void* get_data();
+
+    // Return true if the items of the buffer are floating-point values.
+    bool has_float_items() const;
+
+    // Return true if the items of the buffer are integers.
+    bool has_integer_items() const;
+
+    // Return the number of items in the buffer.
+    size_t get_item_count() const;
+
+    // Return the size of the last dimension of the buffer, or 0 if the buffer is one-dimensional.
+    size_t get_inner_dimension() const;
+
+    // Raise a Python exception unless the buffer holds floating-point values
+    // (respectively integers) and its item count is a multiple of a given number.
+    void check_float_items(const size_t multiple) const;
+    void check_integer_items(const size_t multiple) const;
+
+    // Read or write a range of items, converting them to or from T.
+    template <typename T> void read_items(const size_t first, const size_t count, T* values) const;
+    template <typename T> void write_items(const size_t first, const size_t count, const T* values);
+
+  private:
+    Py_buffer   m_buffer;
+    char        m_kind;                 // 'f' (floating-point), 'i' (signed integer), 'u' (unsigned integer) or 0 (other)
+
+    template <typename U, typename T>
+    void read_items_as(const size_t first, const size_t count, T* values) const;
+
+    template <typename U, typename T>
+    void write_items_as(const size_t first, const size_t count, const T* values);
+};
+
+
+//
+// PyBufferView class implementation.
+//
+
+template <typename T>
+void PyBufferView::read_items(const size_t first, const size_t count, T* values) const
+{
+    assert(m_kind != 0);
+
+    switch (m_kind)
+    {
+      case 'f':
+        if (m_buffer.itemsize == 4)
+            read_items_as<float>(first, count, values);
+        else read_items_as<double>(first, count, values);
+        break;
+
+      case 'i':
+        switch (m_buffer.itemsize)
+        {
+          case 1: read_items_as<foundation::int8>(first, count, values); break;
+          case 2: read_items_as<foundation::int16>(first, count, values); break;
+          case 4: read_items_as<foundation::int32>(first, count, values); break;
+          default: read_items_as<foundation::int64>(first, count, values); break;
+        }
+        break;
+
+      default:
+        switch (m_buffer.itemsize)
+        {
+          case 1: read_items_as<foundation::uint8>(first, count, values); break;
+          case 2: read_items_as<foundation::uint16>(first, count, values); break;
+          case 4: read_items_as<foundation::uint32>(first, count, values); break;
+          default: read_items_as<foundation::uint64>(first, count, values); break;
+        }
+        break;
+    }
+}
+
+template <typename T>
+void PyBufferView::write_items(const size_t first, const size_t count, const T* values)
+{
+    assert(m_kind != 0);
+
+    switch (m_kind)
+    {
+      case 'f':
+        if (m_buffer.itemsize == 4)
+            write_items_as<float>(first, count, values);
+        else write_items_as<double>(first, count, values);
+        break;
+
+      case 'i':
+        switch (m_buffer.itemsize)
+        {
+          case 1: write_items_as<foundation::int8>(first, count, values); break;
+          case 2: write_items_as<foundation::int16>(first, count, values); break;
+          case 4: write_items_as<foundation::int32>(first, count, values); break;
+          default: write_items_as<foundation::int64>(first, count, values); break;
+        }
+        break;
+
+      default:
+        switch (m_buffer.itemsize)
+        {
+          case 1: write_items_as<foundation::uint8>(first, count, values); break;
+          case 2: write_items_as<foundation::uint16>(first, count, values); break;
+          case 4: write_items_as<foundation::uint32>(first, count, values); break;
+          default: write_items_as<foundation::uint64>(first, count, values); break;
+        }
+        break;
+    }
+}
+
+template <typename U, typename T>
+void PyBufferView::read_items_as(const size_t first, const size_t count, T* values) const
+{
+    const char* ptr = static_cast<const char*>(m_buffer.buf) + first * sizeof(U);
+
+    for (size_t i = 0; i < count; ++i, ptr += sizeof(U))
+    {
+        U value;
+        std::memcpy(&value, ptr, sizeof(U));
+        values[i] = static_cast<T>(value);
+    }
+}
+
+template <typename U, typename T>
+void PyBufferView::write_items_as(const size_t first, const size_t count, const T* values)
+{
+    char* ptr = static_cast<char*>(m_buffer.buf) + first * sizeof(U);
+
+    for (size_t i = 0; i < count; ++i, ptr += sizeof(U))
+    {
+        const U value = static_cast<U>(values[i]);
+        std::memcpy(ptr, &value, sizeof(U));
+    }
+}
+
+#endif  // !APPLESEED_PYTHON_PYBUFFER_H
@@ -29,8 +29,11 @@
 import unittest
 
 from testbasis import *
+from testcurveobject import *
 from testdict2dict import *
 from testentitymap import *
 from testentityvector import *
+from testimage import *
+from testmeshobject import *
 
 unittest.TestProgram(testRunner=unittest.TextTestRunner())
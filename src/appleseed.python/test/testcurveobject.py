@@ -0,0 +1,88 @@
+
+#
+# This source file is part of appleseed.
+# Visit http://appleseedhq.net/ for additional information and resources.
+#
+# This software is released under the MIT license.
+#
+# Copyright (c) 2016-2017 Francois Beaune, The appleseedhq Organization
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+import unittest
+import appleseed as asr
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+@unittest.skipIf(np is None, "NumPy is not available")
+class TestCurveObjectBulkAccessors(unittest.TestCase):
+    """
+    Tests of the buffer-based curve object accessors.
+    """
+
+    def setUp(self):
+        self.curves = asr.CurveObject("curves", {})
+
+    def test_push_and_copy_linear_curves(self):
+        points = np.arange(2 * 2 * 3, dtype=np.float32).reshape(2, 2, 3)
+        widths = np.array([[0.1, 0.2], [0.3, 0.4]], dtype=np.float32)
+        self.curves.push_curves1_from(points, widths)
+
+        self.assertEqual(self.curves.get_curve1_count(), 2)
+
+        result_points = np.zeros((2, 2, 3), dtype=np.float64)
+        result_widths = np.zeros((2, 2), dtype=np.float64)
+        self.curves.copy_curves1_to(result_points, result_widths)
+
+        self.assertTrue(np.array_equal(points, result_points))
+        self.assertTrue(np.allclose(widths, result_widths))
+
+    def test_push_and_copy_cubic_curves(self):
+        points = np.arange(3 * 4 * 3, dtype=np.float32).reshape(3, 4, 3)
+        widths = np.full((3, 4), 0.5, dtype=np.float32)
+        self.curves.push_curves3_from(points, widths)
+
+        self.assertEqual(self.curves.get_curve3_count(), 3)
+
+        result_points = np.zeros((3, 4, 3), dtype=np.float32)
+        result_widths = np.zeros((3, 4), dtype=np.float32)
+        self.curves.copy_curves3_to(result_points, result_widths)
+
+        self.assertTrue(np.array_equal(points, result_points))
+        self.assertTrue(np.array_equal(widths, result_widths))
+
+    def test_push_curves_from_buffers_with_different_curve_counts_raises(self):
+        points = np.zeros((2, 2, 3), dtype=np.float32)
+        widths = np.zeros((3, 2), dtype=np.float32)
+
+        with self.assertRaises(ValueError):
+            self.curves.push_curves1_from(points, widths)
+
+    def test_copy_curves_to_too_small_buffers_raises(self):
+        self.curves.push_curves1_from(np.zeros((2, 2, 3), dtype=np.float32), np.zeros((2, 2), dtype=np.float32))
+
+        with self.assertRaises(IndexError):
+            self.curves.copy_curves1_to(np.zeros((1, 2, 3), dtype=np.float32), np.zeros((1, 2), dtype=np.float32))
+
+if __name__ == "__main__":
+    unittest.main()
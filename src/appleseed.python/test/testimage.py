@@ -0,0 +1,97 @@
+
+#
+# This source file is part of appleseed.
+# Visit http://appleseedhq.net/ for additional information and resources.
+#
+# This software is released under the MIT license.
+#
+# Copyright (c) 2016-2017 Francois Beaune, The appleseedhq Organization
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+import unittest
+import appleseed as asr
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+@unittest.skipIf(np is None, "NumPy is not available")
+class TestTileBulkAccessors(unittest.TestCase):
+    """
+    Tests of the buffer-based tile accessors.
+    """
+
+    def setUp(self):
+        self.tile = asr.Tile(4, 2, 3, asr.PixelFormat.Float)
+
+    def test_copy_data_from_and_to(self):
+        data = np.arange(4 * 2 * 3, dtype=np.float32)
+        self.tile.copy_data_from(data)
+
+        result = np.zeros(4 * 2 * 3, dtype=np.float32)
+        self.tile.copy_data_to(result)
+
+        self.assertTrue(np.array_equal(data, result))
+
+    def test_copy_data_from_buffer_of_wrong_size_raises(self):
+        with self.assertRaises(ValueError):
+            self.tile.copy_data_from(np.zeros(4 * 2 * 3 - 1, dtype=np.float32))
+
+
+@unittest.skipIf(np is None, "NumPy is not available")
+class TestImageBulkAccessors(unittest.TestCase):
+    """
+    Tests of the buffer-based image accessors.
+    """
+
+    def setUp(self):
+        # Tiles on the right and bottom edges are smaller than the others.
+        self.frame = asr.Frame("frame", {"resolution": "40 20", "tile_size": "16 16"})
+        self.image = self.frame.image()
+
+    def test_copy_data_from_and_to(self):
+        props = self.image.properties()
+        data = np.arange(20 * 40 * props.channel_count, dtype=np.float32).reshape(20, 40, props.channel_count)
+        self.image.copy_data_from(data)
+
+        result = np.zeros(data.shape, dtype=np.float32)
+        self.image.copy_data_to(result)
+
+        self.assertTrue(np.array_equal(data, result))
+
+    def test_copy_data_from_stores_pixels_in_scanline_order(self):
+        props = self.image.properties()
+        data = np.arange(20 * 40 * props.channel_count, dtype=np.float32).reshape(20, 40, props.channel_count)
+        self.image.copy_data_from(data)
+
+        tile = self.image.tile(2, 1)
+        tile_data = np.zeros((tile.get_height(), tile.get_width(), props.channel_count), dtype=np.float32)
+        tile.copy_data_to(tile_data)
+
+        self.assertTrue(np.array_equal(data[16:20, 32:40], tile_data))
+
+    def test_copy_data_to_buffer_of_wrong_size_raises(self):
+        with self.assertRaises(ValueError):
+            self.image.copy_data_to(np.zeros((20, 39, 4), dtype=np.float32))
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,110 @@
+
+#
+# This source file is part of appleseed.
+# Visit http://appleseedhq.net/ for additional information and resources.
+#
+# This software is released under the MIT license.
+#
+# Copyright (c) 2016-2017 Francois Beaune, The appleseedhq Organization
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+import unittest
+import appleseed as asr
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+@unittest.skipIf(np is None, "NumPy is not available")
+class TestMeshObjectBulkAccessors(unittest.TestCase):
+    """
+    Tests of the buffer-based mesh object accessors.
+    """
+
+    def setUp(self):
+        self.mesh = asr.MeshObject("mesh", {})
+
+    def test_push_and_copy_vertices(self):
+        vertices = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]], dtype=np.float32)
+        self.mesh.push_vertices_from(vertices)
+
+        self.assertEqual(self.mesh.get_vertex_count(), 3)
+
+        result = np.zeros((3, 3), dtype=np.float64)
+        self.mesh.copy_vertices_to(result)
+
+        self.assertTrue(np.array_equal(vertices, result))
+
+    def test_push_and_copy_triangles(self):
+        self.mesh.push_vertices_from(np.zeros((4, 3), dtype=np.float32))
+
+        triangles = np.array([[0, 1, 2, 0], [0, 2, 3, 0]], dtype=np.int32)
+        self.mesh.push_triangles_from(triangles)
+
+        self.assertEqual(self.mesh.get_triangle_count(), 2)
+        self.assertEqual(self.mesh.get_triangle(1).v2, 3)
+
+        result = np.zeros((2, 4), dtype=np.uint32)
+        self.mesh.copy_triangles_to(result)
+
+        self.assertTrue(np.array_equal(triangles, result))
+
+    def test_push_vertices_from_integer_buffer_raises(self):
+        with self.assertRaises(TypeError):
+            self.mesh.push_vertices_from(np.zeros((2, 3), dtype=np.int32))
+
+    def test_push_vertices_from_misshaped_buffer_raises(self):
+        with self.assertRaises(ValueError):
+            self.mesh.push_vertices_from(np.zeros(4, dtype=np.float32))
+
+    def test_push_triangles_from_buffer_with_invalid_vertex_index_raises(self):
+        self.mesh.push_vertices_from(np.zeros((3, 3), dtype=np.float32))
+
+        with self.assertRaises(IndexError):
+            self.mesh.push_triangles_from(np.array([[0, 1, 2], [0, 1, 3]], dtype=np.int32))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 0)
+
+    def test_push_triangles_from_buffer_with_negative_vertex_index_raises(self):
+        self.mesh.push_vertices_from(np.zeros((3, 3), dtype=np.float32))
+
+        with self.assertRaises(IndexError):
+            self.mesh.push_triangles_from(np.array([[0, 1, -1]], dtype=np.int32))
+
+    def test_push_triangles_from_buffer_with_invalid_vertex_normal_index_raises(self):
+        self.mesh.push_vertices_from(np.zeros((3, 3), dtype=np.float32))
+        self.mesh.push_vertex_normals_from(np.array([[0.0, 0.0, 1.0]], dtype=np.float32))
+
+        with self.assertRaises(IndexError):
+            self.mesh.push_triangles_from(np.array([[0, 1, 2, 0, 0, 1, 0]], dtype=np.int32))
+
+    def test_push_triangles_from_buffer_with_invalid_tex_coords_index_raises(self):
+        self.mesh.push_vertices_from(np.zeros((3, 3), dtype=np.float32))
+        self.mesh.push_vertex_normals_from(np.array([[0.0, 0.0, 1.0]], dtype=np.float32))
+        self.mesh.push_tex_coords_from(np.zeros((2, 2), dtype=np.float32))
+
+        with self.assertRaises(IndexError):
+            self.mesh.push_triangles_from(np.array([[0, 1, 2, 0, 0, 0, 0, 1, 2, 0]], dtype=np.int32))
+
+if __name__ == "__main__":
+    unittest.main()
@@ -56,6 +56,7 @@ SuperLogger::SuperLogger()
 
 SuperLogger::~SuperLogger()
 {
+    remove_target(m_log_target);
     delete m_log_target;
 }
 
@@ -78,6 +78,8 @@ void CommandLineHandler::print_program_usage(
 
 #ifdef _WIN32
 
+    logger.flush();
+
     const StringLogTarget& target =
         static_cast<const StringLogTarget&>(logger.get_log_target());
     const QString str = QString::fromStdString(target.get_string());
@@ -161,6 +161,8 @@ MainWindow::MainWindow(QWidget* parent)
 
 MainWindow::~MainWindow()
 {
+    global_logger().remove_target(m_log_target.get());
+
     delete m_project_explorer;
     delete m_ui;
 }
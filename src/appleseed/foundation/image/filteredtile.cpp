@@ -35,6 +35,9 @@
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/atomic.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
 
 using namespace std;
 
@@ -97,14 +100,7 @@ void FilteredTile::add(
     const float dy = y - 0.5f;
 
     // Find the pixels affected by this sample.
-    AABB2i footprint;
-    footprint.min.x = truncate<int>(fast_ceil(dx - m_filter.get_xradius()));
-    footprint.min.y = truncate<int>(fast_ceil(dy - m_filter.get_yradius()));
-    footprint.max.x = truncate<int>(fast_floor(dx + m_filter.get_xradius()));
-    footprint.max.y = truncate<int>(fast_floor(dy + m_filter.get_yradius()));
-
-    // Don't affect pixels outside the crop window.
-    footprint = AABB2i::intersect(footprint, m_crop_window);
+    const AABB2i footprint = compute_footprint(dx, dy);
 
     // Bail out if the point does not fall inside the crop window.
     // Only check the x coordinate; the y coordinate is checked in the loop below.
@@ -137,4 +133,72 @@ void FilteredTile::add(
     }
 }
 
+void FilteredTile::add_nonatomic(
+    const float         x,
+    const float         y,
+    const float*        values)
+{
+    // Convert (x, y) from continuous image space to discrete image space.
+    const float dx = x - 0.5f;
+    const float dy = y - 0.5f;
+
+    // Find the pixels affected by this sample.
+    const AABB2i footprint = compute_footprint(dx, dy);
+
+    // Bail out if the point does not fall inside the crop window.
+    // Only check the x coordinate; the y coordinate is checked in the loop below.
+    if (footprint.min.x > footprint.max.x)
+        return;
+
+    const size_t value_count = m_channel_count - 1;
+
+#ifdef APPLESEED_USE_SSE
+    const size_t simd_value_count = value_count & ~size_t(3);
+#else
+    const size_t simd_value_count = 0;
+#endif
+
+    for (int ry = footprint.min.y; ry <= footprint.max.y; ++ry)
+    {
+        float* APPLESEED_RESTRICT ptr = reinterpret_cast<float*>(pixel(footprint.min.x, ry));
+
+        for (int rx = footprint.min.x; rx <= footprint.max.x; ++rx)
+        {
+            const float weight = m_filter.evaluate(rx - dx, ry - dy);
+
+            // The weight channel comes first, so values are not 16-byte aligned.
+            *ptr++ += weight;
+
+#ifdef APPLESEED_USE_SSE
+            const __m128 mweight = _mm_set1_ps(weight);
+
+            for (size_t i = 0; i < simd_value_count; i += 4)
+            {
+                const __m128 contribution = _mm_mul_ps(_mm_loadu_ps(values + i), mweight);
+                _mm_storeu_ps(ptr + i, _mm_add_ps(_mm_loadu_ps(ptr + i), contribution));
+            }
+#endif
+
+            for (size_t i = simd_value_count; i < value_count; ++i)
+                ptr[i] += values[i] * weight;
+
+            ptr += value_count;
+        }
+    }
+}
+
+AABB2i FilteredTile::compute_footprint(
+    const float         dx,
+    const float         dy) const
+{
+    AABB2i footprint;
+    footprint.min.x = truncate<int>(fast_ceil(dx - m_filter.get_xradius()));
+    footprint.min.y = truncate<int>(fast_ceil(dy - m_filter.get_yradius()));
+    footprint.max.x = truncate<int>(fast_floor(dx + m_filter.get_xradius()));
+    footprint.max.y = truncate<int>(fast_floor(dy + m_filter.get_yradius()));
+
+    // Don't affect pixels outside the crop window.
+    return AABB2i::intersect(footprint, AABB2i(m_crop_window));
+}
+
 }   // namespace foundation
@@ -120,14 +120,29 @@ class FilteredTile
 
     // The point (x, y) is expressed in continuous image space
     // (https://github.com/appleseedhq/appleseed/wiki/Terminology).
+    // This method is thread-safe.
     void add(
         const float         x,
         const float         y,
         const float*        values);
 
+    // Same as add() but not thread-safe. Use it when the tile is only ever
+    // accessed by a single thread: pixels are updated with regular (vectorized)
+    // arithmetic instead of atomic operations.
+    void add_nonatomic(
+        const float         x,
+        const float         y,
+        const float*        values);
+
   protected:
     const AABB2u            m_crop_window;
     const Filter2f&         m_filter;
+
+  private:
+    // Compute the pixels affected by a sample at (dx, dy) in discrete image space.
+    AABB2i compute_footprint(
+        const float         dx,
+        const float         dy) const;
 };
 
 
@@ -30,6 +30,11 @@
 // Interface header.
 #include "pixel.h"
 
+// appleseed.foundation headers.
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
+
 namespace foundation
 {
 
@@ -123,4 +128,174 @@ size_t Pixel::get_dest_channel_count(
     return dest_channel_count;
 }
 
+namespace
+{
+    //
+    // Vectorized conversion kernels for contiguous ranges of values.
+    //
+    // Each kernel produces exactly the same values as the corresponding
+    // scalar loop in pixel.h, including for the leftover values at the end
+    // of the range which are handled by the scalar code.
+    //
+
+#ifdef APPLESEED_USE_SSE
+
+    void convert_float_to_uint8(
+        const float*        src,
+        const size_t        count,
+        uint8*              dest)
+    {
+        const __m128 scale = _mm_set1_ps(256.0f);
+        const __m128 lo = _mm_setzero_ps();
+        const __m128 hi = _mm_set1_ps(255.0f);
+
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            // _mm_max_ps() returns its second operand if either one is NaN,
+            // hence the order of the operands: NaN values are mapped to zero.
+            const __m128 v0 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i +  0), scale), lo), hi);
+            const __m128 v1 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i +  4), scale), lo), hi);
+            const __m128 v2 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i +  8), scale), lo), hi);
+            const __m128 v3 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 12), scale), lo), hi);
+
+            // Truncate to integers in [0, 255] and narrow down to bytes.
+            const __m128i w01 = _mm_packs_epi32(_mm_cvttps_epi32(v0), _mm_cvttps_epi32(v1));
+            const __m128i w23 = _mm_packs_epi32(_mm_cvttps_epi32(v2), _mm_cvttps_epi32(v3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(w01, w23));
+        }
+
+        for (; i < count; ++i)
+        {
+            const float val = clamp(src[i] * 256.0f, 0.0f, 255.0f);
+            dest[i] = truncate<uint8>(val);
+        }
+    }
+
+    void convert_uint8_to_float(
+        const uint8*        src,
+        const size_t        count,
+        float*              dest)
+    {
+        const __m128 scale = _mm_set1_ps(1.0f / 255);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            // Widen 16 bytes to four vectors of 32-bit integers.
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i w0 = _mm_unpacklo_epi8(b, zero);
+            const __m128i w1 = _mm_unpackhi_epi8(b, zero);
+
+            _mm_storeu_ps(dest + i +  0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(w0, zero)), scale));
+            _mm_storeu_ps(dest + i +  4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(w0, zero)), scale));
+            _mm_storeu_ps(dest + i +  8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(w1, zero)), scale));
+            _mm_storeu_ps(dest + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(w1, zero)), scale));
+        }
+
+        for (; i < count; ++i)
+            dest[i] = static_cast<float>(src[i]) * (1.0f / 255);
+    }
+
+#endif
+
+#ifdef APPLESEED_USE_AVX2
+
+    // AVX2 builds are compiled with F16C enabled, which provides hardware
+    // conversions between float and half with round-to-nearest-even, the
+    // rounding mode used by OpenEXR's half class.
+
+    void convert_float_to_half(
+        const float*        src,
+        const size_t        count,
+        half*               dest)
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), h);
+        }
+
+        for (; i < count; ++i)
+            dest[i] = static_cast<half>(src[i]);
+    }
+
+    void convert_half_to_float(
+        const half*         src,
+        const size_t        count,
+        float*              dest)
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(h));
+        }
+
+        for (; i < count; ++i)
+            dest[i] = static_cast<float>(src[i]);
+    }
+
+#endif
+}
+
+bool Pixel::convert_contiguous(
+    const PixelFormat   src_format,
+    const void*         src_begin,
+    const void*         src_end,
+    const PixelFormat   dest_format,
+    void*               dest)
+{
+#ifdef APPLESEED_USE_SSE
+    const size_t count =
+        (reinterpret_cast<const uint8*>(src_end) - reinterpret_cast<const uint8*>(src_begin)) / size(src_format);
+
+    if (src_format == PixelFormatFloat && dest_format == PixelFormatUInt8)
+    {
+        convert_float_to_uint8(
+            reinterpret_cast<const float*>(src_begin),
+            count,
+            reinterpret_cast<uint8*>(dest));
+        return true;
+    }
+
+    if (src_format == PixelFormatUInt8 && dest_format == PixelFormatFloat)
+    {
+        convert_uint8_to_float(
+            reinterpret_cast<const uint8*>(src_begin),
+            count,
+            reinterpret_cast<float*>(dest));
+        return true;
+    }
+
+#ifdef APPLESEED_USE_AVX2
+    if (src_format == PixelFormatFloat && dest_format == PixelFormatHalf)
+    {
+        convert_float_to_half(
+            reinterpret_cast<const float*>(src_begin),
+            count,
+            reinterpret_cast<half*>(dest));
+        return true;
+    }
+
+    if (src_format == PixelFormatHalf && dest_format == PixelFormatFloat)
+    {
+        convert_half_to_float(
+            reinterpret_cast<const half*>(src_begin),
+            count,
+            reinterpret_cast<float*>(dest));
+        return true;
+    }
+#endif
+#endif
+
+    return false;
+}
+
 }   // namespace foundation
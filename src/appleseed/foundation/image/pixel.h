@@ -167,6 +167,15 @@ class Pixel
         const size_t        src_channels,   // number of source channels
         const size_t*       shuffle_table); // channel shuffling table
 
+  private:
+    // Convert a contiguous range of values using a vectorized kernel.
+    // Return false if there is no such kernel for this pair of formats.
+    APPLESEED_DLLSYMBOL static bool convert_contiguous(
+        const PixelFormat   src_format,     // source format
+        const void*         src_begin,      // points to the first value to convert
+        const void*         src_end,        // one beyond the last value to convert
+        const PixelFormat   dest_format,    // destination format
+        void*               dest);          // destination
 };
 
 
@@ -550,7 +559,6 @@ inline void Pixel::convert_to_format<float>(
     {
       case PixelFormatUInt8:                // lossy float -> uint8
         {
-            // todo: optimize this case using SSE?
             uint8* typed_dest = reinterpret_cast<uint8*>(dest);
             for (const float* it = src_begin; it < src_end; it += src_stride)
             {
@@ -1157,6 +1165,13 @@ inline void Pixel::convert(
     assert(src_end);
     assert(dest);
 
+    // Whole tiles are converted with unit strides: pick a vectorized kernel once
+    // for the entire range when one exists for this pair of formats.
+    if (src_stride == 1 &&
+        dest_stride == 1 &&
+        convert_contiguous(src_format, src_begin, src_end, dest_format, dest))
+        return;
+
     switch (src_format)
     {
       case PixelFormatUInt8:                // uint8 -> destination format
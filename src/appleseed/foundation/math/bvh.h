@@ -36,7 +36,9 @@
 #include "foundation/math/bvh/bvh_intersector.h"
 #include "foundation/math/bvh/bvh_medianpartitioner.h"
 #include "foundation/math/bvh/bvh_middlepartitioner.h"
+#include "foundation/math/bvh/bvh_motionsahpartitioner.h"
 #include "foundation/math/bvh/bvh_node.h"
+#include "foundation/math/bvh/bvh_parallelbuilder.h"
 #include "foundation/math/bvh/bvh_partitionerbase.h"
 #include "foundation/math/bvh/bvh_sahpartitioner.h"
 #include "foundation/math/bvh/bvh_sbvhpartitioner.h"
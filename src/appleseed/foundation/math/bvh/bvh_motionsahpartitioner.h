@@ -0,0 +1,239 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_BVH_BVH_MOTIONSAHPARTITIONER_H
+#define APPLESEED_FOUNDATION_MATH_BVH_BVH_MOTIONSAHPARTITIONER_H
+
+// appleseed.foundation headers.
+#include "foundation/math/bvh/bvh_partitionerbase.h"
+#include "foundation/math/scalar.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace foundation {
+namespace bvh {
+
+//
+// A BVH partitioner based on the Surface Area Heuristic (SAH), for items moving
+// linearly over the shutter interval.
+//
+// Items are ordered according to their bounding boxes at a reference time, but
+// the cost of a node is the average surface area of its bounding box over the
+// shutter interval, where the bounding box of the node is linearly interpolated
+// between the union of the start bounding boxes of its items and the union of
+// their end bounding boxes. This prevents items moving in different directions
+// from being grouped together just because they happen to overlap at the
+// reference time. With static items, this partitioner is equivalent to
+// SAHPartitioner.
+//
+
+template <typename AABBVector>
+class MotionSAHPartitioner
+  : public PartitionerBase<AABBVector>
+{
+  public:
+    typedef AABBVector AABBVectorType;
+    typedef typename AABBVectorType::value_type AABBType;
+    typedef typename AABBType::ValueType ValueType;
+
+    // Constructor.
+    MotionSAHPartitioner(
+        const AABBVectorType&   bboxes,
+        const AABBVectorType&   start_bboxes,
+        const AABBVectorType&   end_bboxes,
+        const size_t            max_leaf_size = 1,
+        const ValueType         interior_node_traversal_cost = ValueType(1.0),
+        const ValueType         item_intersection_cost = ValueType(1.0));
+
+    // Partition a set of items into two distinct sets.
+    size_t partition(
+        const size_t            begin,
+        const size_t            end,
+        const AABBType&         bbox);
+
+  private:
+    static const size_t Dimension = AABBType::Dimension;
+
+    const AABBVectorType&       m_start_bboxes;
+    const AABBVectorType&       m_end_bboxes;
+    const size_t                m_max_leaf_size;
+    const ValueType             m_interior_node_traversal_cost;
+    const ValueType             m_item_intersection_cost;
+    std::vector<ValueType>      m_left_areas;           // indexed like the items, so that disjoint ranges can be partitioned concurrently
+
+    // Return the average half surface area of a linearly moving bounding box.
+    static ValueType motion_half_surface_area(
+        const AABBType&         start_bbox,
+        const AABBType&         end_bbox);
+};
+
+
+//
+// MotionSAHPartitioner class implementation.
+//
+
+template <typename AABBVector>
+inline MotionSAHPartitioner<AABBVector>::MotionSAHPartitioner(
+    const AABBVectorType&       bboxes,
+    const AABBVectorType&       start_bboxes,
+    const AABBVectorType&       end_bboxes,
+    const size_t                max_leaf_size,
+    const ValueType             interior_node_traversal_cost,
+    const ValueType             item_intersection_cost)
+  : PartitionerBase<AABBVectorType>(bboxes)
+  , m_start_bboxes(start_bboxes)
+  , m_end_bboxes(end_bboxes)
+  , m_max_leaf_size(max_leaf_size)
+  , m_interior_node_traversal_cost(interior_node_traversal_cost)
+  , m_item_intersection_cost(item_intersection_cost)
+  , m_left_areas(bboxes.size() > 1 ? bboxes.size() - 1 : 0)
+{
+    assert(start_bboxes.size() == bboxes.size());
+    assert(end_bboxes.size() == bboxes.size());
+}
+
+template <typename AABBVector>
+size_t MotionSAHPartitioner<AABBVector>::partition(
+    const size_t                begin,
+    const size_t                end,
+    const AABBType&             bbox)
+{
+    // Don't split leaves containing only degenerate triangles.
+    if (bbox.rank() < Dimension - 1)
+        return end;
+
+    const size_t count = end - begin;
+    assert(count > 1);
+
+    // Don't split leaves containing less than a predefined number of items.
+    if (count <= m_max_leaf_size)
+        return end;
+
+    ValueType best_split_cost = std::numeric_limits<ValueType>::max();
+    size_t best_split_dim = 0;
+    size_t best_split_pivot = 0;
+
+    AABBType start_bbox_accumulator;
+    AABBType end_bbox_accumulator;
+
+    for (size_t d = 0; d < Dimension; ++d)
+    {
+        const std::vector<size_t>& indices = PartitionerBase<AABBVector>::m_indices[d];
+
+        // Left-to-right sweep to accumulate bounding boxes and compute their surface area.
+        start_bbox_accumulator.invalidate();
+        end_bbox_accumulator.invalidate();
+        for (size_t i = 0; i < count - 1; ++i)
+        {
+            const size_t index = indices[begin + i];
+            start_bbox_accumulator.insert(m_start_bboxes[index]);
+            end_bbox_accumulator.insert(m_end_bboxes[index]);
+            m_left_areas[begin + i] =
+                motion_half_surface_area(start_bbox_accumulator, end_bbox_accumulator);
+        }
+
+        // Right-to-left sweep to accumulate bounding boxes, compute their surface area find the best partition.
+        start_bbox_accumulator.invalidate();
+        end_bbox_accumulator.invalidate();
+        for (size_t i = count - 1; i > 0; --i)
+        {
+            // Compute right bounding boxes.
+            const size_t index = indices[begin + i];
+            start_bbox_accumulator.insert(m_start_bboxes[index]);
+            end_bbox_accumulator.insert(m_end_bboxes[index]);
+
+            // Compute the cost of this partition.
+            const ValueType left_cost = m_left_areas[begin + i - 1] * i;
+            const ValueType right_cost =
+                motion_half_surface_area(start_bbox_accumulator, end_bbox_accumulator) * (count - i);
+            const ValueType split_cost = left_cost + right_cost;
+
+            // Keep track of the partition with the lowest cost.
+            if (best_split_cost > split_cost)
+            {
+                best_split_cost = split_cost;
+                best_split_dim = d;
+                best_split_pivot = i;
+            }
+        }
+    }
+
+    // Compute the average surface area of the bounding box of the node.
+    const std::vector<size_t>& indices = PartitionerBase<AABBVector>::m_indices[0];
+    start_bbox_accumulator.invalidate();
+    end_bbox_accumulator.invalidate();
+    for (size_t i = begin; i < end; ++i)
+    {
+        start_bbox_accumulator.insert(m_start_bboxes[indices[i]]);
+        end_bbox_accumulator.insert(m_end_bboxes[indices[i]]);
+    }
+    const ValueType node_area =
+        motion_half_surface_area(start_bbox_accumulator, end_bbox_accumulator);
+
+    // Don't split if it's cheaper to make a leaf.
+    const ValueType split_cost =
+        m_interior_node_traversal_cost +
+        best_split_cost / node_area * m_item_intersection_cost;
+    const ValueType leaf_cost = count * m_item_intersection_cost;
+    if (leaf_cost <= split_cost)
+        return end;
+
+    const size_t pivot = begin + best_split_pivot;
+    assert(pivot < end);
+
+    PartitionerBase<AABBVector>::sort_indices(best_split_dim, begin, end, pivot);
+
+    return pivot;
+}
+
+template <typename AABBVector>
+inline typename MotionSAHPartitioner<AABBVector>::ValueType
+MotionSAHPartitioner<AABBVector>::motion_half_surface_area(
+    const AABBType&             start_bbox,
+    const AABBType&             end_bbox)
+{
+    // The surface area of the interpolated bounding box is a quadratic function
+    // of time, so Simpson's rule gives the exact average over the interval.
+    const AABBType mid_bbox(
+        lerp(start_bbox.min, end_bbox.min, ValueType(0.5)),
+        lerp(start_bbox.max, end_bbox.max, ValueType(0.5)));
+
+    return
+        (half_surface_area(start_bbox) +
+         ValueType(4.0) * half_surface_area(mid_bbox) +
+         half_surface_area(end_bbox)) * ValueType(1.0 / 6.0);
+}
+
+}       // namespace bvh
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_BVH_BVH_MOTIONSAHPARTITIONER_H
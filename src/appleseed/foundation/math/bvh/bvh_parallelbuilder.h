@@ -0,0 +1,367 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_BVH_BVH_PARALLELBUILDER_H
+#define APPLESEED_FOUNDATION_MATH_BVH_BVH_PARALLELBUILDER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Logger; }
+
+namespace foundation {
+namespace bvh {
+
+//
+// Parallel BVH builder.
+//
+// The top levels of the tree are built serially until all remaining item
+// ranges are small enough. The subtrees of these ranges are then built in
+// parallel, and finally grafted below the top levels. The resulting tree
+// has the same structure as the one built by bvh::Builder, but its nodes
+// are not laid out in the same order.
+//
+// The Partitioner class must conform to the prototype given in bvh::Builder.
+// In addition, partition() must support concurrent calls on disjoint item
+// ranges that each contain at most half of the items, as partitioners based
+// on bvh::PartitionerBase do.
+//
+
+template <typename Tree, typename Partitioner>
+class ParallelBuilder
+  : public NonCopyable
+{
+  public:
+    // Constructor.
+    ParallelBuilder();
+
+    // Build a tree using a given number of threads.
+    template <typename Timer>
+    void build(
+        Tree&           tree,
+        Partitioner&    partitioner,
+        const size_t    size,
+        const size_t    items_per_leaf_hint,
+        Logger&         logger,
+        const size_t    thread_count);
+
+    // Return the construction time.
+    double get_build_time() const;
+
+  private:
+    typedef typename Tree::NodeType NodeType;
+    typedef typename Tree::NodeVectorType NodeVectorType;
+    typedef typename NodeType::AABBType AABBType;
+
+    // Minimum number of items of a subtree built in parallel.
+    static const size_t MinSubtreeSize = 1024;
+
+    // Number of subtrees per thread, for load balancing.
+    static const size_t SubtreesPerThread = 8;
+
+    struct Range
+    {
+        size_t          m_node_index;
+        size_t          m_begin;
+        size_t          m_end;
+        AABBType        m_bbox;
+    };
+
+    class BuildSubtreeJob;
+
+    double m_build_time;
+
+    // Partition a range of items and turn the corresponding node into a leaf or an interior node.
+    // Return the index of the first item of the right child, or the end of the range for a leaf.
+    static size_t subdivide(
+        NodeVectorType& nodes,
+        Partitioner&    partitioner,
+        const Range&    range,
+        Range&          left_range,
+        Range&          right_range);
+
+    // Recursively subdivide a subtree.
+    static void subdivide_recurse(
+        NodeVectorType& nodes,
+        Partitioner&    partitioner,
+        const Range&    range);
+
+    // Graft a subtree in place of a given node.
+    static void graft_subtree(
+        NodeVectorType&         nodes,
+        const NodeVectorType&   subtree_nodes,
+        const size_t            node_index);
+};
+
+
+//
+// ParallelBuilder class implementation.
+//
+
+template <typename Tree, typename Partitioner>
+class ParallelBuilder<Tree, Partitioner>::BuildSubtreeJob
+  : public IJob
+{
+  public:
+    BuildSubtreeJob(
+        Partitioner&            partitioner,
+        const Range&            range,
+        NodeVectorType&         subtree_nodes)
+      : m_partitioner(partitioner)
+      , m_range(range)
+      , m_subtree_nodes(subtree_nodes)
+    {
+    }
+
+    virtual void execute(const size_t thread_index) override
+    {
+        // The root of the subtree is node 0.
+        m_subtree_nodes.push_back(NodeType());
+
+        Range root_range = m_range;
+        root_range.m_node_index = 0;
+
+        subdivide_recurse(m_subtree_nodes, m_partitioner, root_range);
+    }
+
+  private:
+    Partitioner&                m_partitioner;
+    const Range                 m_range;
+    NodeVectorType&             m_subtree_nodes;
+};
+
+template <typename Tree, typename Partitioner>
+ParallelBuilder<Tree, Partitioner>::ParallelBuilder()
+  : m_build_time(0.0)
+{
+}
+
+template <typename Tree, typename Partitioner>
+template <typename Timer>
+void ParallelBuilder<Tree, Partitioner>::build(
+    Tree&               tree,
+    Partitioner&        partitioner,
+    const size_t        size,
+    const size_t        items_per_leaf_hint,
+    Logger&             logger,
+    const size_t        thread_count)
+{
+    // Start stopwatch.
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    // Clear the tree.
+    tree.m_nodes.clear();
+
+    // Reserve memory for the nodes.
+    const size_t leaf_count_guess = size / items_per_leaf_hint;
+    const size_t node_count_guess = leaf_count_guess > 0 ? 2 * leaf_count_guess - 1 : 0;
+    tree.m_nodes.reserve(node_count_guess);
+
+    // Create the root node of the tree.
+    tree.m_nodes.push_back(NodeType());
+
+    // Ranges larger than this are subdivided serially. A value of 0 means
+    // that the whole tree is built serially. Ranges built in parallel must
+    // contain at most half of the items, see the class comment.
+    const size_t max_subtree_size =
+        thread_count > 1 && size >= 2 * MinSubtreeSize
+            ? std::max(size / (thread_count * SubtreesPerThread), MinSubtreeSize)
+            : 0;
+
+    // Build the top levels of the tree, in the same depth-first order as bvh::Builder.
+    std::vector<Range> subtree_ranges;
+    std::vector<Range> stack;
+
+    Range root_range;
+    root_range.m_node_index = 0;
+    root_range.m_begin = 0;
+    root_range.m_end = size;
+    root_range.m_bbox = partitioner.compute_bbox(0, size);
+    stack.push_back(root_range);
+
+    while (!stack.empty())
+    {
+        const Range range = stack.back();
+        stack.pop_back();
+
+        if (range.m_end - range.m_begin <= max_subtree_size)
+        {
+            subtree_ranges.push_back(range);
+            continue;
+        }
+
+        Range left_range, right_range;
+        if (subdivide(tree.m_nodes, partitioner, range, left_range, right_range) < range.m_end)
+        {
+            stack.push_back(right_range);
+            stack.push_back(left_range);
+        }
+    }
+
+    if (!subtree_ranges.empty())
+    {
+        // Build the subtrees in parallel.
+        std::vector<NodeVectorType> subtree_nodes(
+            subtree_ranges.size(),
+            NodeVectorType(tree.m_nodes.get_allocator()));
+
+        JobQueue job_queue;
+        for (size_t i = 0; i < subtree_ranges.size(); ++i)
+            job_queue.schedule(new BuildSubtreeJob(partitioner, subtree_ranges[i], subtree_nodes[i]));
+
+        JobManager job_manager(
+            logger,
+            job_queue,
+            std::min(thread_count, subtree_ranges.size()));
+        job_manager.start();
+        job_queue.wait_until_completion();
+
+        // Graft the subtrees below the top levels.
+        for (size_t i = 0; i < subtree_ranges.size(); ++i)
+            graft_subtree(tree.m_nodes, subtree_nodes[i], subtree_ranges[i].m_node_index);
+    }
+
+    // Measure and save construction time.
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename Tree, typename Partitioner>
+inline double ParallelBuilder<Tree, Partitioner>::get_build_time() const
+{
+    return m_build_time;
+}
+
+template <typename Tree, typename Partitioner>
+size_t ParallelBuilder<Tree, Partitioner>::subdivide(
+    NodeVectorType&     nodes,
+    Partitioner&        partitioner,
+    const Range&        range,
+    Range&              left_range,
+    Range&              right_range)
+{
+    assert(range.m_node_index < nodes.size());
+
+    // Try to partition the set of items.
+    size_t pivot = range.m_end;
+    if (range.m_end - range.m_begin > 1)
+    {
+        pivot = partitioner.partition(range.m_begin, range.m_end, typename Partitioner::AABBType(range.m_bbox));
+        assert(pivot > range.m_begin);
+        assert(pivot <= range.m_end);
+    }
+
+    if (pivot == range.m_end)
+    {
+        // Turn the current node into a leaf node.
+        NodeType& node = nodes[range.m_node_index];
+        node.make_leaf();
+        node.set_item_index(range.m_begin);
+        node.set_item_count(range.m_end - range.m_begin);
+    }
+    else
+    {
+        // Compute the child ranges.
+        left_range.m_node_index = nodes.size();
+        left_range.m_begin = range.m_begin;
+        left_range.m_end = pivot;
+        left_range.m_bbox = partitioner.compute_bbox(range.m_begin, pivot);
+        right_range.m_node_index = left_range.m_node_index + 1;
+        right_range.m_begin = pivot;
+        right_range.m_end = range.m_end;
+        right_range.m_bbox = partitioner.compute_bbox(pivot, range.m_end);
+
+        // Turn the current node into an interior node.
+        NodeType& node = nodes[range.m_node_index];
+        node.make_interior();
+        node.set_left_bbox(left_range.m_bbox);
+        node.set_right_bbox(right_range.m_bbox);
+        node.set_child_node_index(left_range.m_node_index);
+
+        // Create the child nodes.
+        nodes.push_back(NodeType());
+        nodes.push_back(NodeType());
+    }
+
+    return pivot;
+}
+
+template <typename Tree, typename Partitioner>
+void ParallelBuilder<Tree, Partitioner>::subdivide_recurse(
+    NodeVectorType&     nodes,
+    Partitioner&        partitioner,
+    const Range&        range)
+{
+    Range left_range, right_range;
+    if (subdivide(nodes, partitioner, range, left_range, right_range) < range.m_end)
+    {
+        subdivide_recurse(nodes, partitioner, left_range);
+        subdivide_recurse(nodes, partitioner, right_range);
+    }
+}
+
+template <typename Tree, typename Partitioner>
+void ParallelBuilder<Tree, Partitioner>::graft_subtree(
+    NodeVectorType&         nodes,
+    const NodeVectorType&   subtree_nodes,
+    const size_t            node_index)
+{
+    assert(!subtree_nodes.empty());
+
+    // The root of the subtree replaces the node, the other nodes are appended to the tree.
+    const size_t base = nodes.size() - 1;
+
+    nodes[node_index] = subtree_nodes[0];
+    nodes.insert(nodes.end(), subtree_nodes.begin() + 1, subtree_nodes.end());
+
+    if (!nodes[node_index].is_leaf())
+        nodes[node_index].set_child_node_index(nodes[node_index].get_child_node_index() + base);
+
+    for (size_t i = base + 1, e = nodes.size(); i < e; ++i)
+    {
+        NodeType& node = nodes[i];
+
+        if (!node.is_leaf())
+            node.set_child_node_index(node.get_child_node_index() + base);
+    }
+}
+
+}       // namespace bvh
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_BVH_BVH_PARALLELBUILDER_H
@@ -67,6 +67,9 @@ class Tree
     template <typename Tree, typename Partitioner>
     friend class Builder;
 
+    template <typename Tree, typename Partitioner>
+    friend class ParallelBuilder;
+
     template <typename Tree, typename Partitioner>
     friend class SpatialBuilder;
 
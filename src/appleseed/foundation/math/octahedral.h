@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
+#define APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace foundation
+{
+
+//
+// Compact encoding of unit vectors into 32 bits using an octahedral mapping:
+// the unit sphere is projected onto the octahedron |x| + |y| + |z| = 1, whose
+// lower half is then unfolded over the [-1,1]^2 square. Each coordinate of the
+// square is stored as a 16-bit fixed-point value; the maximum angular error is
+// about 0.004 degrees.
+//
+// Reference:
+//
+//   A Survey of Efficient Representations for Independent Unit Vectors
+//   http://jcgt.org/published/0003/02/01/paper.pdf
+//
+
+// Encode a unit vector.
+template <typename T>
+uint32 octahedral_encode(const Vector<T, 3>& v);
+
+// Decode a unit vector.
+template <typename T>
+Vector<T, 3> octahedral_decode(const uint32 code);
+
+
+//
+// Implementation.
+//
+
+namespace impl
+{
+    template <typename T>
+    inline uint32 octahedral_quantize(const T x)
+    {
+        return round<uint32>((clamp(x, T(-1.0), T(1.0)) * T(0.5) + T(0.5)) * T(65535.0));
+    }
+
+    template <typename T>
+    inline T octahedral_dequantize(const uint32 x)
+    {
+        return static_cast<T>(x) * T(2.0 / 65535.0) - T(1.0);
+    }
+}
+
+template <typename T>
+inline uint32 octahedral_encode(const Vector<T, 3>& v)
+{
+    assert(is_normalized(v));
+
+    // Project onto the octahedron.
+    const T rcp_norm1 = T(1.0) / (std::abs(v.x) + std::abs(v.y) + std::abs(v.z));
+    T x = v.x * rcp_norm1;
+    T y = v.y * rcp_norm1;
+
+    // Unfold the lower hemisphere.
+    if (v.z < T(0.0))
+    {
+        const T fx = (T(1.0) - std::abs(y)) * (x >= T(0.0) ? T(1.0) : T(-1.0));
+        const T fy = (T(1.0) - std::abs(x)) * (y >= T(0.0) ? T(1.0) : T(-1.0));
+        x = fx;
+        y = fy;
+    }
+
+    return
+          (impl::octahedral_quantize(x) << 16)
+        | impl::octahedral_quantize(y);
+}
+
+template <typename T>
+inline Vector<T, 3> octahedral_decode(const uint32 code)
+{
+    T x = impl::octahedral_dequantize<T>(code >> 16);
+    T y = impl::octahedral_dequantize<T>(code & 0xFFFFUL);
+    const T z = T(1.0) - std::abs(x) - std::abs(y);
+
+    // Fold the lower hemisphere back; this is a no-op on the upper hemisphere.
+    const T t = std::max(-z, T(0.0));
+    x += x >= T(0.0) ? -t : t;
+    y += y >= T(0.0) ? -t : t;
+
+    return normalize(Vector<T, 3>(x, y, z));
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
@@ -31,10 +31,12 @@
 #define APPLESEED_FOUNDATION_MATH_SAMPLING_QMCSAMPLINGCONTEXT_H
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
 #include "foundation/math/rng/distribution.h"
+#include "foundation/math/sobol.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/test/helpers.h"
 
@@ -47,6 +49,7 @@ DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, InitialStateIsCor
 DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestAssignmentOperator);
 DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestSplitting);
 DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestDoubleSplitting);
+DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestSplittingInSobolMode);
 
 namespace foundation
 {
@@ -59,11 +62,20 @@ namespace foundation
 //   - Cranley-Patterson rotation
 //   - Monte Carlo padding
 //
-// Reference:
+// or, alternatively:
+//
+//   - deterministic sampling based on Sobol sequences
+//   - hash-based Owen scrambling
+//   - padding with independently shuffled and scrambled Sobol sequences
+//
+// References:
 //
 //   Kollig and Keller, Efficient Multidimensional Sampling
 //   www.uni-kl.de/AG-Heinrich/EMS.pdf
 //
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
 
 template <typename RNG>
 class QMCSamplingContext
@@ -72,10 +84,11 @@ class QMCSamplingContext
     // Random number generator type.
     typedef RNG RNGType;
 
-    // This sampler can operate in two modes:
+    // This sampler can operate in three modes:
     //   1. In QMC mode, it uses possibly patent-encumbered techniques.
     //   2. In RNG mode, it works like RNGSamplingContext and sticks to random sampling.
-    enum Mode { QMCMode, RNGMode };
+    //   3. In Sobol mode, it uses Owen-scrambled Sobol sequences.
+    enum Mode { QMCMode, RNGMode, SobolMode };
 
     // Construct a sampling context of dimension 0. It cannot be used
     // directly; only child contexts obtained by splitting can.
@@ -85,13 +98,17 @@ class QMCSamplingContext
 
     // Construct a sampling context for a given number of dimensions
     // and samples. Set sample_count to 0 if the required number of
-    // samples is unknown or infinite.
+    // samples is unknown or infinite. In Sobol mode, seed selects the
+    // scrambling of the sequence; contexts that must be decorrelated
+    // (e.g. those of different pixels) should use different seeds but
+    // may all start at the same instance.
     QMCSamplingContext(
         RNG&            rng,
         const Mode      mode,
         const size_t    dimension,
         const size_t    sample_count,
-        const size_t    instance = 0);
+        const size_t    instance = 0,
+        const uint32    seed = 0);
 
     // Assignment operator.
     QMCSamplingContext& operator=(const QMCSamplingContext& rhs);
@@ -125,6 +142,7 @@ class QMCSamplingContext
     GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestAssignmentOperator);
     GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestSplitting);
     GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestDoubleSplitting);
+    GRANT_ACCESS_TO_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, TestSplittingInSobolMode);
 
     typedef Vector<double, 4> VectorType;
 
@@ -139,6 +157,11 @@ class QMCSamplingContext
 
     size_t      m_instance;
     VectorType  m_offset;
+    // Sobol mode only.
+    size_t      m_sample_index;                 // sample number of the last sample drawn
+    size_t      m_sobol_dimension;              // first dimension of the Sobol sequence
+    uint32      m_base_seed;                    // seed of the root context
+    uint32      m_seed;                         // scrambling seed
 
     // Cranley-Patterson rotation.
     template <typename T>
@@ -149,10 +172,14 @@ class QMCSamplingContext
         const Mode      mode,
         const size_t    base_dimension,
         const size_t    base_instance,
+        const uint32    base_seed,
         const size_t    dimension,
         const size_t    sample_count);
 
     void compute_offset();
+    void compute_seed();
+
+    size_t get_child_base_instance(const size_t child_sample_count) const;
 
     template <typename T> struct Tag {};
 
@@ -177,6 +204,10 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_sample_count(0)
   , m_instance(0)
   , m_offset(0.0)
+  , m_sample_index(0)
+  , m_sobol_dimension(0)
+  , m_base_seed(0)
+  , m_seed(0)
 {
 }
 
@@ -186,7 +217,8 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
     const Mode          mode,
     const size_t        dimension,
     const size_t        sample_count,
-    const size_t        instance)
+    const size_t        instance,
+    const uint32        seed)
   : m_rng(rng)
   , m_mode(mode)
   , m_base_dimension(0)
@@ -195,8 +227,15 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_sample_count(sample_count)
   , m_instance(instance)
   , m_offset(0.0)
+  , m_sample_index(instance)
+  , m_sobol_dimension(0)
+  , m_base_seed(seed)
+  , m_seed(0)
 {
     assert(dimension <= VectorType::Dimension);
+
+    if (m_mode == SobolMode)
+        compute_seed();
 }
 
 template <typename RNG>
@@ -205,6 +244,7 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
     const Mode          mode,
     const size_t        base_dimension,
     const size_t        base_instance,
+    const uint32        base_seed,
     const size_t        dimension,
     const size_t        sample_count)
   : m_rng(rng)
@@ -214,11 +254,17 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_dimension(dimension)
   , m_sample_count(sample_count)
   , m_instance(0)
+  , m_sample_index(base_instance)
+  , m_sobol_dimension(0)
+  , m_base_seed(base_seed)
+  , m_seed(0)
 {
     assert(dimension <= VectorType::Dimension);
 
     if (m_mode == QMCMode)
         compute_offset();
+    else if (m_mode == SobolMode)
+        compute_seed();
 }
 
 template <typename RNG> inline
@@ -232,6 +278,10 @@ QMCSamplingContext<RNG>::operator=(const QMCSamplingContext& rhs)
     m_sample_count = rhs.m_sample_count;
     m_instance = rhs.m_instance;
     m_offset = rhs.m_offset;
+    m_sample_index = rhs.m_sample_index;
+    m_sobol_dimension = rhs.m_sobol_dimension;
+    m_base_seed = rhs.m_base_seed;
+    m_seed = rhs.m_seed;
 
     return *this;
 }
@@ -246,7 +296,8 @@ inline QMCSamplingContext<RNG> QMCSamplingContext<RNG>::split(
             m_rng,
             m_mode,
             m_base_dimension + m_dimension,         // dimension allocation
-            m_base_instance + m_instance,           // decorrelation by generalization
+            get_child_base_instance(sample_count),  // decorrelation by generalization
+            m_base_seed,
             dimension,
             sample_count);
 }
@@ -260,19 +311,23 @@ inline void QMCSamplingContext<RNG>::split_in_place(
     assert(dimension <= VectorType::Dimension);
 
     m_base_dimension += m_dimension;                // dimension allocation
-    m_base_instance += m_instance;                  // decorrelation by generalization
+    m_base_instance = get_child_base_instance(sample_count);   // decorrelation by generalization
     m_dimension = dimension;
     m_sample_count = sample_count;
     m_instance = 0;
+    m_sample_index = m_base_instance;
 
     if (m_mode == QMCMode)
         compute_offset();
+    else if (m_mode == SobolMode)
+        compute_seed();
 }
 
 template <typename RNG>
 inline void QMCSamplingContext<RNG>::set_instance(const size_t instance)
 {
     m_instance = instance;
+    m_sample_index = m_base_instance + instance;
 }
 
 template <typename RNG>
@@ -331,6 +386,36 @@ inline void QMCSamplingContext<RNG>::compute_offset()
     }
 }
 
+template <typename RNG>
+inline void QMCSamplingContext<RNG>::compute_seed()
+{
+    if (m_base_dimension + m_dimension <= SobolDimensionCount)
+    {
+        // The first dimensions are drawn from a single high-dimensional Sobol sequence.
+        m_sobol_dimension = m_base_dimension;
+        m_seed = hash_uint32(m_base_seed);
+    }
+    else
+    {
+        // Padding: each higher group of dimensions is drawn from the first dimensions of
+        // the Sobol sequence, shuffled and scrambled with a seed of its own.
+        m_sobol_dimension = 0;
+        m_seed = mix_uint32(m_base_seed, static_cast<uint32>(m_base_dimension));
+    }
+}
+
+template <typename RNG>
+inline size_t QMCSamplingContext<RNG>::get_child_base_instance(const size_t child_sample_count) const
+{
+    // In Sobol mode, the samples of a child context form the block of the Sobol sequence
+    // whose index is the sample number of the last sample drawn from this context, such
+    // that whole trajectories are built from matching samples of the sequence.
+    return
+        m_mode == SobolMode
+            ? m_sample_index * (child_sample_count > 0 ? child_sample_count : 1)
+            : m_base_instance + m_instance;
+}
+
 template <typename RNG>
 template <typename T>
 inline T QMCSamplingContext<RNG>::next2(Tag<T>)
@@ -370,6 +455,15 @@ inline Vector<T, N> QMCSamplingContext<RNG>::next2(Tag<Vector<T, N>>)
             }
         }
     }
+    else if (m_mode == SobolMode)
+    {
+        m_sample_index = m_base_instance + m_instance;
+
+        v = owen_scrambled_sobol_sequence<T, N>(
+                m_sobol_dimension,
+                static_cast<uint32>(m_sample_index),
+                m_seed);
+    }
     else
     {
         for (size_t i = 0; i < N; ++i)
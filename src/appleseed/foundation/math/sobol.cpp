@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "sobol.h"
+
+namespace foundation
+{
+
+//
+// Generator matrices of the first N dimensions of the Sobol sequence.
+//
+// Direction numbers from Joe and Kuo (new-joe-kuo-6.21201):
+//
+//   http://web.maths.unsw.edu.au/~fkuo/sobol/new-joe-kuo-6.21201
+//
+
+const uint32 SobolMatrices[SobolDimensionCount][32] =
+{
+    {
+        0x80000000, 0x40000000, 0x20000000, 0x10000000,
+        0x08000000, 0x04000000, 0x02000000, 0x01000000,
+        0x00800000, 0x00400000, 0x00200000, 0x00100000,
+        0x00080000, 0x00040000, 0x00020000, 0x00010000,
+        0x00008000, 0x00004000, 0x00002000, 0x00001000,
+        0x00000800, 0x00000400, 0x00000200, 0x00000100,
+        0x00000080, 0x00000040, 0x00000020, 0x00000010,
+        0x00000008, 0x00000004, 0x00000002, 0x00000001
+    },
+    {
+        0x80000000, 0xc0000000, 0xa0000000, 0xf0000000,
+        0x88000000, 0xcc000000, 0xaa000000, 0xff000000,
+        0x80800000, 0xc0c00000, 0xa0a00000, 0xf0f00000,
+        0x88880000, 0xcccc0000, 0xaaaa0000, 0xffff0000,
+        0x80008000, 0xc000c000, 0xa000a000, 0xf000f000,
+        0x88008800, 0xcc00cc00, 0xaa00aa00, 0xff00ff00,
+        0x80808080, 0xc0c0c0c0, 0xa0a0a0a0, 0xf0f0f0f0,
+        0x88888888, 0xcccccccc, 0xaaaaaaaa, 0xffffffff
+    },
+    {
+        0x80000000, 0xc0000000, 0x60000000, 0x90000000,
+        0xe8000000, 0x5c000000, 0x8e000000, 0xc5000000,
+        0x68800000, 0x9cc00000, 0xee600000, 0x55900000,
+        0x80680000, 0xc09c0000, 0x60ee0000, 0x90550000,
+        0xe8808000, 0x5cc0c000, 0x8e606000, 0xc5909000,
+        0x6868e800, 0x9c9c5c00, 0xeeee8e00, 0x5555c500,
+        0x8000e880, 0xc0005cc0, 0x60008e60, 0x9000c590,
+        0xe8006868, 0x5c009c9c, 0x8e00eeee, 0xc5005555
+    },
+    {
+        0x80000000, 0xc0000000, 0x20000000, 0x50000000,
+        0xf8000000, 0x74000000, 0xa2000000, 0x93000000,
+        0xd8800000, 0x25400000, 0x59e00000, 0xe6d00000,
+        0x78080000, 0xb40c0000, 0x82020000, 0xc3050000,
+        0x208f8000, 0x51474000, 0xfbea2000, 0x75d93000,
+        0xa0858800, 0x914e5400, 0xdbe79e00, 0x25db6d00,
+        0x58800080, 0xe54000c0, 0x79e00020, 0xb6d00050,
+        0x800800f8, 0xc00c0074, 0x200200a2, 0x50050093
+    },
+    {
+        0x80000000, 0x40000000, 0x20000000, 0xb0000000,
+        0xf8000000, 0xdc000000, 0x7a000000, 0x9d000000,
+        0x5a800000, 0x2fc00000, 0xa1600000, 0xf0b00000,
+        0xda880000, 0x6fc40000, 0x81620000, 0x40bb0000,
+        0x22878000, 0xb3c9c000, 0xfb65a000, 0xddb2d000,
+        0x78022800, 0x9c0b3c00, 0x5a0fb600, 0x2d0ddb00,
+        0xa2878080, 0xf3c9c040, 0xdb65a020, 0x6db2d0b0,
+        0x800228f8, 0x400b3cdc, 0x200fb67a, 0xb00ddb9d
+    },
+    {
+        0x80000000, 0x40000000, 0x60000000, 0x30000000,
+        0xc8000000, 0x24000000, 0x56000000, 0xfb000000,
+        0xe0800000, 0x70400000, 0xa8600000, 0x14300000,
+        0x9ec80000, 0xdf240000, 0xb6d60000, 0x8bbb0000,
+        0x48008000, 0x64004000, 0x36006000, 0xcb003000,
+        0x2880c800, 0x54402400, 0xfe605600, 0xef30fb00,
+        0x7e48e080, 0xaf647040, 0x1eb6a860, 0x9f8b1430,
+        0xd6c81ec8, 0xbb249f24, 0x80d6d6d6, 0x40bbbbbb
+    },
+    {
+        0x80000000, 0xc0000000, 0xa0000000, 0xd0000000,
+        0x58000000, 0x94000000, 0x3e000000, 0xe3000000,
+        0xbe800000, 0x23c00000, 0x1e200000, 0xf3100000,
+        0x46780000, 0x67840000, 0x78460000, 0x84670000,
+        0xc6788000, 0xa784c000, 0xd846a000, 0x5467d000,
+        0x9e78d800, 0x33845400, 0xe6469e00, 0xb7673300,
+        0x20f86680, 0x104477c0, 0xf8668020, 0x4477c010,
+        0x668020f8, 0x77c01044, 0x8020f866, 0xc0104477
+    },
+    {
+        0x80000000, 0x40000000, 0xa0000000, 0x50000000,
+        0x88000000, 0x24000000, 0x12000000, 0x2d000000,
+        0x76800000, 0x9e400000, 0x08200000, 0x64100000,
+        0xb2280000, 0x7d140000, 0xfea20000, 0xba490000,
+        0x1a248000, 0x491b4000, 0xc4b5a000, 0xe3739000,
+        0xf6800800, 0xde400400, 0xa8200a00, 0x34100500,
+        0x3a280880, 0x59140240, 0xeca20120, 0x974902d0,
+        0x6ca48768, 0xd75b49e4, 0xcc95a082, 0x87639641
+    }
+};
+
+}   // namespace foundation
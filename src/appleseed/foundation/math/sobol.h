@@ -0,0 +1,233 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_SOBOL_H
+#define APPLESEED_FOUNDATION_MATH_SOBOL_H
+
+// appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// Sobol sequences with hash-based Owen scrambling.
+//
+// References:
+//
+//   Joe and Kuo, Constructing Sobol sequences with better two-dimensional projections
+//   https://web.maths.unsw.edu.au/~fkuo/sobol/joe-kuo-old.pdf
+//
+//   Laine and Karras, Stratified Sampling for Stochastic Transparency
+//   https://research.nvidia.com/sites/default/files/pubs/2011-06_Stratified-Sampling-for/laine2011egsr_paper.pdf
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+
+
+//
+// Generator matrices of the first N dimensions of the Sobol sequence, one 32-bit
+// column per bit of the sample index. Dimension 0 is the van der Corput sequence.
+//
+
+const size_t SobolDimensionCount = 8;
+APPLESEED_DLLSYMBOL extern const uint32 SobolMatrices[SobolDimensionCount][32];
+
+
+//
+// Bit manipulation kernels.
+//
+
+// Reverse the order of the bits of a 32-bit integer.
+uint32 reverse_bits(uint32 value);
+
+// Hash-based approximation of a random base-2 permutation that only propagates
+// changes from lower bits to higher bits (Laine and Karras).
+uint32 laine_karras_permutation(
+    uint32              value,
+    const uint32        seed);
+
+// Owen scrambling (nested uniform scrambling) of a 32-bit fixed point number in [0,1).
+uint32 nested_uniform_scramble(
+    const uint32        value,
+    const uint32        seed);
+
+// Convert a 32-bit fixed point number to a floating-point value in [0, 1).
+template <typename T>
+T uint32_to_unit_interval(const uint32 value);
+
+
+//
+// Sobol sequence generators.
+//
+// All floating-point return values are in the interval [0, 1).
+//
+
+// Return the i'th sample of a given dimension of the Sobol sequence, as a 32-bit fixed point number.
+uint32 sobol_uint32(
+    const size_t        dimension,      // dimension, in [0, SobolDimensionCount)
+    uint32              i);             // sample number
+
+// Return the i'th sample of a given dimension of the Sobol sequence.
+template <typename T>
+T sobol(
+    const size_t        dimension,      // dimension, in [0, SobolDimensionCount)
+    const uint32        i);             // sample number
+
+// Return the i'th sample of a given dimension of an Owen-scrambled Sobol sequence.
+template <typename T>
+T owen_scrambled_sobol(
+    const size_t        dimension,      // dimension, in [0, SobolDimensionCount)
+    const uint32        i,              // sample number
+    const uint32        seed);          // scrambling seed
+
+// Return the i'th sample of dimensions [first_dimension, first_dimension + Dim) of an
+// Owen-scrambled Sobol sequence. The sample number is shuffled with a nested uniform
+// scramble, which maps aligned blocks of 2^m samples to aligned blocks of 2^m samples,
+// and each dimension is scrambled independently.
+template <typename T, size_t Dim>
+Vector<T, Dim> owen_scrambled_sobol_sequence(
+    const size_t        first_dimension,    // first dimension, first_dimension + Dim <= SobolDimensionCount
+    const uint32        i,                  // sample number
+    const uint32        seed);              // scrambling seed
+
+
+//
+// Implementation.
+//
+
+inline uint32 reverse_bits(uint32 value)
+{
+    value = (value >> 16) | (value << 16);                                      // 16-bit swap
+    value = ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);      // 8-bit swap
+    value = ((value & 0xF0F0F0F0UL) >> 4) | ((value & 0x0F0F0F0FUL) << 4);      // 4-bit swap
+    value = ((value & 0xCCCCCCCCUL) >> 2) | ((value & 0x33333333UL) << 2);      // 2-bit swap
+    value = ((value & 0xAAAAAAAAUL) >> 1) | ((value & 0x55555555UL) << 1);      // 1-bit swap
+    return value;
+}
+
+inline uint32 laine_karras_permutation(
+    uint32              value,
+    const uint32        seed)
+{
+    value += seed;
+    value ^= value * 0x6C50B47CUL;
+    value ^= value * 0xB82F1E52UL;
+    value ^= value * 0xC7AFE638UL;
+    value ^= value * 0x8D22F6E6UL;
+    return value;
+}
+
+inline uint32 nested_uniform_scramble(
+    const uint32        value,
+    const uint32        seed)
+{
+    return reverse_bits(laine_karras_permutation(reverse_bits(value), seed));
+}
+
+template <>
+inline float uint32_to_unit_interval<float>(const uint32 value)
+{
+    // Only keep 24 bits to guarantee that the result is strictly less than 1.
+    return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+}
+
+template <>
+inline double uint32_to_unit_interval<double>(const uint32 value)
+{
+    return static_cast<double>(value) * (1.0 / 4294967296.0);
+}
+
+inline uint32 sobol_uint32(
+    const size_t        dimension,
+    uint32              i)
+{
+    assert(dimension < SobolDimensionCount);
+
+    const uint32* matrix = SobolMatrices[dimension];
+    uint32 result = 0;
+
+    for (; i != 0; i >>= 1, ++matrix)
+    {
+        if (i & 1)
+            result ^= *matrix;
+    }
+
+    return result;
+}
+
+template <typename T>
+inline T sobol(
+    const size_t        dimension,
+    const uint32        i)
+{
+    return uint32_to_unit_interval<T>(sobol_uint32(dimension, i));
+}
+
+template <typename T>
+inline T owen_scrambled_sobol(
+    const size_t        dimension,
+    const uint32        i,
+    const uint32        seed)
+{
+    return
+        uint32_to_unit_interval<T>(
+            nested_uniform_scramble(sobol_uint32(dimension, i), seed));
+}
+
+template <typename T, size_t Dim>
+inline Vector<T, Dim> owen_scrambled_sobol_sequence(
+    const size_t        first_dimension,
+    const uint32        i,
+    const uint32        seed)
+{
+    assert(first_dimension + Dim <= SobolDimensionCount);
+
+    const uint32 index = nested_uniform_scramble(i, seed);
+
+    Vector<T, Dim> p;
+
+    for (size_t d = 0, e = first_dimension; d < Dim; ++d, ++e)
+        p[d] = owen_scrambled_sobol<T>(e, index, mix_uint32(seed, static_cast<uint32>(e)));
+
+    return p;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_SOBOL_H
@@ -37,6 +37,10 @@
 #include "foundation/math/ray.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
 #include "foundation/utility/poison.h"
 
 // Standard headers.
@@ -204,6 +208,9 @@ class TransformInterpolator
     Vector<T, 3>  m_s0, m_s1;
     Quaternion<T> m_q0, m_q1;
     Vector<T, 3>  m_t0, m_t1;
+
+    // Coefficients of the fast_slerp() correction, which only depend on m_q0 and m_q1.
+    T             m_slerp_a, m_slerp_b;
 };
 
 
@@ -653,6 +660,11 @@ bool TransformInterpolator<T>::set_transforms(
     if (dot(m_q0, m_q1) < T(0.0))
         m_q1 = -m_q1;
 
+    // Precompute the parts of fast_slerp() that don't depend on the interpolation parameter.
+    const T d = dot(m_q0, m_q1);
+    m_slerp_a = T(1.0904) + d * (T(-3.2452) + d * (T(3.55645) + d * T(-1.43519)));
+    m_slerp_b = T(0.848013) + d * (T(-1.06021) + d * T(0.215638));
+
     const T Eps = make_eps<T>(1.0e-4f, 1.0e-6);
     return is_normalized(m_q0, Eps) && is_normalized(m_q1, Eps);
 }
@@ -722,7 +734,11 @@ inline void TransformInterpolator<T>::evaluate(const T t, Transform<T>& result)
     //     parent_to_local = inv_smat * parent_to_local;
     //
 
-    const Quaternion<T> q = fast_slerp(m_q0, m_q1, t);
+    // Same as fast_slerp(m_q0, m_q1, t), using precomputed coefficients.
+    const T u = t - T(1.0);
+    const T v = t - T(0.5);
+    const T w = (m_slerp_a * v * v + m_slerp_b) * u * v * t + t;
+    const Quaternion<T> q = normalize(lerp(m_q0, m_q1, w));
 
     const T rtx = q.v[0] + q.v[0];
     const T rty = q.v[1] + q.v[1];
@@ -791,6 +807,95 @@ inline void TransformInterpolator<T>::evaluate(const T t, Transform<T>& result)
     result.m_local_to_parent[15] = result.m_parent_to_local[15] = T(1.0);
 }
 
+#ifdef APPLESEED_USE_SSE
+
+// SSE2-optimized double precision transform interpolation.
+template <>
+inline void TransformInterpolator<double>::evaluate(const double t, Transform<double>& result) const
+{
+    const double u = t - 1.0;
+    const double v = t - 0.5;
+    const double w = (m_slerp_a * v * v + m_slerp_b) * u * v * t + t;
+
+    // Interpolate and normalize the rotation, as (s, x) and (y, z) pairs.
+    const __m128d rot_w0 = _mm_set1_pd(1.0 - w);
+    const __m128d rot_w1 = _mm_set1_pd(w);
+    __m128d qsx = _mm_add_pd(_mm_mul_pd(rot_w0, _mm_loadu_pd(&m_q0.s)), _mm_mul_pd(rot_w1, _mm_loadu_pd(&m_q1.s)));
+    __m128d qyz = _mm_add_pd(_mm_mul_pd(rot_w0, _mm_loadu_pd(&m_q0.v[1])), _mm_mul_pd(rot_w1, _mm_loadu_pd(&m_q1.v[1])));
+    __m128d norm2 = _mm_add_pd(_mm_mul_pd(qsx, qsx), _mm_mul_pd(qyz, qyz));
+    norm2 = _mm_add_pd(norm2, _mm_shuffle_pd(norm2, norm2, 1));
+    const __m128d rcp_norm = _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(norm2));
+    qsx = _mm_mul_pd(qsx, rcp_norm);
+    qyz = _mm_mul_pd(qyz, rcp_norm);
+
+    // Compute the terms of the rotation matrix.
+    APPLESEED_SIMD4_ALIGN double q[4];
+    _mm_store_pd(q + 0, _mm_add_pd(qsx, qsx));
+    _mm_store_pd(q + 2, _mm_add_pd(qyz, qyz));
+    const double qs = 0.5 * q[0];
+    const double qx = 0.5 * q[1];
+    const double qy = 0.5 * q[2];
+    const double twx = q[1] * qs;
+    const double twy = q[2] * qs;
+    const double twz = q[3] * qs;
+    const double txx = q[1] * qx;
+    const double txy = q[2] * qx;
+    const double txz = q[3] * qx;
+    const double tyy = q[2] * qy;
+    const double tyz = q[3] * qy;
+    const double tzz = q[3] * 0.5 * q[3];
+    const double r00 = 1.0 - (tyy + tzz), r01 = txy - twz, r02 = txz + twy;
+    const double r10 = txy + twz, r11 = 1.0 - (txx + tzz), r12 = tyz - twx;
+    const double r20 = txz - twy, r21 = tyz + twx, r22 = 1.0 - (txx + tyy);
+
+    // Interpolate the scaling and translation components, as (x, y) pairs and z scalars.
+    const __m128d w0 = _mm_set1_pd(1.0 - t);
+    const __m128d w1 = _mm_set1_pd(t);
+    const __m128d sxy = _mm_add_pd(_mm_mul_pd(w0, _mm_loadu_pd(&m_s0[0])), _mm_mul_pd(w1, _mm_loadu_pd(&m_s1[0])));
+    const __m128d pxy = _mm_add_pd(_mm_mul_pd(w0, _mm_loadu_pd(&m_t0[0])), _mm_mul_pd(w1, _mm_loadu_pd(&m_t1[0])));
+    const double sz = (1.0 - t) * m_s0[2] + t * m_s1[2];
+    const double pz = (1.0 - t) * m_t0[2] + t * m_t1[2];
+    const __m128d rcp_sxy = _mm_div_pd(_mm_set1_pd(1.0), sxy);
+    const double rcp_sz = 1.0 / sz;
+
+    APPLESEED_SIMD4_ALIGN double p[2];
+    _mm_store_pd(p, pxy);
+
+    // Compute the local-to-parent matrix: the rotation with scaled columns, then the translation.
+    double* l2p = &result.m_local_to_parent[0];
+    _mm_store_pd(l2p +  0, _mm_mul_pd(_mm_set_pd(r01, r00), sxy));
+    _mm_store_pd(l2p +  2, _mm_set_pd(p[0], r02 * sz));
+    _mm_store_pd(l2p +  4, _mm_mul_pd(_mm_set_pd(r11, r10), sxy));
+    _mm_store_pd(l2p +  6, _mm_set_pd(p[1], r12 * sz));
+    _mm_store_pd(l2p +  8, _mm_mul_pd(_mm_set_pd(r21, r20), sxy));
+    _mm_store_pd(l2p + 10, _mm_set_pd(pz, r22 * sz));
+    _mm_store_pd(l2p + 12, _mm_setzero_pd());
+    _mm_store_pd(l2p + 14, _mm_set_pd(1.0, 0.0));
+
+    // Compute the parent-to-local matrix: the transposed rotation with scaled rows,
+    // and the rotated, scaled and negated translation.
+    APPLESEED_SIMD4_ALIGN double rcp_s[2];
+    _mm_store_pd(rcp_s, rcp_sxy);
+    const double ptl0 = r00 * p[0] + r10 * p[1] + r20 * pz;
+    const double ptl1 = r01 * p[0] + r11 * p[1] + r21 * pz;
+    const double ptl2 = r02 * p[0] + r12 * p[1] + r22 * pz;
+
+    double* p2l = &result.m_parent_to_local[0];
+    const __m128d rcp_sx = _mm_set1_pd(rcp_s[0]);
+    const __m128d rcp_sy = _mm_set1_pd(rcp_s[1]);
+    const __m128d rcp_sz2 = _mm_set1_pd(rcp_sz);
+    _mm_store_pd(p2l +  0, _mm_mul_pd(_mm_set_pd(r10, r00), rcp_sx));
+    _mm_store_pd(p2l +  2, _mm_mul_pd(_mm_set_pd(-ptl0, r20), rcp_sx));
+    _mm_store_pd(p2l +  4, _mm_mul_pd(_mm_set_pd(r11, r01), rcp_sy));
+    _mm_store_pd(p2l +  6, _mm_mul_pd(_mm_set_pd(-ptl1, r21), rcp_sy));
+    _mm_store_pd(p2l +  8, _mm_mul_pd(_mm_set_pd(r12, r02), rcp_sz2));
+    _mm_store_pd(p2l + 10, _mm_mul_pd(_mm_set_pd(-ptl2, r22), rcp_sz2));
+    _mm_store_pd(p2l + 12, _mm_setzero_pd());
+    _mm_store_pd(p2l + 14, _mm_set_pd(1.0, 0.0));
+}
+
+#endif  // APPLESEED_USE_SSE
+
 }       // namespace foundation
 
 #endif  // !APPLESEED_FOUNDATION_MATH_TRANSFORM_H
@@ -33,7 +33,9 @@
 // Interface headers.
 #include "foundation/math/voxel/voxel_builder.h"
 #include "foundation/math/voxel/voxel_intersector.h"
+#include "foundation/math/voxel/voxel_parallelbuilder.h"
 #include "foundation/math/voxel/voxel_statistics.h"
 #include "foundation/math/voxel/voxel_tree.h"
+#include "foundation/math/voxel/voxel_triangleintersector.h"
 
 #endif  // !APPLESEED_FOUNDATION_MATH_VOXEL_H
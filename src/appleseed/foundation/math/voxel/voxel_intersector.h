@@ -34,6 +34,10 @@
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/ray.h"
 #include "foundation/math/voxel/voxel_statistics.h"
+#include "foundation/platform/compiler.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
 
 // Standard headers.
 #include <cassert>
@@ -87,6 +91,81 @@ class Intersector
 };
 
 
+//
+// Voxel tree packet intersector.
+//
+// Intersects packets of four rays sharing the same origin and the same direction
+// signs, such as ambient occlusion rays cast from a given point and falling into
+// the same octant. The rays of a packet traverse the tree together, in single
+// precision, and each ray reports the same leaf as Intersector would.
+//
+
+template <typename Tree, size_t S = 64>
+class PacketIntersector
+  : public NonCopyable
+{
+  public:
+    // Types.
+    typedef typename Tree::NodeType NodeType;
+
+    // Number of rays in a packet.
+    static const size_t PacketSize = 4;
+
+    // A packet of rays.
+    struct RayPacket
+    {
+        APPLESEED_SIMD4_ALIGN float m_rcp_dir[3][PacketSize];
+        APPLESEED_SIMD4_ALIGN float m_tmin[PacketSize];
+        APPLESEED_SIMD4_ALIGN float m_tmax[PacketSize];
+        float               m_org[3];               // common origin
+        size_t              m_sgn_dir[3];           // common direction signs, as in RayInfo
+        size_t              m_mask;                 // bitmask of the valid rays of the packet
+    };
+
+    // Intersect a packet of rays with a given voxel tree. Return the bitmask of the
+    // rays that hit a solid (resp. empty) leaf; the distance to the leaf is stored in
+    // distances for these rays, and left unaltered for the others.
+    size_t intersect(
+        const Tree&             tree,
+        const RayPacket&        packet,
+        const bool              solid,
+        float                   distances[PacketSize]) const;
+
+  private:
+    // Node stack size.
+    static const size_t StackSize = S;
+
+#ifdef APPLESEED_USE_SSE
+    typedef __m128 Float4;
+#else
+    struct Float4 { float m_values[PacketSize]; };
+#endif
+
+    // Entry of the node stack.
+    struct NodeEntry
+    {
+        Float4              m_tnear;
+        Float4              m_tfar;
+        const NodeType*     m_node;
+        size_t              m_active;
+    };
+
+    static Float4 load(const float* values);
+    static void store(float* values, const Float4 x);
+
+    // Compute the distances along the rays to a splitting plane.
+    static Float4 split_distances(const float abscissa, const float org, const float* rcp_dir);
+
+    // Return b (and not a) if either argument is NaN.
+    static Float4 min4(const Float4 a, const Float4 b);
+    static Float4 max4(const Float4 a, const Float4 b);
+
+    // Return the bitmasks of a < b and !(a < b).
+    static size_t lt_mask(const Float4 a, const Float4 b);
+    static size_t nlt_mask(const Float4 a, const Float4 b);
+};
+
+
 //
 // Intersector class implementation.
 //
@@ -203,6 +282,241 @@ bool Intersector<T, Tree, S>::intersect(
 
 #undef FOUNDATION_VOXEL_TRAVERSAL_STATS
 
+
+//
+// PacketIntersector class implementation.
+//
+
+template <typename Tree, size_t S>
+size_t PacketIntersector<Tree, S>::intersect(
+    const Tree&             tree,
+    const RayPacket&        packet,
+    const bool              solid,
+    float                   distances[PacketSize]) const
+{
+    assert(!tree.m_nodes.empty());
+
+    // Initialize the node stack.
+    NodeEntry  stack[StackSize];
+    NodeEntry* stack_ptr = stack;
+
+    // Start at the root node, with the rays whose interval is not empty.
+    const NodeType* node = &tree.m_nodes.front();
+    Float4 tnear = load(packet.m_tmin);
+    Float4 tfar = load(packet.m_tmax);
+    const size_t traced = packet.m_mask & nlt_mask(tfar, tnear);
+    size_t active = traced;
+    size_t hits = 0;
+
+    if (active == 0)
+        return 0;
+
+    // Traverse the tree and intersect leaf nodes.
+    while (true)
+    {
+        // Traverse the tree until a leaf is reached.
+        while (node->is_interior())
+        {
+            // Compute the intersections of the splitting plane with the rays.
+            const size_t split_dim = node->get_split_dim();
+            const Float4 t =
+                split_distances(
+                    static_cast<float>(node->get_split_abs()),
+                    packet.m_org[split_dim],
+                    packet.m_rcp_dir[split_dim]);
+
+            // Get child node index and ray direction sign.
+            const NodeType* child = &tree.m_nodes[node->get_child_node_index()];
+            const size_t sgn_dir = packet.m_sgn_dir[split_dim];
+
+            // Determine which rays enter the front and the back nodes. For each ray,
+            // this follows the logic of Intersector::intersect(), including NaNs.
+            const size_t front_active = active & nlt_mask(t, tnear);
+            const size_t back_active = active & lt_mask(t, tfar);
+
+            if (front_active == 0)
+            {
+                // Follow the back node.
+                node = child + sgn_dir;
+                tnear = max4(t, tnear);
+                active = back_active;
+            }
+            else
+            {
+                // Push the back node on the stack.
+                if (back_active != 0)
+                {
+                    assert(stack_ptr < &stack[StackSize]);
+                    stack_ptr->m_tnear = max4(t, tnear);
+                    stack_ptr->m_tfar = tfar;
+                    stack_ptr->m_node = child + sgn_dir;
+                    stack_ptr->m_active = back_active;
+                    ++stack_ptr;
+                }
+
+                // Follow the front node.
+                node = child + 1 - sgn_dir;
+                tfar = min4(t, tfar);
+                active = front_active;
+            }
+        }
+
+        // Terminate the active rays as soon as a solid/empty leaf is hit.
+        if (node->is_solid() == solid)
+        {
+            APPLESEED_SIMD4_ALIGN float tnear_values[PacketSize];
+            store(tnear_values, tnear);
+
+            for (size_t i = 0; i < PacketSize; ++i)
+            {
+                if (active & (size_t(1) << i))
+                    distances[i] = tnear_values[i];
+            }
+
+            hits |= active;
+
+            if (hits == traced)
+                return hits;
+        }
+
+        // Pop the next node that still has rays to trace.
+        do
+        {
+            // Terminate traversal if there is no more nodes to visit.
+            if (stack_ptr == stack)
+                return hits;
+
+            --stack_ptr;
+            active = stack_ptr->m_active & ~hits;
+        } while (active == 0);
+
+        tnear = stack_ptr->m_tnear;
+        tfar = stack_ptr->m_tfar;
+        node = stack_ptr->m_node;
+    }
+}
+
+#ifdef APPLESEED_USE_SSE
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::load(const float* values)
+{
+    return _mm_load_ps(values);
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE void PacketIntersector<Tree, S>::store(float* values, const Float4 x)
+{
+    _mm_store_ps(values, x);
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::split_distances(
+    const float             abscissa,
+    const float             org,
+    const float*            rcp_dir)
+{
+    return _mm_mul_ps(_mm_set1_ps(abscissa - org), _mm_load_ps(rcp_dir));
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::min4(const Float4 a, const Float4 b)
+{
+    return _mm_min_ps(a, b);
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::max4(const Float4 a, const Float4 b)
+{
+    return _mm_max_ps(a, b);
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE size_t PacketIntersector<Tree, S>::lt_mask(const Float4 a, const Float4 b)
+{
+    return static_cast<size_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+}
+
+template <typename Tree, size_t S>
+APPLESEED_FORCE_INLINE size_t PacketIntersector<Tree, S>::nlt_mask(const Float4 a, const Float4 b)
+{
+    return static_cast<size_t>(_mm_movemask_ps(_mm_cmpnlt_ps(a, b)));
+}
+
+#else
+
+template <typename Tree, size_t S>
+inline typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::load(const float* values)
+{
+    Float4 x;
+    for (size_t i = 0; i < PacketSize; ++i)
+        x.m_values[i] = values[i];
+    return x;
+}
+
+template <typename Tree, size_t S>
+inline void PacketIntersector<Tree, S>::store(float* values, const Float4 x)
+{
+    for (size_t i = 0; i < PacketSize; ++i)
+        values[i] = x.m_values[i];
+}
+
+template <typename Tree, size_t S>
+inline typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::split_distances(
+    const float             abscissa,
+    const float             org,
+    const float*            rcp_dir)
+{
+    Float4 x;
+    for (size_t i = 0; i < PacketSize; ++i)
+        x.m_values[i] = (abscissa - org) * rcp_dir[i];
+    return x;
+}
+
+template <typename Tree, size_t S>
+inline typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::min4(const Float4 a, const Float4 b)
+{
+    Float4 x;
+    for (size_t i = 0; i < PacketSize; ++i)
+        x.m_values[i] = a.m_values[i] < b.m_values[i] ? a.m_values[i] : b.m_values[i];
+    return x;
+}
+
+template <typename Tree, size_t S>
+inline typename PacketIntersector<Tree, S>::Float4 PacketIntersector<Tree, S>::max4(const Float4 a, const Float4 b)
+{
+    Float4 x;
+    for (size_t i = 0; i < PacketSize; ++i)
+        x.m_values[i] = a.m_values[i] > b.m_values[i] ? a.m_values[i] : b.m_values[i];
+    return x;
+}
+
+template <typename Tree, size_t S>
+inline size_t PacketIntersector<Tree, S>::lt_mask(const Float4 a, const Float4 b)
+{
+    size_t mask = 0;
+    for (size_t i = 0; i < PacketSize; ++i)
+    {
+        if (a.m_values[i] < b.m_values[i])
+            mask |= size_t(1) << i;
+    }
+    return mask;
+}
+
+template <typename Tree, size_t S>
+inline size_t PacketIntersector<Tree, S>::nlt_mask(const Float4 a, const Float4 b)
+{
+    size_t mask = 0;
+    for (size_t i = 0; i < PacketSize; ++i)
+    {
+        if (!(a.m_values[i] < b.m_values[i]))
+            mask |= size_t(1) << i;
+    }
+    return mask;
+}
+
+#endif  // APPLESEED_USE_SSE
+
 }       // namespace voxel
 }       // namespace foundation
 
@@ -0,0 +1,351 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_PARALLELBUILDER_H
+#define APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_PARALLELBUILDER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/split.h"
+#include "foundation/math/voxel/voxel_builder.h"
+#include "foundation/platform/timers.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/stopwatch.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Logger; }
+
+namespace foundation {
+namespace voxel {
+
+//
+// Parallel voxel tree builder.
+//
+// The top levels of the tree are split upfront into a set of disjoint cells.
+// The subtree of each cell is then built independently, in parallel, using
+// a regular voxel::Builder, and the subtrees are finally grafted below the
+// top levels. The resulting tree partitions space exactly like the one built
+// serially by pushing the same items into a voxel::Builder.
+//
+
+template <
+    typename Tree,
+    typename Timer = DefaultWallclockTimer
+>
+class ParallelBuilder
+  : public NonCopyable
+{
+  public:
+    // Types.
+    typedef typename Tree::ValueType ValueType;
+    typedef typename Tree::AABBType AABBType;
+    typedef typename Tree::NodeType NodeType;
+    typedef Tree TreeType;
+
+    // Constructor.
+    ParallelBuilder(
+        TreeType&       tree,
+        const AABBType& bbox,
+        const ValueType max_extent);
+
+    // Build the tree from a set of items, using a given number of threads.
+    // See voxel::Builder for the prototype of the ItemIntersector class.
+    template <typename ItemIntersector>
+    void build(
+        const std::vector<ItemIntersector>& items,
+        Logger&                             logger,
+        const size_t                        thread_count);
+
+    // Return the construction time.
+    double get_build_time() const;
+
+  private:
+    typedef Split<ValueType> SplitType;
+    typedef Builder<Tree, Timer> SubtreeBuilderType;
+
+    // Maximum number of levels shared by all subtrees.
+    static const size_t MaxTopLevelCount = 12;
+
+    // Number of cells per thread, for load balancing.
+    static const size_t CellsPerThread = 8;
+
+    template <typename ItemIntersector>
+    class BuildSubtreeJob;
+
+    TreeType&           m_tree;
+    const AABBType      m_bbox;
+    const ValueType     m_max_extent;
+    double              m_build_time;
+
+    // Compute the number of top levels of the tree.
+    size_t compute_top_level_count(const size_t thread_count) const;
+
+    // Graft a subtree in place of a given leaf node.
+    void graft_subtree(
+        const TreeType&         subtree,
+        const size_t            node_index);
+
+    // Trim the top levels of the tree and compute the maximum leaf node diagonal length.
+    void trim_top_levels(
+        const std::vector<AABBType>&    node_bboxes,
+        const size_t                    first_cell_index);
+};
+
+
+//
+// ParallelBuilder class implementation.
+//
+
+template <typename Tree, typename Timer>
+template <typename ItemIntersector>
+class ParallelBuilder<Tree, Timer>::BuildSubtreeJob
+  : public IJob
+{
+  public:
+    BuildSubtreeJob(
+        const std::vector<ItemIntersector>& items,
+        TreeType&                           subtree,
+        const AABBType&                     bbox,
+        const ValueType                     max_extent)
+      : m_items(items)
+      , m_subtree(subtree)
+      , m_bbox(bbox)
+      , m_max_extent(max_extent)
+    {
+    }
+
+    virtual void execute(const size_t thread_index) override
+    {
+        SubtreeBuilderType builder(m_subtree, m_bbox, m_max_extent);
+
+        for (size_t i = 0, e = m_items.size(); i < e; ++i)
+        {
+            if (m_items[i].intersect(m_bbox))
+                builder.push(m_items[i]);
+        }
+
+        builder.complete();
+    }
+
+  private:
+    const std::vector<ItemIntersector>&     m_items;
+    TreeType&                               m_subtree;
+    const AABBType                          m_bbox;
+    const ValueType                         m_max_extent;
+};
+
+template <typename Tree, typename Timer>
+ParallelBuilder<Tree, Timer>::ParallelBuilder(
+    TreeType&       tree,
+    const AABBType& bbox,
+    const ValueType max_extent)
+  : m_tree(tree)
+  , m_bbox(bbox)
+  , m_max_extent(max_extent)
+  , m_build_time(0.0)
+{
+    assert(max_extent > ValueType(0.0));
+}
+
+template <typename Tree, typename Timer>
+template <typename ItemIntersector>
+void ParallelBuilder<Tree, Timer>::build(
+    const std::vector<ItemIntersector>& items,
+    Logger&                             logger,
+    const size_t                        thread_count)
+{
+    Stopwatch<Timer> stopwatch;
+    stopwatch.start();
+
+    const size_t top_level_count = compute_top_level_count(thread_count);
+    const size_t cell_count = size_t(1) << top_level_count;
+    const size_t first_cell_index = cell_count - 1;
+
+    // Create the top levels of the tree as a complete binary tree stored in
+    // breadth-first order: the children of node i are nodes 2i+1 and 2i+2.
+    m_tree.clear();
+    m_tree.m_bbox = m_bbox;
+    m_tree.m_nodes.resize(first_cell_index + cell_count);
+
+    std::vector<AABBType> node_bboxes(first_cell_index + cell_count);
+    node_bboxes[0] = m_bbox;
+
+    for (size_t i = 0; i < first_cell_index; ++i)
+    {
+        const SplitType split = SplitType::middle(node_bboxes[i]);
+        split_bbox(node_bboxes[i], split, node_bboxes[2 * i + 1], node_bboxes[2 * i + 2]);
+
+        NodeType& node = m_tree.m_nodes[i];
+        node.make_leaf();
+        node.set_solid_bit(false);
+        node.make_interior();
+        node.set_child_node_index(2 * i + 1);
+        node.set_split_dim(split.m_dimension);
+        node.set_split_abs(split.m_abscissa);
+    }
+
+    // Build the subtrees of all cells in parallel.
+    TreeType* subtrees = new TreeType[cell_count];
+
+    JobQueue job_queue;
+    for (size_t i = 0; i < cell_count; ++i)
+    {
+        job_queue.schedule(
+            new BuildSubtreeJob<ItemIntersector>(
+                items,
+                subtrees[i],
+                node_bboxes[first_cell_index + i],
+                m_max_extent));
+    }
+
+    JobManager job_manager(
+        logger,
+        job_queue,
+        std::max<size_t>(std::min(thread_count, cell_count), 1));
+    job_manager.start();
+    job_queue.wait_until_completion();
+
+    // Graft the subtrees below the top levels.
+    for (size_t i = 0; i < cell_count; ++i)
+        graft_subtree(subtrees[i], first_cell_index + i);
+
+    delete [] subtrees;
+
+    trim_top_levels(node_bboxes, first_cell_index);
+
+    // Measure and save construction time.
+    stopwatch.measure();
+    m_build_time = stopwatch.get_seconds();
+}
+
+template <typename Tree, typename Timer>
+double ParallelBuilder<Tree, Timer>::get_build_time() const
+{
+    return m_build_time;
+}
+
+template <typename Tree, typename Timer>
+size_t ParallelBuilder<Tree, Timer>::compute_top_level_count(const size_t thread_count) const
+{
+    // All cells at a given depth have the same shape, so following the left-most
+    // cell is enough to know where the serial builder would stop refining.
+    AABBType cell_bbox = m_bbox;
+    size_t level_count = 0;
+
+    while (level_count < MaxTopLevelCount &&
+           (size_t(1) << level_count) < thread_count * CellsPerThread)
+    {
+        const SplitType split = SplitType::middle(cell_bbox);
+        const ValueType cell_extent =
+              cell_bbox.max[split.m_dimension]
+            - cell_bbox.min[split.m_dimension];
+
+        if (cell_extent <= m_max_extent)
+            break;
+
+        AABBType right_bbox;
+        split_bbox(AABBType(cell_bbox), split, cell_bbox, right_bbox);
+        ++level_count;
+    }
+
+    return level_count;
+}
+
+template <typename Tree, typename Timer>
+void ParallelBuilder<Tree, Timer>::graft_subtree(
+    const TreeType&         subtree,
+    const size_t            node_index)
+{
+    assert(!subtree.m_nodes.empty());
+
+    // Nodes 1 to n-1 of the subtree are appended to the tree.
+    const size_t base = m_tree.m_nodes.size() - 1;
+
+    for (size_t i = 0, e = subtree.m_nodes.size(); i < e; ++i)
+    {
+        NodeType node = subtree.m_nodes[i];
+
+        if (node.is_interior())
+            node.set_child_node_index(base + node.get_child_node_index());
+
+        if (i == 0)
+            m_tree.m_nodes[node_index] = node;
+        else m_tree.m_nodes.push_back(node);
+    }
+
+    m_tree.m_max_diag = std::max(m_tree.m_max_diag, subtree.m_max_diag);
+}
+
+template <typename Tree, typename Timer>
+void ParallelBuilder<Tree, Timer>::trim_top_levels(
+    const std::vector<AABBType>&    node_bboxes,
+    const size_t                    first_cell_index)
+{
+    ValueType max_diag = m_tree.m_max_diag * m_tree.m_max_diag;
+
+    // Visit the top-level interior nodes bottom-up.
+    for (size_t i = first_cell_index; i-- > 0; )
+    {
+        NodeType& node = m_tree.m_nodes[i];
+        const NodeType& left_node = m_tree.m_nodes[2 * i + 1];
+        const NodeType& right_node = m_tree.m_nodes[2 * i + 2];
+
+        if (!left_node.is_leaf() || !right_node.is_leaf())
+            continue;
+
+        if (left_node.is_solid() && right_node.is_solid())
+        {
+            // Both children are solid leaves: the node becomes a solid leaf.
+            node.make_leaf();
+            node.set_solid_bit(true);
+
+            const typename TreeType::VectorType e = node_bboxes[i].extent();
+            max_diag = std::max(max_diag, e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+        }
+        else if (left_node.is_empty() && right_node.is_empty())
+        {
+            // Both children are empty leaves: no item reached this node.
+            node.make_leaf();
+            node.set_solid_bit(false);
+        }
+    }
+
+    m_tree.m_max_diag = std::sqrt(max_diag);
+}
+
+}       // namespace voxel
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_PARALLELBUILDER_H
@@ -103,6 +103,18 @@ class Tree
     >
     friend class Intersector;
 
+    template <
+        typename Tree,
+        typename Timer
+    >
+    friend class ParallelBuilder;
+
+    template <
+        typename Tree,
+        size_t S
+    >
+    friend class PacketIntersector;
+
     template <typename Tree, typename Builder>
     friend class TreeStatistics;
 
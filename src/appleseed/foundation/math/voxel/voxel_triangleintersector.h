@@ -0,0 +1,100 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_TRIANGLEINTERSECTOR_H
+#define APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_TRIANGLEINTERSECTOR_H
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/intersection/aabbtriangle.h"
+#include "foundation/math/vector.h"
+
+namespace foundation {
+namespace voxel {
+
+//
+// A triangle-bounding box intersection predicate, to insert triangles into voxel trees.
+//
+
+template <typename T>
+class TriangleIntersector
+{
+  public:
+    // Types.
+    typedef T ValueType;
+    typedef Vector<T, 3> VectorType;
+    typedef AABB<T, 3> AABBType;
+
+    // Constructor.
+    TriangleIntersector(
+        const VectorType&   v0,
+        const VectorType&   v1,
+        const VectorType&   v2);
+
+    // Return whether the triangle intersects a given bounding box.
+    bool intersect(const AABBType& bbox) const;
+
+  private:
+    VectorType  m_v0;
+    VectorType  m_v1;
+    VectorType  m_v2;
+    AABBType    m_bbox;
+};
+
+
+//
+// TriangleIntersector class implementation.
+//
+
+template <typename T>
+inline TriangleIntersector<T>::TriangleIntersector(
+    const VectorType&       v0,
+    const VectorType&       v1,
+    const VectorType&       v2)
+  : m_v0(v0)
+  , m_v1(v1)
+  , m_v2(v2)
+{
+    m_bbox.invalidate();
+    m_bbox.insert(m_v0);
+    m_bbox.insert(m_v1);
+    m_bbox.insert(m_v2);
+}
+
+template <typename T>
+inline bool TriangleIntersector<T>::intersect(const AABBType& bbox) const
+{
+    return
+        AABBType::overlap(m_bbox, bbox) &&
+        foundation::intersect(bbox, m_v0, m_v1, m_v2);
+}
+
+}       // namespace voxel
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_VOXEL_VOXEL_TRIANGLEINTERSECTOR_H
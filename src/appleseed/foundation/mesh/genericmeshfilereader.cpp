@@ -55,6 +55,7 @@ struct GenericMeshFileReader::Impl
 {
     string  m_filename;
     int     m_obj_options;
+    size_t  m_obj_parsing_thread_count;
 };
 
 GenericMeshFileReader::GenericMeshFileReader(const char* filename)
@@ -62,6 +63,7 @@ GenericMeshFileReader::GenericMeshFileReader(const char* filename)
 {
     impl->m_filename = filename;
     impl->m_obj_options = OBJMeshFileReader::Default;
+    impl->m_obj_parsing_thread_count = 1;
 }
 
 GenericMeshFileReader::~GenericMeshFileReader()
@@ -79,6 +81,16 @@ void GenericMeshFileReader::set_obj_options(const int obj_options)
     impl->m_obj_options = obj_options;
 }
 
+size_t GenericMeshFileReader::get_obj_parsing_thread_count() const
+{
+    return impl->m_obj_parsing_thread_count;
+}
+
+void GenericMeshFileReader::set_obj_parsing_thread_count(const size_t thread_count)
+{
+    impl->m_obj_parsing_thread_count = thread_count;
+}
+
 void GenericMeshFileReader::read(IMeshBuilder& builder)
 {
     const bf::path filepath(impl->m_filename);
@@ -87,6 +99,7 @@ void GenericMeshFileReader::read(IMeshBuilder& builder)
     if (extension == ".obj")
     {
         OBJMeshFileReader reader(impl->m_filename, impl->m_obj_options);
+        reader.set_parsing_thread_count(impl->m_obj_parsing_thread_count);
         reader.read(builder);
     }
 #ifdef APPLESEED_WITH_ALEMBIC
@@ -41,6 +41,7 @@
 #include <cctype>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -50,6 +51,9 @@ namespace foundation
 //
 // A lexical analyzer for the OBJ file format.
 //
+// The lexer either reads from a file, or from a range of characters in memory
+// such as a line-aligned chunk of a memory-mapped OBJ file.
+//
 
 class OBJMeshFileLexer
 {
@@ -63,6 +67,8 @@ class OBJMeshFileLexer
     // Constructor.
     explicit OBJMeshFileLexer(const ParsingMode parsing_mode = Precise)
       : m_parsing_mode(parsing_mode)
+      , m_mem_ptr(0)
+      , m_mem_end(0)
       , m_eof(false)
       , m_line_number(0)
       , m_line(4096)
@@ -96,16 +102,36 @@ class OBJMeshFileLexer
         return true;
     }
 
-    // Close the input file.
+    // Open a range of characters in memory. The range must remain valid until close() is called.
+    void open(const char* begin, const char* end)
+    {
+        assert(begin != 0);
+        assert(begin <= end);
+
+        m_eof = false;
+        m_line_number = 0;
+        m_line_size = 0;
+        m_line_index = 0;
+
+        m_mem_ptr = begin;
+        m_mem_end = end;
+
+        read_next_line();
+    }
+
+    // Close the input file or memory range.
     void close()
     {
         m_file.close();
+
+        m_mem_ptr = 0;
+        m_mem_end = 0;
     }
 
     // Return the position of the current line in the file.
     size_t get_line_number() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_number;
     }
@@ -113,7 +139,7 @@ class OBJMeshFileLexer
     // Return the current character in the line.
     APPLESEED_FORCE_INLINE unsigned char get_char() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_index == m_line_size ? '\n' : m_line[m_line_index];
     }
@@ -121,7 +147,7 @@ class OBJMeshFileLexer
     // Advance to the next character in the line.
     APPLESEED_FORCE_INLINE void next_char()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (m_line_index < m_line_size)
             ++m_line_index;
@@ -141,7 +167,7 @@ class OBJMeshFileLexer
     // Return true if the end of the line has been reached.
     APPLESEED_FORCE_INLINE bool is_eol() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_line_index == m_line_size;
     }
@@ -149,7 +175,7 @@ class OBJMeshFileLexer
     // Return true if the end of the file has been reached.
     APPLESEED_FORCE_INLINE bool is_eof() const
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         return m_eof && is_eol();
     }
@@ -157,7 +183,7 @@ class OBJMeshFileLexer
     // Eat blank characters and comments.
     void eat_blanks()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         while (true)
         {
@@ -192,7 +218,7 @@ class OBJMeshFileLexer
     // Accept a end-of-line character, or generate a parse error.
     void accept_newline()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (!is_eol())
             parse_error();
@@ -203,7 +229,7 @@ class OBJMeshFileLexer
     // Accept a string of non-blank characters, or generate a parse error.
     void accept_string(const char** begin, size_t* length)
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         if (is_eof())
             parse_error();
@@ -236,7 +262,7 @@ class OBJMeshFileLexer
     // Accept a long integer, or generate a parse error.
     APPLESEED_FORCE_INLINE long accept_long()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         // Read an integer value at the current position in the line.
         const char* base_ptr = &m_line[0];
@@ -255,7 +281,7 @@ class OBJMeshFileLexer
     // Accept a double-precision floating point number, or generate a parse error.
     APPLESEED_FORCE_INLINE double accept_double()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         // Read a floating-point value at the current position in the line.
         char* base_ptr = &m_line[0];
@@ -279,27 +305,36 @@ class OBJMeshFileLexer
     const ParsingMode   m_parsing_mode;     // parsing mode for floating-point values
     bool                m_is_space[256];    // precomputed values of std::isspace(c) for all c
     BufferedFile        m_file;
+    const char*         m_mem_ptr;          // current position in the memory range, if any
+    const char*         m_mem_end;          // end of the memory range, if any
     bool                m_eof;              // has the end of the file been reached?
     size_t              m_line_number;      // position of the current line in the file
     std::vector<char>   m_line;             // current line
     size_t              m_line_size;        // size of the current line (not counting the zero terminator)
     size_t              m_line_index;       // position of the cursor in the current line
 
+    bool is_open() const
+    {
+        return m_file.is_open() || m_mem_ptr != 0;
+    }
+
     // Close the input file and throw an ExceptionParseError exception.
     void parse_error()
     {
-        m_file.close();
+        close();
         throw OBJMeshFileReader::ExceptionParseError(m_line_number);
     }
 
     // Read the next line from the input file.
     void read_next_line()
     {
-        assert(m_file.is_open());
+        assert(is_open());
 
         m_line_size = 0;
 
-        if (!m_eof)
+        if (m_mem_ptr != 0)
+            read_next_line_from_memory();
+        else if (!m_eof)
         {
             ++m_line_number;
 
@@ -326,6 +361,36 @@ class OBJMeshFileLexer
         // Append a null terminator.
         m_line[m_line_size] = 0;
     }
+
+    // Read the next line from the memory range.
+    void read_next_line_from_memory()
+    {
+        if (m_eof)
+            return;
+
+        ++m_line_number;
+
+        const char* line_end =
+            static_cast<const char*>(std::memchr(m_mem_ptr, '\n', m_mem_end - m_mem_ptr));
+
+        if (line_end == 0)
+        {
+            // Reached the end of the memory range.
+            line_end = m_mem_end;
+            m_eof = true;
+        }
+
+        const size_t line_size = line_end - m_mem_ptr;
+
+        // Unlike files, lines in memory are never split.
+        if (m_line.size() < line_size + 1)
+            m_line.resize(line_size + 1);
+
+        std::memcpy(&m_line[0], m_mem_ptr, line_size);
+        m_line_size = line_size;
+
+        m_mem_ptr = m_eof ? line_end : line_end + 1;
+    }
 };
 
 }       // namespace foundation
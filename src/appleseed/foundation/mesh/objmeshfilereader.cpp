@@ -31,19 +31,35 @@
 #include "objmeshfilereader.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/math/vector.h"
 #include "foundation/mesh/imeshbuilder.h"
 #include "foundation/mesh/objmeshfilelexer.h"
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/memory.h"
 
+// Boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/interprocess/exceptions.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/system/error_code.hpp"
+
 // Standard headers.
+#include <algorithm>
 #include <cstring>
+#include <exception>
 #include <map>
 #include <utility>
 #include <vector>
 
 using namespace std;
+namespace bf = boost::filesystem;
+namespace bi = boost::interprocess;
 
 namespace foundation
 {
@@ -55,102 +71,61 @@ namespace foundation
 namespace
 {
     const size_t Undefined = ~0;
-}
-
-struct OBJMeshFileReader::Impl
-{
-    const int               m_options;
-    IMeshBuilder&           m_builder;
-    OBJMeshFileLexer        m_lexer;
 
-    // Current state.
-    bool                    m_inside_mesh_def;              // currently inside a mesh definition?
-    string                  m_current_mesh_name;            // name of the current mesh
-    map<string, size_t>     m_material_slots;               // material slots for the current mesh
-    size_t                  m_current_material_slot_index;  // index of the current material slot
-
-    // Features defined in the file.
-    vector<Vector3d>        m_vertices;
-    vector<Vector2d>        m_tex_coords;
-    vector<Vector3d>        m_normals;
-
-    // Mappings between internal indices and mesh indices.
-    vector<size_t>          m_vertex_index_mapping;
-    vector<size_t>          m_tex_coord_index_mapping;
-    vector<size_t>          m_normal_index_mapping;
-
-    // Temporary vectors for collecting indices while parsing face statements.
-    vector<size_t>          m_face_vertex_indices;
-    vector<size_t>          m_face_tex_coord_indices;
-    vector<size_t>          m_face_normal_indices;
-
-    // Constructor.
-    Impl(
-        const int           options,
-        IMeshBuilder&       builder)
-      : m_options(options)
-      , m_builder(builder)
-      , m_lexer(
-            (options & FavorSpeedOverPrecision)
-                ? OBJMeshFileLexer::Fast
-                : OBJMeshFileLexer::Precise)
-      , m_inside_mesh_def(false)
-      , m_current_material_slot_index(0)
+    // Close the lexer and throw an ExceptionParseError exception.
+    void parse_error(OBJMeshFileLexer& lexer)
     {
-    }
+        const size_t line_number = lexer.get_line_number();
 
-    // Close the input file and throw an ExceptionParseError exception.
-    void parse_error()
-    {
-        const size_t line_number = m_lexer.get_line_number();
+        lexer.close();
 
-        m_lexer.close();
-
-        throw ExceptionParseError(line_number);
+        throw OBJMeshFileReader::ExceptionParseError(line_number);
     }
 
-    void parse_file()
+    // Parse all statements, forwarding the supported ones to the parser.
+    template <typename Parser>
+    void parse_statements(OBJMeshFileLexer& lexer, Parser& parser)
     {
         while (true)
         {
-            m_lexer.eat_blanks();
+            lexer.eat_blanks();
 
             // Handle end of file.
-            if (m_lexer.is_eof())
+            if (lexer.is_eof())
                 break;
 
             // Handle empty lines.
-            if (m_lexer.is_eol())
+            if (lexer.is_eol())
             {
-                m_lexer.accept_newline();
+                lexer.accept_newline();
                 continue;
             }
 
             const char* keyword;
             size_t keyword_length;
 
-            m_lexer.accept_string(&keyword, &keyword_length);
+            lexer.accept_string(&keyword, &keyword_length);
 
             if (keyword_length == 1)
             {
                 switch (keyword[0])
                 {
                   case 'f':
-                    parse_f_statement();
+                    parser.parse_f_statement();
                     break;
 
                   case 'g':
                   case 'o':
-                    parse_o_g_statement();
+                    parser.parse_o_g_statement();
                     break;
 
                   case 'v':
-                    parse_v_statement();
+                    parser.parse_v_statement();
                     break;
 
                   default:
                     // Ignore unknown or unhandled statements.
-                    m_lexer.eat_line();
+                    lexer.eat_line();
                     continue;
                 }
             }
@@ -159,50 +134,47 @@ struct OBJMeshFileReader::Impl
                 switch (keyword[0] * 256 + keyword[1])
                 {
                   case 'v' * 256 + 'n':
-                    parse_vn_statement();
+                    parser.parse_vn_statement();
                     break;
 
                   case 'v' * 256 + 't':
-                    parse_vt_statement();
+                    parser.parse_vt_statement();
                     break;
 
                   default:
                     // Ignore unknown or unhandled statements.
-                    m_lexer.eat_line();
+                    lexer.eat_line();
                     continue;
                 }
             }
             else if (strncmp(keyword, "usemtl", keyword_length) == 0)
             {
-                parse_usemtl_statement();
+                parser.parse_usemtl_statement();
             }
             else
             {
                 // Ignore unknown or unhandled statements.
-                m_lexer.eat_line();
+                lexer.eat_line();
                 continue;
             }
 
-            m_lexer.eat_blanks();
-            m_lexer.accept_newline();
+            lexer.eat_blanks();
+            lexer.accept_newline();
         }
-
-        // End the definition of the last object.
-        if (m_inside_mesh_def)
-            m_builder.end_mesh();
     }
 
-    void parse_f_statement()
+    // Parse the body of a "f" statement, collecting feature indices as they appear in the file.
+    void parse_face_indices(
+        OBJMeshFileLexer&   lexer,
+        vector<long>&       vertex_indices,
+        vector<long>&       tex_coord_indices,
+        vector<long>&       normal_indices)
     {
-        clear_keep_memory(m_face_vertex_indices);
-        clear_keep_memory(m_face_tex_coord_indices);
-        clear_keep_memory(m_face_normal_indices);
-
         while (true)
         {
-            m_lexer.eat_blanks();
+            lexer.eat_blanks();
 
-            if (m_lexer.is_eol())
+            if (lexer.is_eol())
                 break;
 
             //
@@ -210,11 +182,7 @@ struct OBJMeshFileReader::Impl
             // Accept n
             //
 
-            {
-                const long n = m_lexer.accept_long();
-                const size_t v = fix_index(n, m_vertices.size());
-                m_face_vertex_indices.push_back(v);
-            }
+            vertex_indices.push_back(lexer.accept_long());
 
             //
             // Recognized n
@@ -222,12 +190,12 @@ struct OBJMeshFileReader::Impl
             //
 
             {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
+                const unsigned char c = lexer.get_char();
+                if (lexer.is_space(c))
                     continue;
                 else if (c == '/')
-                    m_lexer.next_char();
-                else parse_error();
+                    lexer.next_char();
+                else parse_error(lexer);
             }
 
             //
@@ -236,18 +204,13 @@ struct OBJMeshFileReader::Impl
             //
 
             {
-                const unsigned char c = m_lexer.get_char();
+                const unsigned char c = lexer.get_char();
                 if (c == '/')
                 {
-                    m_lexer.next_char();
+                    lexer.next_char();
                     goto skip;
                 }
-                else
-                {
-                    const long n = m_lexer.accept_long();
-                    const size_t vt = fix_index(n, m_tex_coords.size());
-                    m_face_tex_coord_indices.push_back(vt);
-                }
+                else tex_coord_indices.push_back(lexer.accept_long());
             }
 
             //
@@ -256,12 +219,12 @@ struct OBJMeshFileReader::Impl
             //
 
             {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
+                const unsigned char c = lexer.get_char();
+                if (lexer.is_space(c))
                     continue;
                 else if (c == '/')
-                    m_lexer.next_char();
-                else parse_error();
+                    lexer.next_char();
+                else parse_error(lexer);
             }
 
           skip:
@@ -272,18 +235,462 @@ struct OBJMeshFileReader::Impl
             //
 
             {
-                const unsigned char c = m_lexer.get_char();
-                if (m_lexer.is_space(c))
+                const unsigned char c = lexer.get_char();
+                if (lexer.is_space(c))
                     continue;
-                else
+                else normal_indices.push_back(lexer.accept_long());
+            }
+        }
+    }
+
+    Vector3d parse_vector3(OBJMeshFileLexer& lexer)
+    {
+        Vector3d v;
+
+        lexer.eat_blanks();
+        v.x = lexer.accept_double();
+
+        lexer.eat_blanks();
+        v.y = lexer.accept_double();
+
+        lexer.eat_blanks();
+        v.z = lexer.accept_double();
+
+        return v;
+    }
+
+    Vector3d parse_v_statement_body(OBJMeshFileLexer& lexer)
+    {
+        const Vector3d v = parse_vector3(lexer);
+
+        lexer.eat_blanks();
+
+        if (!lexer.is_eol())
+            lexer.accept_double();
+
+        return v;
+    }
+
+    Vector2d parse_vt_statement_body(OBJMeshFileLexer& lexer)
+    {
+        Vector2d v;
+
+        lexer.eat_blanks();
+        v.x = lexer.accept_double();
+
+        lexer.eat_blanks();
+        v.y = lexer.accept_double();
+
+        lexer.eat_blanks();
+
+        if (!lexer.is_eol())
+            lexer.accept_double();
+
+        return v;
+    }
+
+    string parse_compound_identifier(OBJMeshFileLexer& lexer)
+    {
+        string identifier;
+
+        lexer.eat_blanks();
+
+        while (!lexer.is_eol())
+        {
+            const char* token;
+            size_t token_length;
+
+            lexer.accept_string(&token, &token_length);
+            lexer.eat_blanks();
+
+            if (!identifier.empty())
+                identifier += ' ';
+
+            identifier.append(token, token_length);
+        }
+
+        return identifier;
+    }
+
+    // Convert a 1-based index (or a negative index) to a 0-based index.
+    // Return false if the index is invalid.
+    bool fix_index(const long index, const size_t count, size_t& result)
+    {
+        if (index > 0)
+        {
+            const size_t i = static_cast<size_t>(index);
+            result = i - 1;
+            return i <= count;
+        }
+        else if (index < 0)
+        {
+            const size_t i = static_cast<size_t>(-index);
+            result = count - i;
+            return i <= count;
+        }
+        else return false;
+    }
+
+    OBJMeshFileLexer::ParsingMode get_parsing_mode(const int options)
+    {
+        return
+            (options & OBJMeshFileReader::FavorSpeedOverPrecision)
+                ? OBJMeshFileLexer::Fast
+                : OBJMeshFileLexer::Precise;
+    }
+
+
+    //
+    // Parallel parsing.
+    //
+    // The memory-mapped file is split into line-aligned chunks which are parsed
+    // independently by a pool of threads. Each chunk records its features, its
+    // faces (with their indices as they appear in the file) and its "o", "g" and
+    // "usemtl" statements. Chunks are then inserted into the mesh builder in file
+    // order, which is when indices get resolved and validated.
+    //
+
+    const size_t MinChunkSize = 1024 * 1024;
+    const size_t ChunksPerThread = 4;
+
+    struct ChunkFace
+    {
+        size_t  m_line;                         // line of the statement, relative to the beginning of the chunk
+        size_t  m_vertex_index_count;           // number of vertex indices of this face
+        size_t  m_tex_coord_index_count;        // number of texture coordinate indices of this face
+        size_t  m_normal_index_count;           // number of vertex normal indices of this face
+        size_t  m_defined_vertex_count;         // number of vertices defined in the chunk before this face
+        size_t  m_defined_tex_coord_count;      // number of texture coordinates defined in the chunk before this face
+        size_t  m_defined_normal_count;         // number of vertex normals defined in the chunk before this face
+    };
+
+    struct ChunkNamedStatement
+    {
+        enum Type
+        {
+            ObjectOrGroup,
+            UseMaterial
+        };
+
+        Type    m_type;
+        size_t  m_face_index;                   // index of the first face following this statement
+        string  m_name;
+    };
+
+    struct Chunk
+    {
+        const char*                     m_begin;
+        const char*                     m_end;
+        size_t                          m_line_count;
+
+        // Features defined in the chunk.
+        vector<Vector3d>                m_vertices;
+        vector<Vector2d>                m_tex_coords;
+        vector<Vector3d>                m_normals;
+
+        // Faces defined in the chunk and their feature indices, as they appear in the file.
+        vector<ChunkFace>               m_faces;
+        vector<long>                    m_face_vertex_indices;
+        vector<long>                    m_face_tex_coord_indices;
+        vector<long>                    m_face_normal_indices;
+
+        // Statements affecting the faces that follow them.
+        vector<ChunkNamedStatement>     m_statements;
+
+        // Exception thrown while parsing the chunk, if any.
+        exception_ptr                   m_exception;
+
+        Chunk(const char* begin, const char* end)
+          : m_begin(begin)
+          , m_end(end)
+          , m_line_count(0)
+        {
+        }
+    };
+
+    class ChunkParser
+      : public NonCopyable
+    {
+      public:
+        ChunkParser(
+            const int           options,
+            Chunk&              chunk)
+          : m_lexer(get_parsing_mode(options))
+          , m_chunk(chunk)
+        {
+        }
+
+        void parse()
+        {
+            m_chunk.m_line_count = count(m_chunk.m_begin, m_chunk.m_end, '\n');
+
+            m_lexer.open(m_chunk.m_begin, m_chunk.m_end);
+            parse_statements(m_lexer, *this);
+            m_lexer.close();
+        }
+
+        void parse_f_statement()
+        {
+            ChunkFace face;
+            face.m_line = m_lexer.get_line_number();
+            face.m_defined_vertex_count = m_chunk.m_vertices.size();
+            face.m_defined_tex_coord_count = m_chunk.m_tex_coords.size();
+            face.m_defined_normal_count = m_chunk.m_normals.size();
+
+            const size_t vertex_index_begin = m_chunk.m_face_vertex_indices.size();
+            const size_t tex_coord_index_begin = m_chunk.m_face_tex_coord_indices.size();
+            const size_t normal_index_begin = m_chunk.m_face_normal_indices.size();
+
+            parse_face_indices(
+                m_lexer,
+                m_chunk.m_face_vertex_indices,
+                m_chunk.m_face_tex_coord_indices,
+                m_chunk.m_face_normal_indices);
+
+            face.m_vertex_index_count = m_chunk.m_face_vertex_indices.size() - vertex_index_begin;
+            face.m_tex_coord_index_count = m_chunk.m_face_tex_coord_indices.size() - tex_coord_index_begin;
+            face.m_normal_index_count = m_chunk.m_face_normal_indices.size() - normal_index_begin;
+
+            m_chunk.m_faces.push_back(face);
+        }
+
+        void parse_o_g_statement()
+        {
+            push_named_statement(ChunkNamedStatement::ObjectOrGroup);
+        }
+
+        void parse_v_statement()
+        {
+            m_chunk.m_vertices.push_back(parse_v_statement_body(m_lexer));
+        }
+
+        void parse_vt_statement()
+        {
+            m_chunk.m_tex_coords.push_back(parse_vt_statement_body(m_lexer));
+        }
+
+        void parse_vn_statement()
+        {
+            m_chunk.m_normals.push_back(parse_vector3(m_lexer));
+        }
+
+        void parse_usemtl_statement()
+        {
+            push_named_statement(ChunkNamedStatement::UseMaterial);
+        }
+
+      private:
+        OBJMeshFileLexer    m_lexer;
+        Chunk&              m_chunk;
+
+        void push_named_statement(const ChunkNamedStatement::Type type)
+        {
+            ChunkNamedStatement statement;
+            statement.m_type = type;
+            statement.m_face_index = m_chunk.m_faces.size();
+            statement.m_name = parse_compound_identifier(m_lexer);
+
+            m_chunk.m_statements.push_back(statement);
+        }
+    };
+
+    // Parse chunks until there are none left.
+    class ParseChunks
+    {
+      public:
+        ParseChunks(
+            const int           options,
+            vector<Chunk>&      chunks,
+            volatile uint32&    next_chunk)
+          : m_options(options)
+          , m_chunks(chunks)
+          , m_next_chunk(next_chunk)
+        {
+        }
+
+        void operator()()
+        {
+            while (true)
+            {
+                const size_t chunk_index = atomic_inc(&m_next_chunk);
+
+                if (chunk_index >= m_chunks.size())
+                    break;
+
+                Chunk& chunk = m_chunks[chunk_index];
+
+                try
+                {
+                    ChunkParser parser(m_options, chunk);
+                    parser.parse();
+                }
+                catch (...)
                 {
-                    const long n = m_lexer.accept_long();
-                    const size_t vn = fix_index(n, m_normals.size());
-                    m_face_normal_indices.push_back(vn);
+                    chunk.m_exception = current_exception();
                 }
             }
         }
 
+      private:
+        const int               m_options;
+        vector<Chunk>&          m_chunks;
+        volatile uint32&        m_next_chunk;
+    };
+
+    // Split a range of characters into line-aligned chunks.
+    void split_into_chunks(
+        const char*             begin,
+        const char*             end,
+        const size_t            chunk_count,
+        vector<Chunk>&          chunks)
+    {
+        const size_t size = end - begin;
+        const char* chunk_begin = begin;
+
+        for (size_t i = 1; i <= chunk_count && chunk_begin < end; ++i)
+        {
+            const char* chunk_end = begin + size * i / chunk_count;
+
+            if (chunk_end < chunk_begin)
+                chunk_end = chunk_begin;
+
+            // Extend the chunk to the end of the line.
+            const char* newline =
+                static_cast<const char*>(memchr(chunk_end, '\n', end - chunk_end));
+            chunk_end = newline ? newline + 1 : end;
+
+            chunks.push_back(Chunk(chunk_begin, chunk_end));
+            chunk_begin = chunk_end;
+        }
+    }
+}
+
+struct OBJMeshFileReader::Impl
+{
+    const int               m_options;
+    IMeshBuilder&           m_builder;
+    OBJMeshFileLexer        m_lexer;
+
+    // Current state.
+    bool                    m_inside_mesh_def;              // currently inside a mesh definition?
+    string                  m_current_mesh_name;            // name of the current mesh
+    map<string, size_t>     m_material_slots;               // material slots for the current mesh
+    size_t                  m_current_material_slot_index;  // index of the current material slot
+
+    // Features defined in the file.
+    vector<Vector3d>        m_vertices;
+    vector<Vector2d>        m_tex_coords;
+    vector<Vector3d>        m_normals;
+
+    // Mappings between internal indices and mesh indices.
+    vector<size_t>          m_vertex_index_mapping;
+    vector<size_t>          m_tex_coord_index_mapping;
+    vector<size_t>          m_normal_index_mapping;
+
+    // Temporary vectors for collecting indices while parsing face statements.
+    vector<long>            m_face_file_vertex_indices;
+    vector<long>            m_face_file_tex_coord_indices;
+    vector<long>            m_face_file_normal_indices;
+    vector<size_t>          m_face_vertex_indices;
+    vector<size_t>          m_face_tex_coord_indices;
+    vector<size_t>          m_face_normal_indices;
+
+    // Constructor.
+    Impl(
+        const int           options,
+        IMeshBuilder&       builder)
+      : m_options(options)
+      , m_builder(builder)
+      , m_lexer(get_parsing_mode(options))
+      , m_inside_mesh_def(false)
+      , m_current_material_slot_index(0)
+    {
+    }
+
+    void parse_file()
+    {
+        parse_statements(m_lexer, *this);
+
+        end_last_mesh_def();
+    }
+
+    void end_last_mesh_def()
+    {
+        // End the definition of the last object.
+        if (m_inside_mesh_def)
+            m_builder.end_mesh();
+    }
+
+    void parse_f_statement()
+    {
+        clear_keep_memory(m_face_file_vertex_indices);
+        clear_keep_memory(m_face_file_tex_coord_indices);
+        clear_keep_memory(m_face_file_normal_indices);
+
+        parse_face_indices(
+            m_lexer,
+            m_face_file_vertex_indices,
+            m_face_file_tex_coord_indices,
+            m_face_file_normal_indices);
+
+        const size_t line = m_lexer.get_line_number();
+
+        clear_keep_memory(m_face_vertex_indices);
+        clear_keep_memory(m_face_tex_coord_indices);
+        clear_keep_memory(m_face_normal_indices);
+
+        fix_indices(
+            m_face_file_vertex_indices,
+            0,
+            m_face_file_vertex_indices.size(),
+            m_vertices.size(),
+            line,
+            m_face_vertex_indices);
+
+        fix_indices(
+            m_face_file_tex_coord_indices,
+            0,
+            m_face_file_tex_coord_indices.size(),
+            m_tex_coords.size(),
+            line,
+            m_face_tex_coord_indices);
+
+        fix_indices(
+            m_face_file_normal_indices,
+            0,
+            m_face_file_normal_indices.size(),
+            m_normals.size(),
+            line,
+            m_face_normal_indices);
+
+        end_face_statement(line);
+    }
+
+    // Convert 1-based indices (including negative indices) to 0-based indices.
+    void fix_indices(
+        const vector<long>& indices,
+        const size_t        index_begin,
+        const size_t        index_count,
+        const size_t        feature_count,
+        const size_t        line,
+        vector<size_t>&     fixed_indices)
+    {
+        for (size_t i = index_begin, e = index_begin + index_count; i < e; ++i)
+        {
+            size_t fixed_index;
+
+            if (!fix_index(indices[i], feature_count, fixed_index))
+            {
+                m_lexer.close();
+                throw ExceptionParseError(line);
+            }
+
+            fixed_indices.push_back(fixed_index);
+        }
+    }
+
+    void end_face_statement(const size_t line)
+    {
         // Check whether the face is well-formed.
         const size_t vc = m_face_vertex_indices.size();
         const size_t tc = m_face_tex_coord_indices.size();
@@ -302,31 +709,7 @@ struct OBJMeshFileReader::Impl
         {
             // The face is ill-formed, ignore it or abort parsing.
             if (m_options & StopOnInvalidFaceDef)
-                throw ExceptionInvalidFaceDef(m_lexer.get_line_number());
-        }
-    }
-
-    // Convert 1-based indices (including negative indices) to 0-based indices.
-    size_t fix_index(const long index, const size_t count)
-    {
-        if (index > 0)
-        {
-            const size_t i = static_cast<size_t>(index);
-            if (i > count)
-                parse_error();
-            return i - 1;
-        }
-        else if (index < 0)
-        {
-            const size_t i = static_cast<size_t>(-index);
-            if (i > count)
-                parse_error();
-            return count - i;
-        }
-        else
-        {
-            parse_error();
-            return 0;       // keep the compiler happy
+                throw ExceptionInvalidFaceDef(line);
         }
     }
 
@@ -419,9 +802,11 @@ struct OBJMeshFileReader::Impl
 
     void parse_o_g_statement()
     {
-        // Retrieve the name of the upcoming mesh.
-        const string upcoming_mesh_name = parse_compound_identifier();
+        begin_object_or_group(parse_compound_identifier(m_lexer));
+    }
 
+    void begin_object_or_group(const string& upcoming_mesh_name)
+    {
         // Start a new mesh only if the name of the object or group actually changes.
         if (upcoming_mesh_name != m_current_mesh_name)
         {
@@ -440,92 +825,31 @@ struct OBJMeshFileReader::Impl
         }
     }
 
-    string parse_compound_identifier()
-    {
-        string identifier;
-
-        m_lexer.eat_blanks();
-
-        while (!m_lexer.is_eol())
-        {
-            const char* token;
-            size_t token_length;
-
-            m_lexer.accept_string(&token, &token_length);
-            m_lexer.eat_blanks();
-
-            if (!identifier.empty())
-                identifier += ' ';
-
-            identifier.append(token, token_length);
-        }
-
-        return identifier;
-    }
-
     void parse_v_statement()
     {
-        Vector3d v;
-
-        m_lexer.eat_blanks();
-        v.x = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-        v.y = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-        v.z = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-
-        if (!m_lexer.is_eol())
-            m_lexer.accept_double();
-
-        m_vertices.push_back(v);
+        m_vertices.push_back(parse_v_statement_body(m_lexer));
     }
 
     void parse_vt_statement()
     {
-        Vector2d v;
-
-        m_lexer.eat_blanks();
-        v.x = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-        v.y = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-
-        if (!m_lexer.is_eol())
-            m_lexer.accept_double();
-
-        m_tex_coords.push_back(v);
+        m_tex_coords.push_back(parse_vt_statement_body(m_lexer));
     }
 
     void parse_vn_statement()
     {
-        Vector3d n;
-
-        m_lexer.eat_blanks();
-        n.x = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-        n.y = m_lexer.accept_double();
-
-        m_lexer.eat_blanks();
-        n.z = m_lexer.accept_double();
-
-        m_normals.push_back(n);
+        m_normals.push_back(parse_vector3(m_lexer));
     }
 
     void parse_usemtl_statement()
+    {
+        use_material_slot(parse_compound_identifier(m_lexer));
+    }
+
+    void use_material_slot(const string& material_slot_name)
     {
         // Begin a mesh definition if we're not already inside one.
         ensure_mesh_def();
 
-        // Retrieve the name of the material slot.
-        const string material_slot_name = parse_compound_identifier();
-
         // Check whether this material slot has already been defined for this mesh.
         const map<string, size_t>::const_iterator& it =
             m_material_slots.find(material_slot_name);
@@ -556,6 +880,86 @@ struct OBJMeshFileReader::Impl
             m_current_material_slot_index = 0;
         }
     }
+
+    // Insert the contents of a parsed chunk. first_line is the number of lines before the chunk.
+    void insert_chunk(const Chunk& chunk, const size_t first_line)
+    {
+        // Features are numbered from the beginning of the file.
+        const size_t vertex_base = m_vertices.size();
+        const size_t tex_coord_base = m_tex_coords.size();
+        const size_t normal_base = m_normals.size();
+
+        m_vertices.insert(m_vertices.end(), chunk.m_vertices.begin(), chunk.m_vertices.end());
+        m_tex_coords.insert(m_tex_coords.end(), chunk.m_tex_coords.begin(), chunk.m_tex_coords.end());
+        m_normals.insert(m_normals.end(), chunk.m_normals.begin(), chunk.m_normals.end());
+
+        const size_t face_count = chunk.m_faces.size();
+        size_t statement_index = 0;
+        size_t vertex_index = 0;
+        size_t tex_coord_index = 0;
+        size_t normal_index = 0;
+
+        for (size_t i = 0; i < face_count; ++i)
+        {
+            insert_chunk_statements(chunk, i, statement_index);
+
+            const ChunkFace& face = chunk.m_faces[i];
+            const size_t line = first_line + face.m_line;
+
+            clear_keep_memory(m_face_vertex_indices);
+            clear_keep_memory(m_face_tex_coord_indices);
+            clear_keep_memory(m_face_normal_indices);
+
+            fix_indices(
+                chunk.m_face_vertex_indices,
+                vertex_index,
+                face.m_vertex_index_count,
+                vertex_base + face.m_defined_vertex_count,
+                line,
+                m_face_vertex_indices);
+
+            fix_indices(
+                chunk.m_face_tex_coord_indices,
+                tex_coord_index,
+                face.m_tex_coord_index_count,
+                tex_coord_base + face.m_defined_tex_coord_count,
+                line,
+                m_face_tex_coord_indices);
+
+            fix_indices(
+                chunk.m_face_normal_indices,
+                normal_index,
+                face.m_normal_index_count,
+                normal_base + face.m_defined_normal_count,
+                line,
+                m_face_normal_indices);
+
+            vertex_index += face.m_vertex_index_count;
+            tex_coord_index += face.m_tex_coord_index_count;
+            normal_index += face.m_normal_index_count;
+
+            end_face_statement(line);
+        }
+
+        insert_chunk_statements(chunk, face_count, statement_index);
+    }
+
+    // Insert the statements of a chunk that precede a given face.
+    void insert_chunk_statements(
+        const Chunk&        chunk,
+        const size_t        face_index,
+        size_t&             statement_index)
+    {
+        while (statement_index < chunk.m_statements.size() &&
+               chunk.m_statements[statement_index].m_face_index <= face_index)
+        {
+            const ChunkNamedStatement& statement = chunk.m_statements[statement_index++];
+
+            if (statement.m_type == ChunkNamedStatement::ObjectOrGroup)
+                begin_object_or_group(statement.m_name);
+            else use_material_slot(statement.m_name);
+        }
+    }
 };
 
 OBJMeshFileReader::OBJMeshFileReader(
@@ -563,11 +967,29 @@ OBJMeshFileReader::OBJMeshFileReader(
     const int       options)
   : m_filename(filename)
   , m_options(options)
+  , m_parsing_thread_count(1)
+  , m_parallel_chunk_size(0)
+{
+}
+
+void OBJMeshFileReader::set_parsing_thread_count(const size_t thread_count)
+{
+    m_parsing_thread_count = thread_count;
+}
+
+void OBJMeshFileReader::set_parallel_chunk_size(const size_t size)
 {
+    m_parallel_chunk_size = size;
 }
 
 void OBJMeshFileReader::read(IMeshBuilder& builder)
 {
+    if (m_options & ParallelParsing)
+    {
+        read_in_parallel(builder);
+        return;
+    }
+
     Impl impl(m_options, builder);
 
     // Open the input file.
@@ -581,4 +1003,80 @@ void OBJMeshFileReader::read(IMeshBuilder& builder)
     impl.m_lexer.close();
 }
 
+void OBJMeshFileReader::read_in_parallel(IMeshBuilder& builder)
+{
+    Impl impl(m_options, builder);
+
+    // Empty files cannot be mapped.
+    boost::system::error_code ec;
+    const boost::uintmax_t file_size = bf::file_size(bf::path(m_filename), ec);
+    if (ec)
+        throw ExceptionIOError();
+    if (file_size == 0)
+        return;
+
+    // Map the input file into memory.
+    bi::file_mapping mapping;
+    bi::mapped_region region;
+    try
+    {
+        bi::file_mapping(m_filename.c_str(), bi::read_only).swap(mapping);
+        bi::mapped_region(mapping, bi::read_only).swap(region);
+    }
+    catch (const bi::interprocess_exception&)
+    {
+        throw ExceptionIOError();
+    }
+
+    const char* begin = static_cast<const char*>(region.get_address());
+    const char* end = begin + region.get_size();
+
+    // Split the file into line-aligned chunks.
+    const size_t thread_count = max<size_t>(m_parsing_thread_count, 1);
+    const size_t chunk_count =
+        m_parallel_chunk_size > 0
+            ? max<size_t>(region.get_size() / m_parallel_chunk_size, 1)
+            : min(
+                  thread_count * ChunksPerThread,
+                  max<size_t>(region.get_size() / MinChunkSize, 1));
+    vector<Chunk> chunks;
+    chunks.reserve(chunk_count);
+    split_into_chunks(begin, end, chunk_count, chunks);
+
+    // Parse the chunks in parallel.
+    volatile uint32 next_chunk = 0;
+    boost::thread_group threads;
+    for (size_t i = 0, e = min(thread_count, chunks.size()); i < e; ++i)
+        threads.create_thread(ParseChunks(m_options, chunks, next_chunk));
+    threads.join_all();
+
+    // Insert the chunks into the mesh builder in file order.
+    size_t first_line = 0;
+    for (size_t i = 0, e = chunks.size(); i < e; ++i)
+    {
+        Chunk& chunk = chunks[i];
+
+        impl.insert_chunk(chunk, first_line);
+
+        // Report parse errors with line numbers relative to the beginning of the file.
+        if (chunk.m_exception)
+        {
+            try
+            {
+                rethrow_exception(chunk.m_exception);
+            }
+            catch (const ExceptionParseError& e)
+            {
+                throw ExceptionParseError(first_line + e.m_line);
+            }
+        }
+
+        first_line += chunk.m_line_count;
+
+        chunk = Chunk(chunk.m_begin, chunk.m_end);
+    }
+
+    impl.end_last_mesh_def();
+}
+
 }   // namespace foundation
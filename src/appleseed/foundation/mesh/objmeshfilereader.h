@@ -83,7 +83,8 @@ class OBJMeshFileReader
     {
         Default                 = 0,            // none of the flags below
         FavorSpeedOverPrecision = 1 << 0,       // use approximate algorithm for parsing floating-point values
-        StopOnInvalidFaceDef    = 1 << 1        // stop parsing on invalid face definitions
+        StopOnInvalidFaceDef    = 1 << 1,       // stop parsing on invalid face definitions
+        ParallelParsing         = 1 << 2        // memory-map the file and parse it with multiple threads
     };
 
     // Constructor.
@@ -91,14 +92,27 @@ class OBJMeshFileReader
         const std::string&  filename,
         const int           options = Default);
 
+    // Set the number of threads parsing the file when ParallelParsing is enabled.
+    // The default is a single thread.
+    void set_parsing_thread_count(const size_t thread_count);
+
+    // Set the approximate size in bytes of the chunks parsed in parallel when
+    // ParallelParsing is enabled. Zero (the default) derives the chunk size from
+    // the size of the file and the number of threads.
+    void set_parallel_chunk_size(const size_t size);
+
     // Read a mesh.
     virtual void read(IMeshBuilder& builder) override;
 
   private:
     struct Impl;
 
+    void read_in_parallel(IMeshBuilder& builder);
+
     const std::string       m_filename;
     const int               m_options;
+    size_t                  m_parsing_thread_count;
+    size_t                  m_parallel_chunk_size;
 };
 
 }       // namespace foundation
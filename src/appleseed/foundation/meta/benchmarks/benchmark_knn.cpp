@@ -183,8 +183,8 @@ BENCHMARK_SUITE(Foundation_Math_Knn_Query)
         }
 
       private:
-        Logger                              m_logger;
         auto_release_ptr<FileLogTarget>     m_log_target;
+        Logger                              m_logger;
 
         knn::Tree3f                         m_tree;
         knn::Answer<float>                  m_answer;
@@ -0,0 +1,106 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2015-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/image/pixel.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/benchmark.h"
+
+// OpenEXR headers.
+#include "foundation/platform/_beginexrheaders.h"
+#include "OpenEXR/half.h"
+#include "foundation/platform/_endexrheaders.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+BENCHMARK_SUITE(Foundation_Image_Pixel)
+{
+    struct Fixture
+    {
+        // Number of values in a 64x64 RGBA tile.
+        static const size_t ValueCount = 64 * 64 * 4;
+
+        vector<float>   m_float;
+        vector<half>    m_half;
+        vector<uint8>   m_uint8;
+
+        Fixture()
+          : m_float(ValueCount)
+          , m_half(ValueCount)
+          , m_uint8(ValueCount)
+        {
+            for (size_t i = 0; i < ValueCount; ++i)
+            {
+                m_float[i] = static_cast<float>(i) / ValueCount;
+                m_half[i] = m_float[i];
+                m_uint8[i] = static_cast<uint8>(i);
+            }
+        }
+
+        void convert(
+            const PixelFormat   src_format,
+            const void*         src,
+            const PixelFormat   dest_format,
+            void*               dest)
+        {
+            Pixel::convert(
+                src_format,
+                src,
+                static_cast<const uint8*>(src) + ValueCount * Pixel::size(src_format),
+                1,
+                dest_format,
+                dest,
+                1);
+        }
+    };
+
+    BENCHMARK_CASE_F(ConvertFloatToHalf, Fixture)
+    {
+        convert(PixelFormatFloat, &m_float[0], PixelFormatHalf, &m_half[0]);
+    }
+
+    BENCHMARK_CASE_F(ConvertHalfToFloat, Fixture)
+    {
+        convert(PixelFormatHalf, &m_half[0], PixelFormatFloat, &m_float[0]);
+    }
+
+    BENCHMARK_CASE_F(ConvertFloatToUInt8, Fixture)
+    {
+        convert(PixelFormatFloat, &m_float[0], PixelFormatUInt8, &m_uint8[0]);
+    }
+
+    BENCHMARK_CASE_F(ConvertUInt8ToFloat, Fixture)
+    {
+        convert(PixelFormatUInt8, &m_uint8[0], PixelFormatFloat, &m_float[0]);
+    }
+}
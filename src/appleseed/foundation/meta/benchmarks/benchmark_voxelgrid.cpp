@@ -28,18 +28,27 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/intersection/rayaabb.h"
+#include "foundation/math/ray.h"
 #include "foundation/math/rng/distribution.h"
 #include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/sampling/mappings.h"
 #include "foundation/math/vector.h"
+#include "foundation/math/voxel.h"
 #include "foundation/math/voxelgrid.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/system.h"
 #include "foundation/utility/benchmark.h"
+#include "foundation/utility/log.h"
 #include "foundation/utility/memory.h"
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 using namespace foundation;
+using namespace std;
 
 BENCHMARK_SUITE(Foundation_Math_VoxelGrid3)
 {
@@ -120,3 +129,150 @@ BENCHMARK_SUITE(Foundation_Math_VoxelGrid3)
         }
     }
 }
+
+BENCHMARK_SUITE(Foundation_Math_Voxel_Tree)
+{
+    typedef voxel::Tree<float, 3> TreeType;
+    typedef voxel::TriangleIntersector<float> TriangleIntersector;
+
+    struct Fixture
+    {
+        typedef voxel::PacketIntersector<TreeType> PacketIntersectorType;
+        typedef PacketIntersectorType::RayPacket RayPacket;
+
+        static const size_t TriangleCount = 2000;
+        static const size_t PacketCount = 64;
+        static const size_t RayCount = PacketCount * PacketIntersectorType::PacketSize;
+
+        const AABB3f                    m_bbox;
+        const float                     m_max_extent;
+        vector<TriangleIntersector>     m_triangles;
+        TreeType                        m_tree;
+        Ray3f                           m_rays[RayCount];
+        RayPacket                       m_packets[PacketCount];
+        Logger                          m_logger;
+        size_t                          m_hit_count;
+
+        Fixture()
+          : m_bbox(Vector3f(0.0f), Vector3f(1.0f))
+          , m_max_extent(0.01f)
+          , m_hit_count(0)
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < TriangleCount; ++i)
+            {
+                const Vector3f center = random_point(rng);
+                m_triangles.push_back(
+                    TriangleIntersector(
+                        center + 0.05f * (random_point(rng) - Vector3f(0.5f)),
+                        center + 0.05f * (random_point(rng) - Vector3f(0.5f)),
+                        center + 0.05f * (random_point(rng) - Vector3f(0.5f))));
+            }
+
+            voxel::Builder<TreeType> builder(m_tree, m_bbox, m_max_extent);
+            for (size_t i = 0; i < TriangleCount; ++i)
+                builder.push(m_triangles[i]);
+            builder.complete();
+
+            // Rays of a packet share their origin and the octant of their direction.
+            for (size_t i = 0; i < PacketCount; ++i)
+            {
+                const Vector3f org = random_point(rng);
+                const size_t octant = i % 8;
+                RayPacket& packet = m_packets[i];
+                packet.m_mask = 0;
+
+                for (size_t j = 0; j < PacketIntersectorType::PacketSize; ++j)
+                {
+                    Vector2f s;
+                    s[0] = rand_float2(rng);
+                    s[1] = rand_float2(rng);
+                    Vector3f dir = sample_sphere_uniform(s);
+                    for (size_t d = 0; d < 3; ++d)
+                        dir[d] = (octant & (size_t(1) << d)) ? abs(dir[d]) : -abs(dir[d]);
+
+                    Ray3f& ray = m_rays[i * PacketIntersectorType::PacketSize + j];
+                    ray = Ray3f(org, dir);
+
+                    Ray3f clipped_ray(ray);
+                    const RayInfo3f ray_info(clipped_ray);
+                    if (clip(clipped_ray, ray_info, m_bbox))
+                        packet.m_mask |= size_t(1) << j;
+
+                    for (size_t d = 0; d < 3; ++d)
+                    {
+                        packet.m_org[d] = org[d];
+                        packet.m_sgn_dir[d] = ray_info.m_sgn_dir[d];
+                        packet.m_rcp_dir[d][j] = ray_info.m_rcp_dir[d];
+                    }
+
+                    packet.m_tmin[j] = clipped_ray.m_tmin;
+                    packet.m_tmax[j] = clipped_ray.m_tmax;
+                }
+            }
+        }
+
+        static Vector3f random_point(MersenneTwister& rng)
+        {
+            return
+                Vector3f(
+                    rand_float2(rng),
+                    rand_float2(rng),
+                    rand_float2(rng));
+        }
+    };
+
+    BENCHMARK_CASE_F(SerialBuild, Fixture)
+    {
+        TreeType tree;
+        voxel::Builder<TreeType> builder(tree, m_bbox, m_max_extent);
+
+        for (size_t i = 0; i < TriangleCount; ++i)
+            builder.push(m_triangles[i]);
+
+        builder.complete();
+    }
+
+    BENCHMARK_CASE_F(ParallelBuild, Fixture)
+    {
+        TreeType tree;
+        voxel::ParallelBuilder<TreeType> builder(tree, m_bbox, m_max_extent);
+        builder.build(m_triangles, m_logger, System::get_logical_cpu_core_count());
+    }
+
+    BENCHMARK_CASE_F(SingleRayTraversal, Fixture)
+    {
+        voxel::Intersector<float, TreeType> intersector;
+
+        for (size_t i = 0; i < RayCount; ++i)
+        {
+            Ray3f ray(m_rays[i]);
+            const RayInfo3f ray_info(ray);
+
+            if (clip(ray, ray_info, m_bbox))
+            {
+                float distance;
+                if (intersector.intersect(m_tree, ray, ray_info, true, distance))
+                    ++m_hit_count;
+            }
+        }
+    }
+
+    BENCHMARK_CASE_F(PacketTraversal, Fixture)
+    {
+        PacketIntersectorType intersector;
+
+        for (size_t i = 0; i < PacketCount; ++i)
+        {
+            float distances[PacketIntersectorType::PacketSize];
+            const size_t hits = intersector.intersect(m_tree, m_packets[i], true, distances);
+
+            for (size_t j = 0; j < PacketIntersectorType::PacketSize; ++j)
+            {
+                if (hits & (size_t(1) << j))
+                    ++m_hit_count;
+            }
+        }
+    }
+}
@@ -96,4 +96,24 @@ TEST_SUITE(Foundation_Utility_AttributeSet)
 
         EXPECT_EQ(RefUV, uv);
     }
+
+    TEST_CASE_F(TestDeleteChannel_PreservesIdentifiersOfOtherChannels, FixtureTestAttributeSet)
+    {
+        const AttributeSet::ChannelID normal_id = attributes.create_channel("normal", NumericTypeFloat, 3);
+
+        attributes.delete_channel(uv_id);
+
+        EXPECT_TRUE(attributes.find_channel("uv") == AttributeSet::InvalidChannelID);
+        EXPECT_EQ(normal_id, attributes.find_channel("normal"));
+    }
+
+    TEST_CASE_F(TestCreateChannel_ReusesIdentifierOfDeletedChannel, FixtureTestAttributeSet)
+    {
+        attributes.delete_channel(uv_id);
+
+        const AttributeSet::ChannelID packed_uv_id = attributes.create_channel("packed_uv", NumericTypeUInt16, 2);
+
+        EXPECT_EQ(uv_id, packed_uv_id);
+        EXPECT_EQ(packed_uv_id, attributes.find_channel("packed_uv"));
+    }
 }
@@ -31,9 +31,13 @@
 #include "foundation/math/aabb.h"
 #include "foundation/math/bvh.h"
 #include "foundation/math/ray.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/timers.h"
 #include "foundation/utility/alignedvector.h"
 #include "foundation/utility/iostreamop.h"
+#include "foundation/utility/log.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
@@ -119,6 +123,159 @@ TEST_SUITE(Foundation_Math_BVH_SpatialBuilder)
     }
 }
 
+TEST_SUITE(Foundation_Math_BVH_ParallelBuilder)
+{
+    typedef AlignedVector<bvh::Node<AABB3d>> NodeVector;
+    typedef vector<AABB3d> AABBVector;
+    typedef bvh::SAHPartitioner<AABBVector> Partitioner;
+
+    struct Tree
+      : public bvh::Tree<NodeVector>
+    {
+        using bvh::Tree<NodeVector>::m_nodes;
+    };
+
+    struct Fixture
+    {
+        AABBVector m_bboxes;
+
+        Fixture()
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < 20000; ++i)
+            {
+                const Vector3d center(rand_double1(rng), rand_double1(rng), rand_double1(rng));
+                const Vector3d extent(Vector3d(0.01) * rand_double1(rng));
+                m_bboxes.push_back(AABB3d(center - extent, center + extent));
+            }
+        }
+
+        static bool are_same_subtrees(
+            const Tree&     lhs_tree,
+            const size_t    lhs_index,
+            const Tree&     rhs_tree,
+            const size_t    rhs_index)
+        {
+            const Tree::NodeType& lhs = lhs_tree.m_nodes[lhs_index];
+            const Tree::NodeType& rhs = rhs_tree.m_nodes[rhs_index];
+
+            if (lhs.is_leaf() != rhs.is_leaf())
+                return false;
+
+            if (lhs.is_leaf())
+            {
+                return
+                    lhs.get_item_index() == rhs.get_item_index() &&
+                    lhs.get_item_count() == rhs.get_item_count();
+            }
+
+            return
+                lhs.get_left_bbox() == rhs.get_left_bbox() &&
+                lhs.get_right_bbox() == rhs.get_right_bbox() &&
+                are_same_subtrees(lhs_tree, lhs.get_child_node_index(), rhs_tree, rhs.get_child_node_index()) &&
+                are_same_subtrees(lhs_tree, lhs.get_child_node_index() + 1, rhs_tree, rhs.get_child_node_index() + 1);
+        }
+    };
+
+    TEST_CASE_F(Build_GivenManyThreads_BuildsSameTreeAsSerialBuilder, Fixture)
+    {
+        Partitioner serial_partitioner(m_bboxes, 4);
+        Tree serial_tree;
+        bvh::Builder<Tree, Partitioner> serial_builder;
+        serial_builder.build<DefaultWallclockTimer>(serial_tree, serial_partitioner, m_bboxes.size(), 4);
+
+        Logger logger;
+        Partitioner parallel_partitioner(m_bboxes, 4);
+        Tree parallel_tree;
+        bvh::ParallelBuilder<Tree, Partitioner> parallel_builder;
+        parallel_builder.build<DefaultWallclockTimer>(parallel_tree, parallel_partitioner, m_bboxes.size(), 4, logger, 4);
+
+        EXPECT_EQ(serial_tree.m_nodes.size(), parallel_tree.m_nodes.size());
+        EXPECT_TRUE(are_same_subtrees(serial_tree, 0, parallel_tree, 0));
+        EXPECT_SEQUENCE_EQ(
+            m_bboxes.size(),
+            &serial_partitioner.get_item_ordering()[0],
+            &parallel_partitioner.get_item_ordering()[0]);
+    }
+
+    TEST_CASE_F(Build_GivenSingleThread_BuildsSameTreeAsSerialBuilder, Fixture)
+    {
+        Partitioner serial_partitioner(m_bboxes, 4);
+        Tree serial_tree;
+        bvh::Builder<Tree, Partitioner> serial_builder;
+        serial_builder.build<DefaultWallclockTimer>(serial_tree, serial_partitioner, m_bboxes.size(), 4);
+
+        Logger logger;
+        Partitioner parallel_partitioner(m_bboxes, 4);
+        Tree parallel_tree;
+        bvh::ParallelBuilder<Tree, Partitioner> parallel_builder;
+        parallel_builder.build<DefaultWallclockTimer>(parallel_tree, parallel_partitioner, m_bboxes.size(), 4, logger, 1);
+
+        ASSERT_EQ(serial_tree.m_nodes.size(), parallel_tree.m_nodes.size());
+
+        for (size_t i = 0; i < serial_tree.m_nodes.size(); ++i)
+        {
+            EXPECT_EQ(serial_tree.m_nodes[i].is_leaf(), parallel_tree.m_nodes[i].is_leaf());
+            if (!serial_tree.m_nodes[i].is_leaf())
+                EXPECT_EQ(serial_tree.m_nodes[i].get_child_node_index(), parallel_tree.m_nodes[i].get_child_node_index());
+        }
+    }
+}
+
+TEST_SUITE(Foundation_Math_BVH_MotionSAHPartitioner)
+{
+    typedef AlignedVector<bvh::Node<AABB3d>> NodeVector;
+    typedef vector<AABB3d> AABBVector;
+    typedef bvh::Tree<NodeVector> Tree;
+
+    TEST_CASE(Build_GivenStaticItems_ProducesSameOrderingAsSAHPartitioner)
+    {
+        MersenneTwister rng;
+        AABBVector bboxes;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const Vector3d center(rand_double1(rng), rand_double1(rng), rand_double1(rng));
+            const Vector3d extent(Vector3d(0.01) * rand_double1(rng));
+            bboxes.push_back(AABB3d(center - extent, center + extent));
+        }
+
+        bvh::SAHPartitioner<AABBVector> sah_partitioner(bboxes, 4);
+        Tree sah_tree;
+        bvh::Builder<Tree, bvh::SAHPartitioner<AABBVector>> sah_builder;
+        sah_builder.build<DefaultWallclockTimer>(sah_tree, sah_partitioner, bboxes.size(), 4);
+
+        bvh::MotionSAHPartitioner<AABBVector> motion_partitioner(bboxes, bboxes, bboxes, 4);
+        Tree motion_tree;
+        bvh::Builder<Tree, bvh::MotionSAHPartitioner<AABBVector>> motion_builder;
+        motion_builder.build<DefaultWallclockTimer>(motion_tree, motion_partitioner, bboxes.size(), 4);
+
+        EXPECT_SEQUENCE_EQ(
+            bboxes.size(),
+            &sah_partitioner.get_item_ordering()[0],
+            &motion_partitioner.get_item_ordering()[0]);
+    }
+
+    TEST_CASE(Partition_GivenItemsCrossingEachOtherDuringMotion_SplitsThem)
+    {
+        // Both items are at the same place at mid-shutter time but move in opposite directions.
+        AABBVector bboxes, start_bboxes, end_bboxes;
+        bboxes.push_back(AABB3d(Vector3d(5.0, 0.0, 0.0), Vector3d(6.0, 1.0, 1.0)));
+        bboxes.push_back(AABB3d(Vector3d(5.0, 0.0, 0.0), Vector3d(6.0, 1.0, 1.0)));
+        start_bboxes.push_back(AABB3d(Vector3d(0.0, 0.0, 0.0), Vector3d(1.0, 1.0, 1.0)));
+        start_bboxes.push_back(AABB3d(Vector3d(10.0, 0.0, 0.0), Vector3d(11.0, 1.0, 1.0)));
+        end_bboxes.push_back(start_bboxes[1]);
+        end_bboxes.push_back(start_bboxes[0]);
+
+        bvh::SAHPartitioner<AABBVector> sah_partitioner(bboxes);
+        EXPECT_EQ(2, sah_partitioner.partition(0, 2, sah_partitioner.compute_bbox(0, 2)));
+
+        bvh::MotionSAHPartitioner<AABBVector> motion_partitioner(bboxes, start_bboxes, end_bboxes);
+        EXPECT_EQ(1, motion_partitioner.partition(0, 2, motion_partitioner.compute_bbox(0, 2)));
+    }
+}
+
 TEST_SUITE(Foundation_Math_BVH_Intersector_2D)
 {
     typedef bvh::Node<AABB2d> NodeType;
@@ -102,4 +102,30 @@ TEST_SUITE(Foundation_Image_FilteredTile)
         const BoxFilter2<float> filter(2.0f, 2.0f);
         test("unit tests/outputs/test_filteredtile_boxfilter_radius_2_0.txt", filter);
     }
+
+    TEST_CASE(AddNonAtomic_MatchesAdd)
+    {
+        const GaussianFilter2<float> filter(1.5f, 1.5f, 8.0f);
+
+        // Seven values: one SIMD batch of four followed by three scalar values.
+        FilteredTile tile1(8, 8, 7, filter);
+        FilteredTile tile2(8, 8, 7, filter);
+        tile1.clear();
+        tile2.clear();
+
+        const float values[7] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+        tile1.add(3.3f, 4.7f, values);
+        tile1.add(0.2f, 7.9f, values);
+        tile2.add_nonatomic(3.3f, 4.7f, values);
+        tile2.add_nonatomic(0.2f, 7.9f, values);
+
+        for (size_t i = 0; i < tile1.get_pixel_count(); ++i)
+        {
+            const float* ptr1 = tile1.pixel(i);
+            const float* ptr2 = tile2.pixel(i);
+
+            for (size_t c = 0; c < tile1.get_channel_count(); ++c)
+                EXPECT_FEQ(ptr1[c], ptr2[c]);
+        }
+    }
 }
@@ -30,6 +30,7 @@
 // appleseed.foundation headers.
 #include "foundation/platform/atomic.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/timers.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/job/abortswitch.h"
@@ -44,6 +45,7 @@
 #include <cstddef>
 #include <exception>
 #include <utility>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -374,6 +376,23 @@ TEST_SUITE(Foundation_Utility_Job_JobManager)
 
         EXPECT_EQ(1, execution_count);
     }
+
+    TEST_CASE_F(JobManagerExecutesJobsWithThreadAffinity, FixtureJobManager)
+    {
+        vector<size_t> cpus;
+        System::get_numa_node_cpus(0, cpus);
+        job_manager.set_thread_affinities(vector<vector<size_t>>(1, cpus));
+
+        volatile uint32 execution_count = 0;
+
+        job_queue.schedule(
+            new JobNotifyingAboutExecution(&execution_count));
+
+        job_manager.start();
+        job_queue.wait_until_completion();
+
+        EXPECT_EQ(1, execution_count);
+    }
 }
 
 TEST_SUITE(Foundation_Utility_Job_WorkerThread)
@@ -0,0 +1,208 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/string.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_Log_Logger)
+{
+    struct Fixture
+    {
+        // Declared before the logger so that it outlives it.
+        auto_release_ptr<StringLogTarget>   m_target;
+        Logger                              m_logger;
+
+        Fixture()
+          : m_target(create_string_log_target())
+        {
+            m_logger.set_all_formats("{message}");
+            m_logger.add_target(m_target.get());
+        }
+
+        vector<string> get_lines()
+        {
+            m_logger.flush();
+
+            vector<string> lines;
+            split(m_target->get_string(), "\n", lines);
+
+            // Remove the empty string following the last newline.
+            if (!lines.empty() && lines.back().empty())
+                lines.pop_back();
+
+            return lines;
+        }
+    };
+
+    TEST_CASE_F(Write_GivenDistinctMessages_EmitsMessagesInOrder, Fixture)
+    {
+        LOG_INFO(m_logger, "first");
+        LOG_WARNING(m_logger, "second");
+        LOG_ERROR(m_logger, "third");
+
+        const vector<string> lines = get_lines();
+
+        ASSERT_EQ(3, lines.size());
+        EXPECT_EQ("first", lines[0]);
+        EXPECT_EQ("second", lines[1]);
+        EXPECT_EQ("third", lines[2]);
+    }
+
+    TEST_CASE_F(Write_GivenRepeatedMessage_CollapsesRepetitions, Fixture)
+    {
+        for (size_t i = 0; i < 5; ++i)
+            LOG_WARNING(m_logger, "same");
+
+        LOG_INFO(m_logger, "other");
+
+        const vector<string> lines = get_lines();
+
+        ASSERT_EQ(3, lines.size());
+        EXPECT_EQ("same", lines[0]);
+        EXPECT_EQ("last message repeated 4 times.", lines[1]);
+        EXPECT_EQ("other", lines[2]);
+    }
+
+    TEST_CASE_F(Write_GivenManyWarningsFromSameCallSite_SuppressesExcessWarnings, Fixture)
+    {
+        for (size_t i = 0; i < 100; ++i)
+            LOG_WARNING(m_logger, "warning " FMT_SIZE_T, i);
+
+        const vector<string> lines = get_lines();
+
+        ASSERT_EQ(21, lines.size());
+        EXPECT_EQ("warning 0", lines[0]);
+        EXPECT_EQ("warning 19", lines[19]);
+        EXPECT_EQ("80 similar warnings were suppressed.", lines[20]);
+    }
+
+    TEST_CASE_F(Write_GivenManyInfoMessagesFromSameCallSite_EmitsAllMessages, Fixture)
+    {
+        for (size_t i = 0; i < 100; ++i)
+            LOG_INFO(m_logger, "same");
+
+        const vector<string> lines = get_lines();
+
+        EXPECT_EQ(100, lines.size());
+    }
+
+    TEST_CASE_F(Write_GivenMoreMessagesThanQueueCapacity_EmitsAllMessages, Fixture)
+    {
+        for (size_t i = 0; i < 5000; ++i)
+            LOG_ERROR(m_logger, "error " FMT_SIZE_T, i);
+
+        const vector<string> lines = get_lines();
+
+        ASSERT_EQ(5000, lines.size());
+        EXPECT_EQ("error 4999", lines[4999]);
+    }
+
+    TEST_CASE_F(Write_GivenMessageLongerThanQueueSlot_EmitsWholeMessage, Fixture)
+    {
+        const string message(5000, 'x');
+
+        LOG_INFO(m_logger, "%s", message.c_str());
+
+        const vector<string> lines = get_lines();
+
+        ASSERT_EQ(1, lines.size());
+        EXPECT_EQ(message, lines[0]);
+    }
+
+    TEST_CASE_F(Write_GivenManyErrorsFromSameCallSite_EmitsAllErrors, Fixture)
+    {
+        for (size_t i = 0; i < 100; ++i)
+            LOG_ERROR(m_logger, "error " FMT_SIZE_T, i);
+
+        const vector<string> lines = get_lines();
+
+        EXPECT_EQ(100, lines.size());
+    }
+
+    // A log target that cannot be written to while its mutex is held, like a log
+    // target written in Python while another thread holds the interpreter lock.
+    class BlockingLogTarget
+      : public ILogTarget
+    {
+      public:
+        boost::mutex    m_mutex;
+        vector<string>  m_messages;
+
+        virtual void release() override
+        {
+        }
+
+        virtual void write(
+            const LogMessage::Category  category,
+            const char*                 file,
+            const size_t                line,
+            const char*                 header,
+            const char*                 message) override
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_messages.push_back(message);
+        }
+    };
+
+    TEST_CASE(Write_GivenMoreMessagesThanQueueCapacityWhileTargetIsBlocked_DoesNotWaitForTarget)
+    {
+        BlockingLogTarget target;
+        Logger logger;
+        logger.set_all_formats("{message}");
+        logger.add_target(&target);
+
+        {
+            boost::mutex::scoped_lock lock(target.m_mutex);
+
+            for (size_t i = 0; i < 5000; ++i)
+                LOG_ERROR(logger, "error " FMT_SIZE_T, i);
+        }
+
+        logger.flush();
+        logger.remove_target(&target);
+
+        ASSERT_EQ(5000, target.m_messages.size());
+
+        bool in_order = true;
+        for (size_t i = 0; i < 5000; ++i)
+            in_order = in_order && target.m_messages[i] == "error " + to_string(i);
+        EXPECT_TRUE(in_order);
+    }
+}
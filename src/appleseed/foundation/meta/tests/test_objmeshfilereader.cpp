@@ -44,7 +44,27 @@ using namespace std;
 
 TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
 {
-    struct Face {};
+    struct Face
+    {
+        vector<size_t>      m_vertices;
+        vector<size_t>      m_vertex_normals;
+        vector<size_t>      m_tex_coords;
+        size_t              m_material;
+
+        Face()
+          : m_material(~size_t(0))
+        {
+        }
+
+        bool operator==(const Face& rhs) const
+        {
+            return
+                m_vertices == rhs.m_vertices &&
+                m_vertex_normals == rhs.m_vertex_normals &&
+                m_tex_coords == rhs.m_tex_coords &&
+                m_material == rhs.m_material;
+        }
+    };
 
     struct Mesh
     {
@@ -52,7 +72,19 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
         vector<Vector3d>    m_vertices;
         vector<Vector3d>    m_vertex_normals;
         vector<Vector2d>    m_tex_coords;
+        vector<string>      m_material_slots;
         vector<Face>        m_faces;
+
+        bool operator==(const Mesh& rhs) const
+        {
+            return
+                m_name == rhs.m_name &&
+                m_vertices == rhs.m_vertices &&
+                m_vertex_normals == rhs.m_vertex_normals &&
+                m_tex_coords == rhs.m_tex_coords &&
+                m_material_slots == rhs.m_material_slots &&
+                m_faces == rhs.m_faces;
+        }
     };
 
     struct MeshBuilder
@@ -84,12 +116,57 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
             return m_meshes.back().m_tex_coords.size() - 1;
         }
 
+        virtual size_t push_material_slot(const char* name) override
+        {
+            m_meshes.back().m_material_slots.push_back(name);
+            return m_meshes.back().m_material_slots.size() - 1;
+        }
+
         virtual void begin_face(const size_t vertex_count) override
         {
             m_meshes.back().m_faces.push_back(Face());
+            m_vertex_count = vertex_count;
+        }
+
+        virtual void set_face_vertices(const size_t vertices[]) override
+        {
+            m_meshes.back().m_faces.back().m_vertices.assign(vertices, vertices + m_vertex_count);
+        }
+
+        virtual void set_face_vertex_normals(const size_t vertex_normals[]) override
+        {
+            m_meshes.back().m_faces.back().m_vertex_normals.assign(vertex_normals, vertex_normals + m_vertex_count);
+        }
+
+        virtual void set_face_vertex_tex_coords(const size_t tex_coords[]) override
+        {
+            m_meshes.back().m_faces.back().m_tex_coords.assign(tex_coords, tex_coords + m_vertex_count);
+        }
+
+        virtual void set_face_material(const size_t material) override
+        {
+            m_meshes.back().m_faces.back().m_material = material;
         }
+
+      private:
+        size_t              m_vertex_count;
     };
 
+    size_t get_parse_error_line(OBJMeshFileReader& reader)
+    {
+        try
+        {
+            MeshBuilder builder;
+            reader.read(builder);
+        }
+        catch (const OBJMeshFileReader::ExceptionParseError& e)
+        {
+            return e.m_line;
+        }
+
+        return 0;
+    }
+
     TEST_CASE(ReadCubeMeshFile)
     {
         OBJMeshFileReader reader("unit tests/inputs/test_objmeshfilereader_cube.obj");
@@ -121,4 +198,112 @@ TEST_SUITE(Foundation_Mesh_OBJMeshFileReader)
         EXPECT_EQ(4, mesh.m_tex_coords.size());
         EXPECT_EQ(1, mesh.m_faces.size());
     }
+
+    TEST_CASE(ReadCubeMeshFile_ParallelParsing)
+    {
+        OBJMeshFileReader reader(
+            "unit tests/inputs/test_objmeshfilereader_cube.obj",
+            OBJMeshFileReader::ParallelParsing);
+        MeshBuilder builder;
+        reader.read(builder);
+
+        EXPECT_EQ(1, builder.m_meshes.size());
+
+        Mesh& mesh = builder.m_meshes.front();
+        EXPECT_EQ("", mesh.m_name);
+        EXPECT_EQ(20, mesh.m_vertices.size());
+        EXPECT_EQ(6, mesh.m_vertex_normals.size());
+        EXPECT_EQ(20, mesh.m_tex_coords.size());
+        EXPECT_EQ(12, mesh.m_faces.size());
+    }
+
+    TEST_CASE(ReadQuadMeshFile_ParallelParsing)
+    {
+        OBJMeshFileReader reader(
+            "unit tests/inputs/test_objmeshfilereader_quad.obj",
+            OBJMeshFileReader::ParallelParsing);
+        MeshBuilder builder;
+        reader.read(builder);
+
+        EXPECT_EQ(1, builder.m_meshes.size());
+
+        Mesh& mesh = builder.m_meshes.front();
+        EXPECT_EQ("quad", mesh.m_name);
+        EXPECT_EQ(4, mesh.m_vertices.size());
+        EXPECT_EQ(0, mesh.m_vertex_normals.size());
+        EXPECT_EQ(4, mesh.m_tex_coords.size());
+        EXPECT_EQ(1, mesh.m_faces.size());
+    }
+
+    TEST_CASE(ReadFile_ParallelParsingWithOneLinePerChunk_MatchesSequentialParsing)
+    {
+        const char* Filename = "unit tests/inputs/test_objmeshfilereader_chunkboundaries.obj";
+
+        OBJMeshFileReader sequential_reader(Filename);
+        MeshBuilder sequential_builder;
+        sequential_reader.read(sequential_builder);
+
+        // A chunk size of one byte puts every line in its own chunk.
+        OBJMeshFileReader parallel_reader(Filename, OBJMeshFileReader::ParallelParsing);
+        parallel_reader.set_parsing_thread_count(4);
+        parallel_reader.set_parallel_chunk_size(1);
+        MeshBuilder parallel_builder;
+        parallel_reader.read(parallel_builder);
+
+        ASSERT_EQ(2, sequential_builder.m_meshes.size());
+        EXPECT_TRUE(sequential_builder.m_meshes == parallel_builder.m_meshes);
+    }
+
+    TEST_CASE(ReadFile_ParallelParsingWithOneLinePerChunk_ResolvesRelativeIndicesAcrossChunks)
+    {
+        OBJMeshFileReader reader(
+            "unit tests/inputs/test_objmeshfilereader_chunkboundaries.obj",
+            OBJMeshFileReader::ParallelParsing);
+        reader.set_parsing_thread_count(4);
+        reader.set_parallel_chunk_size(1);
+        MeshBuilder builder;
+        reader.read(builder);
+
+        ASSERT_EQ(2, builder.m_meshes.size());
+
+        const Mesh& first = builder.m_meshes[0];
+        EXPECT_EQ("first", first.m_name);
+        EXPECT_EQ(4, first.m_vertices.size());
+        ASSERT_EQ(2, first.m_material_slots.size());
+        EXPECT_EQ("red", first.m_material_slots[0]);
+        EXPECT_EQ("green", first.m_material_slots[1]);
+        ASSERT_EQ(4, first.m_faces.size());
+        EXPECT_EQ(0, first.m_faces[0].m_material);
+        EXPECT_EQ(0, first.m_faces[1].m_material);
+        EXPECT_EQ(1, first.m_faces[2].m_material);
+        EXPECT_EQ(0, first.m_faces[3].m_material);
+
+        const Mesh& second = builder.m_meshes[1];
+        EXPECT_EQ("second", second.m_name);
+        EXPECT_EQ(4, second.m_vertices.size());
+        EXPECT_EQ(1, second.m_vertex_normals.size());
+        ASSERT_EQ(1, second.m_material_slots.size());
+        EXPECT_EQ("green", second.m_material_slots[0]);
+        ASSERT_EQ(2, second.m_faces.size());
+        EXPECT_EQ(second.m_faces[0].m_vertices[0], second.m_faces[1].m_vertices[0]);
+        EXPECT_EQ(second.m_faces[0].m_vertices[2], second.m_faces[1].m_vertices[1]);
+    }
+
+    TEST_CASE(ReadFile_ParallelParsingWithParseErrorInLaterChunk_ReportsLineFromBeginningOfFile)
+    {
+        const char* Filename = "unit tests/inputs/test_objmeshfilereader_parseerror.obj";
+
+        OBJMeshFileReader sequential_reader(Filename);
+        EXPECT_EQ(12, get_parse_error_line(sequential_reader));
+
+        OBJMeshFileReader one_line_reader(Filename, OBJMeshFileReader::ParallelParsing);
+        one_line_reader.set_parsing_thread_count(4);
+        one_line_reader.set_parallel_chunk_size(1);
+        EXPECT_EQ(12, get_parse_error_line(one_line_reader));
+
+        OBJMeshFileReader several_lines_reader(Filename, OBJMeshFileReader::ParallelParsing);
+        several_lines_reader.set_parsing_thread_count(4);
+        several_lines_reader.set_parallel_chunk_size(64);
+        EXPECT_EQ(12, get_parse_error_line(several_lines_reader));
+    }
 }
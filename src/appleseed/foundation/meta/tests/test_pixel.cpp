@@ -37,6 +37,9 @@
 #include "OpenEXR/half.h"
 #include "foundation/platform/_endexrheaders.h"
 
+// Standard headers.
+#include <cstddef>
+
 using namespace foundation;
 
 TEST_SUITE(Foundation_Image_Pixel)
@@ -100,4 +103,108 @@ TEST_SUITE(Foundation_Image_Pixel)
 
         EXPECT_EQ(4294967295UL, output);
     }
+
+    // Enough values to exercise both the vectorized loops and the scalar tails.
+    const size_t ContiguousValueCount = 37;
+
+    void make_float_values(float values[])
+    {
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+            values[i] = static_cast<float>(i) * 0.0371f - 0.2f;
+    }
+
+    TEST_CASE(Convert_ContiguousFloatToUInt8_MatchesScalarConversion)
+    {
+        float input[ContiguousValueCount];
+        make_float_values(input);
+
+        uint8 output[ContiguousValueCount];
+        Pixel::convert(
+            PixelFormatFloat,
+            input, input + ContiguousValueCount,
+            1,
+            PixelFormatUInt8,
+            output,
+            1);
+
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+        {
+            uint8 expected;
+            Pixel::convert_to_format(&input[i], &input[i] + 1, 1, PixelFormatUInt8, &expected, 1);
+            EXPECT_EQ(expected, output[i]);
+        }
+    }
+
+    TEST_CASE(Convert_ContiguousUInt8ToFloat_MatchesScalarConversion)
+    {
+        uint8 input[ContiguousValueCount];
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+            input[i] = static_cast<uint8>(i * 7);
+
+        float output[ContiguousValueCount];
+        Pixel::convert(
+            PixelFormatUInt8,
+            input, input + ContiguousValueCount,
+            1,
+            PixelFormatFloat,
+            output,
+            1);
+
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+        {
+            float expected;
+            Pixel::convert_to_format(&input[i], &input[i] + 1, 1, PixelFormatFloat, &expected, 1);
+            EXPECT_EQ(expected, output[i]);
+        }
+    }
+
+    TEST_CASE(Convert_ContiguousFloatToHalf_MatchesScalarConversion)
+    {
+        float input[ContiguousValueCount];
+        make_float_values(input);
+        input[0] = 70000.0f;            // overflows to infinity
+        input[1] = 1.0e-6f;             // denormal half
+
+        half output[ContiguousValueCount];
+        Pixel::convert(
+            PixelFormatFloat,
+            input, input + ContiguousValueCount,
+            1,
+            PixelFormatHalf,
+            output,
+            1);
+
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+        {
+            half expected;
+            Pixel::convert_to_format(&input[i], &input[i] + 1, 1, PixelFormatHalf, &expected, 1);
+            EXPECT_EQ(expected.bits(), output[i].bits());
+        }
+    }
+
+    TEST_CASE(Convert_ContiguousHalfToFloat_MatchesScalarConversion)
+    {
+        float values[ContiguousValueCount];
+        make_float_values(values);
+
+        half input[ContiguousValueCount];
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+            input[i] = values[i];
+
+        float output[ContiguousValueCount];
+        Pixel::convert(
+            PixelFormatHalf,
+            input, input + ContiguousValueCount,
+            1,
+            PixelFormatFloat,
+            output,
+            1);
+
+        for (size_t i = 0; i < ContiguousValueCount; ++i)
+        {
+            float expected;
+            Pixel::convert_to_format(&input[i], &input[i] + 1, 1, PixelFormatFloat, &expected, 1);
+            EXPECT_EQ(expected, output[i]);
+        }
+    }
 }
@@ -29,6 +29,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/fp.h"
+#include "foundation/math/hash.h"
 #include "foundation/math/qmc.h"
 #include "foundation/math/rng/mersennetwister.h"
 #include "foundation/math/sampling/mappings.h"
@@ -108,6 +109,101 @@ TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
         EXPECT_EQ(4, child_child_context.m_dimension);
         EXPECT_EQ(0, child_child_context.m_instance);
     }
+
+    TEST_CASE(TestSplittingInSobolMode)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::SobolMode, 2, 64, 7, 42);
+        context.next2<Vector2d>();
+        SamplingContext child_context = context.split(2, 16);
+        child_context.next2<Vector2d>();
+        SamplingContext child_child_context = child_context.split(2, 1);
+
+        EXPECT_EQ(7 * 16, child_context.m_base_instance);
+        EXPECT_EQ(7 * 16, child_context.m_sample_index);
+        EXPECT_EQ(7 * 16, child_child_context.m_base_instance);
+        EXPECT_EQ(0, child_child_context.m_instance);
+        EXPECT_EQ(42, child_child_context.m_base_seed);
+    }
+}
+
+TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_Convergence)
+{
+    typedef MersenneTwister RNG;
+    typedef QMCSamplingContext<RNG> SamplingContext;
+
+    // Estimate, in a number of independent pixels, the integral over [0,1]^4 of a function
+    // with a discontinuity in the pixel dimensions and return the RMS error of the estimates.
+    double compute_rmse(
+        const SamplingContext::Mode mode,
+        const size_t                sample_count)
+    {
+        const size_t PixelCount = 256;
+        const double Reference = Pi<double>() / 16.0;
+
+        double squared_error = 0.0;
+
+        for (size_t p = 0; p < PixelCount; ++p)
+        {
+            // Like the pixel renderers, decorrelate pixels by seeding the scrambling
+            // in Sobol mode and by offsetting the sequence in the other modes.
+            const uint32 pixel_hash = hash_uint32(static_cast<uint32>(p));
+            RNG rng(static_cast<uint32>(p));
+            SamplingContext sampling_context(
+                rng,
+                mode,
+                2,
+                0,
+                mode == SamplingContext::SobolMode ? 0 : pixel_hash,
+                pixel_hash);
+
+            double sum = 0.0;
+
+            for (size_t i = 0; i < sample_count; ++i)
+            {
+                const Vector2d s = sampling_context.next2<Vector2d>();
+                SamplingContext child_sampling_context = sampling_context.split(2, 1);
+                const Vector2d t = child_sampling_context.next2<Vector2d>();
+
+                if (square_norm(s) < 1.0)
+                    sum += t.x * t.y;
+            }
+
+            const double error = sum / sample_count - Reference;
+            squared_error += error * error;
+        }
+
+        return sqrt(squared_error / PixelCount);
+    }
+
+    TEST_CASE(SobolMode_ConvergesFasterThanRNGMode)
+    {
+        for (size_t sample_count = 16; sample_count <= 256; sample_count *= 4)
+        {
+            const double rng_rmse = compute_rmse(SamplingContext::RNGMode, sample_count);
+            const double sobol_rmse = compute_rmse(SamplingContext::SobolMode, sample_count);
+
+            EXPECT_LT(rng_rmse, sobol_rmse);
+        }
+    }
+
+    TEST_CASE(SobolMode_ConvergesAtLeastAsFastAsQMCMode)
+    {
+        for (size_t sample_count = 64; sample_count <= 1024; sample_count *= 4)
+        {
+            const double qmc_rmse = compute_rmse(SamplingContext::QMCMode, sample_count);
+            const double sobol_rmse = compute_rmse(SamplingContext::SobolMode, sample_count);
+
+            EXPECT_LT(qmc_rmse, sobol_rmse);
+        }
+    }
+
+    TEST_CASE(SobolMode_ErrorDecreasesWithSampleCount)
+    {
+        EXPECT_LT(
+            0.5 * compute_rmse(SamplingContext::SobolMode, 16),
+            compute_rmse(SamplingContext::SobolMode, 64));
+    }
 }
 
 TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_DirectIlluminationSimulation)
@@ -0,0 +1,152 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/sobol.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Math_Sobol)
+{
+    // Return true if the points form a (0,m,2)-net in base 2, i.e. if every elementary
+    // interval of area 1/point_count contains exactly one point.
+    bool is_zero_m_2_net(const vector<Vector<uint32, 2>>& points)
+    {
+        size_t m = 0;
+        while ((size_t(1) << m) < points.size())
+            ++m;
+
+        if ((size_t(1) << m) != points.size())
+            return false;
+
+        for (size_t a = 0; a <= m; ++a)
+        {
+            const size_t b = m - a;
+            vector<size_t> counts(points.size(), 0);
+
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                const size_t x = a > 0 ? points[i][0] >> (32 - a) : 0;
+                const size_t y = b > 0 ? points[i][1] >> (32 - b) : 0;
+                ++counts[(x << b) + y];
+            }
+
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                if (counts[i] != 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(ReverseBits)
+    {
+        EXPECT_EQ(0x00000000UL, reverse_bits(0x00000000UL));
+        EXPECT_EQ(0x80000000UL, reverse_bits(0x00000001UL));
+        EXPECT_EQ(0x0000000FUL, reverse_bits(0xF0000000UL));
+        EXPECT_EQ(0x1E6A2C48UL, reverse_bits(0x12345678UL));
+    }
+
+    TEST_CASE(UInt32ToUnitInterval_GivenLargestValue_ReturnsValueLessThanOne)
+    {
+        EXPECT_LT(1.0f, uint32_to_unit_interval<float>(0xFFFFFFFFUL));
+        EXPECT_LT(1.0, uint32_to_unit_interval<double>(0xFFFFFFFFUL));
+    }
+
+    TEST_CASE(Sobol_FirstDimension_IsVanDerCorputSequence)
+    {
+        EXPECT_EQ(0.0,   sobol<double>(0, 0));
+        EXPECT_EQ(0.5,   sobol<double>(0, 1));
+        EXPECT_EQ(0.25,  sobol<double>(0, 2));
+        EXPECT_EQ(0.75,  sobol<double>(0, 3));
+        EXPECT_EQ(0.125, sobol<double>(0, 4));
+    }
+
+    TEST_CASE(Sobol_SecondDimension)
+    {
+        EXPECT_EQ(0.0,   sobol<double>(1, 0));
+        EXPECT_EQ(0.5,   sobol<double>(1, 1));
+        EXPECT_EQ(0.75,  sobol<double>(1, 2));
+        EXPECT_EQ(0.25,  sobol<double>(1, 3));
+        EXPECT_EQ(0.625, sobol<double>(1, 4));
+    }
+
+    TEST_CASE(Sobol_FirstTwoDimensions_FormZeroMTwoNets)
+    {
+        for (size_t m = 0; m <= 8; ++m)
+        {
+            vector<Vector<uint32, 2>> points;
+
+            for (uint32 i = 0; i < (1UL << m); ++i)
+                points.push_back(Vector<uint32, 2>(sobol_uint32(0, i), sobol_uint32(1, i)));
+
+            EXPECT_TRUE(is_zero_m_2_net(points));
+        }
+    }
+
+    TEST_CASE(OwenScrambledSobol_ShuffledAlignedBlock_FormsZeroMTwoNet)
+    {
+        const uint32 Seed = 0x12345678UL;
+        const uint32 FirstIndex = 0xDEADBE00UL;
+
+        vector<Vector<uint32, 2>> points;
+
+        for (uint32 i = 0; i < 256; ++i)
+        {
+            const uint32 index = nested_uniform_scramble(FirstIndex + i, Seed);
+
+            points.push_back(
+                Vector<uint32, 2>(
+                    nested_uniform_scramble(sobol_uint32(0, index), Seed + 1),
+                    nested_uniform_scramble(sobol_uint32(1, index), Seed + 2)));
+        }
+
+        EXPECT_TRUE(is_zero_m_2_net(points));
+    }
+
+    TEST_CASE(OwenScrambledSobolSequence_ReturnsSamplesInUnitSquare)
+    {
+        for (uint32 i = 0; i < 1024; ++i)
+        {
+            const Vector2f s = owen_scrambled_sobol_sequence<float, 2>(6, i, 0xFFFFFFFFUL);
+
+            EXPECT_TRUE(s[0] >= 0.0f && s[0] < 1.0f);
+            EXPECT_TRUE(s[1] >= 0.0f && s[1] < 1.0f);
+        }
+    }
+}
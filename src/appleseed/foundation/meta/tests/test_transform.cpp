@@ -29,6 +29,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/matrix.h"
+#include "foundation/math/quaternion.h"
 #include "foundation/math/ray.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/transform.h"
@@ -300,6 +301,40 @@ TEST_SUITE(Foundation_Math_TransformInterpolator)
             1.0e-9);
     }
 
+    TEST_CASE(Evaluate_GivenScalingRotationAndTranslation_MatchesUnoptimizedImplementation)
+    {
+        const Vector3d s0(0.5, 1.0, 2.0), s1(3.0, 0.25, 1.5);
+        const Quaterniond q0 = Quaterniond::make_rotation(normalize(Vector3d(1.0, 2.0, 3.0)), 0.3);
+        const Quaterniond q1 = Quaterniond::make_rotation(normalize(Vector3d(-2.0, 1.0, 0.5)), 2.1);
+        const Vector3d t0(1.0, -4.0, 12.0), t1(-3.0, 8.0, 2.0);
+
+        const TransformInterpolatord interpolator(
+            Transformd::from_local_to_parent(
+                Matrix4d::make_translation(t0) *
+                Matrix4d::make_rotation(q0) *
+                Matrix4d::make_scaling(s0)),
+            Transformd::from_local_to_parent(
+                Matrix4d::make_translation(t1) *
+                Matrix4d::make_rotation(q1) *
+                Matrix4d::make_scaling(s1)));
+
+        for (size_t i = 0; i <= 8; ++i)
+        {
+            const double t = static_cast<double>(i) / 8;
+
+            const Matrix4d expected_local_to_parent =
+                Matrix4d::make_translation(lerp(t0, t1, t)) *
+                Matrix4d::make_rotation(fast_slerp(interpolator.get_q0(), interpolator.get_q1(), t)) *
+                Matrix4d::make_scaling(lerp(s0, s1, t));
+
+            Transformd result;
+            interpolator.evaluate(t, result);
+
+            EXPECT_FEQ_EPS(expected_local_to_parent, result.get_local_to_parent(), 1.0e-9);
+            EXPECT_FEQ_EPS(inverse(expected_local_to_parent), result.get_parent_to_local(), 1.0e-9);
+        }
+    }
+
     TEST_CASE(VisualizeTransform)
     {
         const Transformd from(Transformd::identity());
@@ -0,0 +1,225 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/intersection/rayaabb.h"
+#include "foundation/math/ray.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/math/voxel.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+namespace
+{
+    typedef voxel::Tree<float, 3> TreeType;
+    typedef voxel::TriangleIntersector<float> TriangleIntersector;
+
+    struct Fixture
+    {
+        static const size_t TriangleCount = 200;
+        static const size_t RayCount = 1000;
+
+        MersenneTwister                 m_rng;
+        AABB3f                          m_bbox;
+        vector<TriangleIntersector>     m_triangles;
+
+        Fixture()
+          : m_bbox(Vector3f(0.0f), Vector3f(1.0f))
+        {
+            for (size_t i = 0; i < TriangleCount; ++i)
+            {
+                const Vector3f center = random_point();
+                m_triangles.push_back(
+                    TriangleIntersector(
+                        center + 0.1f * (random_point() - Vector3f(0.5f)),
+                        center + 0.1f * (random_point() - Vector3f(0.5f)),
+                        center + 0.1f * (random_point() - Vector3f(0.5f))));
+            }
+        }
+
+        Vector3f random_point()
+        {
+            return
+                Vector3f(
+                    rand_float2(m_rng),
+                    rand_float2(m_rng),
+                    rand_float2(m_rng));
+        }
+
+        Vector3f random_direction()
+        {
+            Vector2f s;
+            s[0] = rand_float2(m_rng);
+            s[1] = rand_float2(m_rng);
+            return sample_sphere_uniform(s);
+        }
+
+        void build_serially(TreeType& tree, const float max_extent) const
+        {
+            voxel::Builder<TreeType> builder(tree, m_bbox, max_extent);
+
+            for (size_t i = 0; i < m_triangles.size(); ++i)
+                builder.push(m_triangles[i]);
+
+            builder.complete();
+        }
+
+        void build_in_parallel(TreeType& tree, const float max_extent, const size_t thread_count) const
+        {
+            Logger logger;
+            voxel::ParallelBuilder<TreeType> builder(tree, m_bbox, max_extent);
+            builder.build(m_triangles, logger, thread_count);
+        }
+
+        static bool trace(
+            const TreeType&     tree,
+            Ray3f               ray,
+            float&              distance)
+        {
+            const RayInfo3f ray_info(ray);
+
+            if (!clip(ray, ray_info, tree.get_bbox()))
+                return false;
+
+            voxel::Intersector<float, TreeType> intersector;
+            return intersector.intersect(tree, ray, ray_info, true, distance);
+        }
+    };
+}
+
+TEST_SUITE(Foundation_Math_Voxel_ParallelBuilder)
+{
+    TEST_CASE_F(Build_GivenManyThreads_PartitionsSpaceLikeSerialBuilder, Fixture)
+    {
+        TreeType serial_tree;
+        build_serially(serial_tree, 0.02f);
+
+        TreeType parallel_tree;
+        build_in_parallel(parallel_tree, 0.02f, 4);
+
+        EXPECT_FEQ(serial_tree.get_max_diag_length(), parallel_tree.get_max_diag_length());
+
+        for (size_t i = 0; i < RayCount; ++i)
+        {
+            const Ray3f ray(random_point(), random_direction());
+
+            float serial_distance = 0.0f;
+            const bool serial_hit = trace(serial_tree, ray, serial_distance);
+
+            float parallel_distance = 0.0f;
+            const bool parallel_hit = trace(parallel_tree, ray, parallel_distance);
+
+            ASSERT_EQ(serial_hit, parallel_hit);
+            EXPECT_FEQ(serial_distance, parallel_distance);
+        }
+    }
+
+    TEST_CASE_F(Build_GivenLeafExtentLargerThanTree_CreatesSingleSolidLeaf, Fixture)
+    {
+        TreeType tree;
+        build_in_parallel(tree, 2.0f, 4);
+
+        float distance;
+        const Ray3f ray(Vector3f(0.5f), Vector3f(1.0f, 0.0f, 0.0f));
+        EXPECT_TRUE(trace(tree, ray, distance));
+    }
+}
+
+TEST_SUITE(Foundation_Math_Voxel_PacketIntersector)
+{
+    typedef voxel::PacketIntersector<TreeType> PacketIntersectorType;
+    typedef PacketIntersectorType::RayPacket RayPacket;
+
+    TEST_CASE_F(Intersect_GivenPacketsOfRaysSharingOriginAndOctant_ReturnsSameHitsAsSingleRays, Fixture)
+    {
+        TreeType tree;
+        build_serially(tree, 0.02f);
+
+        PacketIntersectorType packet_intersector;
+
+        for (size_t i = 0; i < RayCount / 4; ++i)
+        {
+            const Vector3f org = random_point();
+            const size_t octant = i % 8;
+
+            Ray3f rays[4];
+            RayPacket packet;
+            packet.m_mask = 0;
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                Vector3f dir = random_direction();
+                for (size_t d = 0; d < 3; ++d)
+                    dir[d] = (octant & (size_t(1) << d)) ? abs(dir[d]) : -abs(dir[d]);
+
+                rays[j] = Ray3f(org, dir);
+
+                Ray3f clipped_ray(rays[j]);
+                const RayInfo3f ray_info(clipped_ray);
+                if (clip(clipped_ray, ray_info, tree.get_bbox()))
+                    packet.m_mask |= size_t(1) << j;
+
+                for (size_t d = 0; d < 3; ++d)
+                {
+                    packet.m_org[d] = org[d];
+                    packet.m_sgn_dir[d] = ray_info.m_sgn_dir[d];
+                    packet.m_rcp_dir[d][j] = ray_info.m_rcp_dir[d];
+                }
+
+                packet.m_tmin[j] = clipped_ray.m_tmin;
+                packet.m_tmax[j] = clipped_ray.m_tmax;
+            }
+
+            float packet_distances[4];
+            const size_t hits = packet_intersector.intersect(tree, packet, true, packet_distances);
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                float distance = 0.0f;
+                const bool hit = trace(tree, rays[j], distance);
+
+                ASSERT_EQ(hit, (hits & (size_t(1) << j)) != 0);
+
+                if (hit)
+                    EXPECT_EQ(distance, packet_distances[j]);
+            }
+        }
+    }
+}
@@ -848,6 +848,7 @@ void System::print_information(Logger& logger)
         "system information:\n"
         "  architecture                  %s\n"
         "  logical cores                 %s\n"
+        "  NUMA nodes                    %s\n"
         "  L1 data cache                 size %s, line size %s\n"
         "  L2 cache                      size %s, line size %s\n"
         "  L3 cache                      size %s, line size %s\n"
@@ -858,6 +859,7 @@ void System::print_information(Logger& logger)
         "  virtual memory                size %s",
         get_cpu_architecture(),
         pretty_uint(get_logical_cpu_core_count()).c_str(),
+        pretty_uint(get_numa_node_count()).c_str(),
         pretty_size(get_l1_data_cache_size()).c_str(),
         pretty_size(get_l1_data_cache_line_size()).c_str(),
         pretty_size(get_l2_cache_size()).c_str(),
@@ -896,6 +898,92 @@ size_t System::get_logical_cpu_core_count()
     return concurrency > 1 ? concurrency : 1;
 }
 
+size_t System::get_numa_node_count()
+{
+#if defined _WIN32
+
+    ULONG highest_node;
+    if (!GetNumaHighestNodeNumber(&highest_node))
+        return 1;
+
+    return static_cast<size_t>(highest_node) + 1;
+
+#elif defined __linux__
+
+    size_t node_count = 0;
+
+    while (true)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu", static_cast<unsigned long>(node_count));
+
+        if (access(path, F_OK) != 0)
+            break;
+
+        ++node_count;
+    }
+
+    return node_count > 0 ? node_count : 1;
+
+#else
+
+    return 1;
+
+#endif
+}
+
+void System::get_numa_node_cpus(const size_t node, vector<size_t>& cpus)
+{
+    cpus.clear();
+
+#if defined _WIN32
+
+    ULONGLONG mask;
+    if (GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask))
+    {
+        for (size_t i = 0; i < sizeof(mask) * 8; ++i)
+        {
+            if (mask & (static_cast<ULONGLONG>(1) << i))
+                cpus.push_back(i);
+        }
+    }
+
+#elif defined __linux__
+
+    // The file contains a list of ranges such as "0-7,16-23".
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%lu/cpulist", static_cast<unsigned long>(node));
+
+    FILE* fp = fopen(path, "r");
+    if (fp)
+    {
+        unsigned long first, last;
+        while (fscanf(fp, "%lu", &first) == 1)
+        {
+            if (fscanf(fp, "-%lu", &last) != 1)
+                last = first;
+
+            for (unsigned long i = first; i <= last; ++i)
+                cpus.push_back(static_cast<size_t>(i));
+
+            if (fgetc(fp) != ',')
+                break;
+        }
+
+        fclose(fp);
+    }
+
+#endif
+
+    // Without NUMA information, assume that a single node spans all cores.
+    if (cpus.empty() && node == 0)
+    {
+        const size_t core_count = get_logical_cpu_core_count();
+        for (size_t i = 0; i < core_count; ++i)
+            cpus.push_back(i);
+    }
+}
+
 #ifdef APPLESEED_X86
 
 // This symbol is not defined by gcc (and potentially other compilers).
@@ -39,6 +39,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class Logger; }
@@ -70,6 +71,16 @@ class APPLESEED_DLLSYMBOL System
     // Return the number of logical CPU cores available in the system.
     static size_t get_logical_cpu_core_count();
 
+    //
+    // NUMA topology.
+    //
+
+    // Return the number of NUMA nodes in the system. Systems without NUMA have a single node.
+    static size_t get_numa_node_count();
+
+    // Retrieve the logical CPU cores belonging to a given NUMA node.
+    static void get_numa_node_cpus(const size_t node, std::vector<size_t>& cpus);
+
     //
     // CPU caches.
     //
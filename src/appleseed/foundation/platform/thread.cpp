@@ -52,6 +52,8 @@
 #include <pthread.h>
 #include <pthread_np.h>
 #elif defined __linux__
+#include <pthread.h>
+#include <sched.h>
 #include <sys/prctl.h>
 #endif
 
@@ -101,6 +103,19 @@ namespace foundation
         }
     }
 
+    bool set_current_thread_affinity(const std::vector<size_t>& cpus)
+    {
+        // Only the first processor group (64 logical cores) is supported.
+        DWORD_PTR mask = 0;
+        for (size_t i = 0; i < cpus.size(); ++i)
+        {
+            if (cpus[i] < sizeof(DWORD_PTR) * 8)
+                mask |= static_cast<DWORD_PTR>(1) << cpus[i];
+        }
+
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+    }
+
 // macOS.
 #elif defined __APPLE__
 
@@ -109,6 +124,12 @@ namespace foundation
         pthread_setname_np(name);
     }
 
+    bool set_current_thread_affinity(const std::vector<size_t>& cpus)
+    {
+        // macOS does not support binding threads to specific cores.
+        return false;
+    }
+
 // FreeBSD.
 #elif defined __FreeBSD__
 
@@ -117,6 +138,12 @@ namespace foundation
         pthread_set_name_np(pthread_self(), name);
     }
 
+    bool set_current_thread_affinity(const std::vector<size_t>& cpus)
+    {
+        // Not implemented.
+        return false;
+    }
+
 // Linux.
 #elif defined __linux__
 
@@ -125,6 +152,24 @@ namespace foundation
         prctl(PR_SET_NAME, (unsigned long)name, 0, 0, 0);
     }
 
+    bool set_current_thread_affinity(const std::vector<size_t>& cpus)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+
+        bool empty = true;
+        for (size_t i = 0; i < cpus.size(); ++i)
+        {
+            if (cpus[i] < CPU_SETSIZE)
+            {
+                CPU_SET(cpus[i], &cpu_set);
+                empty = false;
+            }
+        }
+
+        return !empty && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+
 // Other platforms.
 #else
 
@@ -133,6 +178,11 @@ namespace foundation
         // Do nothing.
     }
 
+    bool set_current_thread_affinity(const std::vector<size_t>& cpus)
+    {
+        return false;
+    }
+
 #endif
 
 void sleep(const uint32 ms)
@@ -44,6 +44,10 @@
 #include "boost/thread/mutex.hpp"
 #include "boost/thread/thread.hpp"
 
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
 namespace foundation    { class Logger; }
@@ -59,6 +63,10 @@ namespace foundation
 // For portability, limit the name to 16 characters, including the terminating zero.
 APPLESEED_DLLSYMBOL void set_current_thread_name(const char* name);
 
+// Restrict the current thread to run on a given set of logical CPU cores.
+// Return false if the platform does not support thread affinity or if the call failed.
+APPLESEED_DLLSYMBOL bool set_current_thread_affinity(const std::vector<size_t>& cpus);
+
 // Suspend the current thread for a given number of milliseconds.
 APPLESEED_DLLSYMBOL void sleep(const uint32 ms);
 APPLESEED_DLLSYMBOL void sleep(const uint32 ms, IAbortSwitch& abort_switch);
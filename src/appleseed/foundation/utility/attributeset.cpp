@@ -60,6 +60,17 @@ AttributeSet::ChannelID AttributeSet::create_channel(
     channel->m_type = type;
     channel->m_dimension = dimension;
     channel->m_value_size = NumericType::size(type) * dimension;
+
+    // Reuse the slot of a deleted channel if there is one.
+    for (size_t i = 0; i < m_channels.size(); ++i)
+    {
+        if (m_channels[i] == 0)
+        {
+            m_channels[i] = channel;
+            return i;
+        }
+    }
+
     m_channels.push_back(channel);
 
     return m_channels.size() - 1;
@@ -69,9 +80,10 @@ void AttributeSet::delete_channel(const ChannelID channel_id)
 {
     assert(channel_id < m_channels.size());
 
-    delete m_channels[channel_id];
+    assert(m_channels[channel_id]);
 
-    m_channels.erase(m_channels.begin() + channel_id);
+    delete m_channels[channel_id];
+    m_channels[channel_id] = 0;
 }
 
 AttributeSet::ChannelID AttributeSet::find_channel(const char* name) const
@@ -82,7 +94,7 @@ AttributeSet::ChannelID AttributeSet::find_channel(const char* name) const
 
     for (size_t i = 0; i < channel_count; ++i)
     {
-        if (!strcmp(m_channels[i]->m_name.c_str(), name))
+        if (m_channels[i] && !strcmp(m_channels[i]->m_name.c_str(), name))
             return i;
     }
 
@@ -59,13 +59,13 @@ class AttributeSet
     // Destructor.
     ~AttributeSet();
 
-    // Create a new attribute channel.
+    // Create a new attribute channel. The identifier of a deleted channel may be reused.
     ChannelID create_channel(
         const std::string&  name,
         const NumericTypeID type,
         const size_t        dimension);
 
-    // Delete an existing channel.
+    // Delete an existing channel. The identifiers of the other channels remain valid.
     void delete_channel(const ChannelID channel_id);
 
     // Find a given attribute channel. Return InvalidChannelID if
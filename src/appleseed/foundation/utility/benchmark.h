@@ -41,6 +41,7 @@
 #include "foundation/utility/benchmark/ibenchmarkcase.h"
 #include "foundation/utility/benchmark/ibenchmarkcasefactory.h"
 #include "foundation/utility/benchmark/ibenchmarklistener.h"
+#include "foundation/utility/benchmark/ibenchmarkstatisticsprovider.h"
 #include "foundation/utility/benchmark/loggerbenchmarklistener.h"
 #include "foundation/utility/benchmark/timingresult.h"
 #include "foundation/utility/benchmark/xmlfilebenchmarklistener.h"
@@ -39,10 +39,13 @@
 #include "foundation/utility/benchmark/benchmarkresult.h"
 #include "foundation/utility/benchmark/ibenchmarkcase.h"
 #include "foundation/utility/benchmark/ibenchmarkcasefactory.h"
+#include "foundation/utility/benchmark/ibenchmarkstatisticsprovider.h"
 #include "foundation/utility/benchmark/timingresult.h"
 #include "foundation/utility/filter.h"
 #include "foundation/utility/gnuplotfile.h"
+#include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
 
 // Standard headers.
 #include <algorithm>
@@ -298,6 +301,33 @@ void BenchmarkSuite::run(
                 __FILE__,
                 __LINE__,
                 timing_result);
+
+            // Post the case-specific statistics, if any, one message per entry.
+            const IBenchmarkStatisticsProvider* stats_provider =
+                dynamic_cast<const IBenchmarkStatisticsProvider*>(benchmark.get());
+            if (stats_provider)
+            {
+                Statistics stats;
+                stats_provider->get_statistics(stats);
+
+                vector<string> lines;
+                split(stats.to_string(), "\n", lines);
+
+                for (size_t j = 0; j < lines.size(); ++j)
+                {
+                    const string line = trim_both(lines[j]);
+                    if (!line.empty())
+                    {
+                        suite_result.write(
+                            *this,
+                            *benchmark.get(),
+                            __FILE__,
+                            __LINE__,
+                            "%s",
+                            line.c_str());
+                    }
+                }
+            }
         }
 #ifdef NDEBUG
         catch (const exception& e)
@@ -54,11 +54,12 @@ struct JobManager::Impl
 {
     typedef vector<WorkerThread*> WorkerThreads;
 
-    Logger&             m_logger;
-    JobQueue&           m_job_queue;
-    size_t              m_thread_count;
-    const int           m_flags;
-    WorkerThreads       m_worker_threads;
+    Logger&                 m_logger;
+    JobQueue&               m_job_queue;
+    size_t                  m_thread_count;
+    const int               m_flags;
+    vector<vector<size_t>>  m_thread_affinities;
+    WorkerThreads           m_worker_threads;
 
     // Constructor.
     Impl(
@@ -95,6 +96,11 @@ size_t JobManager::get_thread_count() const
     return impl->m_thread_count;
 }
 
+void JobManager::set_thread_affinities(const vector<vector<size_t>>& cpu_sets)
+{
+    impl->m_thread_affinities = cpu_sets;
+}
+
 void JobManager::start()
 {
     assert(impl->m_worker_threads.empty() ||
@@ -103,14 +109,22 @@ void JobManager::start()
     // Create worker threads if they don't already exist.
     if (impl->m_worker_threads.empty())
     {
+        const vector<size_t> no_affinity;
+
         for (size_t i = 0; i < impl->m_thread_count; ++i)
         {
+            const vector<size_t>& cpus =
+                impl->m_thread_affinities.empty()
+                    ? no_affinity
+                    : impl->m_thread_affinities[i % impl->m_thread_affinities.size()];
+
             impl->m_worker_threads.push_back(
                 new WorkerThread(
                     i,
                     impl->m_logger,
                     impl->m_job_queue,
-                    impl->m_flags));
+                    impl->m_flags,
+                    cpus));
         }
     }
 
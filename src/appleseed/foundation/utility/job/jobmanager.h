@@ -38,6 +38,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class JobQueue; }
@@ -75,6 +76,12 @@ class APPLESEED_DLLSYMBOL JobManager
     // Return the number of worker threads.
     size_t get_thread_count() const;
 
+    // Bind worker threads to sets of logical CPU cores: worker thread i is bound to the cores
+    // listed in cpu_sets[i % cpu_sets.size()]. An empty vector lets worker threads run anywhere.
+    // Takes effect the next time worker threads are created, i.e. on the first call to start()
+    // or on the first call to start() following a call to stop().
+    void set_thread_affinities(const std::vector<std::vector<size_t>>& cpu_sets);
+
     // Start job execution. Returns immediately.
     void start();
 
@@ -52,14 +52,16 @@ namespace foundation
 //
 
 WorkerThread::WorkerThread(
-    const size_t    index,
-    Logger&         logger,
-    JobQueue&       job_queue,
-    const int       flags)
+    const size_t            index,
+    Logger&                 logger,
+    JobQueue&               job_queue,
+    const int               flags,
+    const vector<size_t>&   cpus)
   : m_index(index)
   , m_logger(logger)
   , m_job_queue(job_queue)
   , m_flags(flags)
+  , m_cpus(cpus)
   , m_thread_func(*this)
   , m_thread(0)
 {
@@ -132,9 +134,24 @@ void WorkerThread::set_thread_name()
     set_current_thread_name(thread_name);
 }
 
+void WorkerThread::set_thread_affinity()
+{
+    if (m_cpus.empty())
+        return;
+
+    if (!set_current_thread_affinity(m_cpus))
+    {
+        LOG_WARNING(
+            m_logger,
+            "worker thread " FMT_SIZE_T ": failed to set thread affinity.",
+            m_index);
+    }
+}
+
 void WorkerThread::run()
 {
     set_thread_name();
+    set_thread_affinity();
 
     while (!m_abort_switch.is_aborted())
     {
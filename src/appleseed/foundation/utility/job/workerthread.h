@@ -40,6 +40,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace boost         { class thread; }
@@ -60,10 +61,12 @@ class WorkerThread
   public:
     // Constructor.
     WorkerThread(
-        const size_t    index,
-        Logger&         logger,
-        JobQueue&       job_queue,
-        const int       flags);     // see foundation::JobManager::Flags
+        const size_t                index,
+        Logger&                     logger,
+        JobQueue&                   job_queue,
+        const int                   flags,      // see foundation::JobManager::Flags
+        const std::vector<size_t>&  cpus =      // logical CPU cores the thread is bound to, empty for none
+            std::vector<size_t>());
 
     // Destructor.
     ~WorkerThread();
@@ -102,6 +105,7 @@ class WorkerThread
     Logger&                         m_logger;
     JobQueue&                       m_job_queue;
     const int                       m_flags;
+    const std::vector<size_t>       m_cpus;
 
     AbortSwitch                     m_abort_switch;
 
@@ -113,6 +117,7 @@ class WorkerThread
     boost::mutex                    m_pause_mutex;
 
     void set_thread_name();
+    void set_thread_affinity();
 
     // Main line of the worker thread.
     void run();
@@ -40,7 +40,9 @@
 #include "foundation/utility/string.h"
 
 // Boost headers.
+#include "boost/atomic/atomic.hpp"
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include "boost/thread/condition_variable.hpp"
 
 // Standard headers.
 #include <algorithm>
@@ -50,6 +52,8 @@
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace boost::posix_time;
@@ -196,52 +200,579 @@ namespace
         size_t              m_thread_count;
         ThreadIdToIntMap    m_thread_id_to_int;
     };
+
+    const size_t InitialBufferSize = 1024;          // in bytes
+    const size_t MaxBufferSize = 1024 * 1024;       // in bytes
+    const size_t QueueCapacity = 1024;              // in messages, must be a power of two
+    const size_t InlineTextSize = 256;              // in bytes, longer messages are allocated on the heap
+    const size_t WriterIdlePeriod = 100;            // in milliseconds
+
+    // A slot of the message queue.
+    struct PendingMessage
+    {
+        boost::atomic<size_t>   m_sequence;
+        LogMessage::Category    m_category;
+        const char*             m_file;
+        size_t                  m_line;
+        ptime                   m_datetime;
+        boost::thread::id       m_thread_id;
+        char                    m_text[InlineTextSize];
+        vector<char>            m_long_text;
+
+        const char* get_text() const
+        {
+            return m_long_text.empty() ? m_text : &m_long_text[0];
+        }
+    };
+
+    // A message set aside while the queue is full.
+    struct OverflowMessage
+    {
+        LogMessage::Category    m_category;
+        const char*             m_file;
+        size_t                  m_line;
+        ptime                   m_datetime;
+        boost::thread::id       m_thread_id;
+        string                  m_text;
+
+        const char* get_text() const
+        {
+            return m_text.c_str();
+        }
+    };
+
+    // Collapse repeated warnings and errors, and limit the rate of warnings per call site.
+    // Debug and info messages are never filtered.
+    class MessageFilter
+      : public NonCopyable
+    {
+      public:
+        enum Decision
+        {
+            Emit,
+            Discard
+        };
+
+        struct Summary
+        {
+            LogMessage::Category    m_category;
+            const char*             m_file;
+            size_t                  m_line;
+            boost::thread::id       m_thread_id;
+            string                  m_text;
+        };
+
+        MessageFilter()
+          : m_has_last(false)
+          , m_repeat_count(0)
+        {
+        }
+
+        // Decide whether a message must be emitted. Summaries of previously
+        // discarded messages that must be emitted first are appended to `summaries`.
+        template <typename Message>
+        Decision filter(const Message& message, vector<Summary>& summaries)
+        {
+            if (message.m_category < LogMessage::Warning)
+            {
+                flush_repeats(summaries);
+                m_has_last = false;
+                return Emit;
+            }
+
+            const char* text = message.get_text();
+
+            // Collapse consecutive identical messages.
+            if (m_has_last &&
+                message.m_category == m_last_category &&
+                m_last_text == text)
+            {
+                if (m_repeat_count == 0)
+                    m_first_repeat_datetime = message.m_datetime;
+                ++m_repeat_count;
+                return Discard;
+            }
+
+            flush_repeats(summaries);
+
+            // Limit the rate of warnings emitted from a given call site. Errors are never limited.
+            if (message.m_category == LogMessage::Warning)
+            {
+                CallSite& site = m_call_sites[make_pair(message.m_file, message.m_line)];
+
+                if (site.m_count == 0 || message.m_datetime - site.m_window_start >= rate_window())
+                {
+                    flush_call_site(message.m_file, message.m_line, site, summaries);
+                    site.m_window_start = message.m_datetime;
+                    site.m_count = 0;
+                }
+
+                if (site.m_count >= MaxWarningsPerCallSite)
+                {
+                    if (site.m_suppressed_count++ == 0)
+                        site.m_thread_id = message.m_thread_id;
+                    return Discard;
+                }
+
+                ++site.m_count;
+            }
+
+            m_has_last = true;
+            m_last_category = message.m_category;
+            m_last_file = message.m_file;
+            m_last_line = message.m_line;
+            m_last_thread_id = message.m_thread_id;
+            m_last_text = text;
+
+            return Emit;
+        }
+
+        // Emit the summaries of messages discarded before a given time.
+        void flush_expired(const ptime& now, vector<Summary>& summaries)
+        {
+            if (m_repeat_count > 0 && now - m_first_repeat_datetime >= rate_window())
+                flush_repeats(summaries);
+
+            for (CallSiteMap::iterator i = m_call_sites.begin(); i != m_call_sites.end(); )
+            {
+                if (now - i->second.m_window_start >= rate_window())
+                {
+                    flush_call_site(i->first.first, i->first.second, i->second, summaries);
+                    m_call_sites.erase(i++);
+                }
+                else ++i;
+            }
+        }
+
+        // Emit the summaries of all discarded messages.
+        void flush_all(vector<Summary>& summaries)
+        {
+            flush_repeats(summaries);
+
+            for (CallSiteMap::iterator i = m_call_sites.begin(); i != m_call_sites.end(); ++i)
+                flush_call_site(i->first.first, i->first.second, i->second, summaries);
+
+            m_call_sites.clear();
+        }
+
+      private:
+        struct CallSite
+        {
+            ptime                   m_window_start;
+            size_t                  m_count;
+            size_t                  m_suppressed_count;
+            boost::thread::id       m_thread_id;
+
+            CallSite()
+              : m_count(0)
+              , m_suppressed_count(0)
+            {
+            }
+        };
+
+        typedef map<pair<const char*, size_t>, CallSite> CallSiteMap;
+
+        static const size_t MaxWarningsPerCallSite = 20;
+
+        static time_duration rate_window()
+        {
+            return seconds(1);
+        }
+
+        bool                    m_has_last;
+        LogMessage::Category    m_last_category;
+        const char*             m_last_file;
+        size_t                  m_last_line;
+        boost::thread::id       m_last_thread_id;
+        string                  m_last_text;
+        size_t                  m_repeat_count;
+        ptime                   m_first_repeat_datetime;
+        CallSiteMap             m_call_sites;
+
+        void flush_repeats(vector<Summary>& summaries)
+        {
+            if (m_repeat_count == 0)
+                return;
+
+            Summary summary;
+            summary.m_category = m_last_category;
+            summary.m_file = m_last_file;
+            summary.m_line = m_last_line;
+            summary.m_thread_id = m_last_thread_id;
+            summary.m_text =
+                "last message repeated " + to_string(m_repeat_count) +
+                (m_repeat_count > 1 ? " times." : " time.");
+            summaries.push_back(summary);
+
+            m_repeat_count = 0;
+        }
+
+        static void flush_call_site(
+            const char*             file,
+            const size_t            line,
+            CallSite&               site,
+            vector<Summary>&        summaries)
+        {
+            if (site.m_suppressed_count == 0)
+                return;
+
+            Summary summary;
+            summary.m_category = LogMessage::Warning;
+            summary.m_file = file;
+            summary.m_line = line;
+            summary.m_thread_id = site.m_thread_id;
+            summary.m_text =
+                to_string(site.m_suppressed_count) +
+                (site.m_suppressed_count > 1 ? " similar warnings were" : " similar warning was") +
+                " suppressed.";
+            summaries.push_back(summary);
+
+            site.m_suppressed_count = 0;
+        }
+    };
 }
 
 
 //
 // Logger class implementation.
 //
+// Calling threads push messages onto a bounded multi-producer queue (a ring buffer of
+// preallocated slots in which each slot carries a sequence number telling whether it
+// is free or holds a message), format their text directly into the slot and publish
+// it. The queue is consumed by the writer thread, or by any thread that needs pending
+// messages to be sent right away, while holding m_output_mutex.
+//
+// Calling threads never wait for the writer thread: when the queue is full, warnings are
+// dropped and other messages are set aside in an unbounded overflow list, which is sent
+// after the queue and receives all messages until it is emptied. The writer thread may be
+// blocked in a log target (e.g. one written in Python waiting for the global interpreter
+// lock) by the very thread that is logging.
+//
+// The writer thread is never joined: when the logger is destroyed, pending messages are
+// sent synchronously, the writer thread is told to stop and takes ownership of the
+// implementation, which it deletes on exit. This keeps the destruction of static loggers
+// from waiting for another thread, which could deadlock when a shared library is unloaded.
+//
 
 struct Logger::Impl
 {
     typedef list<ILogTarget*> LogTargetContainer;
 
-    boost::mutex            m_mutex;
-    bool                    m_enabled;
-    LogMessage::Category    m_verbosity_level;
-    LogTargetContainer      m_targets;
-    vector<char>            m_message_buffer;
-    ThreadMap               m_thread_map;
-    Formatter               m_formatter;
-};
+    // State accessed by calling threads without locking.
+    boost::atomic<bool>             m_enabled;
+    boost::atomic<int>              m_verbosity_level;
+    PendingMessage*                 m_queue;
+    boost::atomic<size_t>           m_enqueue_position;
+    boost::atomic<size_t>           m_dequeue_position;
+    boost::atomic<size_t>           m_dropped_count;
+    boost::atomic<bool>             m_overflowing;
+
+    // Messages set aside while the queue is full, protected by m_overflow_mutex.
+    boost::mutex                    m_overflow_mutex;
+    vector<OverflowMessage>         m_overflow;
+
+    // Writer thread.
+    boost::mutex                    m_writer_mutex;
+    boost::condition_variable       m_writer_wakeup;
+    boost::atomic<bool>             m_writer_started;
+    bool                            m_writer_stopping;
+    boost::thread                   m_writer_thread;
+
+    // State of the consumer of the queue, protected by m_output_mutex.
+    mutable boost::mutex            m_output_mutex;
+    LogTargetContainer              m_targets;
+    ThreadMap                       m_thread_map;
+    Formatter                       m_formatter;
+    MessageFilter                   m_filter;
+    vector<MessageFilter::Summary>  m_summaries;
+
+    Impl()
+      : m_enabled(true)
+      , m_verbosity_level(LogMessage::Info)
+      , m_queue(new PendingMessage[QueueCapacity])
+      , m_enqueue_position(0)
+      , m_dequeue_position(0)
+      , m_dropped_count(0)
+      , m_overflowing(false)
+      , m_writer_started(false)
+      , m_writer_stopping(false)
+    {
+        for (size_t i = 0; i < QueueCapacity; ++i)
+            m_queue[i].m_sequence.store(i, boost::memory_order_relaxed);
+    }
 
-namespace
-{
-    const size_t InitialBufferSize = 1024;      // in bytes
-    const size_t MaxBufferSize = 1024 * 1024;   // in bytes
-}
+    ~Impl()
+    {
+        delete[] m_queue;
+    }
+
+    // Destroy the implementation of a logger. Does not wait for the writer thread.
+    void release()
+    {
+        {
+            boost::mutex::scoped_lock lock(m_output_mutex);
+            drain();
+            flush_summaries(false);
+            m_targets.clear();
+        }
+
+        if (!m_writer_started.load())
+        {
+            delete this;
+            return;
+        }
+
+        // From now on the writer thread owns this object. It must not be accessed
+        // once the lock is released.
+        boost::mutex::scoped_lock lock(m_writer_mutex);
+        m_writer_stopping = true;
+        m_writer_thread.detach();
+        m_writer_wakeup.notify_one();
+    }
+
+    // Claim a free slot of the queue. Lock-free. Return 0 if the queue is full.
+    PendingMessage* acquire_slot(size_t& position)
+    {
+        position = m_enqueue_position.load(boost::memory_order_relaxed);
+
+        while (true)
+        {
+            PendingMessage* slot = &m_queue[position & (QueueCapacity - 1)];
+            const size_t sequence = slot->m_sequence.load(boost::memory_order_acquire);
+
+            if (sequence == position)
+            {
+                if (m_enqueue_position.compare_exchange_weak(position, position + 1, boost::memory_order_relaxed))
+                    return slot;
+            }
+            else if (sequence < position)
+            {
+                // The slot still holds a message from the previous round: the queue is full.
+                return 0;
+            }
+            else position = m_enqueue_position.load(boost::memory_order_relaxed);
+        }
+    }
+
+    // Set a message aside because the queue is full.
+    void push_overflow(const OverflowMessage& message)
+    {
+        {
+            boost::mutex::scoped_lock lock(m_overflow_mutex);
+            m_overflow.push_back(message);
+            m_overflowing.store(true, boost::memory_order_release);
+        }
+
+        start_writer();
+        m_writer_wakeup.notify_one();
+    }
+
+    // Hand a filled slot over to the consumer. Lock-free.
+    void publish_slot(PendingMessage* slot, const size_t position)
+    {
+        slot->m_sequence.store(position + 1, boost::memory_order_release);
+
+        // Wake the writer thread up if the queue was empty. If the notification is lost
+        // because the writer thread is about to wait, it will wake up after its idle period.
+        if (position == m_dequeue_position.load(boost::memory_order_relaxed))
+        {
+            start_writer();
+            m_writer_wakeup.notify_one();
+        }
+    }
+
+    void start_writer()
+    {
+        if (m_writer_started.load(boost::memory_order_acquire))
+            return;
+
+        boost::mutex::scoped_lock lock(m_writer_mutex);
+
+        if (!m_writer_started.load(boost::memory_order_relaxed))
+        {
+            m_writer_thread = boost::thread(&Impl::run_writer, this);
+            m_writer_started.store(true, boost::memory_order_release);
+        }
+    }
+
+    bool is_queue_empty() const
+    {
+        if (m_overflowing.load(boost::memory_order_acquire))
+            return false;
+
+        const size_t position = m_dequeue_position.load(boost::memory_order_relaxed);
+        const PendingMessage& slot = m_queue[position & (QueueCapacity - 1)];
+        return slot.m_sequence.load(boost::memory_order_acquire) != position + 1;
+    }
+
+    void run_writer()
+    {
+        while (true)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_writer_mutex);
+
+                if (!m_writer_stopping && is_queue_empty())
+                    m_writer_wakeup.timed_wait(lock, milliseconds(WriterIdlePeriod));
+
+                if (m_writer_stopping)
+                    break;
+            }
+
+            boost::mutex::scoped_lock lock(m_output_mutex);
+            drain();
+            flush_summaries(true);
+        }
+
+        // The logger was destroyed.
+        delete this;
+    }
+
+    // Send all queued messages to the log targets. m_output_mutex must be held.
+    void drain()
+    {
+        size_t position = m_dequeue_position.load(boost::memory_order_relaxed);
+
+        while (true)
+        {
+            PendingMessage& slot = m_queue[position & (QueueCapacity - 1)];
+
+            if (slot.m_sequence.load(boost::memory_order_acquire) != position + 1)
+                break;
+
+            send(slot);
+
+            if (!slot.m_long_text.empty())
+                vector<char>().swap(slot.m_long_text);
+
+            // Hand the slot back to the producers.
+            slot.m_sequence.store(position + QueueCapacity, boost::memory_order_release);
+            m_dequeue_position.store(++position, boost::memory_order_relaxed);
+        }
+
+        // Send the messages set aside while the queue was full.
+        if (m_overflowing.load(boost::memory_order_acquire))
+        {
+            vector<OverflowMessage> overflow;
+
+            {
+                boost::mutex::scoped_lock lock(m_overflow_mutex);
+                overflow.swap(m_overflow);
+                m_overflowing.store(false, boost::memory_order_release);
+            }
+
+            for (const_each<vector<OverflowMessage>> i = overflow; i; ++i)
+                send(*i);
+        }
+
+        const size_t dropped_count = m_dropped_count.exchange(0);
+        if (dropped_count > 0)
+        {
+            emit(
+                LogMessage::Warning,
+                __FILE__,
+                __LINE__,
+                microsec_clock::universal_time(),
+                boost::this_thread::get_id(),
+                to_string(dropped_count) + " warning(s) were dropped because too many messages were pending.");
+        }
+    }
+
+    // Filter a message and send it to all log targets. m_output_mutex must be held.
+    template <typename Message>
+    void send(const Message& message)
+    {
+        if (m_filter.filter(message, m_summaries) == MessageFilter::Emit)
+        {
+            emit_summaries();
+            emit(
+                message.m_category,
+                message.m_file,
+                message.m_line,
+                message.m_datetime,
+                message.m_thread_id,
+                message.get_text());
+        }
+        else emit_summaries();
+    }
+
+    // Emit the summaries of discarded messages. m_output_mutex must be held.
+    void flush_summaries(const bool expired_only)
+    {
+        if (expired_only)
+            m_filter.flush_expired(microsec_clock::universal_time(), m_summaries);
+        else m_filter.flush_all(m_summaries);
+
+        emit_summaries();
+    }
+
+    void emit_summaries()
+    {
+        for (const_each<vector<MessageFilter::Summary>> i = m_summaries; i; ++i)
+        {
+            emit(
+                i->m_category,
+                i->m_file,
+                i->m_line,
+                microsec_clock::universal_time(),
+                i->m_thread_id,
+                i->m_text);
+        }
+
+        m_summaries.clear();
+    }
+
+    // Format a message and send it to all log targets. m_output_mutex must be held.
+    void emit(
+        const LogMessage::Category  category,
+        const char*                 file,
+        const size_t                line,
+        const ptime&                datetime,
+        const boost::thread::id     thread_id,
+        const string&               text)
+    {
+        // Format the header and message.
+        const size_t thread = m_thread_map.thread_id_to_int(thread_id);
+        const FormatEvaluator format_evaluator(category, datetime, thread, text);
+        const string header = format_evaluator.evaluate(m_formatter.get_header_format(category));
+        const string message = format_evaluator.evaluate(m_formatter.get_message_format(category));
+
+        if (message.empty())
+            return;
+
+        // Send the header and message to all log targets.
+        for (const_each<LogTargetContainer> i = m_targets; i; ++i)
+        {
+            ILogTarget* target = *i;
+            target->write(
+                category,
+                file,
+                line,
+                header.c_str(),
+                message.c_str());
+        }
+    }
+};
 
 Logger::Logger()
   : impl(new Impl())
 {
-    impl->m_enabled = true;
-    impl->m_verbosity_level = LogMessage::Info;
-    impl->m_message_buffer.resize(InitialBufferSize);
 }
 
 Logger::~Logger()
 {
-    delete impl;
+    impl->release();
 }
 
 void Logger::initialize_from(const Logger& source)
 {
-    boost::mutex::scoped_lock source_lock(source.impl->m_mutex);
-    boost::mutex::scoped_lock this_lock(impl->m_mutex);
+    boost::mutex::scoped_lock source_lock(source.impl->m_output_mutex);
+    boost::mutex::scoped_lock this_lock(impl->m_output_mutex);
+
+    impl->drain();
 
-    impl->m_enabled = source.impl->m_enabled;
-    impl->m_verbosity_level = source.impl->m_verbosity_level;
+    impl->m_enabled.store(source.impl->m_enabled.load());
+    impl->m_verbosity_level.store(source.impl->m_verbosity_level.load());
 
     impl->m_targets.clear();
     for (const_each<Impl::LogTargetContainer> i = source.impl->m_targets; i; ++i)
@@ -256,68 +787,80 @@ void Logger::initialize_from(const Logger& source)
 
 void Logger::set_enabled(const bool enabled)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
-    impl->m_enabled = enabled;
+    impl->m_enabled.store(enabled);
 }
 
 void Logger::set_verbosity_level(const LogMessage::Category level)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
-    impl->m_verbosity_level = level;
+    impl->m_verbosity_level.store(level);
 }
 
 LogMessage::Category Logger::get_verbosity_level() const
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
-    return impl->m_verbosity_level;
+    return static_cast<LogMessage::Category>(impl->m_verbosity_level.load());
 }
 
 void Logger::reset_all_formats()
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
+    impl->drain();
     impl->m_formatter.reset_all_formats();
 }
 
 void Logger::reset_format(const LogMessage::Category category)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
+    impl->drain();
     impl->m_formatter.reset_format(category);
 }
 
 void Logger::set_all_formats(const char* format)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
+    impl->drain();
     impl->m_formatter.set_all_formats(format);
 }
 
 void Logger::set_format(const LogMessage::Category category, const char* format)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
+    impl->drain();
     impl->m_formatter.set_format(category, format);
 }
 
 const char* Logger::get_format(const LogMessage::Category category) const
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
     return impl->m_formatter.get_format(category).c_str();
 }
 
 void Logger::add_target(ILogTarget* target)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
 
     assert(target);
+    impl->drain();
     impl->m_targets.push_back(target);
 }
 
 void Logger::remove_target(ILogTarget* target)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
 
     assert(target);
+    impl->drain();
+    impl->flush_summaries(false);
     impl->m_targets.remove(target);
 }
 
+void Logger::flush()
+{
+    boost::mutex::scoped_lock lock(impl->m_output_mutex);
+
+    impl->drain();
+    impl->flush_summaries(false);
+}
+
 namespace
 {
     bool write_to_buffer(
@@ -357,6 +900,31 @@ namespace
             buffer.resize(min(needed_buffer_size, max_buffer_size));
         }
     }
+
+    bool format_message(
+        PendingMessage&     message,
+        const char*         format,
+        va_list             argptr)
+    {
+        va_list argptr_copy;
+        va_copy(argptr_copy, argptr);
+
+        const int result =
+            portable_vsnprintf(message.m_text, InlineTextSize, format, argptr_copy);
+
+        va_end(argptr_copy);
+
+        if (result >= 0 && static_cast<size_t>(result) < InlineTextSize)
+            return true;
+
+        // The message does not fit into the slot.
+        message.m_long_text.resize(
+            result >= 0
+                ? min(static_cast<size_t>(result) + 1, MaxBufferSize)
+                : InitialBufferSize);
+
+        return write_to_buffer(message.m_long_text, MaxBufferSize, format, argptr);
+    }
 }
 
 void Logger::write(
@@ -365,53 +933,75 @@ void Logger::write(
     const size_t                        line,
     APPLESEED_PRINTF_FMT const char*    format, ...)
 {
-    boost::mutex::scoped_lock lock(impl->m_mutex);
-
-    if (category < impl->m_verbosity_level)
+    if (category < impl->m_verbosity_level.load(boost::memory_order_relaxed))
         return;
 
     LogMessage::Category effective_category = category;
 
-    if (impl->m_enabled)
+    if (impl->m_enabled.load(boost::memory_order_relaxed))
     {
-        // Format the message into the temporary buffer.
-        va_list argptr;
-        va_start(argptr, format);
-        const bool formatting_succeeded =
-            write_to_buffer(impl->m_message_buffer, MaxBufferSize, format, argptr);
-
-        // If formatting failed, print the message as an error.
-        if (!formatting_succeeded)
-            effective_category = LogMessage::Error;
-
-        // Retrieve the current UTC time.
-        const ptime datetime(microsec_clock::universal_time());
-
-        // Format the header and message.
-        const size_t thread = impl->m_thread_map.thread_id_to_int(boost::this_thread::get_id());
-        const FormatEvaluator format_evaluator(effective_category, datetime, thread, &impl->m_message_buffer[0]);
-        const string header = format_evaluator.evaluate(impl->m_formatter.get_header_format(effective_category));
-        const string message = format_evaluator.evaluate(impl->m_formatter.get_message_format(effective_category));
-
-        if (!message.empty())
+        // Claim a slot of the queue, unless messages are being set aside.
+        size_t position;
+        PendingMessage* message =
+            impl->m_overflowing.load(boost::memory_order_acquire)
+                ? 0
+                : impl->acquire_slot(position);
+
+        if (message == 0)
         {
-            // Send the header and message to all log targets.
-            for (const_each<Impl::LogTargetContainer> i = impl->m_targets; i; ++i)
+            // Drop warnings and set other messages aside until the queue is consumed.
+            if (category == LogMessage::Warning)
             {
-                ILogTarget* target = *i;
-                target->write(
-                    effective_category,
-                    file,
-                    line,
-                    header.c_str(),
-                    message.c_str());
+                impl->m_dropped_count.fetch_add(1, boost::memory_order_relaxed);
+                return;
             }
+
+            vector<char> buffer(InitialBufferSize);
+            va_list argptr;
+            va_start(argptr, format);
+            const bool formatting_succeeded = write_to_buffer(buffer, MaxBufferSize, format, argptr);
+            va_end(argptr);
+
+            if (!formatting_succeeded)
+                effective_category = LogMessage::Error;
+
+            OverflowMessage overflow_message;
+            overflow_message.m_category = effective_category;
+            overflow_message.m_file = file;
+            overflow_message.m_line = line;
+            overflow_message.m_datetime = microsec_clock::universal_time();
+            overflow_message.m_thread_id = boost::this_thread::get_id();
+            overflow_message.m_text = &buffer[0];
+            impl->push_overflow(overflow_message);
+        }
+        else
+        {
+            // Format the message into the slot.
+            va_list argptr;
+            va_start(argptr, format);
+            const bool formatting_succeeded = format_message(*message, format, argptr);
+            va_end(argptr);
+
+            // If formatting failed, print the message as an error.
+            if (!formatting_succeeded)
+                effective_category = LogMessage::Error;
+
+            // Queue the message. The header is formatted by the writer thread.
+            message->m_category = effective_category;
+            message->m_file = file;
+            message->m_line = line;
+            message->m_datetime = microsec_clock::universal_time();
+            message->m_thread_id = boost::this_thread::get_id();
+            impl->publish_slot(message, position);
         }
     }
 
     // Terminate the application if the message category is 'Fatal'.
     if (effective_category == LogMessage::Fatal)
+    {
+        flush();
         exit(EXIT_FAILURE);
+    }
 }
 
 }   // namespace foundation
@@ -53,6 +53,15 @@ namespace foundation
 //
 // All methods of this class are thread-safe.
 //
+// Calling threads only format the text of a message and push it onto a lock-free
+// queue. Headers are formatted and messages are sent to log targets by a writer
+// thread owned by the logger, so log targets may be invoked from that thread.
+//
+// The writer thread collapses consecutive identical warnings and errors, and limits
+// the rate at which warnings are emitted from any given call site. When too many
+// messages are pending, warnings are dropped. Debug and info messages are never
+// filtered or dropped.
+//
 
 class APPLESEED_DLLSYMBOL Logger
   : public NonCopyable
@@ -100,12 +109,17 @@ class APPLESEED_DLLSYMBOL Logger
 
     // Remove all instances of a given log target.
     // If the specified target cannot be found, nothing happens.
-    // Log targets can be removed at any time.
+    // Log targets can be removed at any time. Pending messages
+    // are sent to the target before it is removed.
     void remove_target(ILogTarget* target);
 
+    // Send all pending messages to the log targets.
+    void flush();
+
     // Write a message. If the message category is Fatal,
     // this function will not return and the program will
-    // be terminated.
+    // be terminated. The file name must outlive the logger
+    // (it is typically the __FILE__ string literal).
     void write(
         const LogMessage::Category          category,
         const char*                         file,
@@ -0,0 +1,292 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "alphamask.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/bitmask.h"
+#include "foundation/utility/siphash.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// AlphaMask class implementation.
+//
+
+namespace
+{
+    // Return a mask of the bits of a tile covered by a rectangle of texels given in tile coordinates.
+    uint64 make_rectangle_mask(
+        const size_t    x0,
+        const size_t    y0,
+        const size_t    x1,
+        const size_t    y1)
+    {
+        assert(x0 <= x1 && x1 < 8);
+        assert(y0 <= y1 && y1 < 8);
+
+        const uint64 row_mask = (0xFFu >> (7 - (x1 - x0))) << x0;
+
+        uint64 mask = 0;
+
+        for (size_t y = y0; y <= y1; ++y)
+            mask |= row_mask << (y * 8);
+
+        return mask;
+    }
+}
+
+AlphaMask::AlphaMask(const BitMask2& bitmask)
+  : m_width(bitmask.get_width())
+  , m_height(bitmask.get_height())
+  , m_tile_count_x((m_width + 7) / 8)
+  , m_max_x(static_cast<float>(m_width) - 1.0f)
+  , m_max_y(static_cast<float>(m_height) - 1.0f)
+{
+    assert(m_width > 0);
+    assert(m_height > 0);
+
+    const size_t tile_count_y = (m_height + 7) / 8;
+
+    m_tiles.resize(m_tile_count_x * tile_count_y);
+    m_level_widths.push_back(m_tile_count_x);
+    m_levels.push_back(vector<uint8>(m_tiles.size()));
+
+    size_t transparent_texel_count = 0;
+
+    // Build the tiles.
+    for (size_t ty = 0; ty < tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < m_tile_count_x; ++tx)
+        {
+            const size_t x_end = min<size_t>(tx * 8 + 8, m_width);
+            const size_t y_end = min<size_t>(ty * 8 + 8, m_height);
+
+            uint64 bits = 0;
+            uint8 opacity = 0;
+
+            for (size_t y = ty * 8; y < y_end; ++y)
+            {
+                for (size_t x = tx * 8; x < x_end; ++x)
+                {
+                    if (bitmask.is_set(x, y))
+                    {
+                        bits |= uint64(1) << ((y & 7) * 8 + (x & 7));
+                        opacity |= Opaque;
+                    }
+                    else
+                    {
+                        opacity |= Transparent;
+                        ++transparent_texel_count;
+                    }
+                }
+            }
+
+            const size_t tile_index = ty * m_tile_count_x + tx;
+
+            if (opacity == Opaque)
+                m_tiles[tile_index] = OpaqueTile;
+            else if (opacity == Transparent)
+                m_tiles[tile_index] = TransparentTile;
+            else
+            {
+                m_tiles[tile_index] = static_cast<uint32>(m_mixed_tiles.size());
+                m_mixed_tiles.push_back(bits);
+            }
+
+            m_levels[0][tile_index] = opacity;
+        }
+    }
+
+    m_transparency = static_cast<double>(transparent_texel_count) / (m_width * m_height);
+
+    // Build the opacity hierarchy, up to a single block covering the whole mask.
+    size_t level_height = tile_count_y;
+    while (m_level_widths.back() > 1 || level_height > 1)
+    {
+        const vector<uint8>& child = m_levels.back();
+        const size_t child_width = m_level_widths.back();
+        const size_t child_height = level_height;
+
+        const size_t width = (child_width + 1) / 2;
+        const size_t height = (child_height + 1) / 2;
+        vector<uint8> parent(width * height, 0);
+
+        for (size_t y = 0; y < child_height; ++y)
+        {
+            for (size_t x = 0; x < child_width; ++x)
+                parent[(y / 2) * width + x / 2] |= child[y * child_width + x];
+        }
+
+        m_level_widths.push_back(width);
+        m_levels.push_back(parent);
+        level_height = height;
+    }
+}
+
+AlphaMask::Opacity AlphaMask::get_opacity(
+    const Vector2f&     uv_min,
+    const Vector2f&     uv_max) const
+{
+    // Be conservative with indefinite coordinates.
+    if (uv_min[0] != uv_min[0] || uv_min[1] != uv_min[1] ||
+        uv_max[0] != uv_max[0] || uv_max[1] != uv_max[1])
+        return Mixed;
+
+    const size_t x0 = get_x(uv_min[0]);
+    const size_t y0 = get_y(uv_min[1]);
+    const size_t x1 = get_x(uv_max[0]);
+    const size_t y1 = get_y(uv_max[1]);
+    assert(x0 <= x1 && y0 <= y1);
+
+    // Find the finest level at which the rectangle spans at most 2x2 blocks.
+    size_t level = 0;
+    size_t bx0 = x0 >> 3, by0 = y0 >> 3;
+    size_t bx1 = x1 >> 3, by1 = y1 >> 3;
+    while (bx1 - bx0 > 1 || by1 - by0 > 1)
+    {
+        bx0 >>= 1; by0 >>= 1;
+        bx1 >>= 1; by1 >>= 1;
+        ++level;
+    }
+
+    uint8 opacity = 0;
+
+    for (size_t by = by0; by <= by1; ++by)
+    {
+        for (size_t bx = bx0; bx <= bx1; ++bx)
+        {
+            opacity |= get_block_opacity(level, bx, by, x0, y0, x1, y1);
+
+            if (opacity == Mixed)
+                return Mixed;
+        }
+    }
+
+    return static_cast<Opacity>(opacity);
+}
+
+uint8 AlphaMask::get_block_opacity(
+    const size_t        level,
+    const size_t        bx,
+    const size_t        by,
+    const size_t        x0,
+    const size_t        y0,
+    const size_t        x1,
+    const size_t        y1) const
+{
+    const uint8 opacity = m_levels[level][by * m_level_widths[level] + bx];
+
+    // The block is entirely opaque or transparent.
+    if (opacity != Mixed)
+        return opacity;
+
+    if (level == 0)
+    {
+        // Look at the texels of the tile covered by the rectangle.
+        const size_t tx = bx * 8;
+        const size_t ty = by * 8;
+        const uint64 rect =
+            make_rectangle_mask(
+                max(x0, tx) - tx,
+                max(y0, ty) - ty,
+                min(x1, tx + 7) - tx,
+                min(y1, ty + 7) - ty);
+        const uint64 bits = m_mixed_tiles[m_tiles[by * m_tile_count_x + bx]];
+
+        uint8 result = 0;
+
+        if (bits & rect)
+            result |= Opaque;
+
+        if (~bits & rect)
+            result |= Transparent;
+
+        return result;
+    }
+
+    // Recurse into the child blocks covered by the rectangle.
+    const size_t child_shift = 3 + level - 1;
+    const size_t cx0 = max(bx * 2, x0 >> child_shift);
+    const size_t cy0 = max(by * 2, y0 >> child_shift);
+    const size_t cx1 = min(bx * 2 + 1, x1 >> child_shift);
+    const size_t cy1 = min(by * 2 + 1, y1 >> child_shift);
+
+    uint8 result = 0;
+
+    for (size_t cy = cy0; cy <= cy1; ++cy)
+    {
+        for (size_t cx = cx0; cx <= cx1; ++cx)
+        {
+            result |= get_block_opacity(level - 1, cx, cy, x0, y0, x1, y1);
+
+            if (result == Mixed)
+                return Mixed;
+        }
+    }
+
+    return result;
+}
+
+uint64 AlphaMask::compute_hash() const
+{
+    uint64 hash = siphash24(siphash24(m_width), siphash24(m_height));
+
+    hash = siphash24(hash, siphash24(&m_tiles[0], m_tiles.size() * sizeof(uint32)));
+
+    if (!m_mixed_tiles.empty())
+        hash = siphash24(hash, siphash24(&m_mixed_tiles[0], m_mixed_tiles.size() * sizeof(uint64)));
+
+    return hash;
+}
+
+size_t AlphaMask::get_memory_size() const
+{
+    size_t size =
+          sizeof(*this)
+        + m_tiles.capacity() * sizeof(uint32)
+        + m_mixed_tiles.capacity() * sizeof(uint64)
+        + m_level_widths.capacity() * sizeof(size_t)
+        + m_levels.capacity() * sizeof(vector<uint8>);
+
+    for (size_t i = 0; i < m_levels.size(); ++i)
+        size += m_levels[i].capacity() * sizeof(uint8);
+
+    return size;
+}
+
+}   // namespace renderer
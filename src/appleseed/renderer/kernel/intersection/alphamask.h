@@ -0,0 +1,174 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
+#define APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class BitMask2; }
+
+namespace renderer
+{
+
+//
+// A binary opacity mask.
+//
+// The mask is split into tiles of 8x8 texels. Tiles that are entirely opaque or
+// entirely transparent are stored as a single flag; other tiles are stored as a
+// 64-bit mask. On top of the tiles, a hierarchy of opacity levels (the opacity of
+// blocks of 2x2 tiles, of 4x4 tiles, etc.) allows to find out cheaply whether a
+// whole rectangle of texels is opaque, transparent or mixed.
+//
+
+class AlphaMask
+  : public foundation::NonCopyable
+{
+  public:
+    // Opacity of a set of texels.
+    enum Opacity
+    {
+        Transparent = 1,
+        Opaque      = 2,
+        Mixed       = Transparent | Opaque
+    };
+
+    // Constructor. Set bits of the input mask are opaque texels.
+    explicit AlphaMask(const foundation::BitMask2& bitmask);
+
+    size_t get_width() const;
+    size_t get_height() const;
+
+    // Return the ratio of transparent texels to the total number of texels.
+    double get_transparency() const;
+
+    // Lookup the mask at a given point.
+    bool is_opaque(const foundation::Vector2f& uv) const;
+    bool is_transparent(const foundation::Vector2f& uv) const;
+
+    // Return the opacity of the texels covered by a given rectangle.
+    Opacity get_opacity(
+        const foundation::Vector2f& uv_min,
+        const foundation::Vector2f& uv_max) const;
+
+    // Compute a hash of the contents of the mask.
+    foundation::uint64 compute_hash() const;
+
+    size_t get_memory_size() const;
+
+  private:
+    static const foundation::uint32 OpaqueTile = ~foundation::uint32(0);
+    static const foundation::uint32 TransparentTile = ~foundation::uint32(0) - 1;
+
+    const size_t                                    m_width;
+    const size_t                                    m_height;
+    const size_t                                    m_tile_count_x;
+    const float                                     m_max_x;
+    const float                                     m_max_y;
+    double                                          m_transparency;
+    std::vector<foundation::uint32>                 m_tiles;            // OpaqueTile, TransparentTile or index into m_mixed_tiles
+    std::vector<foundation::uint64>                 m_mixed_tiles;      // one bit per texel, row by row
+    std::vector<size_t>                             m_level_widths;
+    std::vector<std::vector<foundation::uint8>>     m_levels;           // opacity of blocks of 2^level x 2^level tiles
+
+    size_t get_x(const float u) const;
+    size_t get_y(const float v) const;
+
+    foundation::uint8 get_block_opacity(
+        const size_t            level,
+        const size_t            bx,
+        const size_t            by,
+        const size_t            x0,
+        const size_t            y0,
+        const size_t            x1,
+        const size_t            y1) const;
+};
+
+
+//
+// AlphaMask class implementation.
+//
+
+inline size_t AlphaMask::get_width() const
+{
+    return m_width;
+}
+
+inline size_t AlphaMask::get_height() const
+{
+    return m_height;
+}
+
+inline double AlphaMask::get_transparency() const
+{
+    return m_transparency;
+}
+
+inline size_t AlphaMask::get_x(const float u) const
+{
+    return foundation::truncate<size_t>(foundation::clamp(u * m_width, 0.0f, m_max_x));
+}
+
+inline size_t AlphaMask::get_y(const float v) const
+{
+    return foundation::truncate<size_t>(foundation::clamp(v * m_height, 0.0f, m_max_y));
+}
+
+inline bool AlphaMask::is_opaque(const foundation::Vector2f& uv) const
+{
+    const size_t ix = get_x(uv[0]);
+    const size_t iy = get_y(uv[1]);
+
+    const foundation::uint32 tile = m_tiles[(iy >> 3) * m_tile_count_x + (ix >> 3)];
+
+    if (tile == OpaqueTile)
+        return true;
+
+    if (tile == TransparentTile)
+        return false;
+
+    return ((m_mixed_tiles[tile] >> ((iy & 7) * 8 + (ix & 7))) & 1) != 0;
+}
+
+inline bool AlphaMask::is_transparent(const foundation::Vector2f& uv) const
+{
+    return !is_opaque(uv);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_ALPHAMASK_H
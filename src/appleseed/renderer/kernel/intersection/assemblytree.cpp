@@ -44,6 +44,7 @@
 #include "renderer/modeling/object/regionkit.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
 #include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/proceduralassembly.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/utility/bbox.h"
 
@@ -80,11 +81,13 @@ namespace renderer
 // AssemblyTree class implementation.
 //
 
-AssemblyTree::AssemblyTree(const Scene& scene)
+AssemblyTree::AssemblyTree(
+    const Scene&    scene,
+    const size_t    thread_count)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_scene(scene)
 {
-    update();
+    update(thread_count);
 }
 
 AssemblyTree::~AssemblyTree()
@@ -92,9 +95,9 @@ AssemblyTree::~AssemblyTree()
     RENDERER_LOG_INFO("deleting assembly tree...");
 }
 
-void AssemblyTree::update()
+void AssemblyTree::update(const size_t thread_count)
 {
-    rebuild_assembly_tree();
+    rebuild_assembly_tree(thread_count);
     update_tree_hierarchy();
 }
 
@@ -104,10 +107,34 @@ size_t AssemblyTree::get_memory_size() const
           TreeType::get_memory_size()
         - sizeof(*static_cast<const TreeType*>(this))
         + sizeof(*this)
-        + m_items.capacity() * sizeof(AssemblyInstance*)
+        + get_instance_memory_size()
         + m_assembly_versions.size() * sizeof(pair<UniqueID, VersionID>);
 }
 
+size_t AssemblyTree::get_instance_memory_size() const
+{
+    size_t size = m_items.capacity() * sizeof(Item);
+
+    for (const_each<TransformSequenceDeque> i = m_transform_sequences; i; ++i)
+        size += i->get_memory_size();
+
+    return size;
+}
+
+namespace
+{
+    const ProceduralAssembly* get_pending_procedural_assembly(const Assembly& assembly)
+    {
+        const ProceduralAssembly* procedural_assembly =
+            dynamic_cast<const ProceduralAssembly*>(&assembly);
+
+        return
+            procedural_assembly != 0 && procedural_assembly->is_expansion_pending()
+                ? procedural_assembly
+                : 0;
+    }
+}
+
 void AssemblyTree::collect_assembly_instances(
     const AssemblyInstanceContainer&    assembly_instances,
     const TransformSequence&            parent_transform_seq,
@@ -132,16 +159,17 @@ void AssemblyTree::collect_assembly_instances(
             cumulated_transform_seq,
             assembly_instance_bboxes);
 
-        // Skip empty assemblies.
-        if (assembly.object_instances().empty())
+        // Skip empty assemblies, unless their contents have not been expanded yet.
+        if (assembly.object_instances().empty() && get_pending_procedural_assembly(assembly) == 0)
             continue;
 
         // Create and store an item for this assembly instance.
+        m_transform_sequences.push_back(cumulated_transform_seq);
         m_items.push_back(
             Item(
                 &assembly,
                 &assembly_instance,
-                cumulated_transform_seq));
+                &m_transform_sequences.back()));
 
         // Compute and store the assembly instance bounding box.
         AABB3d assembly_instance_bbox(
@@ -152,11 +180,12 @@ void AssemblyTree::collect_assembly_instances(
     }
 }
 
-void AssemblyTree::rebuild_assembly_tree()
+void AssemblyTree::rebuild_assembly_tree(const size_t thread_count)
 {
     // Clear the current tree.
     clear();
     m_items.clear();
+    m_transform_sequences.clear();
 
     Statistics statistics;
 
@@ -182,12 +211,25 @@ void AssemblyTree::rebuild_assembly_tree()
         AssemblyTreeTriangleIntersectionCost);
 
     // Build the assembly tree.
-    typedef bvh::Builder<AssemblyTree, Partitioner> Builder;
+    typedef bvh::ParallelBuilder<AssemblyTree, Partitioner> Builder;
     Builder builder;
-    builder.build<DefaultWallclockTimer>(*this, partitioner, m_items.size(), AssemblyTreeMaxLeafSize);
+    builder.build<DefaultWallclockTimer>(
+        *this,
+        partitioner,
+        m_items.size(),
+        AssemblyTreeMaxLeafSize,
+        global_logger(),
+        thread_count > 0 ? thread_count : System::get_logical_cpu_core_count());
     statistics.insert_time("build time", builder.get_build_time());
     statistics.merge(bvh::TreeStatistics<AssemblyTree>(*this, AABB3d(m_scene.compute_bbox())));
 
+    if (!m_items.empty())
+    {
+        statistics.insert_size(
+            "memory per instance",
+            (TreeType::get_memory_size() + get_instance_memory_size()) / m_items.size());
+    }
+
     if (!m_items.empty())
     {
         const vector<size_t>& ordering = partitioner.get_item_ordering();
@@ -362,6 +404,41 @@ namespace
         return hash;
     }
 
+    void collect_regions(const Assembly& assembly, RegionInfoVector& regions);
+
+    TriangleTree::Arguments make_triangle_tree_arguments(
+        const Scene&        scene,
+        const Assembly&     assembly)
+    {
+        // Compute the assembly space bounding box of the assembly.
+        const GAABB3 assembly_bbox =
+            compute_parent_bbox<GAABB3>(
+                assembly.object_instances().begin(),
+                assembly.object_instances().end());
+
+        RegionInfoVector regions;
+        collect_regions(assembly, regions);
+
+        return
+            TriangleTree::Arguments(
+                scene,
+                assembly.get_uid(),
+                assembly_bbox,
+                assembly,
+                regions);
+    }
+
+    bool is_deferred(Lazy<TriangleTree>& tree)
+    {
+        return dynamic_cast<DeferredTriangleTreeFactory*>(tree.get_factory()) != 0;
+    }
+
+    template <typename TreeType>
+    bool is_deferred(Lazy<TreeType>&)
+    {
+        return false;
+    }
+
     void collect_regions(const Assembly& assembly, RegionInfoVector& regions)
     {
         assert(regions.empty());
@@ -405,6 +482,14 @@ namespace
 
 void AssemblyTree::create_child_trees(const Assembly& assembly)
 {
+    // Procedural assemblies whose expansion is deferred get a placeholder triangle tree.
+    const ProceduralAssembly* procedural_assembly = get_pending_procedural_assembly(assembly);
+    if (procedural_assembly)
+    {
+        create_deferred_triangle_tree(*procedural_assembly);
+        return;
+    }
+
     // Create a region or a triangle tree if there are mesh objects.
     if (has_object_instances_of_type(assembly, MeshObjectFactory::get_model()))
     {
@@ -446,23 +531,29 @@ void AssemblyTree::create_triangle_tree(const Assembly& assembly)
 
     if (tree == 0)
     {
-        // Compute the assembly space bounding box of the assembly.
-        const GAABB3 assembly_bbox =
-            compute_parent_bbox<GAABB3>(
-                assembly.object_instances().begin(),
-                assembly.object_instances().end());
+        auto_ptr<ILazyFactory<TriangleTree>> triangle_tree_factory(
+            new TriangleTreeFactory(
+                make_triangle_tree_arguments(m_scene, assembly)));
 
-        RegionInfoVector regions;
-        collect_regions(assembly, regions);
+        tree = new Lazy<TriangleTree>(triangle_tree_factory);
+        m_triangle_tree_repository.insert(hash, tree);
+    }
 
+    m_triangle_trees.insert(make_pair(assembly.get_uid(), tree));
+}
+
+void AssemblyTree::create_deferred_triangle_tree(const ProceduralAssembly& assembly)
+{
+    // Deferred trees are never shared: key them by the UID of their assembly.
+    const uint64 values[2] = { 0x6465666572726564ULL, assembly.get_uid() };
+    const uint64 hash = siphash24(&values, sizeof(values));
+
+    Lazy<TriangleTree>* tree = m_triangle_tree_repository.acquire(hash);
+
+    if (tree == 0)
+    {
         auto_ptr<ILazyFactory<TriangleTree>> triangle_tree_factory(
-            new TriangleTreeFactory(
-                TriangleTree::Arguments(
-                    m_scene,
-                    assembly.get_uid(),
-                    assembly_bbox,
-                    assembly,
-                    regions)));
+            new DeferredTriangleTreeFactory(m_scene, assembly));
 
         tree = new Lazy<TriangleTree>(triangle_tree_factory);
         m_triangle_tree_repository.insert(hash, tree);
@@ -543,6 +634,10 @@ namespace
     {
         void operator()(Lazy<TreeType>& tree, const size_t ref_count)
         {
+            // Don't force the expansion of deferred procedural assemblies.
+            if (is_deferred(tree))
+                return;
+
             Access<TreeType> update(&tree);
 
             const bool enable_intersection_filters = ref_count == 1;
@@ -564,6 +659,46 @@ void AssemblyTree::update_triangle_trees()
 }
 
 
+//
+// DeferredTriangleTreeFactory class implementation.
+//
+
+DeferredTriangleTreeFactory::DeferredTriangleTreeFactory(
+    const Scene&                scene,
+    const ProceduralAssembly&   assembly)
+  : m_scene(scene)
+  , m_assembly(const_cast<ProceduralAssembly&>(assembly))
+  , m_has_no_tree(false)
+{
+}
+
+auto_ptr<TriangleTree> DeferredTriangleTreeFactory::create()
+{
+    if (m_has_no_tree)
+        return auto_ptr<TriangleTree>();
+
+    if (!m_assembly.expand_deferred_contents())
+    {
+        // Retry on next access only if the expansion could not be attempted yet.
+        m_has_no_tree = !m_assembly.is_expansion_pending();
+        return auto_ptr<TriangleTree>();
+    }
+
+    if (!has_object_instances_of_type(m_assembly, MeshObjectFactory::get_model()))
+    {
+        m_has_no_tree = true;
+        return auto_ptr<TriangleTree>();
+    }
+
+    auto_ptr<TriangleTree> tree(
+        new TriangleTree(make_triangle_tree_arguments(m_scene, m_assembly)));
+
+    // The tree is never shared, enable intersection filters.
+    tree->update_non_geometry(true);
+
+    return tree;
+}
+
 //
 // Utility function to transform a ray to the space of an assembly instance.
 //
@@ -650,7 +785,7 @@ bool AssemblyLeafVisitor::visit(
 
         // Evaluate the transformation of the assembly instance.
         const TransformSequence* assembly_instance_transform_seq =
-            &item.m_transform_sequence;
+            item.m_transform_sequence;
         Transformd scratch;
         const Transformd& assembly_instance_transform =
             assembly_instance_transform_seq->evaluate(ray.m_time.m_absolute, scratch);
@@ -814,7 +949,7 @@ bool AssemblyLeafProbeVisitor::visit(
         // Evaluate the transformation of the assembly instance.
         Transformd scratch;
         const Transformd& assembly_instance_transform =
-            item.m_transform_sequence.evaluate(ray.m_time.m_absolute, scratch);
+            item.m_transform_sequence->evaluate(ray.m_time.m_absolute, scratch);
 
         // Transform the ray to assembly instance space.
         ShadingRay local_ray;
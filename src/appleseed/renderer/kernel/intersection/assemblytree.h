@@ -46,17 +46,21 @@
 #include "foundation/math/aabb.h"
 #include "foundation/math/bvh.h"
 #include "foundation/utility/alignedvector.h"
+#include "foundation/utility/lazy.h"
 #include "foundation/utility/uid.h"
 #include "foundation/utility/version.h"
 
 // Standard headers.
 #include <cstddef>
+#include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 
 // Forward declarations.
 namespace foundation    { class Statistics; }
 namespace renderer      { class AssemblyInstance; }
+namespace renderer      { class ProceduralAssembly; }
 namespace renderer      { class Scene; }
 namespace renderer      { class ShadingPoint; }
 
@@ -76,13 +80,17 @@ class AssemblyTree
 {
   public:
     // Constructor, builds the tree for a given scene.
-    explicit AssemblyTree(const Scene& scene);
+    // A thread count of 0 uses one thread per logical CPU core.
+    AssemblyTree(
+        const Scene&    scene,
+        const size_t    thread_count);
 
     // Destructor.
     ~AssemblyTree();
 
     // Update the assembly tree and all the child trees.
-    void update();
+    // A thread count of 0 uses one thread per logical CPU core.
+    void update(const size_t thread_count);
 
     // Return the size (in bytes) of this object in memory.
     size_t get_memory_size() const;
@@ -92,19 +100,22 @@ class AssemblyTree
     friend class AssemblyLeafProbeVisitor;
     friend class Intersector;
 
+    // Items are kept small and trivially copyable so that several of them fit in a leaf
+    // node and that reordering millions of them is cheap. The cumulated transform
+    // sequences they point to are owned by the tree.
     struct Item
     {
         const renderer::Assembly*               m_assembly;
         foundation::UniqueID                    m_assembly_uid;
         const renderer::AssemblyInstance*       m_assembly_instance;
-        renderer::TransformSequence             m_transform_sequence;
+        const renderer::TransformSequence*      m_transform_sequence;
 
         Item() {}
 
         Item(
             const renderer::Assembly*           assembly,
             const renderer::AssemblyInstance*   assembly_instance,
-            renderer::TransformSequence         transform_sequence)
+            const renderer::TransformSequence*  transform_sequence)
           : m_assembly(assembly)
           , m_assembly_uid(assembly->get_uid())
           , m_assembly_instance(assembly_instance)
@@ -114,12 +125,14 @@ class AssemblyTree
     };
 
     typedef std::vector<Item> ItemVector;
+    typedef std::deque<TransformSequence> TransformSequenceDeque;
     typedef std::vector<foundation::AABB3d> AABBVector;
     typedef std::vector<const Assembly*> AssemblyVector;
     typedef std::map<foundation::UniqueID, foundation::VersionID> AssemblyVersionMap;
 
     const Scene&                    m_scene;
     ItemVector                      m_items;
+    TransformSequenceDeque          m_transform_sequences;
     AssemblyVersionMap              m_assembly_versions;
 
     TreeRepository<TriangleTree>    m_triangle_tree_repository;
@@ -136,7 +149,10 @@ class AssemblyTree
         const TransformSequence&                parent_transform_seq,
         AABBVector&                             assembly_instance_bboxes);
 
-    void rebuild_assembly_tree();
+    // Return the size (in bytes) of the assembly instance items and their transform sequences.
+    size_t get_instance_memory_size() const;
+
+    void rebuild_assembly_tree(const size_t thread_count);
     void store_items_in_leaves(foundation::Statistics& statistics);
 
     void update_tree_hierarchy();
@@ -146,6 +162,7 @@ class AssemblyTree
     void create_child_trees(const Assembly& assembly);
     void create_region_tree(const Assembly& assembly);
     void create_triangle_tree(const Assembly& assembly);
+    void create_deferred_triangle_tree(const ProceduralAssembly& assembly);
     void create_curve_tree(const Assembly& assembly);
 
     void delete_child_trees(const foundation::UniqueID assembly_id);
@@ -158,6 +175,35 @@ class AssemblyTree
 };
 
 
+//
+// Triangle tree factory for procedural assemblies whose expansion is deferred:
+// the contents of the assembly are expanded the first time the tree is accessed,
+// i.e. the first time a ray hits the bounding box of one of its instances.
+//
+
+class DeferredTriangleTreeFactory
+  : public foundation::ILazyFactory<TriangleTree>
+{
+  public:
+    // Constructor.
+    DeferredTriangleTreeFactory(
+        const Scene&                scene,
+        const ProceduralAssembly&   assembly);
+
+    // Expand the assembly and create its triangle tree. Return an empty pointer if the
+    // expansion failed or if the assembly contains no mesh; this outcome is remembered
+    // until the contents of the assembly are discarded at the end of the render, which
+    // causes the factory to be replaced. An expansion that could not be attempted yet
+    // is retried on the next call.
+    virtual std::auto_ptr<TriangleTree> create() override;
+
+  private:
+    const Scene&            m_scene;
+    ProceduralAssembly&     m_assembly;
+    bool                    m_has_no_tree;
+};
+
+
 //
 // Assembly leaf visitor, used during tree intersection.
 //
@@ -45,10 +45,13 @@
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/bitmask.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/lazy.h"
 
 // Standard headers.
+#include <map>
 #include <memory>
 
 using namespace foundation;
@@ -117,47 +120,21 @@ IntersectionFilter::IntersectionFilter(
     Object&                 object,
     const MaterialArray&    materials,
     TextureCache&           texture_cache)
-  : m_obj_alpha_mask(0)
-  , m_obj_alpha_map_signature(0)
+  : m_obj_alpha_map_signature(0)
 {
     // Initialize the material -> alpha mask mapping.
     m_material_alpha_map_signatures.assign(materials.size(), 0);
-    m_material_alpha_masks.assign(materials.size(), 0);
+    m_material_alpha_masks.resize(materials.size());
 
     // Create alpha masks.
     update(object, materials, texture_cache);
-
-    if (has_alpha_masks())
-    {
-        // Make a local copy of the object's UV coordinates.
-        m_uv.reserve(get_triangle_count(object) * 3);
-        copy_uv_coordinates(object, m_uv);
-    }
-}
-
-IntersectionFilter::~IntersectionFilter()
-{
-    delete m_obj_alpha_mask;
-
-    for (size_t i = 0; i < m_material_alpha_masks.size(); ++i)
-        delete m_material_alpha_masks[i];
-}
-
-namespace
-{
-    template <typename T>
-    void delete_and_clear(T*& ptr)
-    {
-        delete ptr;
-        ptr = 0;
-    }
 }
 
 template <typename EntityType>
 void IntersectionFilter::do_update(
     const EntityType&               entity,
     TextureCache&                   texture_cache,
-    IntersectionFilter::AlphaMask*& mask,
+    AlphaMaskPtr&                   mask,
     uint64&                         signature)
 {
     // Use the uncached version of get_alpha_map() since at this point
@@ -168,38 +145,32 @@ void IntersectionFilter::do_update(
 
     if (alpha_map == 0)
     {
-        delete_and_clear(mask);
+        mask.reset();
         return;
     }
 
     // Don't do anything if there is already an alpha mask and it is up-to-date.
     const uint64 alpha_map_sig = alpha_map->compute_signature();
-    if (mask != 0 && alpha_map_sig == signature)
+    if (mask && alpha_map_sig == signature)
         return;
 
-    // Build the alpha mask.
-    double transparency;
-    auto_ptr<AlphaMask> alpha_mask(
-        create_alpha_mask(
-            alpha_map,
-            texture_cache,
-            transparency));
+    // Retrieve or build the alpha mask.
+    AlphaMaskPtr alpha_mask = get_alpha_mask(alpha_map, alpha_map_sig, texture_cache);
 
     // Discard the alpha mask if it's mostly opaque.
-    if (transparency < 5.0 / 100)
+    if (alpha_mask->get_transparency() < 5.0 / 100)
     {
-        delete_and_clear(mask);
+        mask.reset();
         return;
     }
 
     // Store the alpha mask.
-    delete mask;
-    mask = alpha_mask.release();
+    mask = alpha_mask;
     signature = alpha_map_sig;
 }
 
 void IntersectionFilter::update(
-    const Object&           object,
+    Object&                 object,
     const MaterialArray&    materials,
     TextureCache&           texture_cache)
 {
@@ -219,7 +190,20 @@ void IntersectionFilter::update(
                 m_material_alpha_map_signatures[i]);
         }
         else
-            delete_and_clear(m_material_alpha_masks[i]);
+            m_material_alpha_masks[i].reset();
+    }
+
+    if (has_alpha_masks())
+    {
+        // Make a local copy of the object's UV coordinates.
+        if (m_uv.empty())
+        {
+            m_uv.reserve(get_triangle_count(object) * 3);
+            copy_uv_coordinates(object, m_uv);
+        }
+
+        // Find out which triangles are entirely opaque or transparent.
+        classify_triangles(object);
     }
 }
 
@@ -255,13 +239,81 @@ size_t IntersectionFilter::get_masks_memory_size() const
 
 size_t IntersectionFilter::get_uv_memory_size() const
 {
-    return m_uv.capacity() * sizeof(Vector2f);
+    return
+          m_uv.capacity() * sizeof(Vector2f)
+        + m_triangle_opacities.capacity() * sizeof(uint8);
 }
 
-IntersectionFilter::AlphaMask* IntersectionFilter::create_alpha_mask(
+namespace
+{
+    //
+    // Alpha masks are shared process-wide. They are indexed both by the signature
+    // of their alpha map, so that masks are only built once per alpha map, and by
+    // a hash of their contents, so that identical masks are only stored once.
+    //
+
+    typedef map<uint64, weak_ptr<const AlphaMask>> AlphaMaskCache;
+
+    AlphaMaskCache g_alpha_masks_by_signature;
+    AlphaMaskCache g_alpha_masks_by_hash;
+    boost::mutex g_alpha_mask_cache_mutex;
+
+    shared_ptr<const AlphaMask> find_alpha_mask(
+        AlphaMaskCache&     cache,
+        const uint64        key)
+    {
+        const AlphaMaskCache::const_iterator i = cache.find(key);
+        return i != cache.end() ? i->second.lock() : shared_ptr<const AlphaMask>();
+    }
+
+    void remove_expired_alpha_masks(AlphaMaskCache& cache)
+    {
+        for (AlphaMaskCache::iterator i = cache.begin(); i != cache.end(); )
+        {
+            if (i->second.expired())
+                cache.erase(i++);
+            else ++i;
+        }
+    }
+}
+
+IntersectionFilter::AlphaMaskPtr IntersectionFilter::get_alpha_mask(
+    const Source*           alpha_map,
+    const uint64            alpha_map_signature,
+    TextureCache&           texture_cache)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(g_alpha_mask_cache_mutex);
+
+        if (AlphaMaskPtr mask = find_alpha_mask(g_alpha_masks_by_signature, alpha_map_signature))
+            return mask;
+    }
+
+    // Build the alpha mask outside of the lock since it may take a while.
+    AlphaMaskPtr mask(create_alpha_mask(alpha_map, texture_cache));
+    const uint64 mask_hash = mask->compute_hash();
+
+    boost::lock_guard<boost::mutex> lock(g_alpha_mask_cache_mutex);
+
+    remove_expired_alpha_masks(g_alpha_masks_by_signature);
+    remove_expired_alpha_masks(g_alpha_masks_by_hash);
+
+    // Reuse an identical alpha mask if there is one.
+    AlphaMaskPtr existing_mask = find_alpha_mask(g_alpha_masks_by_hash, mask_hash);
+    if (existing_mask &&
+        existing_mask->get_width() == mask->get_width() &&
+        existing_mask->get_height() == mask->get_height())
+        mask = existing_mask;
+    else g_alpha_masks_by_hash[mask_hash] = mask;
+
+    g_alpha_masks_by_signature[alpha_map_signature] = mask;
+
+    return mask;
+}
+
+AlphaMask* IntersectionFilter::create_alpha_mask(
     const Source*           alpha_map,
-    TextureCache&           texture_cache,
-    double&                 transparency)
+    TextureCache&           texture_cache)
 {
     assert(alpha_map);
 
@@ -280,12 +332,10 @@ IntersectionFilter::AlphaMask* IntersectionFilter::create_alpha_mask(
         height = 1;
     }
 
-    // Create and initialize the alpha mask.
-    AlphaMask* alpha_mask = new AlphaMask(width, height);
+    BitMask2 bitmask(width, height);
 
     const float rcp_width = 1.0f / width;
     const float rcp_height = 1.0f / height;
-    size_t transparent_texel_count = 0;
 
     // Compute the alpha mask.
     for (size_t y = 0; y < height; ++y)
@@ -300,18 +350,56 @@ IntersectionFilter::AlphaMask* IntersectionFilter::create_alpha_mask(
             alpha_map->evaluate(texture_cache, uv, alpha);
 
             // Mark this texel as opaque or transparent in the alpha mask.
-            const bool opaque = alpha[0] > 0.0f;
-            alpha_mask->set_opaque(x, y, opaque);
-
-            // Keep track of the number of transparent texels.
-            transparent_texel_count += opaque ? 0 : 1;
+            bitmask.set(x, y, alpha[0] > 0.0f);
         }
     }
 
-    // Compute the ratio of transparent texels to the total number of texels.
-    transparency = static_cast<double>(transparent_texel_count) / (width * height);
+    return new AlphaMask(bitmask);
+}
+
+void IntersectionFilter::classify_triangles(Object& object)
+{
+    m_triangle_opacities.clear();
+    m_triangle_opacities.reserve(m_uv.size() / 3);
+
+    Access<RegionKit> region_kit(&object.get_region_kit());
+
+    for (const_each<RegionKit> i = *region_kit; i; ++i)
+    {
+        const IRegion* region = *i;
+        Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
+
+        for (const_each<StaticTriangleTess::PrimitiveArray> j = tess->m_primitives; j; ++j)
+        {
+            const size_t triangle_index = m_triangle_opacities.size();
+            const Vector2f& uv0 = m_uv[triangle_index * 3 + 0];
+            const Vector2f& uv1 = m_uv[triangle_index * 3 + 1];
+            const Vector2f& uv2 = m_uv[triangle_index * 3 + 2];
+
+            // Any point of the triangle lies within the bounding rectangle of its texture coordinates.
+            const Vector2f uv_min = component_wise_min(component_wise_min(uv0, uv1), uv2);
+            const Vector2f uv_max = component_wise_max(component_wise_max(uv0, uv1), uv2);
+
+            // A hit is accepted if both the object and the material alpha masks are opaque.
+            const AlphaMask* mtl_alpha_mask =
+                j->m_pa < m_material_alpha_masks.size() ? m_material_alpha_masks[j->m_pa].get() : 0;
+            const AlphaMask::Opacity obj_opacity =
+                m_obj_alpha_mask ? m_obj_alpha_mask->get_opacity(uv_min, uv_max) : AlphaMask::Opaque;
+            const AlphaMask::Opacity mtl_opacity =
+                mtl_alpha_mask ? mtl_alpha_mask->get_opacity(uv_min, uv_max) : AlphaMask::Opaque;
+
+            AlphaMask::Opacity opacity;
+            if (obj_opacity == AlphaMask::Transparent || mtl_opacity == AlphaMask::Transparent)
+                opacity = AlphaMask::Transparent;
+            else if (obj_opacity == AlphaMask::Opaque && mtl_opacity == AlphaMask::Opaque)
+                opacity = AlphaMask::Opaque;
+            else opacity = AlphaMask::Mixed;
+
+            m_triangle_opacities.push_back(static_cast<uint8>(opacity));
+        }
+    }
 
-    return alpha_mask;
+    assert(m_triangle_opacities.size() * 3 == m_uv.size());
 }
 
 }   // namespace renderer
@@ -31,18 +31,18 @@
 #define APPLESEED_RENDERER_KERNEL_INTERSECTION_INTERSECTIONFILTER_H
 
 // appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamask.h"
 #include "renderer/kernel/intersection/trianglekey.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
-#include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/types.h"
-#include "foundation/utility/bitmask.h"
 
 // Standard headers.
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 // Forward declarations.
@@ -54,6 +54,15 @@ namespace renderer  { class TextureCache; }
 namespace renderer
 {
 
+//
+// Filters intersections against the alpha maps of an object and of its materials.
+//
+// Alpha masks are shared between all intersection filters referencing the same
+// alpha map, or alpha maps leading to identical masks, including across assemblies.
+// Triangles whose texture coordinates only cover fully opaque or fully transparent
+// texels are classified once so that alpha masks are never looked up for them.
+//
+
 class IntersectionFilter
   : public foundation::NonCopyable
 {
@@ -63,10 +72,8 @@ class IntersectionFilter
         const MaterialArray&    materials,
         TextureCache&           texture_cache);
 
-    ~IntersectionFilter();
-
     void update(
-        const Object&           object,
+        Object&                 object,
         const MaterialArray&    materials,
         TextureCache&           texture_cache);
 
@@ -81,71 +88,32 @@ class IntersectionFilter
         const double            v) const;
 
   private:
-    class AlphaMask
-      : public foundation::NonCopyable
-    {
-      public:
-        AlphaMask(
-            const size_t        width,
-            const size_t        height)
-          : m_max_x(static_cast<float>(width) - 1.0f)
-          , m_max_y(static_cast<float>(height) - 1.0f)
-          , m_bitmask(width, height)
-        {
-        }
-
-        void set_opaque(
-            const size_t        x,
-            const size_t        y,
-            const bool          opaque)
-        {
-            m_bitmask.set(x, y, opaque);
-        }
-
-        bool is_opaque(const foundation::Vector2f& uv) const
-        {
-            const float fx = foundation::clamp(uv[0] * m_bitmask.get_width(), 0.0f, m_max_x);
-            const float fy = foundation::clamp(uv[1] * m_bitmask.get_height(), 0.0f, m_max_y);
-
-            const size_t ix = foundation::truncate<size_t>(fx);
-            const size_t iy = foundation::truncate<size_t>(fy);
-
-            return m_bitmask.is_set(ix, iy);
-        }
-
-        bool is_transparent(const foundation::Vector2f& uv) const
-        {
-            return !is_opaque(uv);
-        }
-
-        size_t get_memory_size() const
-        {
-            return m_bitmask.get_memory_size();
-        }
-
-      private:
-        const float             m_max_x;
-        const float             m_max_y;
-        foundation::BitMask2    m_bitmask;
-    };
+    typedef std::shared_ptr<const AlphaMask> AlphaMaskPtr;
 
     foundation::uint64                  m_obj_alpha_map_signature;
-    AlphaMask*                          m_obj_alpha_mask;
+    AlphaMaskPtr                        m_obj_alpha_mask;
     std::vector<foundation::uint64>     m_material_alpha_map_signatures;
-    std::vector<AlphaMask*>             m_material_alpha_masks;
+    std::vector<AlphaMaskPtr>           m_material_alpha_masks;
     std::vector<foundation::Vector2f>   m_uv;
+    std::vector<foundation::uint8>      m_triangle_opacities;   // AlphaMask::Opacity of each triangle
 
     template <typename EntityType>
     static void do_update(
         const EntityType&               entity,
         TextureCache&                   texture_cache,
-        IntersectionFilter::AlphaMask*& mask,
+        AlphaMaskPtr&                   mask,
         foundation::uint64&             signature);
 
+    static AlphaMaskPtr get_alpha_mask(
+        const Source*               alpha_map,
+        const foundation::uint64    alpha_map_signature,
+        TextureCache&               texture_cache);
+
     static AlphaMask* create_alpha_mask(
         const Source*           alpha_map,
-        TextureCache&           texture_cache,
-        double&                 transparency);
+        TextureCache&           texture_cache);
+
+    void classify_triangles(Object& object);
 };
 
 
@@ -169,12 +137,17 @@ inline bool IntersectionFilter::accept(
     if (u != u || v != v)
         return true;
 
-    const AlphaMask* mtl_alpha_mask = m_material_alpha_masks[triangle_key.get_triangle_pa()];
+    const AlphaMask* mtl_alpha_mask = m_material_alpha_masks[triangle_key.get_triangle_pa()].get();
 
     if (m_obj_alpha_mask || mtl_alpha_mask)
     {
         const size_t triangle_index = triangle_key.get_triangle_index();
 
+        // Don't look up the alpha masks if the triangle is entirely opaque or transparent.
+        const foundation::uint8 opacity = m_triangle_opacities[triangle_index];
+        if (opacity != AlphaMask::Mixed)
+            return opacity == AlphaMask::Opaque;
+
         const float fu = static_cast<float>(u);
         const float fv = static_cast<float>(v);
 
@@ -37,6 +37,7 @@
 #include "foundation/math/beziercurve.h"
 #include "foundation/math/intersection/raytrianglemt.h"
 #include "foundation/math/matrix.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
 #include <cstddef>
@@ -106,6 +107,10 @@ const size_t TriangleTreeDefaultBinCount = 256;
 // Depth of a subtree in the van Emde Boas node layout.
 const size_t TriangleTreeSubtreeDepth = 3;
 
+// Version of the triangle tree cache file format.
+// Must be incremented whenever the layout of triangle trees or the way they are built changes.
+const foundation::uint32 TriangleTreeCacheFormatVersion = 2;
+
 // Size of the triangle tree access cache.
 const size_t TriangleTreeAccessCacheLines = 128;
 const size_t TriangleTreeAccessCacheWays = 2;
@@ -57,9 +57,11 @@ namespace renderer
 // TraceContext class implementation.
 //
 
-TraceContext::TraceContext(const Scene& scene)
+TraceContext::TraceContext(
+    const Scene&    scene,
+    const size_t    thread_count)
   : m_scene(scene)
-  , m_assembly_tree(new AssemblyTree(scene))
+  , m_assembly_tree(new AssemblyTree(scene, thread_count))
 {
     RENDERER_LOG_DEBUG(
         "data structures size:\n"
@@ -84,9 +86,9 @@ TraceContext::~TraceContext()
     delete m_assembly_tree;
 }
 
-void TraceContext::update()
+void TraceContext::update(const size_t thread_count)
 {
-    m_assembly_tree->update();
+    m_assembly_tree->update(thread_count);
 }
 
 }   // namespace renderer
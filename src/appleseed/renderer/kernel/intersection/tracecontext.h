@@ -36,6 +36,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 namespace renderer  { class AssemblyTree; }
 namespace renderer  { class Scene; }
@@ -55,7 +58,10 @@ class APPLESEED_DLLSYMBOL TraceContext
 {
   public:
     // Constructor, initializes the trace context for a given scene.
-    explicit TraceContext(const Scene& scene);
+    // A thread count of 0 uses one thread per logical CPU core.
+    explicit TraceContext(
+        const Scene&    scene,
+        const size_t    thread_count = 0);
 
     // Destructor.
     ~TraceContext();
@@ -67,7 +73,8 @@ class APPLESEED_DLLSYMBOL TraceContext
     const AssemblyTree& get_assembly_tree() const;
 
     // Synchronize the trace context with the scene.
-    void update();
+    // A thread count of 0 uses one thread per logical CPU core.
+    void update(const size_t thread_count = 0);
 
   private:
     const Scene&    m_scene;
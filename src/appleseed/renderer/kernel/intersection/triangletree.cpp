@@ -68,18 +68,32 @@
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/memory.h"
+#include "foundation/utility/siphash.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
 #include "foundation/utility/string.h"
 
+// Boost headers.
+#include "boost/filesystem.hpp"
+#include "boost/interprocess/exceptions.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <set>
+#include <sstream>
 #include <string>
 
 using namespace foundation;
 using namespace std;
+namespace bf = boost::filesystem;
+namespace bi = boost::interprocess;
 
 namespace renderer
 {
@@ -393,6 +407,75 @@ namespace
     }
 }
 
+namespace
+{
+    //
+    // Triangle trees may be cached on disk so that subsequent renders of the same geometry
+    // can skip the tree construction. A cache file is named after a hash of the geometry and
+    // of the build parameters of the tree; it is made of a header followed by the raw contents
+    // of the tree's arrays, and is memory-mapped when loaded.
+    //
+
+    const char CacheFileMagic[8] = { 'A', 'S', 'T', 'R', 'E', 'E', '\0', '\0' };
+
+    struct CacheFileHeader
+    {
+        char    m_magic[8];
+        uint32  m_version;
+        uint32  m_node_size;
+        uint64  m_key;
+        uint64  m_node_count;
+        uint64  m_node_bbox_count;
+        uint64  m_triangle_key_count;
+        uint64  m_leaf_data_size;
+        uint64  m_static_triangle_count;
+        uint64  m_moving_triangle_count;
+    };
+
+    string get_cache_directory(const ParamArray& params)
+    {
+        const string directory = params.get_optional<string>("cache_directory", "");
+
+        if (!directory.empty())
+            return directory;
+
+        const char* value = getenv("APPLESEED_ACCELERATION_STRUCTURE_CACHE");
+        return value ? value : "";
+    }
+
+    string get_cache_filename(const uint64 key)
+    {
+        stringstream sstr;
+        sstr << "triangletree-" << hex << setw(16) << setfill('0') << key << ".bin";
+        return sstr.str();
+    }
+
+    template <typename Vector>
+    uint64 hash_vector(const uint64 hash, const Vector& vec)
+    {
+        return
+            vec.empty()
+                ? hash
+                : siphash24(hash, siphash24(&vec[0], vec.size() * sizeof(vec[0])));
+    }
+
+    template <typename Vector>
+    void write_vector(ofstream& file, const Vector& vec)
+    {
+        if (!vec.empty())
+            file.write(reinterpret_cast<const char*>(&vec[0]), vec.size() * sizeof(vec[0]));
+    }
+
+    template <typename Vector>
+    void read_vector(MemoryReader& reader, Vector& vec, const size_t size)
+    {
+        vec.resize(size);
+
+        if (size > 0)
+            memcpy(&vec[0], reader.read(size * sizeof(vec[0])), size * sizeof(vec[0]));
+    }
+}
+
 TriangleTree::Arguments::Arguments(
     const Scene&            scene,
     const UniqueID          triangle_tree_uid,
@@ -423,6 +506,30 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
+    // Try to load the tree from the acceleration structure cache.
+    const string cache_directory = get_cache_directory(params);
+    string cache_path;
+    uint64 cache_key = 0;
+    if (!cache_directory.empty())
+    {
+        cache_key = compute_cache_key(params, time);
+        cache_path = (bf::path(cache_directory) / get_cache_filename(cache_key)).string();
+
+        if (load_from_cache(cache_path, cache_key))
+        {
+            RENDERER_LOG_INFO(
+                "loaded triangle tree #" FMT_UNIQUE_ID " from %s in %s (%s %s, %s %s).",
+                m_arguments.m_triangle_tree_uid,
+                cache_path.c_str(),
+                pretty_time(stopwatch.measure().get_seconds()).c_str(),
+                pretty_uint(m_static_triangle_count).c_str(),
+                plural(m_static_triangle_count, "static triangle").c_str(),
+                pretty_uint(m_moving_triangle_count).c_str(),
+                plural(m_moving_triangle_count, "moving triangle").c_str());
+            return;
+        }
+    }
+
     // Build the tree.
     Statistics statistics;
     if (algorithm == "bvh")
@@ -438,6 +545,10 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     assert(m_nodes.size() == m_nodes.capacity());
 #endif
 
+    // Store the tree into the acceleration structure cache.
+    if (!cache_path.empty())
+        save_to_cache(cache_path, cache_key);
+
     // Print triangle tree statistics.
     RENDERER_LOG_DEBUG("%s",
         StatisticsVector::make(
@@ -505,6 +616,53 @@ namespace
 
         return count;
     }
+
+    void compute_triangle_shutter_bboxes(
+        const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+        const vector<GVector3>&             triangle_vertices,
+        vector<GAABB3>&                     triangle_start_bboxes,
+        vector<GAABB3>&                     triangle_end_bboxes)
+    {
+        const size_t triangle_count = triangle_vertex_infos.size();
+
+        triangle_start_bboxes.resize(triangle_count);
+        triangle_end_bboxes.resize(triangle_count);
+
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            const TriangleVertexInfo& vertex_info = triangle_vertex_infos[i];
+            const size_t start_vertex_index = vertex_info.m_vertex_index;
+            const size_t end_vertex_index = start_vertex_index + vertex_info.m_motion_segment_count * 3;
+
+            GAABB3& start_bbox = triangle_start_bboxes[i];
+            start_bbox.invalidate();
+            start_bbox.insert(triangle_vertices[start_vertex_index + 0]);
+            start_bbox.insert(triangle_vertices[start_vertex_index + 1]);
+            start_bbox.insert(triangle_vertices[start_vertex_index + 2]);
+
+            GAABB3& end_bbox = triangle_end_bboxes[i];
+            end_bbox.invalidate();
+            end_bbox.insert(triangle_vertices[end_vertex_index + 0]);
+            end_bbox.insert(triangle_vertices[end_vertex_index + 1]);
+            end_bbox.insert(triangle_vertices[end_vertex_index + 2]);
+        }
+    }
+
+    template <typename Tree, typename Partitioner>
+    double build_tree(
+        Tree&                               tree,
+        Partitioner&                        partitioner,
+        const size_t                        triangle_count,
+        const size_t                        max_leaf_size)
+    {
+        bvh::Builder<Tree, Partitioner> builder;
+        builder.template build<DefaultWallclockTimer>(
+            tree,
+            partitioner,
+            triangle_count,
+            max_leaf_size);
+        return builder.get_build_time();
+    }
 }
 
 void TriangleTree::build_bvh(
@@ -554,22 +712,55 @@ void TriangleTree::build_bvh(
     const GScalar interior_node_traversal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
     const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
 
-    // Create the partitioner.
-    typedef bvh::SAHPartitioner<vector<GAABB3>> Partitioner;
-    Partitioner partitioner(
-        triangle_bboxes,
-        max_leaf_size,
-        interior_node_traversal_cost,
-        triangle_intersection_cost);
-
     // Build the tree.
-    typedef bvh::Builder<TriangleTree, Partitioner> Builder;
-    Builder builder;
-    builder.build<DefaultWallclockTimer>(
-        *this,
-        partitioner,
-        triangle_keys.size(),
-        max_leaf_size);
+    vector<size_t> triangle_indices;
+    vector<GVector3> triangle_vertices;
+    double partition_time;
+    if (m_moving_triangle_count > 0)
+    {
+        // Collect triangle vertices.
+        collect_triangles<GAABB3>(
+            m_arguments,
+            time,
+            save_memory,
+            0,
+            0,
+            &triangle_vertices,
+            0);
+
+        // Compute the bounding boxes of the triangles at shutter open and shutter close times.
+        vector<GAABB3> triangle_start_bboxes, triangle_end_bboxes;
+        compute_triangle_shutter_bboxes(
+            triangle_vertex_infos,
+            triangle_vertices,
+            triangle_start_bboxes,
+            triangle_end_bboxes);
+
+        // Choose splits according to the bounding boxes of the nodes over the whole shutter interval.
+        typedef bvh::MotionSAHPartitioner<vector<GAABB3>> Partitioner;
+        Partitioner partitioner(
+            triangle_bboxes,
+            triangle_start_bboxes,
+            triangle_end_bboxes,
+            max_leaf_size,
+            interior_node_traversal_cost,
+            triangle_intersection_cost);
+
+        partition_time = build_tree(*this, partitioner, triangle_keys.size(), max_leaf_size);
+        triangle_indices = partitioner.get_item_ordering();
+    }
+    else
+    {
+        typedef bvh::SAHPartitioner<vector<GAABB3>> Partitioner;
+        Partitioner partitioner(
+            triangle_bboxes,
+            max_leaf_size,
+            interior_node_traversal_cost,
+            triangle_intersection_cost);
+
+        partition_time = build_tree(*this, partitioner, triangle_keys.size(), max_leaf_size);
+        triangle_indices = partitioner.get_item_ordering();
+    }
     statistics.merge(
         bvh::TreeStatistics<TriangleTree>(*this, AABB3d(m_arguments.m_bbox)));
 
@@ -579,26 +770,28 @@ void TriangleTree::build_bvh(
     clear_release_memory(triangle_bboxes);
 
     // Collect triangle vertices.
-    vector<GVector3> triangle_vertices;
-    collect_triangles<GAABB3>(
-        m_arguments,
-        time,
-        save_memory,
-        0,
-        0,
-        &triangle_vertices,
-        0);
+    if (triangle_vertices.empty())
+    {
+        collect_triangles<GAABB3>(
+            m_arguments,
+            time,
+            save_memory,
+            0,
+            0,
+            &triangle_vertices,
+            0);
+    }
 
     // Compute and propagate motion bounding boxes.
     compute_motion_bboxes(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
         0);
 
     // Store triangles and triangle keys into the tree.
     store_triangles(
-        partitioner.get_item_ordering(),
+        triangle_indices,
         triangle_vertex_infos,
         triangle_vertices,
         triangle_keys,
@@ -607,7 +800,7 @@ void TriangleTree::build_bvh(
     const double storing_time = stopwatch.measure().get_seconds();
 
     statistics.insert_time("collection time", collection_time);
-    statistics.insert_time("partition time", builder.get_build_time());
+    statistics.insert_time("partition time", partition_time);
     statistics.insert_time("store time", storing_time);
 }
 
@@ -816,10 +1009,12 @@ vector<GAABB3> TriangleTree::compute_motion_bboxes(
         vector<GAABB3> bboxes(bbox_count);
 
         for (size_t i = 0; i < bbox_count; ++i)
-        {
-            bboxes[i] = left_bboxes[i * left_bboxes.size() / bbox_count];
-            bboxes[i].insert(right_bboxes[i * right_bboxes.size() / bbox_count]);
-        }
+            bboxes[i].invalidate();
+
+        // Children may have different numbers of motion segments: the parent path
+        // has as many keys as the finest one and bounds both children at all times.
+        insert_path<GAABB3>(left_bboxes.begin(), left_bboxes.end(), bboxes.begin(), bboxes.end());
+        insert_path<GAABB3>(right_bboxes.begin(), right_bboxes.end(), bboxes.begin(), bboxes.end());
 
         return bboxes;
     }
@@ -994,6 +1189,171 @@ void TriangleTree::store_triangles(
     statistics.insert_percent("fat leaves", fat_leaf_count, leaf_count);
 }
 
+uint64 TriangleTree::compute_cache_key(
+    const ParamArray&   params,
+    const double        time) const
+{
+    vector<TriangleKey> triangle_keys;
+    vector<TriangleVertexInfo> triangle_vertex_infos;
+    vector<GVector3> triangle_vertices;
+    collect_triangles<GAABB3>(
+        m_arguments,
+        time,
+        false,
+        &triangle_keys,
+        &triangle_vertex_infos,
+        &triangle_vertices,
+        0);
+
+    // Hash the build parameters, except the location of the cache.
+    stringstream sstr;
+    sstr << TriangleTreeCacheFormatVersion << ' ' << sizeof(NodeType);
+#ifdef RENDERER_TRIANGLE_TREE_REORDER_NODES
+    sstr << " reorder";
+#endif
+    for (const_each<StringDictionary> i = params.strings(); i; ++i)
+    {
+        if (strcmp(i->key(), "cache_directory") != 0)
+            sstr << ' ' << i->key() << '=' << i->value();
+    }
+    const string build_params = sstr.str();
+    uint64 hash = siphash24(build_params.data(), build_params.size());
+
+    // Hash the bounding box of the tree.
+    hash = siphash24(hash, siphash24(m_arguments.m_bbox));
+
+    // Hash the geometry.
+    vector<uint64> vertex_infos;
+    vertex_infos.reserve(triangle_vertex_infos.size() * 3);
+    for (const_each<vector<TriangleVertexInfo>> i = triangle_vertex_infos; i; ++i)
+    {
+        vertex_infos.push_back(i->m_vertex_index);
+        vertex_infos.push_back(i->m_motion_segment_count);
+        vertex_infos.push_back(i->m_vis_flags);
+    }
+    hash = hash_vector(hash, triangle_keys);
+    hash = hash_vector(hash, vertex_infos);
+    hash = hash_vector(hash, triangle_vertices);
+
+    return hash;
+}
+
+bool TriangleTree::load_from_cache(
+    const string&       path,
+    const uint64        key)
+{
+    try
+    {
+        if (!bf::exists(path))
+            return false;
+
+        const bi::file_mapping mapping(path.c_str(), bi::read_only);
+        const bi::mapped_region region(mapping, bi::read_only);
+
+        if (region.get_size() < sizeof(CacheFileHeader))
+            return false;
+
+        CacheFileHeader header;
+        memcpy(&header, region.get_address(), sizeof(CacheFileHeader));
+
+        if (memcmp(header.m_magic, CacheFileMagic, sizeof(CacheFileMagic)) != 0 ||
+            header.m_version != TriangleTreeCacheFormatVersion ||
+            header.m_node_size != sizeof(NodeType) ||
+            header.m_key != key)
+            return false;
+
+        const uint64 expected_size =
+            sizeof(CacheFileHeader) +
+            header.m_node_count * sizeof(NodeType) +
+            header.m_node_bbox_count * sizeof(AABBType) +
+            header.m_triangle_key_count * sizeof(TriangleKey) +
+            header.m_leaf_data_size;
+
+        if (region.get_size() != expected_size)
+        {
+            RENDERER_LOG_WARNING("ignoring truncated acceleration structure cache file %s.", path.c_str());
+            return false;
+        }
+
+        MemoryReader reader(region.get_address());
+        reader += static_cast<isize_t>(sizeof(CacheFileHeader));
+
+        read_vector(reader, m_nodes, static_cast<size_t>(header.m_node_count));
+        read_vector(reader, m_node_bboxes, static_cast<size_t>(header.m_node_bbox_count));
+        read_vector(reader, m_triangle_keys, static_cast<size_t>(header.m_triangle_key_count));
+        read_vector(reader, m_leaf_data, static_cast<size_t>(header.m_leaf_data_size));
+
+        m_static_triangle_count = static_cast<size_t>(header.m_static_triangle_count);
+        m_moving_triangle_count = static_cast<size_t>(header.m_moving_triangle_count);
+
+        return true;
+    }
+    catch (const bi::interprocess_exception& e)
+    {
+        RENDERER_LOG_WARNING(
+            "failed to read acceleration structure cache file %s: %s.",
+            path.c_str(),
+            e.what());
+        return false;
+    }
+}
+
+void TriangleTree::save_to_cache(
+    const string&       path,
+    const uint64        key) const
+{
+    CacheFileHeader header;
+    memcpy(header.m_magic, CacheFileMagic, sizeof(CacheFileMagic));
+    header.m_version = TriangleTreeCacheFormatVersion;
+    header.m_node_size = static_cast<uint32>(sizeof(NodeType));
+    header.m_key = key;
+    header.m_node_count = m_nodes.size();
+    header.m_node_bbox_count = m_node_bboxes.size();
+    header.m_triangle_key_count = m_triangle_keys.size();
+    header.m_leaf_data_size = m_leaf_data.size();
+    header.m_static_triangle_count = m_static_triangle_count;
+    header.m_moving_triangle_count = m_moving_triangle_count;
+
+    // Write to a temporary file first, then move it into place, so that
+    // concurrent renders never see an incomplete cache file.
+    boost::system::error_code ec;
+    const bf::path final_path(path);
+    bf::create_directories(final_path.parent_path(), ec);
+    const bf::path temp_path = bf::unique_path(final_path.string() + ".%%%%-%%%%-%%%%.tmp", ec);
+
+    {
+        ofstream file(temp_path.string().c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        if (!file.is_open())
+        {
+            RENDERER_LOG_WARNING("failed to create acceleration structure cache file %s.", path.c_str());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_vector(file, m_nodes);
+        write_vector(file, m_node_bboxes);
+        write_vector(file, m_triangle_keys);
+        write_vector(file, m_leaf_data);
+
+        if (!file)
+        {
+            file.close();
+            bf::remove(temp_path, ec);
+            RENDERER_LOG_WARNING("failed to write acceleration structure cache file %s.", path.c_str());
+            return;
+        }
+    }
+
+    bf::rename(temp_path, final_path, ec);
+
+    if (ec)
+    {
+        bf::remove(temp_path, ec);
+        RENDERER_LOG_WARNING("failed to write acceleration structure cache file %s.", path.c_str());
+    }
+    else RENDERER_LOG_DEBUG("wrote acceleration structure cache file %s.", path.c_str());
+}
+
 namespace
 {
     struct FilterKey
@@ -1182,7 +1542,7 @@ namespace
                 filter_key.m_materials.size(),
                 filter_key.m_materials.size() > 1 ? "s" : "",
                 pretty_size(intersection_filter->get_masks_memory_size()).c_str(),
-                pretty_size(intersection_filter->get_masks_memory_size()).c_str(),
+                pretty_size(intersection_filter->get_uv_memory_size()).c_str(),
                 filter_key_hash);
 
             // Store this intersection filter.
@@ -48,14 +48,20 @@
 #include "foundation/utility/alignedvector.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/poolallocator.h"
+#include "foundation/utility/test.h"
 #include "foundation/utility/uid.h"
 
 // Standard headers.
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
+DECLARE_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenTreeSavedToCache_RestoresTree);
+DECLARE_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenMismatchingVersion_ReturnsFalse);
+DECLARE_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenMismatchingKey_ReturnsFalse);
+
 // Forward declarations.
 namespace foundation    { class Statistics; }
 namespace renderer      { class Assembly; }
@@ -120,6 +126,10 @@ class TriangleTree
     friend class TriangleLeafVisitor;
     friend class TriangleLeafProbeVisitor;
 
+    GRANT_ACCESS_TO_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenTreeSavedToCache_RestoresTree);
+    GRANT_ACCESS_TO_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenMismatchingVersion_ReturnsFalse);
+    GRANT_ACCESS_TO_TEST_CASE(Renderer_Kernel_Intersection_TriangleTree, LoadFromCache_GivenMismatchingKey_ReturnsFalse);
+
     const Arguments                             m_arguments;
 
     size_t                                      m_static_triangle_count;
@@ -156,6 +166,21 @@ class TriangleTree
         const std::vector<TriangleKey>&         triangle_keys,
         foundation::Statistics&                 statistics);
 
+    // Return a hash of the geometry and build parameters of the tree.
+    foundation::uint64 compute_cache_key(
+        const ParamArray&                       params,
+        const double                            time) const;
+
+    // Load the tree from a cache file. Return false if the file is missing or stale.
+    bool load_from_cache(
+        const std::string&                      path,
+        const foundation::uint64                key);
+
+    // Save the tree to a cache file.
+    void save_to_cache(
+        const std::string&                      path,
+        const foundation::uint64                key) const;
+
     void update_intersection_filters();
     void delete_intersection_filters();
 };
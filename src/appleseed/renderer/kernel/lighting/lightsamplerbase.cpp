@@ -234,9 +234,9 @@ void LightSamplerBase::collect_emitting_triangles(
                     triangle.m_n2 != Triangle::None)
                 {
                     // Retrieve object instance space vertex normals.
-                    const Vector3d n0_os = Vector3d(tess->m_vertex_normals[triangle.m_n0]);
-                    const Vector3d n1_os = Vector3d(tess->m_vertex_normals[triangle.m_n1]);
-                    const Vector3d n2_os = Vector3d(tess->m_vertex_normals[triangle.m_n2]);
+                    const Vector3d n0_os = Vector3d(tess->get_vertex_normal(triangle.m_n0));
+                    const Vector3d n1_os = Vector3d(tess->get_vertex_normal(triangle.m_n1));
+                    const Vector3d n2_os = Vector3d(tess->get_vertex_normal(triangle.m_n2));
 
                     // Transform vertex normals to world space.
                     n0 = normalize(global_transform.normal_to_parent(n0_os));
@@ -173,7 +173,7 @@ namespace
             OIIOTextureSystem&          oiio_texture_system,
             OSLShadingSystem&           shading_system,
             const ParamArray&           params)
-          : SampleGeneratorBase(generator_index, generator_count)
+          : SampleGeneratorBase(generator_index, generator_count, 0)
           , m_params(params)
           , m_scene(*project.get_scene())
           , m_frame(frame)
@@ -535,7 +535,8 @@ namespace
 
         virtual size_t generate_samples(
             const size_t                sequence_index,
-            SampleVector&               samples) override
+            SampleVector&               samples,
+            SampleAOVArray&             sample_aovs) override
         {
             m_arena.clear();
 
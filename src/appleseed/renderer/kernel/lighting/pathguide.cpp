@@ -0,0 +1,302 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "pathguide.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/fp.h"
+#include "foundation/math/scalar.h"
+#include "foundation/platform/atomic.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    // Map a unit-length direction to the unit square using the equal-area cylindrical mapping.
+    Vector2f direction_to_square(const Vector3f& d)
+    {
+        const float cos_theta = clamp(d[2], -1.0f, 1.0f);
+        const float phi = atan2(d[1], d[0]);
+
+        return
+            Vector2f(
+                (cos_theta + 1.0f) * 0.5f,
+                (phi < 0.0f ? phi + TwoPi<float>() : phi) * RcpTwoPi<float>());
+    }
+
+    // Map a point of the unit square to a unit-length direction; inverse of direction_to_square().
+    Vector3f square_to_direction(const Vector2f& p)
+    {
+        const float cos_theta = 2.0f * p[0] - 1.0f;
+        const float sin_theta = sqrt(max(1.0f - cos_theta * cos_theta, 0.0f));
+        const float phi = TwoPi<float>() * p[1];
+
+        return Vector3f(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+    }
+
+    size_t bin_index(const Vector2f& p)
+    {
+        const size_t Res = PathGuide::DirectionalResolution;
+        const size_t x = min(truncate<size_t>(p[0] * Res), Res - 1);
+        const size_t y = min(truncate<size_t>(p[1] * Res), Res - 1);
+        return y * Res + x;
+    }
+
+    // Solid angle subtended by a single bin, the mapping being area-preserving.
+    const float RcpBinSolidAngle = PathGuide::BinCount * RcpFourPi<float>();
+}
+
+
+//
+// PathGuide class implementation.
+//
+
+PathGuide::PathGuide(
+    const AABB3d&   bbox,
+    const size_t    spatial_threshold,
+    const size_t    max_leaf_count)
+  : m_spatial_threshold(max<size_t>(spatial_threshold, 1))
+  , m_max_leaf_count(max<size_t>(max_leaf_count, 1))
+  , m_iteration(0)
+{
+    Node root;
+    root.m_bbox = bbox.is_valid() ? bbox : AABB3d(Vector3d(-1.0), Vector3d(1.0));
+    root.m_child = ~uint32(0);
+    root.m_leaf = 0;
+    root.m_split_dim = 0;
+    root.m_split_abs = 0.0;
+    m_nodes.push_back(root);
+
+    m_leaves.resize(1);
+    Leaf& leaf = m_leaves.front();
+    fill(leaf.m_training, leaf.m_training + BinCount, 0.0f);
+    fill(leaf.m_cdf, leaf.m_cdf + BinCount, 0.0f);
+    leaf.m_sample_count = 0;
+    leaf.m_trained = false;
+}
+
+float PathGuide::sample(
+    const size_t        leaf_index,
+    const Vector2f&     s,
+    Vector3f&           incoming) const
+{
+    assert(leaf_index < m_leaves.size());
+    const Leaf& leaf = m_leaves[leaf_index];
+    assert(leaf.m_trained);
+
+    // Choose a bin.
+    const float* cdf_end = leaf.m_cdf + BinCount;
+    const float* it = upper_bound(leaf.m_cdf, cdf_end, s[0]);
+    if (it == cdf_end)
+        --it;
+    const size_t bin = it - leaf.m_cdf;
+    const float cdf_low = bin > 0 ? leaf.m_cdf[bin - 1] : 0.0f;
+    const float bin_prob = leaf.m_cdf[bin] - cdf_low;
+    if (bin_prob <= 0.0f)
+        return 0.0f;
+
+    // Choose a point inside the bin, reusing the first sample.
+    const size_t Res = DirectionalResolution;
+    const float u = clamp((s[0] - cdf_low) / bin_prob, 0.0f, 0.99999994f);
+    const Vector2f p(
+        ((bin % Res) + u) / Res,
+        ((bin / Res) + s[1]) / Res);
+
+    incoming = square_to_direction(p);
+
+    return bin_prob * RcpBinSolidAngle;
+}
+
+float PathGuide::evaluate_pdf(
+    const size_t        leaf_index,
+    const Vector3f&     incoming) const
+{
+    assert(leaf_index < m_leaves.size());
+    const Leaf& leaf = m_leaves[leaf_index];
+
+    if (!leaf.m_trained)
+        return 0.0f;
+
+    const size_t bin = bin_index(direction_to_square(incoming));
+    const float cdf_low = bin > 0 ? leaf.m_cdf[bin - 1] : 0.0f;
+
+    return (leaf.m_cdf[bin] - cdf_low) * RcpBinSolidAngle;
+}
+
+void PathGuide::record(
+    const size_t        leaf_index,
+    const Vector3f&     incoming,
+    const float         value)
+{
+    assert(leaf_index < m_leaves.size());
+    Leaf& leaf = m_leaves[leaf_index];
+
+    atomic_inc(&leaf.m_sample_count);
+
+    if (value > 0.0f)
+    {
+        const size_t bin = bin_index(direction_to_square(incoming));
+        atomic_add(&leaf.m_training[bin], value);
+    }
+}
+
+void PathGuide::refine()
+{
+    // Split the leaves that received many samples, the children inheriting the training data of their parent.
+    for (size_t i = 0, e = m_nodes.size(); i < e; ++i)
+    {
+        if (m_nodes[i].m_child == ~uint32(0))
+            split(i, m_leaves[m_nodes[i].m_leaf].m_sample_count);
+    }
+
+    // Build the sampling distributions and reset the training data.
+    for (size_t i = 0, e = m_leaves.size(); i < e; ++i)
+    {
+        Leaf& leaf = m_leaves[i];
+
+        float total = 0.0f;
+        for (size_t j = 0; j < BinCount; ++j)
+            total += leaf.m_training[j];
+
+        // Keep the previous distribution if the leaf did not receive any radiance.
+        if (total > 0.0f)
+        {
+            const float rcp_total = 1.0f / total;
+            float cdf = 0.0f;
+
+            for (size_t j = 0; j < BinCount; ++j)
+            {
+                cdf += leaf.m_training[j] * rcp_total;
+                leaf.m_cdf[j] = cdf;
+            }
+
+            leaf.m_cdf[BinCount - 1] = 1.0f;
+            leaf.m_trained = true;
+        }
+
+        fill(leaf.m_training, leaf.m_training + BinCount, 0.0f);
+        leaf.m_sample_count = 0;
+    }
+
+    ++m_iteration;
+}
+
+void PathGuide::split(
+    const size_t        node_index,
+    const size_t        sample_count)
+{
+    if (sample_count <= m_spatial_threshold || m_leaves.size() >= m_max_leaf_count)
+        return;
+
+    // Split the node in its middle, along its longest dimension.
+    const AABB3d bbox = m_nodes[node_index].m_bbox;
+    const size_t split_dim = max_index(bbox.extent());
+    const double split_abs = bbox.center(split_dim);
+
+    Node child;
+    child.m_child = ~uint32(0);
+    child.m_split_dim = 0;
+    child.m_split_abs = 0.0;
+
+    // The left child reuses the leaf of its parent, the right child gets a copy of it.
+    const uint32 child_index = static_cast<uint32>(m_nodes.size());
+    child.m_leaf = m_nodes[node_index].m_leaf;
+    child.m_bbox = bbox;
+    child.m_bbox.max[split_dim] = split_abs;
+    m_nodes.push_back(child);
+
+    child.m_leaf = static_cast<uint32>(m_leaves.size());
+    child.m_bbox = bbox;
+    child.m_bbox.min[split_dim] = split_abs;
+    m_nodes.push_back(child);
+    m_leaves.push_back(m_leaves[m_nodes[node_index].m_leaf]);
+
+    Node& node = m_nodes[node_index];
+    node.m_child = child_index;
+    node.m_split_dim = static_cast<uint32>(split_dim);
+    node.m_split_abs = split_abs;
+
+    // Assume the samples are evenly distributed among the children.
+    split(child_index, sample_count / 2);
+    split(child_index + 1, sample_count / 2);
+}
+
+
+//
+// GuidedPath class implementation.
+//
+
+void GuidedPath::splat()
+{
+    assert(m_guide);
+
+    const Spectrum& path_radiance = m_path_radiance.m_beauty;
+
+    for (size_t i = 0; i < m_vertex_count; ++i)
+    {
+        const Vertex& vertex = m_vertices[i];
+
+        // The radiance added to the path after this vertex, divided by the throughput
+        // at this vertex, estimates the radiance incident along the sampled direction.
+        float incident_radiance = 0.0f;
+        size_t channel_count = 0;
+        for (size_t c = 0, e = Spectrum::size(); c < e; ++c)
+        {
+            if (vertex.m_throughput[c] > 0.0f)
+            {
+                incident_radiance += (path_radiance[c] - vertex.m_radiance[c]) / vertex.m_throughput[c];
+                ++channel_count;
+            }
+        }
+
+        if (channel_count == 0)
+            continue;
+
+        incident_radiance /= channel_count;
+
+        if (!FP<float>::is_finite(incident_radiance))
+            continue;
+
+        m_guide->record(
+            vertex.m_leaf_index,
+            vertex.m_incoming,
+            incident_radiance / vertex.m_probability);
+    }
+}
+
+}   // namespace renderer
@@ -0,0 +1,286 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_PATHGUIDE_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_PATHGUIDE_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/shading/shadingcomponents.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// A spatio-directional structure that learns the distribution of incident radiance
+// in the scene and allows to importance sample it.
+//
+// Space is subdivided by a binary kd-tree built over the scene's bounding box. Each
+// leaf of the tree stores a directional histogram of incident radiance; directions
+// are mapped to the unit square using the equal-area cylindrical mapping, so that
+// all bins subtend the same solid angle.
+//
+// The structure is trained progressively: during a rendering pass, paths splat their
+// radiance estimates into the training histograms using atomic operations only. At
+// the end of the pass, refine() splits the leaves that received enough samples and
+// turns the training histograms into the sampling distributions used in the next pass.
+//
+// Reference:
+//
+//   Practical Path Guiding for Efficient Light-Transport Simulation
+//   https://tom94.net/data/publications/mueller17practical/mueller17practical.pdf
+//
+
+class PathGuide
+  : public foundation::NonCopyable
+{
+  public:
+    // Resolution of the directional histograms.
+    enum { DirectionalResolution = 16 };
+    enum { BinCount = DirectionalResolution * DirectionalResolution };
+
+    // Constructor.
+    PathGuide(
+        const foundation::AABB3d&   bbox,
+        const size_t                spatial_threshold,      // a leaf is split when it receives more samples than this
+        const size_t                max_leaf_count);
+
+    // Return the index of the leaf containing a given point.
+    size_t find_leaf(const foundation::Vector3d& point) const;
+
+    // Return true if a given leaf has a sampling distribution.
+    bool is_trained(const size_t leaf_index) const;
+
+    // Sample the incident radiance distribution of a given leaf.
+    // Returns the probability density of the sampled direction with respect to solid angle.
+    float sample(
+        const size_t                leaf_index,
+        const foundation::Vector2f& s,
+        foundation::Vector3f&       incoming) const;
+
+    // Evaluate the probability density of a given direction with respect to solid angle.
+    float evaluate_pdf(
+        const size_t                leaf_index,
+        const foundation::Vector3f& incoming) const;
+
+    // Splat a radiance estimate. Thread-safe.
+    void record(
+        const size_t                leaf_index,
+        const foundation::Vector3f& incoming,
+        const float                 value);
+
+    // Refine the spatial subdivision and rebuild the sampling distributions
+    // from the training data. Must not be called while rendering.
+    void refine();
+
+    // Return the number of leaves of the kd-tree.
+    size_t get_leaf_count() const;
+
+    // Return the number of times refine() was called.
+    size_t get_iteration() const;
+
+  private:
+    struct Node
+    {
+        foundation::AABB3d          m_bbox;
+        foundation::uint32          m_child;                // index of the first child, ~0 for leaves
+        foundation::uint32          m_leaf;                 // index of the leaf, leaves only
+        foundation::uint32          m_split_dim;
+        double                      m_split_abs;
+    };
+
+    struct Leaf
+    {
+        float                       m_training[BinCount];   // accumulated with atomic additions
+        float                       m_cdf[BinCount];        // cumulative distribution function of the bins
+        volatile foundation::uint32 m_sample_count;
+        bool                        m_trained;
+    };
+
+    const size_t                    m_spatial_threshold;
+    const size_t                    m_max_leaf_count;
+    size_t                          m_iteration;
+    std::vector<Node>               m_nodes;
+    std::vector<Leaf>               m_leaves;
+
+    void split(
+        const size_t                node_index,
+        const size_t                sample_count);
+};
+
+
+//
+// The vertices of a single path sampled with the help of a path guide.
+//
+// Vertices are recorded as the path is being traced. Once the path is complete,
+// splat() derives the radiance that arrived at each vertex along the sampled
+// direction from the final path radiance and feeds it back to the path guide.
+//
+
+class GuidedPath
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. The path guide may be null, in which case the guided path must not be used.
+    GuidedPath(
+        PathGuide*                  guide,
+        const float                 bsdf_sampling_fraction,
+        const ShadingComponents&    path_radiance);
+
+    // Return the path guide.
+    const PathGuide& get_guide() const;
+
+    // Return the probability of sampling the BSDF rather than the path guide.
+    float get_bsdf_sampling_fraction() const;
+
+    // Record a path vertex. Must be called after the path throughput was updated.
+    void add_vertex(
+        const size_t                leaf_index,
+        const foundation::Vector3f& incoming,
+        const float                 probability,
+        const Spectrum&             throughput);
+
+    // Splat the radiance estimates of all vertices into the path guide.
+    void splat();
+
+  private:
+    enum { MaxVertexCount = 32 };
+
+    struct Vertex
+    {
+        size_t                      m_leaf_index;
+        foundation::Vector3f        m_incoming;
+        float                       m_probability;
+        Spectrum                    m_throughput;
+        Spectrum                    m_radiance;             // path radiance when the vertex was recorded
+    };
+
+    PathGuide*                      m_guide;
+    const float                     m_bsdf_sampling_fraction;
+    const ShadingComponents&        m_path_radiance;
+    size_t                          m_vertex_count;
+    Vertex                          m_vertices[MaxVertexCount];
+};
+
+
+//
+// PathGuide class implementation.
+//
+
+inline size_t PathGuide::find_leaf(const foundation::Vector3d& point) const
+{
+    size_t node_index = 0;
+
+    while (true)
+    {
+        const Node& node = m_nodes[node_index];
+
+        if (node.m_child == ~foundation::uint32(0))
+            return node.m_leaf;
+
+        node_index = node.m_child;
+        if (point[node.m_split_dim] >= node.m_split_abs)
+            ++node_index;
+    }
+}
+
+inline bool PathGuide::is_trained(const size_t leaf_index) const
+{
+    assert(leaf_index < m_leaves.size());
+    return m_leaves[leaf_index].m_trained;
+}
+
+inline size_t PathGuide::get_leaf_count() const
+{
+    return m_leaves.size();
+}
+
+inline size_t PathGuide::get_iteration() const
+{
+    return m_iteration;
+}
+
+
+//
+// GuidedPath class implementation.
+//
+
+inline GuidedPath::GuidedPath(
+    PathGuide*                      guide,
+    const float                     bsdf_sampling_fraction,
+    const ShadingComponents&        path_radiance)
+  : m_guide(guide)
+  , m_bsdf_sampling_fraction(bsdf_sampling_fraction)
+  , m_path_radiance(path_radiance)
+  , m_vertex_count(0)
+{
+}
+
+inline const PathGuide& GuidedPath::get_guide() const
+{
+    assert(m_guide);
+    return *m_guide;
+}
+
+inline float GuidedPath::get_bsdf_sampling_fraction() const
+{
+    return m_bsdf_sampling_fraction;
+}
+
+inline void GuidedPath::add_vertex(
+    const size_t                    leaf_index,
+    const foundation::Vector3f&     incoming,
+    const float                     probability,
+    const Spectrum&                 throughput)
+{
+    if (m_vertex_count == MaxVertexCount)
+        return;
+
+    Vertex& vertex = m_vertices[m_vertex_count++];
+    vertex.m_leaf_index = leaf_index;
+    vertex.m_incoming = incoming;
+    vertex.m_probability = probability;
+    vertex.m_throughput = throughput;
+    vertex.m_radiance = m_path_radiance.m_beauty;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_PATHGUIDE_H
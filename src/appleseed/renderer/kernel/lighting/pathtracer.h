@@ -34,6 +34,7 @@
 #include "renderer/global/globallogger.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/lighting/pathguide.h"
 #include "renderer/kernel/lighting/pathvertex.h"
 #include "renderer/kernel/lighting/scatteringmode.h"
 #include "renderer/kernel/shading/shadingcontext.h"
@@ -87,7 +88,8 @@ class PathTracer
         const size_t            max_specular_bounces,
         const size_t            max_volume_bounces,
         const size_t            max_iterations = 1000,
-        const double            near_start = 0.0);          // abort tracing if the first ray is shorter than this
+        const double            near_start = 0.0,           // abort tracing if the first ray is shorter than this
+        GuidedPath*             guided_path = nullptr);     // if set, sample directions using a path guide
 
     size_t trace(
         SamplingContext&        sampling_context,
@@ -111,6 +113,7 @@ class PathTracer
     const size_t                m_max_volume_bounces;
     const size_t                m_max_iterations;
     const double                m_near_start;
+    GuidedPath*                 m_guided_path;
     size_t                      m_diffuse_bounces;
     size_t                      m_glossy_bounces;
     size_t                      m_specular_bounces;
@@ -137,6 +140,16 @@ class PathTracer
         BSDFSample&             sample,
         ShadingRay&             ray);
 
+    // Sample a scattering direction using both the BSDF and the path guide, combined
+    // with one-sample multiple importance sampling. Returns the probability density
+    // with which the direction was sampled, while sample.m_probability is set to the
+    // BSDF probability density for MIS at light-emitting vertices.
+    float sample_guided_bsdf(
+        SamplingContext&        sampling_context,
+        PathVertex&             vertex,
+        const size_t            leaf_index,
+        BSDFSample&             sample);
+
     // This method performs raymarching across the volume.
     // Returns whether the path should be continued.
     bool march(
@@ -163,7 +176,8 @@ inline PathTracer<PathVisitor, VolumeVisitor, Adjoint>::PathTracer(
     const size_t                max_specular_bounces,
     const size_t                max_volume_bounces,
     const size_t                max_iterations,
-    const double                near_start)
+    const double                near_start,
+    GuidedPath*                 guided_path)
   : m_path_visitor(path_visitor)
   , m_volume_visitor(volume_visitor)
   , m_rr_min_path_length(rr_min_path_length)
@@ -174,6 +188,7 @@ inline PathTracer<PathVisitor, VolumeVisitor, Adjoint>::PathTracer(
   , m_max_volume_bounces(max_volume_bounces)
   , m_max_iterations(max_iterations)
   , m_near_start(near_start)
+  , m_guided_path(guided_path)
 {
 }
 
@@ -643,17 +658,41 @@ bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::process_bounce(
     if (vertex.m_scattering_modes == ScatteringMode::None)
         return false;
 
+    // Probability density with which the scattered direction is sampled.
+    float sample_probability;
+
+    // Whether this vertex is recorded into the guided path.
+    bool guided = false;
+    size_t leaf_index = 0;
+
     // Above-surface scattering.
     if (vertex.m_bssrdf == nullptr)
     {
-        vertex.m_bsdf->sample(
-            sampling_context,
-            vertex.m_bsdf_data,
-            Adjoint,
-            true,       // multiply by |cos(incoming, normal)|
-            vertex.m_scattering_modes,
-            sample);
+        if (m_guided_path != nullptr &&
+            (vertex.m_scattering_modes & vertex.m_bsdf->get_modes() & (ScatteringMode::Diffuse | ScatteringMode::Glossy)) != 0)
+        {
+            leaf_index = m_guided_path->get_guide().find_leaf(vertex.get_point());
+            sample_probability =
+                sample_guided_bsdf(
+                    sampling_context,
+                    vertex,
+                    leaf_index,
+                    sample);
+            guided = sample_probability != BSDF::DiracDelta;
+        }
+        else
+        {
+            vertex.m_bsdf->sample(
+                sampling_context,
+                vertex.m_bsdf_data,
+                Adjoint,
+                true,       // multiply by |cos(incoming, normal)|
+                vertex.m_scattering_modes,
+                sample);
+            sample_probability = sample.m_probability;
+        }
     }
+    else sample_probability = sample.m_probability;
 
     // Terminate the path if it gets absorbed.
     if (sample.m_mode == ScatteringMode::None)
@@ -672,10 +711,20 @@ bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::process_bounce(
         vertex.m_aov_mode = sample.m_mode;
 
     // Update path throughput.
-    if (sample.m_probability != BSDF::DiracDelta)
-        sample.m_value /= sample.m_probability;
+    if (sample_probability != BSDF::DiracDelta)
+        sample.m_value /= sample_probability;
     vertex.m_throughput *= sample.m_value.m_beauty;
 
+    // Record the vertex to later train the path guide.
+    if (guided)
+    {
+        m_guided_path->add_vertex(
+            leaf_index,
+            sample.m_incoming.get_value(),
+            sample_probability,
+            vertex.m_throughput);
+    }
+
     // Update bounce counters.
     ++vertex.m_path_length;
     m_diffuse_bounces +=  (sample.m_mode >> ScatteringMode::DiffuseBitShift)  & 1;
@@ -704,6 +753,93 @@ bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::process_bounce(
     return true;
 }
 
+template <typename PathVisitor, typename VolumeVisitor, bool Adjoint>
+float PathTracer<PathVisitor, VolumeVisitor, Adjoint>::sample_guided_bsdf(
+    SamplingContext&            sampling_context,
+    PathVertex&                 vertex,
+    const size_t                leaf_index,
+    BSDFSample&                 sample)
+{
+    const PathGuide& guide = m_guided_path->get_guide();
+
+    // Only use the BSDF until the path guide has learned something about this region.
+    const float bsdf_sampling_fraction =
+        guide.is_trained(leaf_index) ? m_guided_path->get_bsdf_sampling_fraction() : 1.0f;
+
+    // Path guiding only applies to non-specular scattering.
+    const int guided_modes = vertex.m_scattering_modes & ~ScatteringMode::Specular;
+
+    sampling_context.split_in_place(3, 1);
+    const foundation::Vector3f s = sampling_context.next2<foundation::Vector3f>();
+
+    if (s[0] < bsdf_sampling_fraction)
+    {
+        vertex.m_bsdf->sample(
+            sampling_context,
+            vertex.m_bsdf_data,
+            Adjoint,
+            true,       // multiply by |cos(incoming, normal)|
+            vertex.m_scattering_modes,
+            sample);
+
+        if (sample.m_mode == ScatteringMode::None)
+            return 0.0f;
+
+        // Specular directions can only be sampled by the BSDF.
+        if (sample.m_probability == BSDF::DiracDelta)
+        {
+            sample.m_value /= bsdf_sampling_fraction;
+            return BSDF::DiracDelta;
+        }
+
+        if (bsdf_sampling_fraction == 1.0f)
+            return sample.m_probability;
+    }
+    else
+    {
+        foundation::Vector3f incoming;
+        if (guide.sample(leaf_index, foundation::Vector2f(s[1], s[2]), incoming) == 0.0f)
+        {
+            sample.m_mode = ScatteringMode::None;
+            return 0.0f;
+        }
+
+        sample.m_incoming = foundation::Dual3f(incoming);
+        sample.m_mode =
+            ScatteringMode::has_diffuse(guided_modes)
+                ? ScatteringMode::Diffuse
+                : ScatteringMode::Glossy;
+    }
+
+    // Evaluate the BSDF in the sampled direction, since sampling one of its
+    // components alone does not give the density of the whole BSDF.
+    const float bsdf_prob =
+        vertex.m_bsdf->evaluate(
+            vertex.m_bsdf_data,
+            Adjoint,
+            true,       // multiply by |cos(incoming, normal)|
+            sample.m_geometric_normal,
+            sample.m_shading_basis,
+            sample.m_outgoing.get_value(),
+            sample.m_incoming.get_value(),
+            guided_modes,
+            sample.m_value);
+
+    if (bsdf_prob == 0.0f)
+    {
+        sample.m_mode = ScatteringMode::None;
+        return 0.0f;
+    }
+
+    // The BSDF density alone is used for MIS at light-emitting vertices; this keeps
+    // the estimator unbiased since light sampling weights also use the BSDF density.
+    sample.m_probability = bsdf_prob;
+
+    return
+        bsdf_sampling_fraction * bsdf_prob +
+        (1.0f - bsdf_sampling_fraction) * guide.evaluate_pdf(leaf_index, foundation::Vector3f(sample.m_incoming.get_value()));
+}
+
 template <typename PathVisitor, typename VolumeVisitor, bool Adjoint>
 bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::march(
     SamplingContext&            sampling_context,
@@ -35,6 +35,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/lighting/directlightingintegrator.h"
 #include "renderer/kernel/lighting/imagebasedlighting.h"
+#include "renderer/kernel/lighting/pathguide.h"
 #include "renderer/kernel/lighting/pathtracer.h"
 #include "renderer/kernel/lighting/pathvertex.h"
 #include "renderer/kernel/lighting/scatteringmode.h"
@@ -118,6 +119,9 @@ namespace
 
             const size_t    m_distance_sample_count;        // number of distance samples until the ray is completely extincted
 
+            const bool      m_enable_path_guiding;          // is path guiding enabled?
+            const float     m_guiding_bsdf_fraction;        // probability of sampling the BSDF rather than the path guide
+
             float           m_rcp_dl_light_sample_count;
             float           m_rcp_ibl_env_sample_count;
 
@@ -138,6 +142,8 @@ namespace
               , m_has_max_ray_intensity(params.strings().exist("max_ray_intensity"))
               , m_distance_sample_count(params.get_optional<size_t>("volume_distance_samples", 4))
               , m_max_ray_intensity(params.get_optional<float>("max_ray_intensity", 0.0f))
+              , m_enable_path_guiding(params.get_optional<bool>("enable_path_guiding", false))
+              , m_guiding_bsdf_fraction(clamp(params.get_optional<float>("guiding_bsdf_fraction", 0.5f), 0.01f, 1.0f))
             {
                 // Precompute the reciprocal of the number of light samples.
                 m_rcp_dl_light_sample_count =
@@ -180,7 +186,9 @@ namespace
                     "  dl light threshold            %s\n"
                     "  ibl env samples               %s\n"
                     "  max ray intensity             %s\n"
-                    "  volume distance samples       %s",
+                    "  volume distance samples       %s\n"
+                    "  path guiding                  %s\n"
+                    "  guiding bsdf fraction         %s",
                     m_enable_dl ? "on" : "off",
                     m_enable_ibl ? "on" : "off",
                     m_enable_caustics ? "on" : "off",
@@ -195,15 +203,19 @@ namespace
                     pretty_scalar(m_dl_low_light_threshold, 3).c_str(),
                     pretty_scalar(m_ibl_env_sample_count).c_str(),
                     m_has_max_ray_intensity ? pretty_scalar(m_max_ray_intensity).c_str() : "infinite",
-                    pretty_int(m_distance_sample_count).c_str());
+                    pretty_int(m_distance_sample_count).c_str(),
+                    m_enable_path_guiding ? "on" : "off",
+                    pretty_scalar(m_guiding_bsdf_fraction, 2).c_str());
             }
         };
 
         PTLightingEngine(
             const BackwardLightSampler&     light_sampler,
+            PathGuide*                      path_guide,
             const ParamArray&               params)
           : m_params(params)
           , m_light_sampler(light_sampler)
+          , m_path_guide(path_guide)
           , m_path_count(0)
           , m_inf_volume_ray_warnings(0)
         {
@@ -263,6 +275,11 @@ namespace
                 radiance,
                 m_inf_volume_ray_warnings);
 
+            GuidedPath guided_path(
+                m_path_guide,
+                m_params.m_guiding_bsdf_fraction,
+                radiance);
+
             PathTracer<PathVisitor, VolumeVisitor, false> path_tracer(     // false = not adjoint
                 path_visitor,
                 volume_visitor,
@@ -272,7 +289,9 @@ namespace
                 m_params.m_max_glossy_bounces,
                 m_params.m_max_specular_bounces,
                 m_params.m_max_volume_bounces,
-                shading_context.get_max_iterations());
+                shading_context.get_max_iterations(),
+                0.0,
+                m_path_guide ? &guided_path : nullptr);
 
             const size_t path_length =
                 path_tracer.trace(
@@ -280,6 +299,10 @@ namespace
                     shading_context,
                     shading_point);
 
+            // Train the path guide with this path.
+            if (m_path_guide)
+                guided_path.splat();
+
             // Update statistics.
             ++m_path_count;
             m_path_length.insert(path_length);
@@ -297,6 +320,7 @@ namespace
       private:
         const Parameters                m_params;
         const BackwardLightSampler&     m_light_sampler;
+        PathGuide*                      m_path_guide;
 
         uint64                          m_path_count;
         Population<uint64>              m_path_length;
@@ -1126,8 +1150,10 @@ namespace
 
 PTLightingEngineFactory::PTLightingEngineFactory(
     const BackwardLightSampler&     light_sampler,
+    PathGuide*                      path_guide,
     const ParamArray&               params)
   : m_light_sampler(light_sampler)
+  , m_path_guide(path_guide)
   , m_params(params)
 {
     PTLightingEngine::Parameters(params).print();
@@ -1140,7 +1166,7 @@ void PTLightingEngineFactory::release()
 
 ILightingEngine* PTLightingEngineFactory::create()
 {
-    return new PTLightingEngine(m_light_sampler, m_params);
+    return new PTLightingEngine(m_light_sampler, m_path_guide, m_params);
 }
 
 Dictionary PTLightingEngineFactory::get_params_metadata()
@@ -1251,6 +1277,42 @@ Dictionary PTLightingEngineFactory::get_params_metadata()
             .insert("label", "Distance Samples")
             .insert("help", "Number of distance samples per ray for volume rendering"));
 
+    metadata.dictionaries().insert(
+        "enable_path_guiding",
+        Dictionary()
+            .insert("type", "bool")
+            .insert("default", "false")
+            .insert("label", "Enable Path Guiding")
+            .insert("help", "Learn the distribution of incident light across passes and use it to guide paths (requires multiple passes)"));
+
+    metadata.dictionaries().insert(
+        "guiding_bsdf_fraction",
+        Dictionary()
+            .insert("type", "float")
+            .insert("default", "0.5")
+            .insert("min", "0.01")
+            .insert("max", "1.0")
+            .insert("label", "Guiding BSDF Fraction")
+            .insert("help", "Probability of sampling the BSDF rather than the learned light distribution"));
+
+    metadata.dictionaries().insert(
+        "guiding_spatial_threshold",
+        Dictionary()
+            .insert("type", "int")
+            .insert("default", "4000")
+            .insert("min", "1")
+            .insert("label", "Guiding Spatial Threshold")
+            .insert("help", "Number of samples a region of space must receive before it is subdivided"));
+
+    metadata.dictionaries().insert(
+        "guiding_max_leaves",
+        Dictionary()
+            .insert("type", "int")
+            .insert("default", "16384")
+            .insert("min", "1")
+            .insert("label", "Guiding Max Regions")
+            .insert("help", "Maximum number of regions of space the path guide is made of"));
+
     return metadata;
 }
 
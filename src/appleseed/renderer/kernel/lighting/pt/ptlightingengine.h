@@ -40,6 +40,7 @@
 // Forward declarations.
 namespace foundation    { class Dictionary; }
 namespace renderer      { class BackwardLightSampler; }
+namespace renderer      { class PathGuide; }
 
 namespace renderer
 {
@@ -52,9 +53,10 @@ class PTLightingEngineFactory
   : public ILightingEngineFactory
 {
   public:
-    // Constructor.
+    // Constructor. The path guide is optional.
     PTLightingEngineFactory(
         const BackwardLightSampler&     light_sampler,
+        PathGuide*                      path_guide,
         const ParamArray&               params);
 
     // Delete this instance.
@@ -68,6 +70,7 @@ class PTLightingEngineFactory
 
   private:
     const BackwardLightSampler&     m_light_sampler;
+    PathGuide*                      m_path_guide;
     ParamArray                      m_params;
 };
 
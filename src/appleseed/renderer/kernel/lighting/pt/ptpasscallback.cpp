@@ -0,0 +1,100 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "ptpasscallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globaltypes.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// PTPassCallback class implementation.
+//
+
+PTPassCallback::PTPassCallback(
+    const Scene&                scene,
+    const ParamArray&           params)
+  : m_path_guide(
+        AABB3d(scene.compute_bbox()),
+        params.get_optional<size_t>("guiding_spatial_threshold", 4000),
+        params.get_optional<size_t>("guiding_max_leaves", 16384))
+{
+}
+
+void PTPassCallback::release()
+{
+    delete this;
+}
+
+void PTPassCallback::on_pass_begin(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    IAbortSwitch&           abort_switch)
+{
+    m_stopwatch.start();
+}
+
+void PTPassCallback::on_pass_end(
+    const Frame&            frame,
+    JobQueue&               job_queue,
+    IAbortSwitch&           abort_switch)
+{
+    m_stopwatch.measure();
+    const double pass_time = m_stopwatch.get_seconds();
+
+    // Learn from the radiance recorded during this pass.
+    m_stopwatch.start();
+    m_path_guide.refine();
+    m_stopwatch.measure();
+
+    RENDERER_LOG_INFO(
+        "path guiding pass %s completed in %s, path guide refined in %s (%s %s).",
+        pretty_uint(m_path_guide.get_iteration()).c_str(),
+        pretty_time(pass_time).c_str(),
+        pretty_time(m_stopwatch.get_seconds()).c_str(),
+        pretty_uint(m_path_guide.get_leaf_count()).c_str(),
+        plural(m_path_guide.get_leaf_count(), "leaf", "leaves").c_str());
+}
+
+}   // namespace renderer
@@ -37,6 +37,7 @@
 #include "renderer/modeling/camera/camera.h"
 #include "renderer/modeling/input/source.h"
 #include "renderer/modeling/material/material.h"
+#include "renderer/modeling/object/object.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/shadergroup/shadergroup.h"
 #include "renderer/modeling/volume/volume.h"
@@ -135,8 +136,6 @@ const ShadingPoint& Tracer::do_trace(
         if (material == 0)
             break;
 
-        const Material::RenderData& render_data = material->get_render_data();
-
         // Compute transmission of participating media.
         const ShadingRay& volume_ray = shading_point_ptr->get_ray();
         if (volume != nullptr)
@@ -151,12 +150,6 @@ const ShadingPoint& Tracer::do_trace(
         // Compute alpha.
         Alpha alpha;
         evaluate_alpha(*material, *shading_point_ptr, alpha);
-        if (render_data.m_bsdf == nullptr &&
-            render_data.m_bssrdf == nullptr &&
-            render_data.m_volume != nullptr)
-        {
-            alpha[0] = 0.0f;
-        }
 
         // Stop at the first fully opaque occluder.
         if (alpha[0] >= 1.0f)
@@ -263,18 +256,9 @@ const ShadingPoint& Tracer::do_trace_between(
         if (material == nullptr)
             break;
 
-        const Material::RenderData& render_data = material->get_render_data();
-
         // Compute alpha.
         Alpha alpha;
         evaluate_alpha(*material, *shading_point_ptr, alpha);
-        if (
-            render_data.m_bsdf == nullptr &&
-            render_data.m_bssrdf == nullptr &&
-            render_data.m_volume != nullptr)
-        {
-            alpha[0] = 0.0f;
-        }
 
         // Stop at the first fully opaque occluder.
         if (alpha[0] >= 1.0f)
@@ -329,18 +313,49 @@ void Tracer::evaluate_alpha(
     const ShadingPoint&         shading_point,
     Alpha&                      alpha) const
 {
-    alpha = shading_point.get_alpha();
+    const Material::RenderData& render_data = material.get_render_data();
 
-    // Apply OSL transparency if needed.
-    if (const ShaderGroup* sg = material.get_render_data().m_shader_group)
+    // Materials that only define a volume don't occlude rays at their boundary.
+    if (render_data.m_bsdf == nullptr &&
+        render_data.m_bssrdf == nullptr &&
+        render_data.m_volume != nullptr)
     {
-        if (sg->has_transparency())
+        alpha.set(0.0f);
+        return;
+    }
+
+    // Materials are classified once per frame: when the object doesn't have its
+    // own alpha map, opaque and uniformly transparent materials require neither
+    // texture lookups nor OSL execution, and textured opacity doesn't need OSL.
+    if (render_data.m_opacity != Material::OpacityShaded &&
+        shading_point.is_triangle_primitive() &&
+        shading_point.get_object().get_alpha_map() == nullptr)
+    {
+        switch (render_data.m_opacity)
         {
-            Alpha a;
-            m_shadergroup_exec.execute_shadow(*sg, shading_point, a);
-            alpha *= a;
+          case Material::OpacityOpaque:
+            alpha.set(1.0f);
+            return;
+
+          case Material::OpacityUniform:
+            alpha.set(render_data.m_uniform_alpha);
+            return;
+
+          default:
+            alpha = shading_point.get_alpha();
+            return;
         }
     }
+
+    alpha = shading_point.get_alpha();
+
+    // Apply OSL transparency if needed.
+    if (render_data.m_opacity == Material::OpacityShaded)
+    {
+        Alpha a;
+        m_shadergroup_exec.execute_shadow(*render_data.m_shader_group, shading_point, a);
+        alpha *= a;
+    }
 }
 
 }   // namespace renderer
@@ -40,6 +40,7 @@
 #include "renderer/modeling/project/project.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/scene/visibilityflags.h"
+#include "renderer/utility/settingsparsing.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
@@ -186,6 +187,7 @@ bool BaseRenderer::initialize_osl(TextureStore& texture_store, IAbortSwitch& abo
     return
         m_project.get_scene()->create_optimized_osl_shader_groups(
             *m_shading_system,
+            get_rendering_thread_count(m_params),
             &abort_switch);
 }
 
@@ -38,6 +38,7 @@
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
 #include "foundation/utility/statistics.h"
 
 // Standard headers.
@@ -85,6 +86,34 @@ namespace
             tile.clear(Color4f(0.0f, 0.0f, 0.0f, 1.0f));
         }
 
+        virtual bool supports_tile_regions() const override
+        {
+            return true;
+        }
+
+        virtual void render_tile_region(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const AABB2u&   region,
+            const size_t    pass_hash,
+            IAbortSwitch&   abort_switch) override
+        {
+            Image& image = frame.image();
+
+            assert(tile_x < image.properties().m_tile_count_x);
+            assert(tile_y < image.properties().m_tile_count_y);
+
+            Tile& tile = image.tile(tile_x, tile_y);
+
+            // Set all pixels of the region to opaque black.
+            for (size_t y = region.min.y; y <= region.max.y; ++y)
+            {
+                for (size_t x = region.min.x; x <= region.max.x; ++x)
+                    tile.set_pixel(x, y, Color4f(0.0f, 0.0f, 0.0f, 1.0f));
+            }
+        }
+
         virtual StatisticsVector get_statistics() const override
         {
             return StatisticsVector();
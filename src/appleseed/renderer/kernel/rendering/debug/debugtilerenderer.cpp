@@ -38,6 +38,8 @@
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/statistics.h"
 
 // Standard headers.
@@ -79,16 +81,45 @@ namespace
             assert(tile_x < image.properties().m_tile_count_x);
             assert(tile_y < image.properties().m_tile_count_y);
 
+            const Tile& tile = image.tile(tile_x, tile_y);
+
+            render_tile_region(
+                frame,
+                tile_x,
+                tile_y,
+                AABB2u(
+                    Vector2u(0, 0),
+                    Vector2u(tile.get_width() - 1, tile.get_height() - 1)),
+                pass_hash,
+                abort_switch);
+        }
+
+        virtual bool supports_tile_regions() const override
+        {
+            return true;
+        }
+
+        virtual void render_tile_region(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const AABB2u&   region,
+            const size_t    pass_hash,
+            IAbortSwitch&   abort_switch) override
+        {
+            Image& image = frame.image();
+
+            assert(tile_x < image.properties().m_tile_count_x);
+            assert(tile_y < image.properties().m_tile_count_y);
+
             Tile& tile = image.tile(tile_x, tile_y);
-            const size_t tile_width = tile.get_width();
-            const size_t tile_height = tile.get_height();
-            const size_t max_x = tile_width - 1;
-            const size_t max_y = tile_height - 1;
+            const size_t max_x = tile.get_width() - 1;
+            const size_t max_y = tile.get_height() - 1;
 
-            // Draw a pixel-sized checkerboard inside the tile.
-            for (size_t y = 0; y < tile_height; ++y)
+            // Draw a pixel-sized checkerboard inside the region.
+            for (size_t y = region.min.y; y <= region.max.y; ++y)
             {
-                for (size_t x = 0; x < tile_width; ++x)
+                for (size_t x = region.min.x; x <= region.max.x; ++x)
                 {
                     const float gray = 0.6f + ((x + y) & 1) * 0.2f;
                     const Color4f pixel_color(gray, gray, gray, 1.0f);
@@ -97,16 +128,28 @@ namespace
             }
 
             // Color the corners of the tile.
-            tile.set_pixel(0,     0,     Color4f(1.0f, 0.0f, 0.0f, 1.0f));      // top left pixel is red
-            tile.set_pixel(max_x, 0,     Color4f(0.0f, 1.0f, 0.0f, 1.0f));      // top right pixel is green
-            tile.set_pixel(0,     max_y, Color4f(1.0f, 1.0f, 1.0f, 1.0f));      // bottom left pixel is white
-            tile.set_pixel(max_x, max_y, Color4f(0.0f, 0.0f, 1.0f, 1.0f));      // bottom right pixel is blue
+            color_corner(tile, region, 0,     0,     Color4f(1.0f, 0.0f, 0.0f, 1.0f));  // top left pixel is red
+            color_corner(tile, region, max_x, 0,     Color4f(0.0f, 1.0f, 0.0f, 1.0f));  // top right pixel is green
+            color_corner(tile, region, 0,     max_y, Color4f(1.0f, 1.0f, 1.0f, 1.0f));  // bottom left pixel is white
+            color_corner(tile, region, max_x, max_y, Color4f(0.0f, 0.0f, 1.0f, 1.0f));  // bottom right pixel is blue
         }
 
         virtual StatisticsVector get_statistics() const override
         {
             return StatisticsVector();
         }
+
+      private:
+        static void color_corner(
+            Tile&           tile,
+            const AABB2u&   region,
+            const size_t    x,
+            const size_t    y,
+            const Color4f&  color)
+        {
+            if (region.contains(Vector2u(x, y)))
+                tile.set_pixel(x, y, color);
+        }
     };
 }
 
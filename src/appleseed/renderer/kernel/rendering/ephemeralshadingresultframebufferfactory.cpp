@@ -70,6 +70,11 @@ ShadingResultFrameBuffer* EphemeralShadingResultFrameBufferFactory::create(
     return framebuffer;
 }
 
+bool EphemeralShadingResultFrameBufferFactory::supports_tile_regions() const
+{
+    return true;
+}
+
 void EphemeralShadingResultFrameBufferFactory::destroy(
     ShadingResultFrameBuffer*   framebuffer)
 {
@@ -60,6 +60,8 @@ class EphemeralShadingResultFrameBufferFactory
         const size_t                tile_y,
         const foundation::AABB2u&   tile_bbox) override;
 
+    virtual bool supports_tile_regions() const override;
+
     virtual void destroy(
         ShadingResultFrameBuffer*   framebuffer) override;
 };
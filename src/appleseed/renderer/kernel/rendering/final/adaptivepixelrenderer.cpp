@@ -130,16 +130,14 @@ namespace
         virtual void on_tile_end(
             const Frame&                frame,
             Tile&                       tile,
-            TileStack&                  aov_tiles) override
+            TileStack&                  aov_tiles,
+            const AABB2i&               region) override
         {
             if (m_params.m_diagnostics)
             {
-                const size_t width = tile.get_width();
-                const size_t height = tile.get_height();
-
-                for (size_t y = 0; y < height; ++y)
+                for (int y = region.min.y; y <= region.max.y; ++y)
                 {
-                    for (size_t x = 0; x < width; ++x)
+                    for (int x = region.min.x; x <= region.max.x; ++x)
                     {
                         Color<float, 2> values;
                         m_diagnostics->get_pixel(x, y, values);
@@ -176,12 +174,15 @@ namespace
             const size_t pixel_index = pi.y * frame_width + pi.x;
             const size_t instance = hash_uint32(static_cast<uint32>(pass_hash + pixel_index));
             SamplingContext::RNGType rng(pass_hash, instance);
+            // In Sobol mode, pixels are decorrelated by scrambling the sequence rather than by offsetting it.
+            const bool sobol_mode = m_params.m_sampling_mode == SamplingContext::SobolMode;
             SamplingContext sampling_context(
                 rng,
                 m_params.m_sampling_mode,
                 2,                          // number of dimensions
                 0,                          // number of samples -- unknown
-                instance);                  // initial instance number
+                sobol_mode ? 0 : instance,  // initial instance number
+                static_cast<uint32>(instance));     // scrambling seed -- Sobol mode only
 
             VariationTracker trackers[3];
 
@@ -132,12 +132,15 @@ namespace
                 const size_t pixel_index = pi.y * frame_width + pi.x;
                 const size_t instance = hash_uint32(static_cast<uint32>(pass_hash + pixel_index));
                 SamplingContext::RNGType rng(pass_hash, instance);
+                // In Sobol mode, pixels are decorrelated by scrambling the sequence rather than by offsetting it.
+                const bool sobol_mode = m_params.m_sampling_mode == SamplingContext::SobolMode;
                 SamplingContext sampling_context(
                     rng,
                     m_params.m_sampling_mode,
                     2,                          // number of dimensions
                     0,                          // number of samples -- unknown
-                    instance);                  // initial instance number
+                    sobol_mode ? 0 : instance,  // initial instance number
+                    static_cast<uint32>(instance));     // scrambling seed -- Sobol mode only
 
                 for (size_t i = 0; i < m_sample_count; ++i)
                 {
@@ -68,6 +68,99 @@ namespace renderer
 
 namespace
 {
+    //
+    // A tile renderer that creates the actual tile renderer the first time it renders a tile.
+    //
+    // Since each rendering thread only ever uses its own tile renderer, this ensures that
+    // per-thread rendering state (shading context, texture cache, arena, tile buffers, etc.)
+    // is allocated and first touched by the thread using it, hence on its local NUMA node.
+    //
+
+    class DeferredTileRenderer
+      : public ITileRenderer
+    {
+      public:
+        DeferredTileRenderer(
+            ITileRendererFactory*   factory,
+            const size_t            thread_index,
+            boost::mutex&           creation_mutex)
+          : m_factory(factory)
+          , m_thread_index(thread_index)
+          , m_creation_mutex(creation_mutex)
+          , m_tile_renderer(0)
+        {
+        }
+
+        virtual void release() override
+        {
+            if (m_tile_renderer)
+                m_tile_renderer->release();
+
+            delete this;
+        }
+
+        virtual void render_tile(
+            const Frame&            frame,
+            const size_t            tile_x,
+            const size_t            tile_y,
+            const size_t            pass_hash,
+            IAbortSwitch&           abort_switch) override
+        {
+            get_tile_renderer()->render_tile(
+                frame,
+                tile_x,
+                tile_y,
+                pass_hash,
+                abort_switch);
+        }
+
+        virtual bool supports_tile_regions() const override
+        {
+            return get_tile_renderer()->supports_tile_regions();
+        }
+
+        virtual void render_tile_region(
+            const Frame&            frame,
+            const size_t            tile_x,
+            const size_t            tile_y,
+            const AABB2u&           region,
+            const size_t            pass_hash,
+            IAbortSwitch&           abort_switch) override
+        {
+            get_tile_renderer()->render_tile_region(
+                frame,
+                tile_x,
+                tile_y,
+                region,
+                pass_hash,
+                abort_switch);
+        }
+
+        virtual StatisticsVector get_statistics() const override
+        {
+            return m_tile_renderer ? m_tile_renderer->get_statistics() : StatisticsVector();
+        }
+
+      private:
+        ITileRendererFactory*       m_factory;
+        const size_t                m_thread_index;
+        boost::mutex&               m_creation_mutex;
+        mutable ITileRenderer*      m_tile_renderer;
+
+        ITileRenderer* get_tile_renderer() const
+        {
+            if (m_tile_renderer == 0)
+            {
+                // Tile renderer factories are not required to be thread-safe.
+                boost::mutex::scoped_lock lock(m_creation_mutex);
+                m_tile_renderer = m_factory->create(m_thread_index);
+            }
+
+            return m_tile_renderer;
+        }
+    };
+
+
     //
     // Generic frame renderer.
     //
@@ -97,11 +190,18 @@ namespace
                     m_job_queue,
                     m_params.m_thread_count,
                     JobManager::KeepRunningOnEmptyQueue));
+            m_job_manager->set_thread_affinities(m_params.m_thread_affinities);
 
-            // Instantiate tile renderers, one per rendering thread.
+            // Instantiate tile renderers, one per rendering thread. When rendering threads are
+            // bound to specific cores, let each thread create its own tile renderer.
             m_tile_renderers.reserve(m_params.m_thread_count);
             for (size_t i = 0; i < m_params.m_thread_count; ++i)
-                m_tile_renderers.push_back(tile_renderer_factory->create(i));
+            {
+                m_tile_renderers.push_back(
+                    m_params.m_thread_affinities.empty()
+                        ? tile_renderer_factory->create(i)
+                        : new DeferredTileRenderer(tile_renderer_factory, i, m_tile_renderer_creation_mutex));
+            }
 
             if (tile_callback_factory)
             {
@@ -115,10 +215,12 @@ namespace
                 "rendering settings:\n"
                 "  spectrum mode                 %s\n"
                 "  sampling mode                 %s\n"
-                "  threads                       %s",
+                "  threads                       %s\n"
+                "  thread affinity               %s",
                 get_spectrum_mode_name(get_spectrum_mode(params)).c_str(),
                 get_sampling_context_mode_name(get_sampling_context_mode(params)).c_str(),
-                pretty_int(m_params.m_thread_count).c_str());
+                pretty_int(m_params.m_thread_count).c_str(),
+                params.get_optional<string>("thread_affinity", "none").c_str());
         }
 
         virtual ~GenericFrameRenderer()
@@ -173,6 +275,7 @@ namespace
                     m_params.m_tile_ordering,
                     m_params.m_pass_count,
                     m_params.m_spectrum_mode,
+                    m_params.m_tile_splitting,
                     m_tile_renderers,
                     m_tile_callbacks,
                     m_pass_callback,
@@ -220,15 +323,19 @@ namespace
         {
             const Spectrum::Mode                m_spectrum_mode;
             const size_t                        m_thread_count;     // number of rendering threads
+            vector<vector<size_t>>              m_thread_affinities; // cores rendering threads are bound to
             const TileJobFactory::TileOrdering  m_tile_ordering;    // tile rendering order
             const size_t                        m_pass_count;       // number of rendering passes
+            const bool                          m_tile_splitting;   // split tiles to keep all threads busy?
 
             explicit Parameters(const ParamArray& params)
               : m_spectrum_mode(get_spectrum_mode(params))
               , m_thread_count(get_rendering_thread_count(params))
               , m_tile_ordering(get_tile_ordering(params))
               , m_pass_count(params.get_optional<size_t>("passes", 1))
+              , m_tile_splitting(params.get_optional<bool>("tile_splitting", true))
             {
+                get_rendering_thread_affinities(params, m_thread_affinities);
             }
 
             static TileJobFactory::TileOrdering get_tile_ordering(const ParamArray& params)
@@ -274,6 +381,7 @@ namespace
                 const TileJobFactory::TileOrdering  tile_ordering,
                 const size_t                        pass_count,
                 const Spectrum::Mode                spectrum_mode,
+                const bool                          tile_splitting,
                 vector<ITileRenderer*>&             tile_renderers,
                 vector<ITileCallback*>&             tile_callbacks,
                 IPassCallback*                      pass_callback,
@@ -284,6 +392,7 @@ namespace
               , m_tile_ordering(tile_ordering)
               , m_pass_count(pass_count)
               , m_spectrum_mode(spectrum_mode)
+              , m_tile_splitting(tile_splitting)
               , m_tile_renderers(tile_renderers)
               , m_tile_callbacks(tile_callbacks)
               , m_pass_callback(pass_callback)
@@ -320,6 +429,7 @@ namespace
                         m_tile_callbacks,
                         pass_hash,
                         m_spectrum_mode,
+                        m_tile_splitting ? &m_job_queue : 0,
                         tile_jobs,
                         m_abort_switch);
 
@@ -350,6 +460,7 @@ namespace
             IPassCallback*                          m_pass_callback;
             const size_t                            m_pass_count;
             const Spectrum::Mode                    m_spectrum_mode;
+            const bool                              m_tile_splitting;
             JobQueue&                               m_job_queue;
             IAbortSwitch&                           m_abort_switch;
             bool&                                   m_is_rendering;
@@ -364,6 +475,7 @@ namespace
         AbortSwitch                 m_abort_switch;
 
         vector<ITileRenderer*>      m_tile_renderers;   // tile renderers, one per thread
+        boost::mutex                m_tile_renderer_creation_mutex;
         vector<ITileCallback*>      m_tile_callbacks;   // tile callbacks, none or one per thread
         IPassCallback*              m_pass_callback;
 
@@ -482,6 +594,14 @@ Dictionary GenericFrameRendererFactory::get_params_metadata()
                             .insert("label", "Random")
                             .insert("help", "Random tile ordering"))));
 
+    metadata.dictionaries().insert(
+        "tile_splitting",
+        Dictionary()
+            .insert("type", "bool")
+            .insert("default", "true")
+            .insert("label", "Tile Splitting")
+            .insert("help", "Split the last tiles of each pass to keep all rendering threads busy"));
+
     return metadata;
 }
 
@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/aov/aovaccumulator.h"
+#include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/rendering/isamplerenderer.h"
 #include "renderer/kernel/rendering/localsampleaccumulationbuffer.h"
 #include "renderer/kernel/rendering/pixelcontext.h"
@@ -75,7 +76,7 @@ namespace
             const ParamArray&               params,
             const size_t                    generator_index,
             const size_t                    generator_count)
-          : SampleGeneratorBase(generator_index, generator_count)
+          : SampleGeneratorBase(generator_index, generator_count, frame.aov_images().size())
           , m_params(params)
           , m_frame(frame)
           , m_canvas_width(frame.image().properties().m_canvas_width)
@@ -87,6 +88,7 @@ namespace
           , m_sample_renderer(sample_renderer_factory->create(generator_index))
           , m_window_width_next_pow2(next_power(static_cast<double>(m_window_width), 2.0))
           , m_window_height_next_pow3(next_power(static_cast<double>(m_window_height), 3.0))
+          , m_aov_accumulators(frame.aovs())
         {
         }
 
@@ -144,7 +146,8 @@ namespace
 
         virtual size_t generate_samples(
             const size_t                    sequence_index,
-            SampleVector&                   samples) override
+            SampleVector&                   samples,
+            SampleAOVArray&                 sample_aovs) override
         {
             // Compute the sample position in NDC.
             const size_t Bases[2] = { 2, 3 };
@@ -180,7 +183,7 @@ namespace
                 sequence_index);            // initial instance number
 
             // Render the sample.
-            ShadingResult shading_result;
+            ShadingResult shading_result(sample_aovs.get_aov_count());
             m_sample_renderer->render_sample(
                 sampling_context,
                 pixel_context,
@@ -204,6 +207,10 @@ namespace
             sample.m_color = shading_result.m_main;
             samples.push_back(sample);
 
+            // Store its AOVs.
+            if (sample_aovs.get_aov_count() > 0)
+                sample_aovs.push_back(shading_result.m_aovs);
+
             return 1;
         }
     };
@@ -250,6 +257,7 @@ SampleAccumulationBuffer* GenericSampleGeneratorFactory::create_sample_accumulat
         new LocalSampleAccumulationBuffer(
             props.m_canvas_width,
             props.m_canvas_height,
+            m_frame.aov_images().size(),
             m_frame.get_filter());
 }
 
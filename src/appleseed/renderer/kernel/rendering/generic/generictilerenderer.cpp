@@ -117,6 +117,32 @@ namespace
             const size_t    tile_y,
             const size_t    pass_hash,
             IAbortSwitch&   abort_switch) override
+        {
+            const Tile& tile = frame.image().tile(tile_x, tile_y);
+
+            render_tile_region(
+                frame,
+                tile_x,
+                tile_y,
+                AABB2u(
+                    Vector2u(0, 0),
+                    Vector2u(tile.get_width() - 1, tile.get_height() - 1)),
+                pass_hash,
+                abort_switch);
+        }
+
+        virtual bool supports_tile_regions() const override
+        {
+            return m_framebuffer_factory->supports_tile_regions();
+        }
+
+        virtual void render_tile_region(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const AABB2u&   region,
+            const size_t    pass_hash,
+            IAbortSwitch&   abort_switch) override
         {
             // Retrieve frame properties.
             const CanvasProperties& frame_properties = frame.image().properties();
@@ -145,6 +171,12 @@ namespace
             tile_bbox.max.x -= tile_origin_x;
             tile_bbox.max.y -= tile_origin_y;
 
+            // Restrict the bounding box to the requested region.
+            const AABB2i region_bbox(region);
+            tile_bbox = AABB2i::intersect(tile_bbox, region_bbox);
+            if (!tile_bbox.is_valid())
+                return;
+
             // Pad the bounding box with tile margins.
             AABB2i padded_tile_bbox;
             padded_tile_bbox.min.x = tile_bbox.min.x - m_margin_width;
@@ -156,12 +188,13 @@ namespace
             m_pixel_renderer->on_tile_begin(frame, tile, aov_tiles);
 
             // Create the framebuffer into which we will accumulate the samples.
+            // Samples are only accumulated into the pixels of the region.
             ShadingResultFrameBuffer* framebuffer =
                 m_framebuffer_factory->create(
                     frame,
                     tile_x,
                     tile_y,
-                    tile_bbox);
+                    AABB2u(tile_bbox));
             assert(framebuffer);
 
             // Loop over tile pixels.
@@ -202,13 +235,13 @@ namespace
             }
 
             // Develop the framebuffer to the tile.
-            framebuffer->develop_to_tile(tile, aov_tiles);
+            framebuffer->develop_to_tile(tile, aov_tiles, region_bbox);
 
             // Release the framebuffer.
             m_framebuffer_factory->destroy(framebuffer);
 
             // Inform the pixel renderer that we are done rendering the tile.
-            m_pixel_renderer->on_tile_end(frame, tile, aov_tiles);
+            m_pixel_renderer->on_tile_end(frame, tile, aov_tiles, region_bbox);
         }
 
         virtual StatisticsVector get_statistics() const override
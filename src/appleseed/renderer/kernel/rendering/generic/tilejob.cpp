@@ -39,8 +39,10 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/vector.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <exception>
 
@@ -54,23 +56,39 @@ namespace renderer
 // TileJob class implementation.
 //
 
+namespace
+{
+    // Regions smaller than this (in pixels, along their longest side) are not split further.
+    const size_t MinRegionSize = 16;
+
+    // Number of rows of pixels rendered between two opportunities to split the region.
+    // Each chunk renders the filter margins of the tile again.
+    const size_t ChunkHeight = 16;
+}
+
 TileJob::TileJob(
     const TileRendererVector&   tile_renderers,
     const TileCallbackVector&   tile_callbacks,
     const Frame&                frame,
     const size_t                tile_x,
     const size_t                tile_y,
+    const AABB2u&               region,
     const size_t                pass_hash,
     const Spectrum::Mode        spectrum_mode,
+    JobQueue*                   job_queue,
     IAbortSwitch&               abort_switch)
   : m_tile_renderers(tile_renderers)
   , m_tile_callbacks(tile_callbacks)
   , m_frame(frame)
   , m_tile_x(tile_x)
   , m_tile_y(tile_y)
+  , m_region(region)
   , m_pass_hash(pass_hash)
   , m_spectrum_mode(spectrum_mode)
+  , m_job_queue(job_queue)
   , m_abort_switch(abort_switch)
+  , m_first_region(true)
+  , m_pending_regions(new boost::atomic<size_t>(1))
 {
     // Either there is no tile callback, or there is the same number
     // of tile callbacks and rendering threads.
@@ -79,45 +97,118 @@ TileJob::TileJob(
         || m_tile_callbacks.size() == tile_renderers.size());
 }
 
+TileJob::TileJob(
+    const TileJob&              parent,
+    const AABB2u&               region)
+  : m_tile_renderers(parent.m_tile_renderers)
+  , m_tile_callbacks(parent.m_tile_callbacks)
+  , m_frame(parent.m_frame)
+  , m_tile_x(parent.m_tile_x)
+  , m_tile_y(parent.m_tile_y)
+  , m_region(region)
+  , m_pass_hash(parent.m_pass_hash)
+  , m_spectrum_mode(parent.m_spectrum_mode)
+  , m_job_queue(parent.m_job_queue)
+  , m_abort_switch(parent.m_abort_switch)
+  , m_first_region(false)
+  , m_pending_regions(parent.m_pending_regions)
+{
+}
+
 void TileJob::execute(const size_t thread_index)
 {
     // Initialize thread-local variables.
     Spectrum::set_mode(m_spectrum_mode);
 
-    // Retrieve the tile callback.
     assert(thread_index < m_tile_renderers.size());
+    ITileRenderer* tile_renderer = m_tile_renderers[thread_index];
+
+    // Retrieve the tile callback.
     ITileCallback* tile_callback =
         m_tile_callbacks.size() == m_tile_renderers.size()
             ? m_tile_callbacks[thread_index]
             : 0;
 
-    // Call the pre-render tile callback.
-    if (tile_callback)
+    // Call the pre-render tile callback, before any region is split off.
+    if (tile_callback && m_first_region)
         tile_callback->on_tile_begin(&m_frame, m_tile_x, m_tile_y);
 
     try
     {
-        // Render the tile.
-        m_tile_renderers[thread_index]->render_tile(
-            m_frame,
-            m_tile_x,
-            m_tile_y,
-            m_pass_hash,
-            m_abort_switch);
+        // Render the region in chunks so that idle rendering threads can take over parts of it.
+        if (m_job_queue && m_tile_renderers.size() > 1 && tile_renderer->supports_tile_regions())
+            render_region_in_chunks(tile_renderer);
+        else
+        {
+            tile_renderer->render_tile_region(
+                m_frame,
+                m_tile_x,
+                m_tile_y,
+                m_region,
+                m_pass_hash,
+                m_abort_switch);
+        }
     }
     catch (const exception&)
     {
-        // Call the post-render tile callback.
-        if (tile_callback)
+        // Call the post-render tile callback if this was the last region of the tile.
+        if (--*m_pending_regions == 0 && tile_callback)
             tile_callback->on_tile_end(&m_frame, m_tile_x, m_tile_y);
 
         // Rethrow the exception.
         throw;
     }
 
-    // Call the post-render tile callback.
-    if (tile_callback)
+    // Call the post-render tile callback if this was the last region of the tile.
+    if (--*m_pending_regions == 0 && tile_callback)
         tile_callback->on_tile_end(&m_frame, m_tile_x, m_tile_y);
 }
 
+void TileJob::render_region_in_chunks(ITileRenderer* tile_renderer)
+{
+    while (true)
+    {
+        // Hand parts of the remainder of the region over to idle rendering threads.
+        split_region();
+
+        // Render the next rows of the region.
+        AABB2u chunk = m_region;
+        chunk.max.y = min(m_region.min.y + ChunkHeight - 1, m_region.max.y);
+        tile_renderer->render_tile_region(
+            m_frame,
+            m_tile_x,
+            m_tile_y,
+            chunk,
+            m_pass_hash,
+            m_abort_switch);
+
+        if (chunk.max.y == m_region.max.y || m_abort_switch.is_aborted())
+            break;
+
+        m_region.min.y = chunk.max.y + 1;
+    }
+}
+
+void TileJob::split_region()
+{
+    // Worker threads are idle when there are fewer running and scheduled jobs than threads.
+    while (m_job_queue->get_total_job_count() < m_tile_renderers.size())
+    {
+        const Vector2u extent = m_region.extent() + Vector2u(1);
+        const size_t axis = extent.x >= extent.y ? 0 : 1;
+
+        if (extent[axis] < 2 * MinRegionSize)
+            break;
+
+        // Keep the first half of the region and schedule the second half.
+        AABB2u second_half = m_region;
+        const size_t split = m_region.min[axis] + extent[axis] / 2;
+        m_region.max[axis] = split - 1;
+        second_half.min[axis] = split;
+
+        ++*m_pending_regions;
+        m_job_queue->schedule(new TileJob(*this, second_half));
+    }
+}
+
 }   // namespace renderer
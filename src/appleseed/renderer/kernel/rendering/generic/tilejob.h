@@ -34,10 +34,15 @@
 #include "renderer/global/globaltypes.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/aabb.h"
 #include "foundation/utility/job.h"
 
+// Boost headers.
+#include "boost/atomic/atomic.hpp"
+
 // Standard headers.
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 // Forward declarations.
@@ -59,29 +64,50 @@ class TileJob
     typedef std::vector<ITileRenderer*> TileRendererVector;
     typedef std::vector<ITileCallback*> TileCallbackVector;
 
-    // Constructor.
+    // Constructor. The job renders the given region (in tile space) of the tile.
+    // If a job queue is provided, the job renders its region a few rows at a time
+    // and, between two chunks, splits the remainder of the region and schedules the
+    // pieces to the queue when rendering threads are idle, e.g. at the end of a pass.
+    // Tile callbacks are invoked once per tile, not once per region.
     TileJob(
         const TileRendererVector&   tile_renderers,
         const TileCallbackVector&   tile_callbacks,
         const Frame&                frame,
         const size_t                tile_x,
         const size_t                tile_y,
+        const foundation::AABB2u&   region,
         const size_t                pass_hash,
         const Spectrum::Mode        spectrum_mode,
+        foundation::JobQueue*       job_queue,
         foundation::IAbortSwitch&   abort_switch);
 
     // Execute the job.
     virtual void execute(const size_t thread_index);
 
   private:
+    // Number of regions of the tile that remain to be rendered.
+    typedef std::shared_ptr<boost::atomic<size_t>> RegionCounter;
+
     const TileRendererVector&       m_tile_renderers;
     const TileCallbackVector&       m_tile_callbacks;
     const Frame&                    m_frame;
     const size_t                    m_tile_x;
     const size_t                    m_tile_y;
+    foundation::AABB2u              m_region;
     const size_t                    m_pass_hash;
     const Spectrum::Mode            m_spectrum_mode;
+    foundation::JobQueue*           m_job_queue;
     foundation::IAbortSwitch&       m_abort_switch;
+    const bool                      m_first_region;
+    RegionCounter                   m_pending_regions;
+
+    // Constructor for the jobs rendering the regions split off the first one.
+    TileJob(
+        const TileJob&              parent,
+        const foundation::AABB2u&   region);
+
+    void render_region_in_chunks(ITileRenderer* tile_renderer);
+    void split_region();
 };
 
 }       // namespace renderer
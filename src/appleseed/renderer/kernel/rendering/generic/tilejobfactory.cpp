@@ -36,7 +36,10 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
 #include "foundation/math/ordering.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/otherwise.h"
 
 // Standard headers.
@@ -59,6 +62,7 @@ void TileJobFactory::create(
     const TileJob::TileCallbackVector&  tile_callbacks,
     const size_t                        pass_hash,
     const Spectrum::Mode                spectrum_mode,
+    JobQueue*                           job_queue,
     TileJobVector&                      tile_jobs,
     IAbortSwitch&                       abort_switch)
 {
@@ -82,6 +86,12 @@ void TileJobFactory::create(
         assert(tile_x < props.m_tile_count_x);
         assert(tile_y < props.m_tile_count_y);
 
+        // Compute the region covered by the tile.
+        const Tile& tile = frame.image().tile(tile_x, tile_y);
+        const AABB2u region(
+            Vector2u(0, 0),
+            Vector2u(tile.get_width() - 1, tile.get_height() - 1));
+
         // Create the tile job.
         tile_jobs.push_back(
             new TileJob(
@@ -90,8 +100,10 @@ void TileJobFactory::create(
                 frame,
                 tile_x,
                 tile_y,
+                region,
                 pass_hash,
                 spectrum_mode,
+                job_queue,
                 abort_switch));
     }
 }
@@ -44,6 +44,7 @@
 // Forward declarations.
 namespace foundation    { class CanvasProperties; }
 namespace foundation    { class IAbortSwitch; }
+namespace foundation    { class JobQueue; }
 namespace renderer      { class Frame; }
 namespace renderer      { class TileJob; }
 
@@ -68,7 +69,8 @@ class TileJobFactory
         RandomOrdering
     };
 
-    // Create tile jobs for a given frame.
+    // Create tile jobs for a given frame. If a job queue is provided, tile jobs
+    // may split themselves and schedule the pieces to it (see TileJob).
     void create(
         const Frame&                        frame,
         const TileOrdering                  tile_ordering,
@@ -76,6 +78,7 @@ class TileJobFactory
         const TileJob::TileCallbackVector&  tile_callbacks,
         const size_t                        pass_hash,
         const Spectrum::Mode                spectrum_mode,
+        foundation::JobQueue*               job_queue,
         TileJobVector&                      tile_jobs,
         foundation::IAbortSwitch&           abort_switch);
 
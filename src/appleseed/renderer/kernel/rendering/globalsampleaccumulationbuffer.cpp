@@ -1,4 +1,3 @@
-
 //
 // This source file is part of appleseed.
 // Visit http://appleseedhq.net/ for additional information and resources.
@@ -37,27 +36,73 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/color.h"
+#include "foundation/image/filteredtile.h"
 #include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/utility/countof.h"
 #include "foundation/utility/job/iabortswitch.h"
 
 // Boost headers.
 #include "boost/chrono/duration.hpp"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
 using namespace foundation;
 using namespace std;
 
 namespace renderer
 {
 
+//
+// GlobalSampleAccumulationBuffer class implementation.
+//
+// To shorten the time to first image, samples are not only accumulated into the
+// full resolution framebuffer but also into a few low resolution framebuffers,
+// at 1/4, 1/8 and 1/16 of the resolution in each dimension. The coarsest level
+// that samples are still pushed to is the "active level"; it is the one that is
+// displayed, upsampled to the resolution of the frame. As soon as a finer level
+// has received on average one sample per pixel, it becomes the new active level.
+// Since a pixel of a coarse level collects the contributions of many pixels of
+// the full resolution framebuffer, its value is scaled by the ratio of pixel
+// areas when the level is developed.
+//
+
 GlobalSampleAccumulationBuffer::GlobalSampleAccumulationBuffer(
     const size_t    width,
     const size_t    height,
     const Filter2f& filter)
-  : m_fb(width, height, 3, filter)
-  , m_filter_rcp_norm_factor(1.0f / compute_normalization_factor(filter))
+  : m_filter_rcp_norm_factor(1.0f / compute_normalization_factor(filter))
+{
+    m_levels.push_back(new FilteredTile(width, height, 3, filter));
+
+    const size_t PreviewLevelDivisors[] = { 4, 8, 16 };
+
+    for (size_t i = 0; i < countof(PreviewLevelDivisors); ++i)
+    {
+        const size_t level_width = max<size_t>(width / PreviewLevelDivisors[i], 1);
+        const size_t level_height = max<size_t>(height / PreviewLevelDivisors[i], 1);
+
+        const FilteredTile* finer_level = m_levels.back();
+        if (level_width == finer_level->get_width() && level_height == finer_level->get_height())
+            break;
+
+        m_levels.push_back(new FilteredTile(level_width, level_height, 3, filter));
+    }
+
+    m_remaining_samples = new boost::atomic<int64>[m_levels.size()];
+
+    clear();
+}
+
+GlobalSampleAccumulationBuffer::~GlobalSampleAccumulationBuffer()
 {
+    delete[] m_remaining_samples;
+
+    for (size_t i = 0, e = m_levels.size(); i < e; ++i)
+        delete m_levels[i];
 }
 
 void GlobalSampleAccumulationBuffer::clear()
@@ -67,41 +112,85 @@ void GlobalSampleAccumulationBuffer::clear()
 
     m_sample_count = 0;
 
-    m_fb.clear();
+    for (size_t i = 0, e = m_levels.size(); i < e; ++i)
+    {
+        m_levels[i]->clear();
+
+        m_remaining_samples[i] =
+            static_cast<int64>(m_levels[i]->get_pixel_count());
+    }
+
+    m_active_level = static_cast<uint32>(m_levels.size() - 1);
 }
 
 void GlobalSampleAccumulationBuffer::store_samples(
-    const size_t    sample_count,
-    const Sample    samples[],
-    IAbortSwitch&   abort_switch)
+    const size_t            sample_count,
+    const Sample            samples[],
+    const SampleAOVArray&   sample_aovs,
+    IAbortSwitch&           abort_switch)
 {
-    // Request non-exclusive access.
-    boost::shared_lock<boost::shared_mutex> lock(m_mutex, boost::defer_lock);
-    while (true)
+    // AOVs are not supported by this buffer.
+    assert(sample_aovs.size() == 0);
+
     {
-        if (abort_switch.is_aborted())
-            return;
-        if (lock.try_lock_for(boost::chrono::milliseconds(5)))
-            break;
-    }
+        // Request non-exclusive access.
+        boost::shared_lock<boost::shared_mutex> lock(m_mutex, boost::defer_lock);
+        while (true)
+        {
+            if (abort_switch.is_aborted())
+                return;
+            if (lock.try_lock_for(boost::chrono::milliseconds(5)))
+                break;
+        }
 
-    const float fw = static_cast<float>(m_fb.get_width());
-    const float fh = static_cast<float>(m_fb.get_height());
-    size_t counter = 0;
+        // Store samples at every level, starting with the highest resolution level up to the active level.
+        size_t counter = 0;
+        for (uint32 i = 0, e = m_active_level; i <= e; ++i)
+        {
+            FilteredTile* level = m_levels[i];
+            const float fw = static_cast<float>(level->get_width());
+            const float fh = static_cast<float>(level->get_height());
 
-    const Sample* sample_end = samples + sample_count;
-    for (const Sample* s = samples; s < sample_end; ++s)
-    {
-        if ((counter++ & 4096) == 0 && abort_switch.is_aborted())
-            return;
+            const Sample* sample_end = samples + sample_count;
+            for (const Sample* s = samples; s < sample_end; ++s)
+            {
+                if ((counter++ & 4096) == 0 && abort_switch.is_aborted())
+                    return;
 
-        const float fx = s->m_position.x * fw;
-        const float fy = s->m_position.y * fh;
+                const float fx = s->m_position.x * fw;
+                const float fy = s->m_position.y * fh;
 
-        Color3f value(s->m_color.rgb());
-        value *= m_filter_rcp_norm_factor;
+                Color3f value(s->m_color.rgb());
+                value *= m_filter_rcp_norm_factor;
 
-        m_fb.add(fx, fy, &value[0]);
+                level->add(fx, fy, &value[0]);
+            }
+        }
+    }
+
+    // Potentially update the new active level if we're not already at the highest resolution level.
+    if (m_active_level > 0)
+    {
+        // Update sample counters for all levels up to the active level.
+        const int64 n = static_cast<int64>(sample_count);
+        for (uint32 i = 0, e = m_active_level; i <= e; ++i)
+            m_remaining_samples[i].fetch_sub(n);
+
+        // Find the new active level.
+        uint32 cur_active_level = m_active_level;
+        uint32 new_active_level = cur_active_level;
+        for (uint32 i = 0, e = cur_active_level; i < e; ++i)
+        {
+            if (m_remaining_samples[i] <= 0)
+            {
+                new_active_level = i;
+                break;
+            }
+        }
+
+        // Attempt to update the active level. It's OK if we fail, another thread will succeed.
+        if (new_active_level < cur_active_level)
+            m_active_level.compare_exchange_strong(cur_active_level, new_active_level);
     }
 }
 
@@ -122,11 +211,17 @@ void GlobalSampleAccumulationBuffer::develop_to_frame(
     Image& image = frame.image();
     const CanvasProperties& frame_props = image.properties();
 
-    assert(frame_props.m_canvas_width == m_fb.get_width());
-    assert(frame_props.m_canvas_height == m_fb.get_height());
+    assert(frame_props.m_canvas_width == m_levels[0]->get_width());
+    assert(frame_props.m_canvas_height == m_levels[0]->get_height());
     assert(frame_props.m_channel_count == 4);
 
-    const float scale = 1.0f / m_sample_count;
+    const FilteredTile& level = *m_levels[m_active_level];
+
+    // Account for the difference of pixel area between the active level and the frame.
+    const float area_ratio =
+        static_cast<float>(level.get_pixel_count()) /
+        static_cast<float>(m_levels[0]->get_pixel_count());
+    const float scale = area_ratio / m_sample_count;
 
     for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
     {
@@ -140,7 +235,14 @@ void GlobalSampleAccumulationBuffer::develop_to_frame(
             const size_t x = tx * frame_props.m_tile_width;
             const size_t y = ty * frame_props.m_tile_height;
 
-            develop_to_tile(tile, x, y, tx, ty, scale);
+            develop_to_tile(
+                tile,
+                frame_props.m_canvas_width,
+                frame_props.m_canvas_height,
+                level,
+                x,
+                y,
+                scale);
         }
     }
 }
@@ -150,22 +252,33 @@ void GlobalSampleAccumulationBuffer::increment_sample_count(const uint64 delta_s
     m_sample_count += delta_sample_count;
 }
 
+size_t GlobalSampleAccumulationBuffer::get_active_level() const
+{
+    return m_active_level;
+}
+
 void GlobalSampleAccumulationBuffer::develop_to_tile(
-    Tile&           tile,
-    const size_t    origin_x,
-    const size_t    origin_y,
-    const size_t    tile_x,
-    const size_t    tile_y,
-    const float     scale) const
+    Tile&               tile,
+    const size_t        image_width,
+    const size_t        image_height,
+    const FilteredTile& level,
+    const size_t        origin_x,
+    const size_t        origin_y,
+    const float         scale) const
 {
     const size_t tile_width = tile.get_width();
     const size_t tile_height = tile.get_height();
+    const size_t level_width = level.get_width();
+    const size_t level_height = level.get_height();
 
     for (size_t y = 0; y < tile_height; ++y)
     {
+        const size_t src_y = (origin_y + y) * level_height / image_height;
+
         for (size_t x = 0; x < tile_width; ++x)
         {
-            const float* ptr = m_fb.pixel(origin_x + x, origin_y + y);
+            const size_t src_x = (origin_x + x) * level_width / image_width;
+            const float* ptr = level.pixel(src_x, src_y);
 
             Color4f color(ptr[1], ptr[2], ptr[3], 1.0f);
             color.rgb() *= scale;
@@ -34,20 +34,23 @@
 #include "renderer/kernel/rendering/sampleaccumulationbuffer.h"
 
 // appleseed.foundation headers.
-#include "foundation/image/filteredtile.h"
 #include "foundation/math/filter.h"
+#include "foundation/platform/atomic.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
 #include "foundation/platform/types.h"
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
+namespace foundation    { class FilteredTile; }
 namespace foundation    { class IAbortSwitch; }
 namespace foundation    { class Tile; }
 namespace renderer      { class Frame; }
 namespace renderer      { class Sample; }
+namespace renderer      { class SampleAOVArray; }
 
 namespace renderer
 {
@@ -62,6 +65,9 @@ class GlobalSampleAccumulationBuffer
         const size_t                height,
         const foundation::Filter2f& filter);
 
+    // Destructor.
+    ~GlobalSampleAccumulationBuffer();
+
     // Reset the buffer to its initial state. Thread-safe.
     virtual void clear() override;
 
@@ -69,6 +75,7 @@ class GlobalSampleAccumulationBuffer
     virtual void store_samples(
         const size_t                sample_count,
         const Sample                samples[],
+        const SampleAOVArray&       sample_aovs,
         foundation::IAbortSwitch&   abort_switch) override;
 
     // Develop the buffer to a frame. Thread-safe.
@@ -79,18 +86,24 @@ class GlobalSampleAccumulationBuffer
     // Increment the number of samples used for pixel values renormalization. Thread-safe.
     void increment_sample_count(const foundation::uint64 delta_sample_count);
 
+    // Exposed for tests.
+    size_t get_active_level() const;
+
   private:
-    boost::shared_mutex             m_mutex;
-    foundation::FilteredTile        m_fb;
-    const float                     m_filter_rcp_norm_factor;
+    boost::shared_mutex                     m_mutex;
+    std::vector<foundation::FilteredTile*>  m_levels;
+    boost::atomic<foundation::int64>*       m_remaining_samples;
+    boost::atomic<foundation::uint32>       m_active_level;
+    const float                             m_filter_rcp_norm_factor;
 
     void develop_to_tile(
-        foundation::Tile&           tile,
-        const size_t                origin_x,
-        const size_t                origin_y,
-        const size_t                tile_x,
-        const size_t                tile_y,
-        const float                 scale) const;
+        foundation::Tile&                   tile,
+        const size_t                        image_width,
+        const size_t                        image_height,
+        const foundation::FilteredTile&     level,
+        const size_t                        origin_x,
+        const size_t                        origin_y,
+        const float                         scale) const;
 };
 
 }       // namespace renderer
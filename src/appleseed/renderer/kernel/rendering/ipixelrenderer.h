@@ -63,11 +63,14 @@ class IPixelRenderer
         foundation::Tile&           tile,
         TileStack&                  aov_tiles) = 0;
 
-    // This method is called after a tile has been rendered.
+    // This method is called after a tile, or a region of a tile, has been rendered.
+    // The region is expressed in tile space and covers the whole tile when the tile
+    // was rendered at once.
     virtual void on_tile_end(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) = 0;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2i&   region) = 0;
 
     // Render a pixel.
     virtual void render_pixel(
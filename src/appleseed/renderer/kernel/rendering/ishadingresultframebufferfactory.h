@@ -54,6 +54,10 @@ class IShadingResultFrameBufferFactory
         const size_t                tile_y,
         const foundation::AABB2u&   tile_bbox) = 0;
 
+    // Return true if framebuffers for disjoint regions of a given tile can be
+    // created and used concurrently (see ITileRenderer::render_tile_region()).
+    virtual bool supports_tile_regions() const = 0;
+
     virtual void destroy(
         ShadingResultFrameBuffer*   framebuffer) = 0;
 };
@@ -32,6 +32,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
+#include "foundation/math/aabb.h"
 
 // Standard headers.
 #include <cstddef>
@@ -60,6 +61,20 @@ class ITileRenderer
         const size_t                pass_hash,
         foundation::IAbortSwitch&   abort_switch) = 0;
 
+    // Return true if render_tile_region() is supported.
+    virtual bool supports_tile_regions() const = 0;
+
+    // Render a rectangular region (in tile space) of a tile. Disjoint regions of a
+    // given tile can be rendered concurrently by different tile renderers, and must
+    // produce the same pixels as rendering the whole tile at once.
+    virtual void render_tile_region(
+        const Frame&                frame,
+        const size_t                tile_x,
+        const size_t                tile_y,
+        const foundation::AABB2u&   region,
+        const size_t                pass_hash,
+        foundation::IAbortSwitch&   abort_switch) = 0;
+
     // Retrieve performance statistics.
     virtual foundation::StatisticsVector get_statistics() const = 0;
 };
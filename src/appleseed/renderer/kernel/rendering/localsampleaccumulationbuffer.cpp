@@ -31,6 +31,7 @@
 #include "localsampleaccumulationbuffer.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/aov/aovsettings.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
 #include "renderer/kernel/rendering/sample.h"
@@ -77,13 +78,19 @@ namespace renderer
 //   pushing samples to and the level that is displayed. As soon as a level contains enough
 //   samples, it becomes the new active level.
 //
+//   AOVs, if any, are accumulated into a separate full resolution framebuffer with one
+//   weight channel followed by the RGBA channels of each AOV. They are developed along
+//   with the active level, pixels that did not receive any sample yet being left black.
+//
 
 //#define PRINT_DETAILED_PERF_REPORTS
 
 LocalSampleAccumulationBuffer::LocalSampleAccumulationBuffer(
     const size_t        width,
     const size_t        height,
+    const size_t        aov_count,
     const Filter2f&     filter)
+  : m_aov_fb(aov_count > 0 ? new FilteredTile(width, height, 4 * aov_count, filter) : 0)
 {
     const size_t MinSize = 32;
 
@@ -110,6 +117,8 @@ LocalSampleAccumulationBuffer::~LocalSampleAccumulationBuffer()
 {
     delete[] m_remaining_pixels;
 
+    delete m_aov_fb;
+
     for (size_t i = 0, e = m_levels.size(); i < e; ++i)
         delete m_levels[i];
 }
@@ -139,13 +148,17 @@ void LocalSampleAccumulationBuffer::clear()
             static_cast<int32>(m_levels[i]->get_pixel_count());
     }
 
+    if (m_aov_fb)
+        m_aov_fb->clear();
+
     m_active_level = static_cast<uint32>(m_levels.size() - 1);
 }
 
 void LocalSampleAccumulationBuffer::store_samples(
-    const size_t        sample_count,
-    const Sample        samples[],
-    IAbortSwitch&       abort_switch)
+    const size_t            sample_count,
+    const Sample            samples[],
+    const SampleAOVArray&   sample_aovs,
+    IAbortSwitch&           abort_switch)
 {
 #ifdef PRINT_DETAILED_PERF_REPORTS
     Stopwatch<DefaultWallclockTimer> sw(0);
@@ -189,6 +202,32 @@ void LocalSampleAccumulationBuffer::store_samples(
             }
         }
 
+        // Store AOVs at full resolution.
+        if (m_aov_fb && sample_aovs.size() > 0)
+        {
+            assert(sample_aovs.size() == sample_count);
+            assert(4 * sample_aovs.get_aov_count() + 1 == m_aov_fb->get_channel_count());
+
+            const float fb_width = static_cast<float>(m_aov_fb->get_width());
+            const float fb_height = static_cast<float>(m_aov_fb->get_height());
+
+            float values[4 * MaxAOVCount];
+
+            for (size_t i = 0; i < sample_count; ++i)
+            {
+                if ((counter++ & 4096) == 0 && abort_switch.is_aborted())
+                {
+                    m_lock.unlock_read();
+                    return;
+                }
+
+                const float fx = samples[i].m_position.x * fb_width;
+                const float fy = samples[i].m_position.y * fb_height;
+                sample_aovs.get(i, values);
+                m_aov_fb->add(fx, fy, values);
+            }
+        }
+
         m_lock.unlock_read();
     }
 
@@ -287,6 +326,17 @@ void LocalSampleAccumulationBuffer::develop_to_frame(
                 origin_x,
                 origin_y,
                 rect);
+
+            if (m_aov_fb)
+            {
+                TileStack aov_tiles = frame.aov_images().tiles(tx, ty);
+                develop_aovs_to_tiles(
+                    aov_tiles,
+                    *m_aov_fb,
+                    origin_x,
+                    origin_y,
+                    rect);
+            }
         }
     }
 
@@ -363,4 +413,35 @@ void LocalSampleAccumulationBuffer::develop_to_tile(
     }
 }
 
+void LocalSampleAccumulationBuffer::develop_aovs_to_tiles(
+    TileStack&          aov_tiles,
+    const FilteredTile& aov_fb,
+    const size_t        origin_x,
+    const size_t        origin_y,
+    const AABB2u&       rect)
+{
+    if (rect.min.x > rect.max.x)
+        return;
+
+    const size_t aov_count = (aov_fb.get_channel_count() - 1) / 4;
+
+    for (size_t iy = rect.min.y; iy <= rect.max.y; ++iy)
+    {
+        for (size_t ix = rect.min.x; ix <= rect.max.x; ++ix)
+        {
+            const float* ptr = aov_fb.pixel(ix, iy);
+
+            const float weight = *ptr++;
+            const float rcp_weight = weight == 0.0f ? 0.0f : 1.0f / weight;
+
+            for (size_t i = 0; i < aov_count; ++i)
+            {
+                const Color4f aov(ptr[0], ptr[1], ptr[2], ptr[3]);
+                aov_tiles.set_pixel(ix - origin_x, iy - origin_y, i, aov * rcp_weight);
+                ptr += 4;
+            }
+        }
+    }
+}
+
 }   // namespace renderer
@@ -51,6 +51,8 @@ namespace foundation    { class IAbortSwitch; }
 namespace foundation    { class Tile; }
 namespace renderer      { class Frame; }
 namespace renderer      { class Sample; }
+namespace renderer      { class SampleAOVArray; }
+namespace renderer      { class TileStack; }
 
 namespace renderer
 {
@@ -59,10 +61,11 @@ class LocalSampleAccumulationBuffer
   : public SampleAccumulationBuffer
 {
   public:
-    // Constructor.
+    // Constructor. AOVs are accumulated at full resolution only.
     LocalSampleAccumulationBuffer(
         const size_t                        width,
         const size_t                        height,
+        const size_t                        aov_count,
         const foundation::Filter2f&         filter);
 
     // Destructor.
@@ -75,6 +78,7 @@ class LocalSampleAccumulationBuffer
     virtual void store_samples(
         const size_t                        sample_count,
         const Sample                        samples[],
+        const SampleAOVArray&               sample_aovs,
         foundation::IAbortSwitch&           abort_switch) override;
 
     // Develop the buffer to a frame. Thread-safe.
@@ -92,6 +96,14 @@ class LocalSampleAccumulationBuffer
         const size_t                        origin_y,
         const foundation::AABB2u&           rect);
 
+    // Exposed for tests.
+    static void develop_aovs_to_tiles(
+        TileStack&                          aov_tiles,
+        const foundation::FilteredTile&     aov_fb,
+        const size_t                        origin_x,
+        const size_t                        origin_y,
+        const foundation::AABB2u&           rect);
+
   private:
     typedef foundation::ReadWriteLock<
         foundation::SleepWaitPolicy<5>
@@ -99,6 +111,7 @@ class LocalSampleAccumulationBuffer
 
     LockType                                m_lock;
     std::vector<foundation::FilteredTile*>  m_levels;
+    foundation::FilteredTile*               m_aov_fb;
     boost::atomic<foundation::int32>*       m_remaining_pixels;
     boost::atomic<foundation::uint32>       m_active_level;
 };
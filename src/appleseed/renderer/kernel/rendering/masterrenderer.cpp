@@ -221,6 +221,9 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     // Construct an abort switch based on the renderer controller.
     RendererControllerAbortSwitch abort_switch(*m_renderer_controller);
 
+    // Scene preparation uses as many threads as rendering.
+    m_project.set_rendering_thread_count(get_rendering_thread_count(m_params));
+
     // We start by expanding all procedural assemblies.
     if (!m_project.get_scene()->expand_procedural_assemblies(m_project, &abort_switch))
         return IRendererController::AbortRendering;
@@ -304,6 +307,10 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             return m_renderer_controller->get_status();
         }
 
+        // Allow procedural assemblies whose expansion is deferred to be expanded while rendering.
+        ProceduralAssembly::ExpansionContext expansion_context(m_project, *m_shading_system, recorder);
+        m_project.get_scene()->set_procedural_assembly_expansion_context(&expansion_context);
+
         frame_renderer.start_rendering();
 
         const IRendererController::Status status = wait_for_event(frame_renderer);
@@ -325,6 +332,8 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
 
         assert(!frame_renderer.is_rendering());
 
+        m_project.get_scene()->set_procedural_assembly_expansion_context(0);
+
         // Perform post-frame rendering actions
         recorder.on_frame_end(m_project);
         m_renderer_controller->on_frame_end();
@@ -92,6 +92,12 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
     return m_framebuffers[index];
 }
 
+bool PermanentShadingResultFrameBufferFactory::supports_tile_regions() const
+{
+    // Framebuffers are shared by all passes rendering a given tile.
+    return false;
+}
+
 void PermanentShadingResultFrameBufferFactory::destroy(
     ShadingResultFrameBuffer*   framebuffer)
 {
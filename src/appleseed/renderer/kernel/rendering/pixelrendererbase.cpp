@@ -60,7 +60,8 @@ void PixelRendererBase::on_tile_begin(
 void PixelRendererBase::on_tile_end(
     const Frame&    frame,
     Tile&           tile,
-    TileStack&      aov_tiles)
+    TileStack&      aov_tiles,
+    const AABB2i&   region)
 {
 }
 
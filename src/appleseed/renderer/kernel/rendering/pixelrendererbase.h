@@ -34,6 +34,7 @@
 #include "renderer/kernel/rendering/ipixelrenderer.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/aabb.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/compiler.h"
 
@@ -65,11 +66,12 @@ class PixelRendererBase
         foundation::Tile&           tile,
         TileStack&                  aov_tiles) override;
 
-    // This method is called after a tile has been rendered.
+    // This method is called after a tile, or a region of a tile, has been rendered.
     virtual void on_tile_end(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) override;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2i&   region) override;
 
   protected:
     void on_pixel_begin();
@@ -120,6 +120,7 @@ namespace
                     m_job_queue,
                     m_params.m_thread_count,
                     JobManager::KeepRunningOnEmptyQueue));
+            m_job_manager->set_thread_affinities(m_params.m_thread_affinities);
 
             // Instantiate sample generators, one per rendering thread.
             m_sample_generators.reserve(m_params.m_thread_count);
@@ -374,6 +375,7 @@ namespace
             const bool              m_perf_stats;           // collect and print performance statistics?
             const bool              m_luminance_stats;      // collect and print luminance statistics?
             const string            m_ref_image_path;       // path to the reference image
+            vector<vector<size_t>>  m_thread_affinities;    // cores rendering threads are bound to
 
             explicit Parameters(const ParamArray& params)
               : m_spectrum_mode(get_spectrum_mode(params))
@@ -384,6 +386,7 @@ namespace
               , m_luminance_stats(params.get_optional<bool>("luminance_statistics", false))
               , m_ref_image_path(params.get_optional<string>("reference_image", ""))
             {
+                get_rendering_thread_affinities(params, m_thread_affinities);
             }
         };
 
@@ -34,6 +34,7 @@
 #include "renderer/kernel/lighting/bdpt/bdptlightingengine.h"
 #include "renderer/kernel/lighting/lighttracing/lighttracingsamplegenerator.h"
 #include "renderer/kernel/lighting/pt/ptlightingengine.h"
+#include "renderer/kernel/lighting/pt/ptpasscallback.h"
 #include "renderer/kernel/lighting/sppm/sppmlightingengine.h"
 #include "renderer/kernel/lighting/sppm/sppmparameters.h"
 #include "renderer/kernel/lighting/sppm/sppmpasscallback.h"
@@ -86,6 +87,7 @@ namespace
         copy_param(child, source, "spectrum_mode");
         copy_param(child, source, "sampling_mode");
         copy_param(child, source, "rendering_threads");
+        copy_param(child, source, "thread_affinity");
         return child;
     }
 }
@@ -153,10 +155,34 @@ bool RendererComponents::create_lighting_engine_factory()
                 m_scene,
                 get_child_and_inherit_globals(m_params, "light_sampler")));
 
+        const ParamArray pt_params = get_child_and_inherit_globals(m_params, "pt");    // todo: change to "pt_lighting_engine"?
+
+        PathGuide* path_guide = 0;
+
+        if (pt_params.get_optional<bool>("enable_path_guiding", false))
+        {
+            // The path guide is trained at the end of each pass by the pass callback.
+            // Without a pass to learn from, recording and splatting would be wasted work.
+            if (m_params.get_optional<string>("frame_renderer", "generic") != "generic" ||
+                m_params.get_optional<size_t>("passes", 1) < 2)
+            {
+                RENDERER_LOG_WARNING(
+                    "path guiding requires the generic frame renderer with at least two passes; "
+                    "path guiding is disabled.");
+            }
+            else
+            {
+                PTPassCallback* pt_pass_callback = new PTPassCallback(m_scene, pt_params);
+                m_pass_callback.reset(pt_pass_callback);
+                path_guide = &pt_pass_callback->get_path_guide();
+            }
+        }
+
         m_lighting_engine_factory.reset(
             new PTLightingEngineFactory(
                 *m_backward_light_sampler,
-                get_child_and_inherit_globals(m_params, "pt")));    // todo: change to "pt_lighting_engine"?
+                path_guide,
+                pt_params));
 
         return true;
     }
@@ -34,6 +34,11 @@
 #include "foundation/image/color.h"
 #include "foundation/math/vector.h"
 
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
 namespace renderer
 {
 
@@ -44,6 +49,81 @@ class Sample
     foundation::Color4f     m_color;
 };
 
+
+//
+// AOV values of a set of samples, stored in structure-of-arrays layout: each
+// AOV channel has its own array holding the values of all samples. Samples and
+// their AOV values are matched by index.
+//
+
+class SampleAOVArray
+{
+  public:
+    // Constructor.
+    explicit SampleAOVArray(const size_t aov_count = 0);
+
+    // Return the number of AOVs per sample.
+    size_t get_aov_count() const;
+
+    // Return the number of samples.
+    size_t size() const;
+
+    // Remove all samples but keep the memory allocated.
+    void clear();
+
+    // Append the AOV values of one sample. 'aovs' must hold get_aov_count() colors.
+    void push_back(const foundation::Color4f aovs[]);
+
+    // Retrieve the AOV values of a given sample, in the order they were pushed.
+    // 'values' must hold 4 * get_aov_count() floats.
+    void get(const size_t sample_index, float values[]) const;
+
+  private:
+    size_t                              m_aov_count;
+    std::vector<std::vector<float>>     m_channels;
+};
+
+
+//
+// SampleAOVArray class implementation.
+//
+
+inline SampleAOVArray::SampleAOVArray(const size_t aov_count)
+  : m_aov_count(aov_count)
+  , m_channels(4 * aov_count)
+{
+}
+
+inline size_t SampleAOVArray::get_aov_count() const
+{
+    return m_aov_count;
+}
+
+inline size_t SampleAOVArray::size() const
+{
+    return m_channels.empty() ? 0 : m_channels[0].size();
+}
+
+inline void SampleAOVArray::clear()
+{
+    for (size_t i = 0, e = m_channels.size(); i < e; ++i)
+        m_channels[i].clear();
+}
+
+inline void SampleAOVArray::push_back(const foundation::Color4f aovs[])
+{
+    for (size_t i = 0, e = m_channels.size(); i < e; ++i)
+        m_channels[i].push_back(aovs[i / 4][i % 4]);
+}
+
+inline void SampleAOVArray::get(const size_t sample_index, float values[]) const
+{
+    assert(sample_index < size());
+
+    for (size_t i = 0, e = m_channels.size(); i < e; ++i)
+        values[i] = m_channels[i][sample_index];
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLE_H
@@ -42,6 +42,7 @@
 namespace foundation    { class IAbortSwitch; }
 namespace renderer      { class Frame; }
 namespace renderer      { class Sample; }
+namespace renderer      { class SampleAOVArray; }
 
 namespace renderer
 {
@@ -60,9 +61,11 @@ class SampleAccumulationBuffer
     virtual void clear() = 0;
 
     // Store a set of samples into the buffer. Thread-safe.
+    // 'sample_aovs' is either empty or holds the AOV values of the samples.
     virtual void store_samples(
         const size_t                sample_count,
         const Sample                samples[],
+        const SampleAOVArray&       sample_aovs,
         foundation::IAbortSwitch&   abort_switch) = 0;
 
     // Develop the buffer to a frame. Thread-safe.
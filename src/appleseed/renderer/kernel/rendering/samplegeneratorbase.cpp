@@ -56,9 +56,11 @@ namespace
 
 SampleGeneratorBase::SampleGeneratorBase(
     const size_t                generator_index,
-    const size_t                generator_count)
+    const size_t                generator_count,
+    const size_t                aov_count)
   : m_generator_index(generator_index)
   , m_stride((generator_count - 1) * SampleBatchSize)
+  , m_sample_aovs(aov_count)
 {
     reset();
 }
@@ -79,12 +81,13 @@ void SampleGeneratorBase::generate_samples(
 
     clear_keep_memory(m_samples);
     m_samples.reserve(sample_count);
+    m_sample_aovs.clear();
 
     size_t stored = 0;
 
     while (stored < sample_count)
     {
-        stored += generate_samples(m_sequence_index, m_samples);
+        stored += generate_samples(m_sequence_index, m_samples, m_sample_aovs);
         ++m_sequence_index;
 
         if (++m_current_batch_size == SampleBatchSize)
@@ -98,7 +101,10 @@ void SampleGeneratorBase::generate_samples(
     }
 
     if (stored > 0)
-        buffer.store_samples(stored, &m_samples[0], abort_switch);
+    {
+        assert(m_sample_aovs.get_aov_count() == 0 || m_sample_aovs.size() == stored);
+        buffer.store_samples(stored, &m_samples[0], m_sample_aovs, abort_switch);
+    }
 }
 
 void SampleGeneratorBase::signal_invalid_sample()
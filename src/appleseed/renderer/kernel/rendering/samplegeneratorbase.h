@@ -58,7 +58,8 @@ class SampleGeneratorBase
   public:
     SampleGeneratorBase(
         const size_t                generator_index,
-        const size_t                generator_count);
+        const size_t                generator_count,
+        const size_t                aov_count);
 
     // Reset the sample generator to its initial state.
     virtual void reset();
@@ -73,10 +74,12 @@ class SampleGeneratorBase
     typedef std::vector<Sample> SampleVector;
 
     // Generate one or multiple samples for a given sequence index and store them in 'samples'.
-    // Return the number of samples that were stored.
+    // If the sample generator was constructed with a non-zero number of AOVs, the AOV values
+    // of each sample must be stored in 'sample_aovs'. Return the number of samples that were stored.
     virtual size_t generate_samples(
         const size_t                sequence_index,
-        SampleVector&               samples) = 0;
+        SampleVector&               samples,
+        SampleAOVArray&             sample_aovs) = 0;
 
     void signal_invalid_sample();
 
@@ -86,6 +89,7 @@ class SampleGeneratorBase
     size_t                          m_sequence_index;
     size_t                          m_current_batch_size;
     SampleVector                    m_samples;
+    SampleAOVArray                  m_sample_aovs;
     foundation::uint64              m_invalid_sample_count;
 };
 
@@ -68,7 +68,6 @@ ShadingResultFrameBuffer::ShadingResultFrameBuffer(
         get_total_channel_count(aov_count),
         filter)
   , m_aov_count(aov_count)
-  , m_scratch(get_total_channel_count(aov_count))
 {
 }
 
@@ -85,7 +84,6 @@ ShadingResultFrameBuffer::ShadingResultFrameBuffer(
         crop_window,
         filter)
   , m_aov_count(aov_count)
-  , m_scratch(get_total_channel_count(aov_count))
 {
 }
 
@@ -94,7 +92,11 @@ void ShadingResultFrameBuffer::add(
     const float                     y,
     const ShadingResult&            sample)
 {
-    float* ptr = &m_scratch[0];
+    assert(sample.m_aov_count == m_aov_count);
+
+    // Gather the main output and the AOVs into the channel layout of this framebuffer.
+    float values[4 * (1 + MaxAOVCount)];
+    float* ptr = values;
 
     *ptr++ = sample.m_main[0];
     *ptr++ = sample.m_main[1];
@@ -110,7 +112,8 @@ void ShadingResultFrameBuffer::add(
         *ptr++ = aov[3];
     }
 
-    FilteredTile::add(x, y, &m_scratch[0]);
+    // A framebuffer is only ever accessed by one rendering thread at a time.
+    FilteredTile::add_nonatomic(x, y, values);
 }
 
 void ShadingResultFrameBuffer::merge(
@@ -134,11 +137,27 @@ void ShadingResultFrameBuffer::develop_to_tile(
     Tile&                           tile,
     TileStack&                      aov_tiles) const
 {
-    const float* ptr = pixel(0);
+    develop_to_tile(
+        tile,
+        aov_tiles,
+        AABB2i(
+            Vector2i(0, 0),
+            Vector2i(static_cast<int>(m_width) - 1, static_cast<int>(m_height) - 1)));
+}
 
-    for (size_t y = 0, h = m_height; y < h; ++y)
+void ShadingResultFrameBuffer::develop_to_tile(
+    Tile&                           tile,
+    TileStack&                      aov_tiles,
+    const AABB2i&                   region) const
+{
+    assert(region.min.x >= 0 && region.max.x < static_cast<int>(m_width));
+    assert(region.min.y >= 0 && region.max.y < static_cast<int>(m_height));
+
+    for (size_t y = region.min.y, ye = region.max.y; y <= ye; ++y)
     {
-        for (size_t x = 0, w = m_width; x < w; ++x)
+        const float* ptr = pixel(region.min.x, y);
+
+        for (size_t x = region.min.x, xe = region.max.x; x <= xe; ++x)
         {
             const float weight = *ptr++;
             const float rcp_weight = weight == 0.0f ? 0.0f : 1.0f / weight;
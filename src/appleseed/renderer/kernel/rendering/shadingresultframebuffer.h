@@ -37,7 +37,6 @@
 
 // Standard headers.
 #include <cstddef>
-#include <vector>
 
 // Forward declarations.
 namespace foundation    { class Tile; }
@@ -81,9 +80,14 @@ class ShadingResultFrameBuffer
         foundation::Tile&               tile,
         TileStack&                      aov_tiles) const;
 
+    // Only develop the pixels of a given region, in tile space.
+    void develop_to_tile(
+        foundation::Tile&               tile,
+        TileStack&                      aov_tiles,
+        const foundation::AABB2i&       region) const;
+
   private:
     const size_t                        m_aov_count;
-    std::vector<float>                  m_scratch;
 };
 
 }       // namespace renderer
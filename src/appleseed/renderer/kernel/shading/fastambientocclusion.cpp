@@ -47,7 +47,6 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/aabb.h"
-#include "foundation/math/intersection/aabbtriangle.h"
 #include "foundation/math/intersection/rayaabb.h"
 #include "foundation/math/ray.h"
 #include "foundation/math/sampling/mappings.h"
@@ -58,6 +57,7 @@
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -65,13 +65,115 @@ using namespace std;
 namespace renderer
 {
 
+namespace
+{
+    typedef voxel::TriangleIntersector<GScalar> TriangleIntersector;
+
+
+    //
+    // Collects triangles into a vector, for the parallel builder.
+    //
+
+    class TriangleCollector
+    {
+      public:
+        explicit TriangleCollector(vector<TriangleIntersector>& triangles)
+          : m_triangles(triangles)
+        {
+        }
+
+        void push(const TriangleIntersector& triangle)
+        {
+            m_triangles.push_back(triangle);
+        }
+
+      private:
+        vector<TriangleIntersector>& m_triangles;
+    };
+
+
+    //
+    // Push all the world space triangles of a scene into a given sink,
+    // which is either a serial voxel tree builder or a triangle collector.
+    //
+
+    template <typename Sink>
+    void push_triangles(const Scene& scene, Sink& sink)
+    {
+        // The voxel tree is built using the scene geometry at the middle of the shutter interval.
+        const float time = scene.get_active_camera()->get_shutter_middle_time();
+
+        // Loop over the assembly instances of the scene.
+        for (const_each<AssemblyInstanceContainer> i = scene.assembly_instances(); i; ++i)
+        {
+            // Retrieve the assembly instance.
+            const AssemblyInstance& assembly_instance = *i;
+
+            // Retrieve the assembly.
+            const Assembly& assembly = assembly_instance.get_assembly();
+
+            // Loop over the object instances of the assembly.
+            for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
+            {
+                // Retrieve the object instance.
+                const ObjectInstance& object_instance = *j;
+
+                // Compute the object space to world space transformation.
+                const Transformd transform =
+                      assembly_instance.transform_sequence().evaluate(time)
+                    * object_instance.get_transform();
+
+                // Retrieve the object.
+                Object& object = object_instance.get_object();
+
+                // Retrieve the region kit of the object.
+                Access<RegionKit> region_kit(&object.get_region_kit());
+
+                // Loop over the regions of the object.
+                const size_t region_count = region_kit->size();
+                for (size_t region_index = 0; region_index < region_count; ++region_index)
+                {
+                    // Retrieve the region.
+                    const IRegion* region = (*region_kit)[region_index];
+
+                    // Retrieve the tessellation of the region.
+                    Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
+
+                    // Push all triangles of the region into the sink.
+                    const size_t triangle_count = tess->m_primitives.size();
+                    for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
+                    {
+                        // Fetch the triangle.
+                        const Triangle& triangle = tess->m_primitives[triangle_index];
+
+                        // Retrieve object instance space vertices of the triangle.
+                        const GVector3& v0_os = tess->m_vertices[triangle.m_v0];
+                        const GVector3& v1_os = tess->m_vertices[triangle.m_v1];
+                        const GVector3& v2_os = tess->m_vertices[triangle.m_v2];
+
+                        // Transform triangle vertices to world space.
+                        const GVector3 v0(transform.point_to_parent(v0_os));
+                        const GVector3 v1(transform.point_to_parent(v1_os));
+                        const GVector3 v2(transform.point_to_parent(v2_os));
+
+                        // Push the triangle.
+                        sink.push(TriangleIntersector(v0, v1, v2));
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 //
 // AOVoxelTree class implementation.
 //
 
 AOVoxelTree::AOVoxelTree(
     const Scene&    scene,
-    const GScalar   max_extent_fraction)
+    const GScalar   max_extent_fraction,
+    const size_t    thread_count)
 {
     assert(max_extent_fraction > GScalar(0.0));
 
@@ -84,13 +186,33 @@ AOVoxelTree::AOVoxelTree(
     // Compute the maximum extent of a leaf, in world space.
     const GScalar max_extent = max_extent_fraction * max_value(scene_bbox.extent());
 
-    // Build the tree.
-    BuilderType builder(m_tree, scene_bbox, max_extent);
-    build(scene, builder);
-    builder.complete();
+    if (thread_count > 1)
+    {
+        // Every cell of the parallel builder is built from the whole set of
+        // triangles, so they have to be collected before the build starts.
+        vector<TriangleIntersector> triangles;
+        TriangleCollector collector(triangles);
+        push_triangles(scene, collector);
+
+        // Build the tree.
+        ParallelBuilderType builder(m_tree, scene_bbox, max_extent);
+        builder.build(triangles, global_logger(), thread_count);
+        print_statistics(builder);
+    }
+    else
+    {
+        // Stream the triangles into the tree.
+        SerialBuilderType builder(m_tree, scene_bbox, max_extent);
+        push_triangles(scene, builder);
+        builder.complete();
+        print_statistics(builder);
+    }
+}
 
-    // Print statistics.
-    TreeStatisticsType tree_stats(m_tree, builder);
+template <typename Builder>
+void AOVoxelTree::print_statistics(const Builder& builder) const
+{
+    voxel::TreeStatistics<TreeType, Builder> tree_stats(m_tree, builder);
     RENDERER_LOG_DEBUG("ambient occlusion voxel tree statistics:");
     tree_stats.print(global_logger());
 }
@@ -135,117 +257,6 @@ void AOVoxelTree::dump_tree_to_disk(const string& filename) const
     }
 }
 
-namespace
-{
-    //
-    // A triangle-bounding box intersection predicate.
-    //
-
-    class TriangleIntersector
-    {
-      public:
-        // Constructor.
-        TriangleIntersector(
-            const GVector3& v0,
-            const GVector3& v1,
-            const GVector3& v2)
-          : m_v0(v0)
-          , m_v1(v1)
-          , m_v2(v2)
-        {
-            // Compute and store the bounding box of the triangle.
-            m_triangle_bbox.invalidate();
-            m_triangle_bbox.insert(m_v0);
-            m_triangle_bbox.insert(m_v1);
-            m_triangle_bbox.insert(m_v2);
-        }
-
-        // Return whether the item intersect a given bounding box.
-        bool intersect(const GAABB3& bbox) const
-        {
-            if (GAABB3::overlap(m_triangle_bbox, bbox))
-                return foundation::intersect(bbox, m_v0, m_v1, m_v2);
-            else return false;
-        }
-
-      private:
-        const GVector3  m_v0;
-        const GVector3  m_v1;
-        const GVector3  m_v2;
-        GAABB3          m_triangle_bbox;
-
-    };
-}
-
-void AOVoxelTree::build(
-    const Scene&    scene,
-    BuilderType&    builder)
-{
-    // The voxel tree is built using the scene geometry at the middle of the shutter interval.
-    const float time = scene.get_active_camera()->get_shutter_middle_time();
-
-    // Loop over the assembly instances of the scene.
-    for (const_each<AssemblyInstanceContainer> i = scene.assembly_instances(); i; ++i)
-    {
-        // Retrieve the assembly instance.
-        const AssemblyInstance& assembly_instance = *i;
-
-        // Retrieve the assembly.
-        const Assembly& assembly = assembly_instance.get_assembly();
-
-        // Loop over the object instances of the assembly.
-        for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
-        {
-            // Retrieve the object instance.
-            const ObjectInstance& object_instance = *j;
-
-            // Compute the object space to world space transformation.
-            const Transformd transform =
-                  assembly_instance.transform_sequence().evaluate(time)
-                * object_instance.get_transform();
-
-            // Retrieve the object.
-            Object& object = object_instance.get_object();
-
-            // Retrieve the region kit of the object.
-            Access<RegionKit> region_kit(&object.get_region_kit());
-
-            // Loop over the regions of the object.
-            const size_t region_count = region_kit->size();
-            for (size_t region_index = 0; region_index < region_count; ++region_index)
-            {
-                // Retrieve the region.
-                const IRegion* region = (*region_kit)[region_index];
-
-                // Retrieve the tessellation of the region.
-                Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
-
-                // Push all triangles of the region into the tree.
-                const size_t triangle_count = tess->m_primitives.size();
-                for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
-                {
-                    // Fetch the triangle.
-                    const Triangle& triangle = tess->m_primitives[triangle_index];
-
-                    // Retrieve object instance space vertices of the triangle.
-                    const GVector3& v0_os = tess->m_vertices[triangle.m_v0];
-                    const GVector3& v1_os = tess->m_vertices[triangle.m_v1];
-                    const GVector3& v2_os = tess->m_vertices[triangle.m_v2];
-
-                    // Transform triangle vertices to world space.
-                    const GVector3 v0(transform.point_to_parent(v0_os));
-                    const GVector3 v1(transform.point_to_parent(v1_os));
-                    const GVector3 v2(transform.point_to_parent(v2_os));
-
-                    // Push the triangle into the tree.
-                    TriangleIntersector intersector(v0, v1, v2);
-                    builder.push(intersector);
-                }
-            }
-        }
-    }
-}
-
 
 //
 // AOVoxelTreeIntersector class implementation.
@@ -301,6 +312,134 @@ bool AOVoxelTreeIntersector::trace(
     return false;
 }
 
+void AOVoxelTreeIntersector::trace(
+    const ShadingRay::RayType*  rays,
+    const size_t                ray_count,
+    const bool                  solid,
+    bool*                       hits,
+    double*                     distances) const
+{
+    typedef PacketIntersectorType::RayPacket RayPacket;
+    const size_t PacketSize = PacketIntersectorType::PacketSize;
+
+    // Retrieve the voxel tree.
+    const AOVoxelTree::TreeType& tree = m_tree.m_tree;
+    const AABB3d tree_bbox(tree.get_bbox());
+
+    // One packet per direction octant.
+    RayPacket packets[8];
+    size_t packet_ray_indices[8][PacketSize];
+    size_t packet_sizes[8];
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        clear_packet(packets[i]);
+        packet_sizes[i] = 0;
+    }
+
+    for (size_t i = 0; i < ray_count; ++i)
+    {
+        hits[i] = false;
+
+        // Clip the ray against the bounding box of the tree.
+        ShadingRay::RayType ray(rays[i]);
+        const ShadingRay::RayInfoType ray_info(ray);
+        if (!clip(ray, ray_info, tree_bbox))
+            continue;
+
+        // Append the ray to the packet of its octant.
+        const size_t octant =
+            ray_info.m_sgn_dir[0] | (ray_info.m_sgn_dir[1] << 1) | (ray_info.m_sgn_dir[2] << 2);
+        RayPacket& packet = packets[octant];
+        const size_t lane = packet_sizes[octant]++;
+
+        if (lane == 0)
+        {
+            for (size_t d = 0; d < 3; ++d)
+            {
+                packet.m_org[d] = static_cast<float>(ray.m_org[d]);
+                packet.m_sgn_dir[d] = ray_info.m_sgn_dir[d];
+            }
+        }
+
+        for (size_t d = 0; d < 3; ++d)
+            packet.m_rcp_dir[d][lane] = static_cast<float>(ray_info.m_rcp_dir[d]);
+
+        packet.m_tmin[lane] = static_cast<float>(ray.m_tmin);
+        packet.m_tmax[lane] = static_cast<float>(ray.m_tmax);
+        packet.m_mask |= size_t(1) << lane;
+        packet_ray_indices[octant][lane] = i;
+
+        // Trace the packet as soon as it is full.
+        if (packet_sizes[octant] == PacketSize)
+        {
+            trace_packet(packet, packet_ray_indices[octant], rays, solid, hits, distances);
+            clear_packet(packet);
+            packet_sizes[octant] = 0;
+        }
+    }
+
+    // Trace the remaining, partially filled packets.
+    for (size_t i = 0; i < 8; ++i)
+    {
+        if (packet_sizes[i] > 0)
+            trace_packet(packets[i], packet_ray_indices[i], rays, solid, hits, distances);
+    }
+}
+
+void AOVoxelTreeIntersector::clear_packet(PacketIntersectorType::RayPacket& packet)
+{
+    for (size_t i = 0; i < PacketIntersectorType::PacketSize; ++i)
+    {
+        for (size_t d = 0; d < 3; ++d)
+            packet.m_rcp_dir[d][i] = 0.0f;
+
+        packet.m_tmin[i] = 0.0f;
+        packet.m_tmax[i] = 0.0f;
+    }
+
+    packet.m_mask = 0;
+}
+
+void AOVoxelTreeIntersector::trace_packet(
+    const PacketIntersectorType::RayPacket& packet,
+    const size_t*               ray_indices,
+    const ShadingRay::RayType*  rays,
+    const bool                  solid,
+    bool*                       hits,
+    double*                     distances) const
+{
+    const AOVoxelTree::TreeType& tree = m_tree.m_tree;
+
+    // Intersect the packet with the tree.
+    PacketIntersectorType intersector;
+    float packet_distances[PacketIntersectorType::PacketSize];
+    const size_t hit_mask = intersector.intersect(tree, packet, solid, packet_distances);
+
+    for (size_t i = 0; i < PacketIntersectorType::PacketSize; ++i)
+    {
+        if (!(packet.m_mask & (size_t(1) << i)))
+            continue;
+
+        const size_t ray_index = ray_indices[i];
+
+        if (hit_mask & (size_t(1) << i))
+        {
+            hits[ray_index] = true;
+            distances[ray_index] = static_cast<double>(packet_distances[i]);
+        }
+        else if (!solid)
+        {
+            // Same fallback as the single ray version.
+            ShadingRay::RayType ray(rays[ray_index]);
+            const ShadingRay::RayInfoType ray_info(ray);
+            const AABB3d tree_bbox(tree.get_bbox());
+            clip(ray, ray_info, tree_bbox);
+            hits[ray_index] = intersect(ray, ray_info, tree_bbox, distances[ray_index]);
+        }
+    }
+}
+
 
 //
 // Compute fast ambient occlusion at a given point in space.
@@ -316,41 +455,61 @@ double compute_fast_ambient_occlusion(
     const size_t                    sample_count,
     double&                         min_distance)
 {
+    // Number of ambient occlusion rays traced together.
+    const size_t RayBatchSize = 32;
+
     // Create a sampling context.
     SamplingContext child_sampling_context = sampling_context.split(2, sample_count);
 
-    // Construct the ambient occlusion ray.
-    ShadingRay::RayType ray;
-    ray.m_org = point;
-    ray.m_tmin = 0.0;
-    ray.m_tmax = max_distance;
+    // Construct the ambient occlusion rays.
+    ShadingRay::RayType rays[RayBatchSize];
+    for (size_t i = 0; i < RayBatchSize; ++i)
+    {
+        rays[i].m_org = point;
+        rays[i].m_tmin = 0.0;
+        rays[i].m_tmax = max_distance;
+    }
 
     size_t computed_samples = 0;
     size_t occluded_samples = 0;
 
     min_distance = max_distance;
 
-    for (size_t i = 0; i < sample_count; ++i)
+    size_t i = 0;
+    while (i < sample_count)
     {
-        // Generate a cosine-weighted direction over the unit hemisphere.
-        ray.m_dir = sample_hemisphere_cosine(child_sampling_context.next2<Vector2d>());
+        size_t ray_count = 0;
 
-        // Transform the direction to world space.
-        ray.m_dir = shading_basis.transform_to_parent(ray.m_dir);
+        for (; i < sample_count && ray_count < RayBatchSize; ++i)
+        {
+            // Generate a cosine-weighted direction over the unit hemisphere.
+            Vector3d dir = sample_hemisphere_cosine(child_sampling_context.next2<Vector2d>());
 
-        // Don't cast rays on or below the geometric surface.
-        if (dot(ray.m_dir, geometric_normal) <= 0.0)
-            continue;
+            // Transform the direction to world space.
+            dir = shading_basis.transform_to_parent(dir);
+
+            // Don't cast rays on or below the geometric surface.
+            if (dot(dir, geometric_normal) <= 0.0)
+                continue;
+
+            rays[ray_count++].m_dir = dir;
+        }
 
         // Count the number of computed samples.
-        ++computed_samples;
+        computed_samples += ray_count;
+
+        // Trace the ambient occlusion rays and count the number of occluded samples.
+        bool hits[RayBatchSize];
+        double distances[RayBatchSize];
+        intersector.trace(rays, ray_count, true, hits, distances);
 
-        // Trace the ambient occlusion ray and count the number of occluded samples.
-        double distance;
-        if (intersector.trace(ray, true, distance))
+        for (size_t j = 0; j < ray_count; ++j)
         {
-            ++occluded_samples;
-            min_distance = min(min_distance, distance);
+            if (hits[j])
+            {
+                ++occluded_samples;
+                min_distance = min(min_distance, distances[j]);
+            }
         }
     }
 
@@ -56,10 +56,13 @@ namespace renderer
 class AOVoxelTree
 {
   public:
-    // Constructor, build the tree for a given scene.
+    // Constructor, build the tree for a given scene. The thread count should
+    // be the number of rendering threads; with a single thread, the triangles
+    // of the scene are streamed into the tree instead of being collected first.
     AOVoxelTree(
         const Scene&        scene,
-        const GScalar       max_extent_fraction);
+        const GScalar       max_extent_fraction,
+        const size_t        thread_count);
 
     // Return the maximum leaf node diagonal length.
     GScalar get_max_diag_length() const;
@@ -75,19 +78,15 @@ class AOVoxelTree
 
     // Types.
     typedef foundation::voxel::Tree<GScalar, 3> TreeType;
-    typedef foundation::voxel::Builder<TreeType> BuilderType;
-    typedef foundation::voxel::TreeStatistics<
-        TreeType,
-        BuilderType
-    > TreeStatisticsType;
+    typedef foundation::voxel::Builder<TreeType> SerialBuilderType;
+    typedef foundation::voxel::ParallelBuilder<TreeType> ParallelBuilderType;
 
     // Voxel tree.
     TreeType                m_tree;
 
-    // Build the tree.
-    void build(
-        const Scene&        scene,
-        BuilderType&        builder);
+    // Print statistics about the tree and its construction.
+    template <typename Builder>
+    void print_statistics(const Builder& builder) const;
 };
 
 
@@ -110,16 +109,40 @@ class AOVoxelTreeIntersector
         const bool          solid,
         double&             distance) const;
 
+    // Trace a batch of world space rays sharing the same origin through the voxel tree.
+    // Rays are grouped into packets of rays going in the same octant and traversed together.
+    void trace(
+        const ShadingRay::RayType*  rays,
+        const size_t                ray_count,
+        const bool                  solid,
+        bool*                       hits,
+        double*                     distances) const;
+
   private:
     // Types.
     typedef foundation::voxel::Intersector<
         double,
         AOVoxelTree::TreeType
     > IntersectorType;
+    typedef foundation::voxel::PacketIntersector<
+        AOVoxelTree::TreeType
+    > PacketIntersectorType;
 
     // Voxel tree.
     const AOVoxelTree&      m_tree;
 
+    // Reset a packet to an empty one.
+    static void clear_packet(PacketIntersectorType::RayPacket& packet);
+
+    // Trace a packet of rays and scatter the results back to the batch.
+    void trace_packet(
+        const PacketIntersectorType::RayPacket& packet,
+        const size_t*               ray_indices,
+        const ShadingRay::RayType*  rays,
+        const bool                  solid,
+        bool*                       hits,
+        double*                     distances) const;
+
     // Intersection statistics.
 #ifdef FOUNDATION_VOXEL_ENABLE_TRAVERSAL_STATS
     mutable foundation::voxel::TraversalStatistics m_traversal_stats;
@@ -36,6 +36,10 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/octahedral.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/attributeset.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/numerictype.h"
@@ -67,8 +71,8 @@ class StaticTessellation
     typedef std::vector<PrimitiveType> PrimitiveArray;
 
     // Primary features.
+    // Vertex normals are accessed through the methods below since they may be compressed.
     VectorArray                 m_vertices;
-    VectorArray                 m_vertex_normals;
     PrimitiveArray              m_primitives;
 
     // Additional attributes.
@@ -83,6 +87,13 @@ class StaticTessellation
     // Constructor.
     StaticTessellation();
 
+    // Insert and access vertex normals.
+    void reserve_vertex_normals(const size_t count);
+    size_t push_vertex_normal(const GVector3& normal);      // the normal must be unit-length
+    size_t get_vertex_normal_count() const;
+    GVector3 get_vertex_normal(const size_t index) const;
+    void clear_vertex_normals();
+
     // Insert and access texture coordinates.
     void reserve_tex_coords(const size_t count);
     size_t push_tex_coords(const GVector2& uv);
@@ -91,7 +102,7 @@ class StaticTessellation
 
     // Insert and access vertex tangents.
     void reserve_vertex_tangents(const size_t count);
-    size_t push_vertex_tangent(const GVector3& tangent);    // the tangent must be unit-length
+    size_t push_vertex_tangent(const GVector3& tangent);
     size_t get_vertex_tangent_count() const;
     GVector3 get_vertex_tangent(const size_t index) const;
 
@@ -144,7 +155,27 @@ class StaticTessellation
     // Compute the local space bounding box of the tessellation over the shutter interval.
     GAABB3 compute_local_bbox() const;
 
+    // Switch to a compact storage of vertex attributes: vertex normals and unit-length
+    // tangents are octahedral-encoded into 32 bits, texture coordinates are stored as
+    // 16-bit fixed-point values if their range allows it without visible loss of precision.
+    // Attributes may still be inserted afterward; motion poses are not compressed.
+    void compress_vertex_attributes();
+    bool has_compressed_vertex_attributes() const;
+
+    // Return the size in bytes of vertex normals, tangents and texture coordinates.
+    size_t get_vertex_attributes_memory_size() const;
+
   private:
+    typedef std::vector<foundation::uint32> PackedVectorArray;
+
+    bool                                m_compressed;
+    VectorArray                         m_vertex_normals;
+    PackedVectorArray                   m_packed_vertex_normals;    // octahedral-encoded vertex normals
+    bool                                m_packed_uv_0;              // UV coordinates set #0 stored as 16-bit fixed-point values
+    GVector2                            m_uv_0_offset;
+    GVector2                            m_uv_0_scale;
+    bool                                m_packed_tangents;          // octahedral-encoded vertex tangents
+
     foundation::AttributeSet::ChannelID m_uv_0_cid;         // UV coordinates set #0
     foundation::AttributeSet::ChannelID m_tangents_cid;     // per-vertex tangent vectors
     foundation::AttributeSet::ChannelID m_ms_count_cid;     // motion segment count
@@ -154,6 +185,11 @@ class StaticTessellation
 
     void create_uv_0_attribute();
     void create_tangents_attribute();
+
+    void pack_tex_coords();
+    void unpack_tex_coords();
+    void pack_tangents();
+    void unpack_tangents();
 };
 
 // Specialization of the StaticTessellation class for triangles.
@@ -178,7 +214,10 @@ typedef foundation::AccessCache<
 
 template <typename Primitive>
 inline StaticTessellation<Primitive>::StaticTessellation()
-  : m_uv_0_cid(foundation::AttributeSet::InvalidChannelID)
+  : m_compressed(false)
+  , m_packed_uv_0(false)
+  , m_packed_tangents(false)
+  , m_uv_0_cid(foundation::AttributeSet::InvalidChannelID)
   , m_tangents_cid(foundation::AttributeSet::InvalidChannelID)
   , m_ms_count_cid(foundation::AttributeSet::InvalidChannelID)
   , m_vp_cid(foundation::AttributeSet::InvalidChannelID)
@@ -187,6 +226,55 @@ inline StaticTessellation<Primitive>::StaticTessellation()
 {
 }
 
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::reserve_vertex_normals(const size_t count)
+{
+    if (m_compressed)
+        m_packed_vertex_normals.reserve(count);
+    else m_vertex_normals.reserve(count);
+}
+
+template <typename Primitive>
+inline size_t StaticTessellation<Primitive>::push_vertex_normal(const GVector3& normal)
+{
+    if (m_compressed)
+    {
+        const size_t index = m_packed_vertex_normals.size();
+        m_packed_vertex_normals.push_back(foundation::octahedral_encode(foundation::safe_normalize(normal)));
+        return index;
+    }
+    else
+    {
+        const size_t index = m_vertex_normals.size();
+        m_vertex_normals.push_back(normal);
+        return index;
+    }
+}
+
+template <typename Primitive>
+inline size_t StaticTessellation<Primitive>::get_vertex_normal_count() const
+{
+    return m_compressed ? m_packed_vertex_normals.size() : m_vertex_normals.size();
+}
+
+template <typename Primitive>
+inline GVector3 StaticTessellation<Primitive>::get_vertex_normal(const size_t index) const
+{
+    assert(index < get_vertex_normal_count());
+
+    return
+        m_compressed
+            ? foundation::octahedral_decode<GScalar>(m_packed_vertex_normals[index])
+            : m_vertex_normals[index];
+}
+
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::clear_vertex_normals()
+{
+    m_vertex_normals.clear();
+    m_packed_vertex_normals.clear();
+}
+
 template <typename Primitive>
 inline void StaticTessellation<Primitive>::reserve_tex_coords(const size_t count)
 {
@@ -202,6 +290,23 @@ inline size_t StaticTessellation<Primitive>::push_tex_coords(const GVector2& uv)
     if (m_uv_0_cid == foundation::AttributeSet::InvalidChannelID)
         create_uv_0_attribute();
 
+    if (m_packed_uv_0)
+    {
+        const GVector2 p = (uv - m_uv_0_offset) * m_uv_0_scale;
+
+        // Fall back to full precision if these coordinates are out of the quantization range.
+        if (p.x < GScalar(0.0) || p.x > GScalar(65535.0) ||
+            p.y < GScalar(0.0) || p.y > GScalar(65535.0))
+            unpack_tex_coords();
+        else
+        {
+            const foundation::uint32 packed_uv =
+                  (foundation::round<foundation::uint32>(p.x) << 16)
+                | foundation::round<foundation::uint32>(p.y);
+            return m_vertex_attributes.push_attribute(m_uv_0_cid, packed_uv);
+        }
+    }
+
     return m_vertex_attributes.push_attribute(m_uv_0_cid, uv);
 }
 
@@ -219,6 +324,18 @@ inline GVector2 StaticTessellation<Primitive>::get_tex_coords(const size_t index
 {
     assert(m_uv_0_cid != foundation::AttributeSet::InvalidChannelID);
 
+    if (m_packed_uv_0)
+    {
+        foundation::uint32 packed_uv;
+        m_vertex_attributes.get_attribute(m_uv_0_cid, index, &packed_uv);
+
+        return
+            m_uv_0_offset +
+            GVector2(
+                static_cast<GScalar>(packed_uv >> 16),
+                static_cast<GScalar>(packed_uv & 0xFFFFUL)) / m_uv_0_scale;
+    }
+
     GVector2 uv;
     m_vertex_attributes.get_attribute(m_uv_0_cid, index, &uv);
 
@@ -240,6 +357,14 @@ inline size_t StaticTessellation<Primitive>::push_vertex_tangent(const GVector3&
     if (m_tangents_cid == foundation::AttributeSet::InvalidChannelID)
         create_tangents_attribute();
 
+    if (m_packed_tangents)
+    {
+        // Fall back to full precision if this tangent is not unit-length since its norm would be lost.
+        if (!foundation::is_normalized(tangent))
+            unpack_tangents();
+        else return m_vertex_attributes.push_attribute(m_tangents_cid, foundation::octahedral_encode(tangent));
+    }
+
     return m_vertex_attributes.push_attribute(m_tangents_cid, tangent);
 }
 
@@ -257,6 +382,13 @@ inline GVector3 StaticTessellation<Primitive>::get_vertex_tangent(const size_t i
 {
     assert(m_tangents_cid != foundation::AttributeSet::InvalidChannelID);
 
+    if (m_packed_tangents)
+    {
+        foundation::uint32 packed_tangent;
+        m_vertex_attributes.get_attribute(m_tangents_cid, index, &packed_tangent);
+        return foundation::octahedral_decode<GScalar>(packed_tangent);
+    }
+
     GVector3 tangent;
     m_vertex_attributes.get_attribute(m_tangents_cid, index, &tangent);
 
@@ -352,7 +484,7 @@ inline void StaticTessellation<Primitive>::set_vertex_normal_pose(
     const size_t    motion_segment_index,
     const GVector3& normal)
 {
-    assert(normal_index < m_vertex_normals.size());
+    assert(normal_index < get_vertex_normal_count());
 
     const size_t motion_segment_count = get_motion_segment_count();
     assert(motion_segment_index < motion_segment_count);
@@ -378,7 +510,7 @@ inline GVector3 StaticTessellation<Primitive>::get_vertex_normal_pose(
     const size_t    motion_segment_index) const
 {
     assert(m_vnp_cid != foundation::AttributeSet::InvalidChannelID);
-    assert(normal_index < m_vertex_normals.size());
+    assert(normal_index < get_vertex_normal_count());
 
     const size_t motion_segment_count = get_motion_segment_count();
     assert(motion_segment_index < motion_segment_count);
@@ -434,7 +566,7 @@ inline GVector3 StaticTessellation<Primitive>::get_vertex_tangent_pose(
     const size_t    motion_segment_index) const
 {
     assert(m_vtp_cid != foundation::AttributeSet::InvalidChannelID);
-    assert(tangent_index < m_vertex_normals.size());
+    assert(tangent_index < get_vertex_tangent_count());
 
     const size_t motion_segment_count = get_motion_segment_count();
     assert(motion_segment_index < motion_segment_count);
@@ -478,6 +610,176 @@ GAABB3 StaticTessellation<Primitive>::compute_local_bbox() const
     return bbox;
 }
 
+template <typename Primitive>
+void StaticTessellation<Primitive>::compress_vertex_attributes()
+{
+    if (m_compressed)
+        return;
+
+    // Compress vertex normals.
+    const size_t normal_count = m_vertex_normals.size();
+    m_packed_vertex_normals.resize(normal_count);
+    for (size_t i = 0; i < normal_count; ++i)
+        m_packed_vertex_normals[i] = foundation::octahedral_encode(foundation::safe_normalize(m_vertex_normals[i]));
+    VectorArray().swap(m_vertex_normals);
+
+    // Compress vertex tangents and texture coordinates.
+    if (m_tangents_cid != foundation::AttributeSet::InvalidChannelID)
+        pack_tangents();
+    if (m_uv_0_cid != foundation::AttributeSet::InvalidChannelID)
+        pack_tex_coords();
+
+    m_compressed = true;
+}
+
+template <typename Primitive>
+inline bool StaticTessellation<Primitive>::has_compressed_vertex_attributes() const
+{
+    return m_compressed;
+}
+
+template <typename Primitive>
+size_t StaticTessellation<Primitive>::get_vertex_attributes_memory_size() const
+{
+    return
+          m_vertex_normals.size() * sizeof(GVector3)
+        + m_packed_vertex_normals.size() * sizeof(foundation::uint32)
+        + get_vertex_tangent_count() * (m_packed_tangents ? sizeof(foundation::uint32) : sizeof(GVector3))
+        + get_tex_coords_count() * (m_packed_uv_0 ? sizeof(foundation::uint32) : sizeof(GVector2));
+}
+
+template <typename Primitive>
+void StaticTessellation<Primitive>::pack_tex_coords()
+{
+    assert(!m_packed_uv_0);
+
+    const size_t uv_count = get_tex_coords_count();
+
+    if (uv_count == 0)
+        return;
+
+    // Compute the range of the texture coordinates.
+    GVector2 uv_min = get_tex_coords(0);
+    GVector2 uv_max = uv_min;
+    for (size_t i = 1; i < uv_count; ++i)
+    {
+        const GVector2 uv = get_tex_coords(i);
+        uv_min = foundation::component_wise_min(uv_min, uv);
+        uv_max = foundation::component_wise_max(uv_max, uv);
+    }
+
+    // Only quantize texture coordinates spanning a small range, so that the
+    // quantization error remains below 1/32768 (an eighth of a texel at 4K).
+    const GVector2 extent = uv_max - uv_min;
+    if (extent.x > GScalar(2.0) || extent.y > GScalar(2.0))
+        return;
+
+    m_uv_0_offset = uv_min;
+    m_uv_0_scale =
+        GVector2(
+            extent.x > GScalar(0.0) ? GScalar(65535.0) / extent.x : GScalar(1.0),
+            extent.y > GScalar(0.0) ? GScalar(65535.0) / extent.y : GScalar(1.0));
+
+    const foundation::AttributeSet::ChannelID packed_uv_0_cid =
+        m_vertex_attributes.create_channel(
+            "packed_uv_0",
+            foundation::NumericTypeUInt32,
+            1);
+    m_vertex_attributes.reserve_attributes(packed_uv_0_cid, uv_count);
+
+    for (size_t i = 0; i < uv_count; ++i)
+    {
+        const GVector2 p = (get_tex_coords(i) - m_uv_0_offset) * m_uv_0_scale;
+        const foundation::uint32 packed_uv =
+              (foundation::round<foundation::uint32>(foundation::clamp(p.x, GScalar(0.0), GScalar(65535.0))) << 16)
+            | foundation::round<foundation::uint32>(foundation::clamp(p.y, GScalar(0.0), GScalar(65535.0)));
+        m_vertex_attributes.push_attribute(packed_uv_0_cid, packed_uv);
+    }
+
+    m_vertex_attributes.delete_channel(m_uv_0_cid);
+    m_uv_0_cid = packed_uv_0_cid;
+    m_packed_uv_0 = true;
+}
+
+template <typename Primitive>
+void StaticTessellation<Primitive>::unpack_tex_coords()
+{
+    assert(m_packed_uv_0);
+
+    const size_t uv_count = get_tex_coords_count();
+
+    const foundation::AttributeSet::ChannelID packed_uv_0_cid = m_uv_0_cid;
+    create_uv_0_attribute();
+    m_vertex_attributes.reserve_attributes(m_uv_0_cid, uv_count);
+
+    for (size_t i = 0; i < uv_count; ++i)
+    {
+        foundation::uint32 packed_uv;
+        m_vertex_attributes.get_attribute(packed_uv_0_cid, i, &packed_uv);
+
+        const GVector2 uv =
+            m_uv_0_offset +
+            GVector2(
+                static_cast<GScalar>(packed_uv >> 16),
+                static_cast<GScalar>(packed_uv & 0xFFFFUL)) / m_uv_0_scale;
+        m_vertex_attributes.push_attribute(m_uv_0_cid, uv);
+    }
+
+    m_vertex_attributes.delete_channel(packed_uv_0_cid);
+    m_packed_uv_0 = false;
+}
+
+template <typename Primitive>
+void StaticTessellation<Primitive>::pack_tangents()
+{
+    assert(!m_packed_tangents);
+
+    const size_t tangent_count = get_vertex_tangent_count();
+
+    // Only encode unit-length tangents: the encoding does not preserve the norm.
+    for (size_t i = 0; i < tangent_count; ++i)
+    {
+        if (!foundation::is_normalized(get_vertex_tangent(i)))
+            return;
+    }
+
+    const foundation::AttributeSet::ChannelID packed_tangents_cid =
+        m_vertex_attributes.create_channel(
+            "packed_tangents",
+            foundation::NumericTypeUInt32,
+            1);
+    m_vertex_attributes.reserve_attributes(packed_tangents_cid, tangent_count);
+
+    for (size_t i = 0; i < tangent_count; ++i)
+        m_vertex_attributes.push_attribute(packed_tangents_cid, foundation::octahedral_encode(get_vertex_tangent(i)));
+
+    m_vertex_attributes.delete_channel(m_tangents_cid);
+    m_tangents_cid = packed_tangents_cid;
+    m_packed_tangents = true;
+}
+
+template <typename Primitive>
+void StaticTessellation<Primitive>::unpack_tangents()
+{
+    assert(m_packed_tangents);
+
+    const size_t tangent_count = get_vertex_tangent_count();
+
+    const foundation::AttributeSet::ChannelID packed_tangents_cid = m_tangents_cid;
+    create_tangents_attribute();
+    m_vertex_attributes.reserve_attributes(m_tangents_cid, tangent_count);
+
+    for (size_t i = 0; i < tangent_count; ++i)
+    {
+        foundation::uint32 packed_tangent;
+        m_vertex_attributes.get_attribute(packed_tangents_cid, i, &packed_tangent);
+        m_vertex_attributes.push_attribute(m_tangents_cid, foundation::octahedral_decode<GScalar>(packed_tangent));
+    }
+
+    m_vertex_attributes.delete_channel(packed_tangents_cid);
+    m_packed_tangents = false;
+}
+
 template <typename Primitive>
 void StaticTessellation<Primitive>::create_uv_0_attribute()
 {
@@ -0,0 +1,831 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bsdf/lambertianbrdf.h"
+#include "renderer/modeling/bssrdf/bssrdf.h"
+#include "renderer/modeling/bssrdf/normalizeddiffusionbssrdf.h"
+#include "renderer/modeling/camera/camera.h"
+#include "renderer/modeling/camera/pinholecamera.h"
+#include "renderer/modeling/edf/diffuseedf.h"
+#include "renderer/modeling/edf/edf.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/light/pointlight.h"
+#include "renderer/modeling/material/genericmaterial.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/meshobjectprimitives.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/scene/textureinstance.h"
+#include "renderer/modeling/scene/visibilityflags.h"
+#include "renderer/modeling/surfaceshader/physicalsurfaceshader.h"
+#include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/modeling/texture/memorytexture2d.h"
+#include "renderer/modeling/texture/texture.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/transformsequence.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/otherwise.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+//
+// End-to-end rendering benchmarks.
+//
+// Each case renders a small image of either the built-in Cornell Box project or
+// of a procedurally generated scene stressing one particular aspect of the renderer
+// (instancing, light sampling, acceleration structures, subsurface scattering or
+// texturing), and reports throughput metrics in addition to its running time:
+//
+//   - the time it took to build the acceleration structures of the scene
+//   - the number of samples (or pixels) rendered per second, for rendering cases
+//   - the number of rays traced per second, for ray tracing cases
+//
+
+BENCHMARK_SUITE(Renderer_Kernel_Rendering_MasterRenderer)
+{
+    const size_t ImageSize = 64;                // width and height of the rendered images, in pixels
+    const size_t UniformSampleCount = 4;        // samples per pixel with the uniform pixel renderer
+    const size_t AdaptiveMinSampleCount = 2;    // minimum samples per pixel with the adaptive pixel renderer
+    const size_t AdaptiveMaxSampleCount = 16;   // maximum samples per pixel with the adaptive pixel renderer
+    const size_t TraceRayCount = 16384;         // number of rays traced per run by ray tracing cases
+
+    enum SceneType
+    {
+        CornellBoxScene,                        // built-in Cornell Box project
+        ManyInstancesScene,                     // thousands of assembly instances
+        ManyLightsScene,                        // hundreds of point lights
+        DenseMeshScene,                         // a single mesh with more than a million triangles
+        SSSScene,                               // subsurface scattering objects
+        TexturedScene                           // textured surfaces
+    };
+
+    enum LightingEngineType
+    {
+        PTEngine,
+        SPPMEngine
+    };
+
+    enum PixelRendererType
+    {
+        UniformPixelRenderer,
+        AdaptivePixelRenderer
+    };
+
+
+    //
+    // Scene construction.
+    //
+
+    void set_frame(Project& project, const char* camera_name)
+    {
+        ParamArray params;
+        params.insert("camera", camera_name);
+        params.insert("resolution", to_string(ImageSize) + " " + to_string(ImageSize));
+        params.insert("tile_size", "16 16");
+        params.insert("color_space", "linear_rgb");
+
+        project.set_frame(FrameFactory::create("beauty", params));
+    }
+
+    void add_material(
+        Assembly&       assembly,
+        const char*     name,
+        const char*     reflectance)
+    {
+        const string bsdf_name = string(name) + "_brdf";
+
+        assembly.bsdfs().insert(
+            LambertianBRDFFactory().create(
+                bsdf_name.c_str(),
+                ParamArray().insert("reflectance", reflectance)));
+
+        assembly.materials().insert(
+            GenericMaterialFactory().create(
+                name,
+                ParamArray()
+                    .insert("surface_shader", "physical_shader")
+                    .insert("bsdf", bsdf_name)));
+    }
+
+    void add_light_material(
+        Assembly&       assembly,
+        const char*     name,
+        const float     radiance)
+    {
+        const string edf_name = string(name) + "_edf";
+
+        assembly.edfs().insert(
+            DiffuseEDFFactory().create(
+                edf_name.c_str(),
+                ParamArray().insert("radiance", radiance)));
+
+        assembly.materials().insert(
+            GenericMaterialFactory().create(
+                name,
+                ParamArray()
+                    .insert("surface_shader", "physical_shader")
+                    .insert("edf", edf_name)));
+    }
+
+    void add_primitive(
+        Assembly&           assembly,
+        const char*         name,
+        const ParamArray&   params,
+        const char*         material_name,
+        const Transformd&   transform)
+    {
+        auto_release_ptr<MeshObject> mesh = create_primitive_mesh(name, params);
+        assert(mesh.get());
+
+        assembly.objects().insert(auto_release_ptr<Object>(mesh));
+
+        const string instance_name = string(name) + "_inst";
+        assembly.object_instances().insert(
+            ObjectInstanceFactory::create(
+                instance_name.c_str(),
+                ParamArray(),
+                name,
+                transform,
+                StringDictionary().insert("default", material_name)));
+    }
+
+    // Create a project made of a ground plane lit by an area light and seen from above,
+    // to which scene-specific content is added by the caller.
+    auto_release_ptr<Project> create_base_project(Assembly*& assembly_ptr)
+    {
+        auto_release_ptr<Project> project(ProjectFactory::create("benchmark"));
+        project->add_default_configurations();
+
+        auto_release_ptr<Scene> scene(SceneFactory::create());
+
+        auto_release_ptr<Assembly> assembly(
+            AssemblyFactory().create("assembly", ParamArray()));
+
+        assembly->surface_shaders().insert(
+            PhysicalSurfaceShaderFactory().create("physical_shader", ParamArray()));
+
+        add_material(assembly.ref(), "ground_material", "0.5");
+        add_material(assembly.ref(), "default_material", "0.8");
+        add_light_material(assembly.ref(), "light_material", 20.0f);
+
+        add_primitive(
+            assembly.ref(),
+            "ground",
+            ParamArray()
+                .insert("primitive", "grid")
+                .insert("resolution_u", 1)
+                .insert("resolution_v", 1)
+                .insert("width", 20.0f)
+                .insert("height", 20.0f),
+            "ground_material",
+            Transformd::identity());
+
+        add_primitive(
+            assembly.ref(),
+            "area_light",
+            ParamArray()
+                .insert("primitive", "grid")
+                .insert("resolution_u", 1)
+                .insert("resolution_v", 1)
+                .insert("width", 2.0f)
+                .insert("height", 2.0f),
+            "light_material",
+            Transformd::from_local_to_parent(
+                  Matrix4d::make_translation(Vector3d(0.0, 8.0, 0.0))
+                * Matrix4d::make_rotation_x(Pi<double>())));
+
+        assembly_ptr = assembly.get();
+
+        scene->assembly_instances().insert(
+            AssemblyInstanceFactory::create(
+                "assembly_inst",
+                ParamArray(),
+                "assembly"));
+        scene->assemblies().insert(assembly);
+
+        auto_release_ptr<Camera> camera(
+            PinholeCameraFactory().create(
+                "camera",
+                ParamArray()
+                    .insert("film_dimensions", "0.025 0.025")
+                    .insert("focal_length", "0.035")));
+        camera->transform_sequence().set_transform(
+            0.0f,
+            Transformd::from_local_to_parent(
+                Matrix4d::make_lookat(
+                    Vector3d(0.0, 7.0, 14.0),
+                    Vector3d(0.0, 0.0, 0.0),
+                    Vector3d(0.0, 1.0, 0.0))));
+        scene->cameras().insert(camera);
+
+        project->set_scene(scene);
+        set_frame(project.ref(), "camera");
+
+        return project;
+    }
+
+    auto_release_ptr<Project> create_cornell_box_project()
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+        set_frame(project.ref(), "camera");
+        return project;
+    }
+
+    // A 64x64 grid of instances of an assembly containing a single sphere.
+    auto_release_ptr<Project> create_many_instances_project()
+    {
+        Assembly* assembly;
+        auto_release_ptr<Project> project(create_base_project(assembly));
+        Scene& scene = *project->get_scene();
+
+        auto_release_ptr<Assembly> sphere_assembly(
+            AssemblyFactory().create("sphere_assembly", ParamArray()));
+        sphere_assembly->surface_shaders().insert(
+            PhysicalSurfaceShaderFactory().create("physical_shader", ParamArray()));
+        add_material(sphere_assembly.ref(), "default_material", "0.8");
+        add_primitive(
+            sphere_assembly.ref(),
+            "sphere",
+            ParamArray()
+                .insert("primitive", "sphere")
+                .insert("resolution_u", 16)
+                .insert("resolution_v", 8)
+                .insert("radius", 0.1f),
+            "default_material",
+            Transformd::identity());
+        scene.assemblies().insert(sphere_assembly);
+
+        const size_t GridSize = 64;
+
+        for (size_t y = 0; y < GridSize; ++y)
+        {
+            for (size_t x = 0; x < GridSize; ++x)
+            {
+                const string name = "sphere_assembly_inst_" + to_string(y * GridSize + x);
+
+                auto_release_ptr<AssemblyInstance> assembly_instance(
+                    AssemblyInstanceFactory::create(
+                        name.c_str(),
+                        ParamArray(),
+                        "sphere_assembly"));
+
+                assembly_instance->transform_sequence().set_transform(
+                    0.0f,
+                    Transformd::from_local_to_parent(
+                        Matrix4d::make_translation(
+                            Vector3d(
+                                -8.0 + 16.0 * x / (GridSize - 1),
+                                0.1,
+                                -8.0 + 16.0 * y / (GridSize - 1)))));
+
+                scene.assembly_instances().insert(assembly_instance);
+            }
+        }
+
+        return project;
+    }
+
+    // A few spheres lit by a 16x16 grid of point lights.
+    auto_release_ptr<Project> create_many_lights_project()
+    {
+        Assembly* assembly;
+        auto_release_ptr<Project> project(create_base_project(assembly));
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const string name = "sphere_" + to_string(i);
+            add_primitive(
+                *assembly,
+                name.c_str(),
+                ParamArray()
+                    .insert("primitive", "sphere")
+                    .insert("resolution_u", 32)
+                    .insert("resolution_v", 16),
+                "default_material",
+                Transformd::from_local_to_parent(
+                    Matrix4d::make_translation(Vector3d(-4.5 + 3.0 * i, 1.0, 0.0))));
+        }
+
+        const size_t GridSize = 16;
+
+        for (size_t y = 0; y < GridSize; ++y)
+        {
+            for (size_t x = 0; x < GridSize; ++x)
+            {
+                const string name = "light_" + to_string(y * GridSize + x);
+
+                auto_release_ptr<Light> light(
+                    PointLightFactory().create(
+                        name.c_str(),
+                        ParamArray()
+                            .insert("intensity", 1.0f)
+                            .insert("intensity_multiplier", 4.0f)));
+
+                light->set_transform(
+                    Transformd::from_local_to_parent(
+                        Matrix4d::make_translation(
+                            Vector3d(
+                                -9.0 + 18.0 * x / (GridSize - 1),
+                                3.0,
+                                -9.0 + 18.0 * y / (GridSize - 1)))));
+
+                assembly->lights().insert(light);
+            }
+        }
+
+        return project;
+    }
+
+    // A single sphere made of about 1.2 million triangles.
+    auto_release_ptr<Project> create_dense_mesh_project()
+    {
+        Assembly* assembly;
+        auto_release_ptr<Project> project(create_base_project(assembly));
+
+        add_primitive(
+            *assembly,
+            "dense_sphere",
+            ParamArray()
+                .insert("primitive", "sphere")
+                .insert("resolution_u", 1024)
+                .insert("resolution_v", 576)
+                .insert("radius", 3.0f),
+            "default_material",
+            Transformd::from_local_to_parent(
+                Matrix4d::make_translation(Vector3d(0.0, 3.0, 0.0))));
+
+        return project;
+    }
+
+    // Three spheres with a subsurface scattering material.
+    auto_release_ptr<Project> create_sss_project()
+    {
+        Assembly* assembly;
+        auto_release_ptr<Project> project(create_base_project(assembly));
+
+        assembly->bssrdfs().insert(
+            NormalizedDiffusionBSSRDFFactory().create(
+                "sss_bssrdf",
+                ParamArray()
+                    .insert("reflectance", "0.8")
+                    .insert("mfp", "0.5")
+                    .insert("ior", "1.3")));
+
+        assembly->materials().insert(
+            GenericMaterialFactory().create(
+                "sss_material",
+                ParamArray()
+                    .insert("surface_shader", "physical_shader")
+                    .insert("bssrdf", "sss_bssrdf")));
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const string name = "sss_sphere_" + to_string(i);
+            add_primitive(
+                *assembly,
+                name.c_str(),
+                ParamArray()
+                    .insert("primitive", "sphere")
+                    .insert("resolution_u", 64)
+                    .insert("resolution_v", 32)
+                    .insert("radius", 1.5f),
+                "sss_material",
+                Transformd::from_local_to_parent(
+                    Matrix4d::make_translation(Vector3d(-4.0 + 4.0 * i, 1.5, 0.0))));
+        }
+
+        return project;
+    }
+
+    // A ground plane and a few spheres whose diffuse reflectance is read from a 1024x1024 texture.
+    auto_release_ptr<Project> create_textured_project()
+    {
+        Assembly* assembly;
+        auto_release_ptr<Project> project(create_base_project(assembly));
+        Scene& scene = *project->get_scene();
+
+        const size_t TextureSize = 1024;
+        const size_t CheckerSize = 32;
+
+        auto_release_ptr<Image> image(
+            new Image(TextureSize, TextureSize, 64, 64, 3, PixelFormatFloat));
+
+        for (size_t y = 0; y < TextureSize; ++y)
+        {
+            for (size_t x = 0; x < TextureSize; ++x)
+            {
+                const bool odd = ((x / CheckerSize) + (y / CheckerSize)) % 2 == 1;
+                const Color3f color(
+                    odd ? 0.8f : 0.1f,
+                    static_cast<float>(x) / TextureSize,
+                    static_cast<float>(y) / TextureSize);
+                image->set_pixel(x, y, color);
+            }
+        }
+
+        scene.textures().insert(
+            MemoryTexture2dFactory::static_create(
+                "checker_texture",
+                ParamArray().insert("color_space", "linear_rgb"),
+                image));
+
+        scene.texture_instances().insert(
+            TextureInstanceFactory::create(
+                "checker_texture_inst",
+                ParamArray()
+                    .insert("addressing_mode", "wrap")
+                    .insert("filtering_mode", "bilinear"),
+                "checker_texture"));
+
+        add_material(*assembly, "textured_material", "checker_texture_inst");
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const string name = "textured_sphere_" + to_string(i);
+            add_primitive(
+                *assembly,
+                name.c_str(),
+                ParamArray()
+                    .insert("primitive", "sphere")
+                    .insert("resolution_u", 64)
+                    .insert("resolution_v", 32)
+                    .insert("radius", 1.5f),
+                "textured_material",
+                Transformd::from_local_to_parent(
+                    Matrix4d::make_translation(Vector3d(-4.0 + 4.0 * i, 1.5, 0.0))));
+        }
+
+        return project;
+    }
+
+    auto_release_ptr<Project> create_project(const SceneType scene_type)
+    {
+        switch (scene_type)
+        {
+          case CornellBoxScene: return create_cornell_box_project();
+          case ManyInstancesScene: return create_many_instances_project();
+          case ManyLightsScene: return create_many_lights_project();
+          case DenseMeshScene: return create_dense_mesh_project();
+          case SSSScene: return create_sss_project();
+          case TexturedScene: return create_textured_project();
+          assert_otherwise_and_return(auto_release_ptr<Project>());
+        }
+    }
+
+
+    //
+    // Fixtures.
+    //
+
+    // Create a project, bind its inputs and build its acceleration structures.
+    struct SceneFixtureBase
+      : public IBenchmarkStatisticsProvider
+    {
+        auto_release_ptr<Project>   m_project;
+        double                      m_bvh_build_time;
+
+        explicit SceneFixtureBase(const SceneType scene_type)
+          : m_project(create_project(scene_type))
+        {
+            InputBinder input_binder;
+            input_binder.bind(*m_project->get_scene());
+            assert(input_binder.get_error_count() == 0);
+
+            Stopwatch<DefaultWallclockTimer> stopwatch;
+            stopwatch.start();
+            m_project->update_trace_context();
+            stopwatch.measure();
+
+            m_bvh_build_time = stopwatch.get_seconds();
+        }
+
+        virtual void get_statistics(Statistics& stats) const override
+        {
+            stats.insert_time("bvh build time", m_bvh_build_time, 3);
+        }
+    };
+
+    template <SceneType SceneT, LightingEngineType EngineT, PixelRendererType PixelRendererT>
+    struct RenderFixture
+      : public SceneFixtureBase
+    {
+        ParamArray                  m_params;
+        double                      m_render_time;
+        size_t                      m_render_count;
+
+        RenderFixture()
+          : SceneFixtureBase(SceneT)
+          , m_render_time(0.0)
+          , m_render_count(0)
+        {
+            m_params = m_project->configurations().get_by_name("final")->get_inherited_parameters();
+
+            m_params.insert("lighting_engine", EngineT == PTEngine ? "pt" : "sppm");
+            m_params.insert_path("sppm.light_photons_per_pass", 20000);
+            m_params.insert_path("sppm.env_photons_per_pass", 0);
+
+            m_params.insert("pixel_renderer", PixelRendererT == UniformPixelRenderer ? "uniform" : "adaptive");
+            m_params.insert_path("uniform_pixel_renderer.samples", UniformSampleCount);
+            m_params.insert_path("adaptive_pixel_renderer.min_samples", AdaptiveMinSampleCount);
+            m_params.insert_path("adaptive_pixel_renderer.max_samples", AdaptiveMaxSampleCount);
+        }
+
+        void render()
+        {
+            DefaultRendererController renderer_controller;
+            MasterRenderer renderer(
+                m_project.ref(),
+                m_params,
+                &renderer_controller);
+
+            Stopwatch<DefaultWallclockTimer> stopwatch;
+            stopwatch.start();
+            renderer.render();
+            stopwatch.measure();
+
+            m_render_time += stopwatch.get_seconds();
+            ++m_render_count;
+        }
+
+        virtual void get_statistics(Statistics& stats) const override
+        {
+            SceneFixtureBase::get_statistics(stats);
+
+            if (m_render_time == 0.0)
+                return;
+
+            const double pixel_count = static_cast<double>(ImageSize * ImageSize * m_render_count);
+            stats.insert<double>("pixels/s", pixel_count / m_render_time);
+
+            // The number of samples per pixel is only known in advance with the uniform pixel renderer.
+            if (PixelRendererT == UniformPixelRenderer)
+                stats.insert<double>("samples/s", pixel_count * UniformSampleCount / m_render_time);
+        }
+    };
+
+    template <SceneType SceneT>
+    struct TraceFixture
+      : public SceneFixtureBase
+    {
+        TextureStore                m_texture_store;
+        TextureCache                m_texture_cache;
+        Intersector                 m_intersector;
+        vector<ShadingRay>          m_rays;
+        size_t                      m_hit_count;
+        double                      m_trace_time;
+        size_t                      m_trace_count;
+
+        TraceFixture()
+          : SceneFixtureBase(SceneT)
+          , m_texture_store(*m_project->get_scene())
+          , m_texture_cache(m_texture_store)
+          , m_intersector(m_project->get_trace_context(), m_texture_cache)
+          , m_hit_count(0)
+          , m_trace_time(0.0)
+          , m_trace_count(0)
+        {
+            // Generate rays originating from a sphere enclosing the scene and aimed at random points inside it.
+            const AABB3d bbox(m_project->get_scene()->compute_bbox());
+            const Vector3d center = bbox.center();
+            const double radius = 1.5 * bbox.radius();
+
+            MersenneTwister rng;
+            m_rays.reserve(TraceRayCount);
+
+            for (size_t i = 0; i < TraceRayCount; ++i)
+            {
+                Vector2d s;
+                s[0] = rand_double2(rng);
+                s[1] = rand_double2(rng);
+                const Vector3d origin = center + radius * sample_sphere_uniform(s);
+
+                Vector3d target;
+                for (size_t j = 0; j < 3; ++j)
+                    target[j] = rand_double1(rng, bbox.min[j], bbox.max[j]);
+
+                m_rays.push_back(
+                    ShadingRay(
+                        origin,
+                        normalize(target - origin),
+                        ShadingRay::Time::create_with_normalized_time(0.0f, 0.0f, 0.0f),
+                        VisibilityFlags::CameraRay,
+                        0));
+            }
+        }
+
+        void trace()
+        {
+            Stopwatch<DefaultWallclockTimer> stopwatch;
+            stopwatch.start();
+
+            for (size_t i = 0; i < m_rays.size(); ++i)
+            {
+                ShadingPoint shading_point;
+                if (m_intersector.trace(m_rays[i], shading_point))
+                    ++m_hit_count;
+            }
+
+            stopwatch.measure();
+
+            m_trace_time += stopwatch.get_seconds();
+            ++m_trace_count;
+        }
+
+        virtual void get_statistics(Statistics& stats) const override
+        {
+            SceneFixtureBase::get_statistics(stats);
+
+            if (m_trace_time == 0.0)
+                return;
+
+            const double ray_count = static_cast<double>(m_rays.size() * m_trace_count);
+            stats.insert<double>("rays/s", ray_count / m_trace_time);
+            stats.insert_percent("hit rate", static_cast<double>(m_hit_count), ray_count);
+        }
+    };
+
+
+    //
+    // Rendering cases.
+    //
+
+    typedef RenderFixture<CornellBoxScene, PTEngine, UniformPixelRenderer> CornellBoxPTUniformFixture;
+    typedef RenderFixture<CornellBoxScene, PTEngine, AdaptivePixelRenderer> CornellBoxPTAdaptiveFixture;
+    typedef RenderFixture<CornellBoxScene, SPPMEngine, UniformPixelRenderer> CornellBoxSPPMUniformFixture;
+    typedef RenderFixture<CornellBoxScene, SPPMEngine, AdaptivePixelRenderer> CornellBoxSPPMAdaptiveFixture;
+    typedef RenderFixture<ManyInstancesScene, PTEngine, UniformPixelRenderer> ManyInstancesPTUniformFixture;
+    typedef RenderFixture<ManyInstancesScene, SPPMEngine, UniformPixelRenderer> ManyInstancesSPPMUniformFixture;
+    typedef RenderFixture<ManyLightsScene, PTEngine, UniformPixelRenderer> ManyLightsPTUniformFixture;
+    typedef RenderFixture<ManyLightsScene, SPPMEngine, UniformPixelRenderer> ManyLightsSPPMUniformFixture;
+    typedef RenderFixture<DenseMeshScene, PTEngine, UniformPixelRenderer> DenseMeshPTUniformFixture;
+    typedef RenderFixture<DenseMeshScene, PTEngine, AdaptivePixelRenderer> DenseMeshPTAdaptiveFixture;
+    typedef RenderFixture<SSSScene, PTEngine, UniformPixelRenderer> SSSPTUniformFixture;
+    typedef RenderFixture<TexturedScene, PTEngine, UniformPixelRenderer> TexturedPTUniformFixture;
+    typedef RenderFixture<TexturedScene, SPPMEngine, UniformPixelRenderer> TexturedSPPMUniformFixture;
+
+    BENCHMARK_CASE_F(RenderCornellBox_PT_Uniform, CornellBoxPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderCornellBox_PT_Adaptive, CornellBoxPTAdaptiveFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderCornellBox_SPPM_Uniform, CornellBoxSPPMUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderCornellBox_SPPM_Adaptive, CornellBoxSPPMAdaptiveFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderManyInstances_PT_Uniform, ManyInstancesPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderManyInstances_SPPM_Uniform, ManyInstancesSPPMUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderManyLights_PT_Uniform, ManyLightsPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderManyLights_SPPM_Uniform, ManyLightsSPPMUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderDenseMesh_PT_Uniform, DenseMeshPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderDenseMesh_PT_Adaptive, DenseMeshPTAdaptiveFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderSSS_PT_Uniform, SSSPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderTextured_PT_Uniform, TexturedPTUniformFixture)
+    {
+        render();
+    }
+
+    BENCHMARK_CASE_F(RenderTextured_SPPM_Uniform, TexturedSPPMUniformFixture)
+    {
+        render();
+    }
+
+
+    //
+    // Ray tracing cases.
+    //
+
+    typedef TraceFixture<CornellBoxScene> CornellBoxTraceFixture;
+    typedef TraceFixture<ManyInstancesScene> ManyInstancesTraceFixture;
+    typedef TraceFixture<DenseMeshScene> DenseMeshTraceFixture;
+
+    BENCHMARK_CASE_F(TraceCornellBox, CornellBoxTraceFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(TraceManyInstances, ManyInstancesTraceFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(TraceDenseMesh, DenseMeshTraceFixture)
+    {
+        trace();
+    }
+}
@@ -45,12 +45,21 @@ BENCHMARK_SUITE(Renderer_Utility_TransformSequence)
 {
     struct Fixture
     {
+        static const size_t TimeCount = 64;
+
         const AABB3d        m_bbox;
         TransformSequence   m_sequence;
         AABB3d              m_motion_bbox;
+        float               m_times[TimeCount];
+        Vector3d            m_point;
+        Vector3d            m_dir;
+        Vector3d            m_accumulated;
 
         Fixture()
           : m_bbox(Vector3d(-20.0, -20.0, -5.0), Vector3d(-10.0, -10.0, 5.0))
+          , m_point(1.0, 2.0, 3.0)
+          , m_dir(normalize(Vector3d(1.0, -1.0, 0.5)))
+          , m_accumulated(0.0)
         {
             const Vector3d axis = normalize(Vector3d(0.1, 0.2, 1.0));
             m_sequence.set_transform(
@@ -64,6 +73,9 @@ BENCHMARK_SUITE(Renderer_Utility_TransformSequence)
                     Matrix4d::make_rotation(axis, Pi<double>() - Pi<double>() / 8) *
                     Matrix4d::make_scaling(Vector3d(0.2))));
             m_sequence.prepare();
+
+            for (size_t i = 0; i < TimeCount; ++i)
+                m_times[i] = static_cast<float>(i) / (TimeCount - 1);
         }
     };
 
@@ -71,4 +83,25 @@ BENCHMARK_SUITE(Renderer_Utility_TransformSequence)
     {
         m_motion_bbox = m_sequence.to_parent(m_bbox);
     }
+
+    BENCHMARK_CASE_F(Evaluate, Fixture)
+    {
+        for (size_t i = 0; i < TimeCount; ++i)
+        {
+            Transformd scratch;
+            const Transformd& transform = m_sequence.evaluate(m_times[i], scratch);
+            m_accumulated += transform.get_parent_to_local().extract_translation();
+        }
+    }
+
+    BENCHMARK_CASE_F(EvaluateAndTransformRay, Fixture)
+    {
+        for (size_t i = 0; i < TimeCount; ++i)
+        {
+            Transformd scratch;
+            const Transformd& transform = m_sequence.evaluate(m_times[i], scratch);
+            m_accumulated += transform.point_to_local(m_point);
+            m_accumulated += transform.vector_to_local(m_dir);
+        }
+    }
 }
@@ -0,0 +1,127 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/intersection/alphamask.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/bitmask.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Intersection_AlphaMask)
+{
+    Vector2f texel_center(const BitMask2& bitmask, const size_t x, const size_t y)
+    {
+        return
+            Vector2f(
+                (x + 0.5f) / bitmask.get_width(),
+                (y + 0.5f) / bitmask.get_height());
+    }
+
+    TEST_CASE(IsOpaque_GivenRandomMask_MatchesSourceMask)
+    {
+        BitMask2 bitmask(37, 21);
+
+        MersenneTwister rng;
+
+        for (size_t y = 0; y < bitmask.get_height(); ++y)
+        {
+            for (size_t x = 0; x < bitmask.get_width(); ++x)
+                bitmask.set(x, y, x < 16 || rand_int1(rng, 0, 1) == 1);
+        }
+
+        const AlphaMask mask(bitmask);
+
+        for (size_t y = 0; y < bitmask.get_height(); ++y)
+        {
+            for (size_t x = 0; x < bitmask.get_width(); ++x)
+                EXPECT_EQ(bitmask.is_set(x, y), mask.is_opaque(texel_center(bitmask, x, y)));
+        }
+    }
+
+    struct Fixture
+    {
+        BitMask2 m_bitmask;
+
+        // The left half of the mask is opaque except for one texel, the right half is transparent.
+        Fixture()
+          : m_bitmask(64, 64)
+        {
+            for (size_t y = 0; y < m_bitmask.get_height(); ++y)
+            {
+                for (size_t x = 0; x < m_bitmask.get_width(); ++x)
+                    m_bitmask.set(x, y, x < 32 && !(x == 3 && y == 3));
+            }
+        }
+    };
+
+    TEST_CASE_F(GetOpacity_GivenRectangleOverOpaqueTexels_ReturnsOpaque, Fixture)
+    {
+        const AlphaMask mask(m_bitmask);
+
+        EXPECT_EQ(AlphaMask::Opaque, mask.get_opacity(Vector2f(0.1f, 0.1f), Vector2f(0.45f, 0.9f)));
+        EXPECT_EQ(AlphaMask::Opaque, mask.get_opacity(texel_center(m_bitmask, 4, 0), texel_center(m_bitmask, 7, 7)));
+    }
+
+    TEST_CASE_F(GetOpacity_GivenRectangleOverTransparentTexels_ReturnsTransparent, Fixture)
+    {
+        const AlphaMask mask(m_bitmask);
+
+        EXPECT_EQ(AlphaMask::Transparent, mask.get_opacity(Vector2f(0.5f, 0.0f), Vector2f(1.0f, 1.0f)));
+        EXPECT_EQ(AlphaMask::Transparent, mask.get_opacity(texel_center(m_bitmask, 3, 3), texel_center(m_bitmask, 3, 3)));
+    }
+
+    TEST_CASE_F(GetOpacity_GivenRectangleOverMixedTexels_ReturnsMixed, Fixture)
+    {
+        const AlphaMask mask(m_bitmask);
+
+        EXPECT_EQ(AlphaMask::Mixed, mask.get_opacity(Vector2f(0.25f, 0.25f), Vector2f(0.75f, 0.75f)));
+        EXPECT_EQ(AlphaMask::Mixed, mask.get_opacity(texel_center(m_bitmask, 2, 2), texel_center(m_bitmask, 4, 4)));
+    }
+
+    TEST_CASE_F(ComputeHash_GivenIdenticalMasks_ReturnsSameHash, Fixture)
+    {
+        const AlphaMask mask1(m_bitmask);
+        const AlphaMask mask2(m_bitmask);
+
+        m_bitmask.set(40, 40, true);
+        const AlphaMask mask3(m_bitmask);
+
+        EXPECT_EQ(mask1.compute_hash(), mask2.compute_hash());
+        EXPECT_NEQ(mask1.compute_hash(), mask3.compute_hash());
+    }
+}
@@ -0,0 +1,284 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/assemblytree.h"
+#include "renderer/kernel/intersection/triangletree.h"
+#include "renderer/kernel/rendering/rendererservices.h"
+#include "renderer/kernel/shading/oslshadingsystem.h"
+#include "renderer/kernel/texturing/oiiotexturesystem.h"
+#include "renderer/modeling/entity/onframebeginrecorder.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/light/pointlight.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/proceduralassembly.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/transform.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/test.h"
+#include "foundation/utility/version.h"
+
+// OpenImageIO headers.
+#include "foundation/platform/_beginoiioheaders.h"
+#include "OpenImageIO/texture.h"
+#include "foundation/platform/_endoiioheaders.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Intersection_DeferredTriangleTreeFactory)
+{
+    void insert_triangle_object_instance(Assembly& assembly)
+    {
+        auto_release_ptr<MeshObject> mesh_object =
+            MeshObjectFactory::create("triangle", ParamArray());
+
+        mesh_object->push_vertex(GVector3(0.0f, 0.0f, 0.0f));
+        mesh_object->push_vertex(GVector3(1.0f, 0.0f, 0.0f));
+        mesh_object->push_vertex(GVector3(0.0f, 1.0f, 0.0f));
+        mesh_object->push_triangle(Triangle(0, 1, 2));
+
+        assembly.objects().insert(auto_release_ptr<Object>(mesh_object));
+
+        assembly.object_instances().insert(
+            ObjectInstanceFactory::create(
+                "triangle_inst",
+                ParamArray(),
+                "triangle",
+                Transformd::identity(),
+                StringDictionary()));
+    }
+
+    class TestProceduralAssembly
+      : public ProceduralAssembly
+    {
+      public:
+        bool    m_expansion_succeeds;
+        bool    m_expansion_creates_mesh;
+        bool    m_expansion_creates_light;
+        size_t  m_expansion_count;
+
+        TestProceduralAssembly()
+          : ProceduralAssembly(
+                "procedural_assembly",
+                ParamArray()
+                    .insert("deferred_expansion", true)
+                    .insert("bbox_min", "-1.0 -1.0 -1.0")
+                    .insert("bbox_max", "1.0 1.0 1.0"))
+          , m_expansion_succeeds(true)
+          , m_expansion_creates_mesh(true)
+          , m_expansion_creates_light(false)
+          , m_expansion_count(0)
+        {
+        }
+
+        virtual void release() override
+        {
+            delete this;
+        }
+
+        virtual bool expand_contents(
+            const Project&          project,
+            const Assembly*         parent,
+            IAbortSwitch*           abort_switch) override
+        {
+            ++m_expansion_count;
+
+            if (m_expansion_succeeds && m_expansion_creates_mesh)
+                insert_triangle_object_instance(*this);
+
+            if (m_expansion_succeeds && m_expansion_creates_light)
+            {
+                lights().insert(
+                    PointLightFactory::static_create(
+                        "light",
+                        ParamArray().insert("intensity", "1.0")));
+            }
+
+            return m_expansion_succeeds;
+        }
+    };
+
+    struct Fixture
+    {
+        auto_release_ptr<Project>               m_project;
+        TestProceduralAssembly*                 m_assembly;
+        std::shared_ptr<OIIOTextureSystem>      m_texture_system;
+        std::shared_ptr<RendererServices>       m_renderer_services;
+        std::shared_ptr<OSLShadingSystem>       m_shading_system;
+        OnFrameBeginRecorder                    m_recorder;
+        std::unique_ptr<ProceduralAssembly::ExpansionContext> m_context;
+
+        Fixture()
+          : m_project(ProjectFactory::create("project"))
+        {
+            m_project->set_scene(SceneFactory::create());
+
+            m_assembly = new TestProceduralAssembly();
+            m_project->get_scene()->assemblies().insert(auto_release_ptr<Assembly>(m_assembly));
+
+            m_texture_system.reset(
+                OIIOTextureSystemFactory::create(),
+                [](OIIOTextureSystem* object) { object->release(); });
+            m_renderer_services.reset(
+                new RendererServices(
+                    m_project.ref(),
+                    reinterpret_cast<OIIO::TextureSystem&>(*m_texture_system)));
+            m_shading_system.reset(
+                OSLShadingSystemFactory::create(m_renderer_services.get(), m_texture_system.get()),
+                [](OSLShadingSystem* object) { object->release(); });
+
+            m_context.reset(
+                new ProceduralAssembly::ExpansionContext(
+                    m_project.ref(),
+                    *m_shading_system,
+                    m_recorder));
+            m_assembly->set_expansion_context(m_context.get());
+        }
+
+        ~Fixture()
+        {
+            m_assembly->set_expansion_context(0);
+            m_recorder.on_frame_end(m_project.ref());
+        }
+    };
+
+    TEST_CASE_F(Create_GivenAssemblyExpandingToMesh_ReturnsTree, Fixture)
+    {
+        DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+
+        const auto_ptr<TriangleTree> tree(factory.create());
+
+        EXPECT_NEQ(0, tree.get());
+        EXPECT_EQ(1, m_assembly->m_expansion_count);
+    }
+
+    TEST_CASE_F(Create_GivenFailedExpansion_ReturnsEmptyPointerOnEveryCall, Fixture)
+    {
+        m_assembly->m_expansion_succeeds = false;
+        DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+
+        const auto_ptr<TriangleTree> first_tree(factory.create());
+        const auto_ptr<TriangleTree> second_tree(factory.create());
+
+        EXPECT_EQ(0, first_tree.get());
+        EXPECT_EQ(0, second_tree.get());
+        EXPECT_EQ(1, m_assembly->m_expansion_count);
+    }
+
+    TEST_CASE_F(Create_GivenExpansionWithoutMesh_RemembersEmptyResult, Fixture)
+    {
+        m_assembly->m_expansion_creates_mesh = false;
+        DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+
+        const auto_ptr<TriangleTree> first_tree(factory.create());
+        EXPECT_EQ(0, first_tree.get());
+
+        // A mesh showing up after the expansion must not cause the factory to look again.
+        insert_triangle_object_instance(*m_assembly);
+        InputBinder input_binder;
+        input_binder.bind(*m_project->get_scene(), *m_assembly);
+
+        const auto_ptr<TriangleTree> second_tree(factory.create());
+        EXPECT_EQ(0, second_tree.get());
+        EXPECT_EQ(1, m_assembly->m_expansion_count);
+    }
+
+    TEST_CASE_F(Create_GivenNoExpansionContext_RetriesOnNextCall, Fixture)
+    {
+        m_assembly->set_expansion_context(0);
+        DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+
+        const auto_ptr<TriangleTree> first_tree(factory.create());
+        EXPECT_EQ(0, first_tree.get());
+        EXPECT_EQ(0, m_assembly->m_expansion_count);
+
+        m_assembly->set_expansion_context(m_context.get());
+
+        const auto_ptr<TriangleTree> second_tree(factory.create());
+        EXPECT_NEQ(0, second_tree.get());
+        EXPECT_EQ(1, m_assembly->m_expansion_count);
+    }
+
+    TEST_CASE_F(DiscardDeferredContents_GivenExpandedAssembly_DropsContentsAndMakesExpansionPending, Fixture)
+    {
+        {
+            DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+            const auto_ptr<TriangleTree> tree(factory.create());
+        }
+
+        const VersionID version_id = m_assembly->get_version_id();
+
+        m_recorder.on_frame_end(m_project.ref());
+        m_assembly->discard_deferred_contents();
+
+        EXPECT_TRUE(m_assembly->is_expansion_pending());
+        EXPECT_TRUE(m_assembly->objects().empty());
+        EXPECT_TRUE(m_assembly->object_instances().empty());
+        EXPECT_NEQ(version_id, m_assembly->get_version_id());
+
+        DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+        const auto_ptr<TriangleTree> tree(factory.create());
+
+        EXPECT_NEQ(0, tree.get());
+        EXPECT_EQ(2, m_assembly->m_expansion_count);
+    }
+
+    TEST_CASE_F(DiscardDeferredContents_GivenExpansionCreatingLight_StopsDeferringExpansion, Fixture)
+    {
+        m_assembly->m_expansion_creates_light = true;
+
+        {
+            DeferredTriangleTreeFactory factory(*m_project->get_scene(), *m_assembly);
+            const auto_ptr<TriangleTree> tree(factory.create());
+        }
+
+        m_recorder.on_frame_end(m_project.ref());
+        m_assembly->discard_deferred_contents();
+
+        EXPECT_FALSE(m_assembly->is_expansion_pending());
+        EXPECT_TRUE(m_assembly->lights().empty());
+    }
+}
@@ -35,6 +35,9 @@
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/test.h"
 
+// Standard headers.
+#include <cstddef>
+
 using namespace foundation;
 using namespace renderer;
 
@@ -78,4 +81,65 @@ TEST_SUITE(Renderer_Utility_BBox)
 
         EXPECT_FEQ(bboxes[1], result);
     }
+
+    bool path_bounds_path(
+        const AABB3d*   path,
+        const size_t    path_bbox_count,
+        const AABB3d*   bboxes,
+        const size_t    bbox_count)
+    {
+        const size_t StepCount = 1000;
+
+        for (size_t i = 0; i < StepCount; ++i)
+        {
+            const double time = static_cast<double>(i) / StepCount;
+
+            AABB3d path_bbox = interpolate<AABB3d>(path, path + path_bbox_count, time);
+            path_bbox.grow(Vector3d(1.0e-9));
+
+            const AABB3d bbox = interpolate<AABB3d>(bboxes, bboxes + bbox_count, time);
+
+            if (!path_bbox.contains(bbox.min) || !path_bbox.contains(bbox.max))
+                return false;
+        }
+
+        return true;
+    }
+
+    TEST_CASE(InsertPath_Given2KeyPathInto4KeyPath_BoundsPathAtAllTimes)
+    {
+        const AABB3d bboxes[2] =
+        {
+            AABB3d(Vector3d(0.0), Vector3d(1.0)),
+            AABB3d(Vector3d(9.0), Vector3d(10.0))
+        };
+
+        AABB3d path[4];
+        for (size_t i = 0; i < 4; ++i)
+            path[i] = AABB3d(Vector3d(5.0), Vector3d(5.0));
+
+        insert_path<AABB3d>(bboxes, bboxes + 2, path, path + 4);
+
+        EXPECT_TRUE(path_bounds_path(path, 4, bboxes, 2));
+    }
+
+    TEST_CASE(InsertPath_Given4KeyPathInto8KeyPath_BoundsPathAtAllTimes)
+    {
+        // This path has kinks at t = 1/3 and t = 2/3, which are not keys of the 8-key path.
+        const AABB3d bboxes[4] =
+        {
+            AABB3d(Vector3d(0.0), Vector3d(1.0)),
+            AABB3d(Vector3d(9.0), Vector3d(10.0)),
+            AABB3d(Vector3d(0.0), Vector3d(1.0)),
+            AABB3d(Vector3d(9.0), Vector3d(10.0))
+        };
+
+        AABB3d path[8];
+        for (size_t i = 0; i < 8; ++i)
+            path[i].invalidate();
+
+        insert_path<AABB3d>(bboxes, bboxes + 4, path, path + 8);
+
+        EXPECT_TRUE(path_bounds_path(path, 8, bboxes, 4));
+    }
 }
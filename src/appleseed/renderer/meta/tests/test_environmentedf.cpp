@@ -43,8 +43,10 @@
 #include "renderer/modeling/environmentedf/constantenvironmentedf.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentedf/gradientenvironmentedf.h"
+#include "renderer/modeling/environmentedf/hosekenvironmentedf.h"
 #include "renderer/modeling/environmentedf/latlongmapenvironmentedf.h"
 #include "renderer/modeling/environmentedf/mirrorballmapenvironmentedf.h"
+#include "renderer/modeling/environmentedf/preethamenvironmentedf.h"
 #include "renderer/modeling/input/source.h"
 #include "renderer/modeling/input/texturesource.h"
 #include "renderer/modeling/scene/containers.h"
@@ -327,4 +329,80 @@ TEST_SUITE(Renderer_Modeling_EnvironmentEDF)
 
         EXPECT_TRUE(consistent);
     }
+
+    TEST_CASE_F(CheckTabulatedHosekEnvironmentEDFConsistency, Fixture)
+    {
+        auto_release_ptr<EnvironmentEDF> env_edf(
+            HosekEnvironmentEDFFactory().create(
+                "env_edf",
+                ParamArray()
+                    .insert("sun_theta", "45.0")
+                    .insert("sun_phi", "0.0")
+                    .insert("turbidity", "1.0")
+                    .insert("table_resolution", "64")));
+        EnvironmentEDF& env_edf_ref = env_edf.ref();
+        m_scene.environment_edfs().insert(env_edf);
+
+        const bool consistent = check_consistency(env_edf_ref);
+
+        EXPECT_TRUE(consistent);
+    }
+
+    TEST_CASE_F(CheckTabulatedPreethamEnvironmentEDFConsistency, Fixture)
+    {
+        auto_release_ptr<EnvironmentEDF> env_edf(
+            PreethamEnvironmentEDFFactory().create(
+                "env_edf",
+                ParamArray()
+                    .insert("sun_theta", "45.0")
+                    .insert("sun_phi", "0.0")
+                    .insert("turbidity", "1.0")
+                    .insert("table_resolution", "64")));
+        EnvironmentEDF& env_edf_ref = env_edf.ref();
+        m_scene.environment_edfs().insert(env_edf);
+
+        const bool consistent = check_consistency(env_edf_ref);
+
+        EXPECT_TRUE(consistent);
+    }
+
+    TEST_CASE_F(OnFrameBegin_GivenHosekEnvironmentEDFAndSceneWithoutEnvironment_DoesNotTabulateSky, Fixture)
+    {
+        auto_release_ptr<EnvironmentEDF> env_edf(
+            HosekEnvironmentEDFFactory().create(
+                "env_edf",
+                ParamArray()
+                    .insert("turbidity", "1.0")
+                    .insert("table_resolution", "64")));
+        EnvironmentEDF& env_edf_ref = env_edf.ref();
+        m_scene.environment_edfs().insert(env_edf);
+
+        bind_inputs();
+
+        OnFrameBeginRecorder recorder;
+        const bool success = env_edf_ref.on_frame_begin(m_project, &m_scene, recorder);
+        recorder.on_frame_end(m_project);
+
+        EXPECT_TRUE(success);
+    }
+
+    TEST_CASE_F(OnFrameBegin_GivenPreethamEnvironmentEDFAndSceneWithoutEnvironment_DoesNotTabulateSky, Fixture)
+    {
+        auto_release_ptr<EnvironmentEDF> env_edf(
+            PreethamEnvironmentEDFFactory().create(
+                "env_edf",
+                ParamArray()
+                    .insert("turbidity", "1.0")
+                    .insert("table_resolution", "64")));
+        EnvironmentEDF& env_edf_ref = env_edf.ref();
+        m_scene.environment_edfs().insert(env_edf);
+
+        bind_inputs();
+
+        OnFrameBeginRecorder recorder;
+        const bool success = env_edf_ref.on_frame_begin(m_project, &m_scene, recorder);
+        recorder.on_frame_end(m_project);
+
+        EXPECT_TRUE(success);
+    }
 }
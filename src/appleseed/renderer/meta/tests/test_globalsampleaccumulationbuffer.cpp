@@ -0,0 +1,111 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/globalsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/filter.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_GlobalSampleAccumulationBuffer)
+{
+    void store_samples(GlobalSampleAccumulationBuffer& buffer, const size_t sample_count)
+    {
+        vector<Sample> samples(sample_count);
+
+        for (size_t i = 0; i < sample_count; ++i)
+        {
+            samples[i].m_position = Vector2f(0.5f, 0.5f);
+            samples[i].m_color = Color4f(1.0f);
+        }
+
+        AbortSwitch abort_switch;
+        buffer.store_samples(sample_count, &samples[0], SampleAOVArray(), abort_switch);
+    }
+
+    TEST_CASE(Constructor_StartsWithCoarsestPreviewLevel)
+    {
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        GlobalSampleAccumulationBuffer buffer(64, 64, filter);
+
+        // Levels are 64x64, 16x16, 8x8 and 4x4.
+        EXPECT_EQ(3, buffer.get_active_level());
+    }
+
+    TEST_CASE(Constructor_GivenTinyFrame_SkipsRedundantPreviewLevels)
+    {
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        GlobalSampleAccumulationBuffer buffer(6, 6, filter);
+
+        // Levels are 6x6 and 1x1.
+        EXPECT_EQ(1, buffer.get_active_level());
+    }
+
+    TEST_CASE(StoreSamples_HandsOffToFinerLevelsAsSamplesAccumulate)
+    {
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        GlobalSampleAccumulationBuffer buffer(64, 64, filter);
+
+        store_samples(buffer, 8 * 8 - 1);
+        EXPECT_EQ(3, buffer.get_active_level());
+
+        store_samples(buffer, 1);
+        EXPECT_EQ(2, buffer.get_active_level());
+
+        store_samples(buffer, 16 * 16 - 8 * 8);
+        EXPECT_EQ(1, buffer.get_active_level());
+
+        store_samples(buffer, 64 * 64 - 16 * 16);
+        EXPECT_EQ(0, buffer.get_active_level());
+    }
+
+    TEST_CASE(Clear_RestartsFromCoarsestPreviewLevel)
+    {
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        GlobalSampleAccumulationBuffer buffer(64, 64, filter);
+
+        store_samples(buffer, 64 * 64);
+        buffer.clear();
+
+        EXPECT_EQ(3, buffer.get_active_level());
+    }
+}
@@ -27,17 +27,20 @@
 //
 
 // appleseed.renderer headers.
+#include "renderer/kernel/aov/tilestack.h"
 #include "renderer/kernel/rendering/localsampleaccumulationbuffer.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
 #include "foundation/image/filteredtile.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/math/aabb.h"
 #include "foundation/math/filter.h"
 #include "foundation/math/rng/distribution.h"
 #include "foundation/math/rng/mersennetwister.h"
 #include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
 #include "foundation/utility/job.h"
 #include "foundation/utility/test.h"
 
@@ -138,4 +141,44 @@ TEST_SUITE(Renderer_Kernel_Rendering_LocalSampleAccumulationBuffer)
             EXPECT_TRUE(honors_crop_window(crop_window));
         }
     }
+
+    TEST_CASE(DevelopAOVsToTiles_NormalizesAOVsByFilterWeight)
+    {
+        // A full resolution AOV framebuffer with two AOVs.
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        FilteredTile aov_fb(4, 4, 2 * 4, filter);
+        aov_fb.clear();
+
+        // Two samples in pixel (1, 2), none elsewhere.
+        static const float values1[8] = { 1.0f, 2.0f, 3.0f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f };
+        static const float values2[8] = { 3.0f, 4.0f, 5.0f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f };
+        aov_fb.add(1.5f, 2.5f, values1);
+        aov_fb.add(1.5f, 2.5f, values2);
+
+        Tile aov_tile1(4, 4, 4, PixelFormatFloat);
+        Tile aov_tile2(4, 4, 4, PixelFormatFloat);
+        aov_tile1.clear(Color4f(-1.0f));
+        aov_tile2.clear(Color4f(-1.0f));
+
+        TileStack aov_tiles;
+        aov_tiles.append(&aov_tile1);
+        aov_tiles.append(&aov_tile2);
+
+        LocalSampleAccumulationBuffer::develop_aovs_to_tiles(
+            aov_tiles,
+            aov_fb,
+            0, 0,
+            AABB2u(Vector2u(0, 0), Vector2u(3, 3)));
+
+        Color4f color;
+
+        aov_tile1.get_pixel(1, 2, color);
+        EXPECT_EQ(Color4f(2.0f, 3.0f, 4.0f, 1.0f), color);
+
+        aov_tile2.get_pixel(1, 2, color);
+        EXPECT_EQ(Color4f(0.5f, 0.5f, 0.5f, 1.0f), color);
+
+        aov_tile1.get_pixel(0, 0, color);
+        EXPECT_EQ(Color4f(0.0f), color);
+    }
 }
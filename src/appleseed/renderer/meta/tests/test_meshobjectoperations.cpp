@@ -0,0 +1,175 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/meshobjectoperations.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/triangle.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Modeling_Object_MeshObjectOperations)
+{
+    // A bumpy grid with one motion segment, large enough to span several vertex blocks.
+    auto_release_ptr<MeshObject> create_grid()
+    {
+        const size_t Width = 160;
+        const size_t Height = 120;
+
+        auto_release_ptr<MeshObject> object = MeshObjectFactory::create("grid", ParamArray());
+
+        MersenneTwister rng;
+
+        for (size_t y = 0; y <= Height; ++y)
+        {
+            for (size_t x = 0; x <= Width; ++x)
+            {
+                object->push_vertex(GVector3(GScalar(x), GScalar(y), rand_float1(rng)));
+                object->push_tex_coords(
+                    GVector2(
+                        GScalar(x) / Width + rand_float1(rng, 0.0f, 0.001f),
+                        GScalar(y) / Height + rand_float1(rng, 0.0f, 0.001f)));
+            }
+        }
+
+        for (size_t y = 0; y < Height; ++y)
+        {
+            for (size_t x = 0; x < Width; ++x)
+            {
+                const size_t v0 = y * (Width + 1) + x;
+                const size_t v1 = v0 + 1;
+                const size_t v2 = v1 + Width + 1;
+                const size_t v3 = v0 + Width + 1;
+
+                Triangle t0(v0, v1, v2);
+                t0.m_a0 = t0.m_v0; t0.m_a1 = t0.m_v1; t0.m_a2 = t0.m_v2;
+                object->push_triangle(t0);
+
+                Triangle t1(v2, v3, v0);
+                t1.m_a0 = t1.m_v0; t1.m_a1 = t1.m_v1; t1.m_a2 = t1.m_v2;
+                object->push_triangle(t1);
+            }
+        }
+
+        object->set_motion_segment_count(1);
+
+        for (size_t i = 0; i < object->get_vertex_count(); ++i)
+            object->set_vertex_pose(i, 0, object->get_vertex(i) + GVector3(0.0f, 0.0f, rand_float1(rng)));
+
+        return object;
+    }
+
+    // Serial reference: scatter the normal of each triangle to its vertices, in triangle order.
+    vector<GVector3> compute_reference_normals(const MeshObject& object, const size_t pose)
+    {
+        vector<GVector3> normals(object.get_vertex_count(), GVector3(0.0));
+
+        for (size_t i = 0; i < object.get_triangle_count(); ++i)
+        {
+            const Triangle& triangle = object.get_triangle(i);
+
+            const GVector3 v0 = pose == 0 ? object.get_vertex(triangle.m_v0) : object.get_vertex_pose(triangle.m_v0, pose - 1);
+            const GVector3 v1 = pose == 0 ? object.get_vertex(triangle.m_v1) : object.get_vertex_pose(triangle.m_v1, pose - 1);
+            const GVector3 v2 = pose == 0 ? object.get_vertex(triangle.m_v2) : object.get_vertex_pose(triangle.m_v2, pose - 1);
+            const GVector3 normal = normalize(compute_triangle_normal(v0, v1, v2));
+
+            normals[triangle.m_v0] += normal;
+            normals[triangle.m_v1] += normal;
+            normals[triangle.m_v2] += normal;
+        }
+
+        for (size_t i = 0; i < normals.size(); ++i)
+            normals[i] = safe_normalize(normals[i]);
+
+        return normals;
+    }
+
+    TEST_CASE(ComputeSmoothVertexNormals_GivenSeveralThreads_MatchesSerialReferenceExactly)
+    {
+        auto_release_ptr<MeshObject> object = create_grid();
+        const vector<GVector3> expected_base_normals = compute_reference_normals(object.ref(), 0);
+        const vector<GVector3> expected_pose_normals = compute_reference_normals(object.ref(), 1);
+
+        compute_smooth_vertex_normals(object.ref(), 4);
+
+        ASSERT_EQ(object->get_vertex_count(), object->get_vertex_normal_count());
+
+        size_t mismatch_count = 0;
+
+        for (size_t i = 0; i < object->get_vertex_count(); ++i)
+        {
+            if (object->get_vertex_normal(i) != expected_base_normals[i])
+                ++mismatch_count;
+
+            if (object->get_vertex_normal_pose(i, 0) != expected_pose_normals[i])
+                ++mismatch_count;
+        }
+
+        EXPECT_EQ(0, mismatch_count);
+    }
+
+    TEST_CASE(ComputeSmoothVertexTangents_GivenSeveralThreads_MatchesSingleThreadExactly)
+    {
+        auto_release_ptr<MeshObject> serial_object = create_grid();
+        auto_release_ptr<MeshObject> parallel_object = create_grid();
+
+        compute_smooth_vertex_tangents(serial_object.ref(), 1);
+        compute_smooth_vertex_tangents(parallel_object.ref(), 4);
+
+        ASSERT_EQ(serial_object->get_vertex_count(), parallel_object->get_vertex_tangent_count());
+
+        size_t mismatch_count = 0;
+
+        for (size_t i = 0; i < serial_object->get_vertex_count(); ++i)
+        {
+            if (parallel_object->get_vertex_tangent(i) != serial_object->get_vertex_tangent(i))
+                ++mismatch_count;
+
+            if (parallel_object->get_vertex_tangent_pose(i, 0) != serial_object->get_vertex_tangent_pose(i, 0))
+                ++mismatch_count;
+        }
+
+        EXPECT_EQ(0, mismatch_count);
+    }
+}
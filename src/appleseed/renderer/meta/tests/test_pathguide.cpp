@@ -0,0 +1,200 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/pathguide.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Lighting_PathGuide)
+{
+    const AABB3d SceneBBox(Vector3d(-1.0), Vector3d(1.0));
+
+    // Record radiance arriving mostly from above, and a little from everywhere else.
+    void train(PathGuide& guide, const size_t leaf_index, const size_t sample_count)
+    {
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < sample_count; ++i)
+        {
+            const Vector3f incoming = sample_sphere_uniform(rand_vector2<Vector2f>(rng));
+            guide.record(leaf_index, incoming, incoming[2] > 0.9f ? 10.0f : 0.1f);
+        }
+    }
+
+    // Integrate the density of a leaf over the sphere, with one point per cell
+    // of a regular grid in the equal-area (cos theta, phi) parameterization.
+    float integrate_pdf(const PathGuide& guide, const size_t leaf_index)
+    {
+        const size_t Res = 4 * PathGuide::DirectionalResolution;
+
+        float integral = 0.0f;
+
+        for (size_t i = 0; i < Res; ++i)
+        {
+            for (size_t j = 0; j < Res; ++j)
+            {
+                const float cos_theta = 2.0f * (i + 0.5f) / Res - 1.0f;
+                const float sin_theta = sqrt(1.0f - cos_theta * cos_theta);
+                const float phi = TwoPi<float>() * (j + 0.5f) / Res;
+                const Vector3f incoming(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+
+                integral += guide.evaluate_pdf(leaf_index, incoming);
+            }
+        }
+
+        return integral * FourPi<float>() / (Res * Res);
+    }
+
+    TEST_CASE(IsTrained_GivenNewGuide_ReturnsFalse)
+    {
+        const PathGuide guide(SceneBBox, 100, 16);
+
+        EXPECT_FALSE(guide.is_trained(0));
+        EXPECT_EQ(0.0f, guide.evaluate_pdf(0, Vector3f(0.0f, 0.0f, 1.0f)));
+    }
+
+    TEST_CASE(Refine_GivenNoRecordedRadiance_LeavesLeafUntrained)
+    {
+        PathGuide guide(SceneBBox, 100, 16);
+        guide.record(0, Vector3f(0.0f, 0.0f, 1.0f), 0.0f);
+
+        guide.refine();
+
+        EXPECT_FALSE(guide.is_trained(0));
+        EXPECT_EQ(1, guide.get_iteration());
+    }
+
+    TEST_CASE(EvaluatePdf_GivenTrainedLeaf_IntegratesToOne)
+    {
+        PathGuide guide(SceneBBox, 100000, 16);
+        train(guide, 0, 10000);
+
+        guide.refine();
+
+        ASSERT_TRUE(guide.is_trained(0));
+        EXPECT_FEQ_EPS(1.0f, integrate_pdf(guide, 0), 1.0e-3f);
+    }
+
+    TEST_CASE(Sample_GivenTrainedLeaf_ReturnsPdfOfSampledDirection)
+    {
+        PathGuide guide(SceneBBox, 100000, 16);
+        train(guide, 0, 10000);
+        guide.refine();
+
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            Vector3f incoming;
+            const float pdf = guide.sample(0, rand_vector2<Vector2f>(rng), incoming);
+
+            EXPECT_FEQ_EPS(1.0f, norm(incoming), 1.0e-5f);
+            EXPECT_GT(0.0f, pdf);
+            EXPECT_FEQ_EPS(pdf, guide.evaluate_pdf(0, incoming), 1.0e-4f * pdf);
+        }
+    }
+
+    TEST_CASE(Sample_GivenTrainedLeaf_FavorsDirectionsWithMoreRadiance)
+    {
+        PathGuide guide(SceneBBox, 100000, 16);
+        train(guide, 0, 10000);
+        guide.refine();
+
+        MersenneTwister rng;
+        size_t upward_count = 0;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            Vector3f incoming;
+            guide.sample(0, rand_vector2<Vector2f>(rng), incoming);
+
+            if (incoming[2] > 0.875f)
+                ++upward_count;
+        }
+
+        // The upper 1/16th of the sphere receives about 90% of the recorded radiance.
+        EXPECT_GT(800, upward_count);
+    }
+
+    TEST_CASE(Refine_GivenLeafAboveSpatialThreshold_SplitsLeafAndKeepsDistribution)
+    {
+        PathGuide guide(SceneBBox, 1000, 16);
+        train(guide, 0, 2500);
+
+        guide.refine();
+
+        ASSERT_GT(1, guide.get_leaf_count());
+
+        const size_t left_leaf = guide.find_leaf(Vector3d(-0.9));
+        const size_t right_leaf = guide.find_leaf(Vector3d(0.9));
+        EXPECT_NEQ(left_leaf, right_leaf);
+
+        // Children inherit the training data of their parent.
+        for (size_t i = 0; i < guide.get_leaf_count(); ++i)
+        {
+            EXPECT_TRUE(guide.is_trained(i));
+            EXPECT_FEQ_EPS(1.0f, integrate_pdf(guide, i), 1.0e-3f);
+        }
+    }
+
+    TEST_CASE(Refine_GivenLeafBelowSpatialThreshold_DoesNotSplitLeaf)
+    {
+        PathGuide guide(SceneBBox, 1000, 16);
+        train(guide, 0, 500);
+
+        guide.refine();
+
+        EXPECT_EQ(1, guide.get_leaf_count());
+    }
+
+    TEST_CASE(Refine_GivenManySamples_DoesNotExceedMaxLeafCount)
+    {
+        PathGuide guide(SceneBBox, 10, 5);
+        train(guide, 0, 10000);
+
+        guide.refine();
+
+        EXPECT_EQ(5, guide.get_leaf_count());
+    }
+}
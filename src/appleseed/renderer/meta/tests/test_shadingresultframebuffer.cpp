@@ -0,0 +1,143 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2010-2013 Francois Beaune, Jupiter Jazz Limited
+// Copyright (c) 2014-2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/aov/tilestack.h"
+#include "renderer/kernel/rendering/shadingresultframebuffer.h"
+#include "renderer/kernel/shading/shadingresult.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/filter.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_ShadingResultFrameBuffer)
+{
+    TEST_CASE(DevelopToTile_GivenDisjointRegions_MatchesWholeTile)
+    {
+        const size_t Width = 16;
+        const size_t Height = 16;
+        const GaussianFilter2<float> filter(1.5f, 1.5f, 8.0f);
+
+        const AABB2u whole(Vector2u(0, 0), Vector2u(Width - 1, Height - 1));
+        const AABB2u left(Vector2u(0, 0), Vector2u(6, Height - 1));
+        const AABB2u right(Vector2u(7, 0), Vector2u(Width - 1, Height - 1));
+
+        ShadingResultFrameBuffer whole_framebuffer(Width, Height, 0, whole, filter);
+        ShadingResultFrameBuffer left_framebuffer(Width, Height, 0, left, filter);
+        ShadingResultFrameBuffer right_framebuffer(Width, Height, 0, right, filter);
+        whole_framebuffer.clear();
+        left_framebuffer.clear();
+        right_framebuffer.clear();
+
+        // Splat the same samples, including samples in the tile margins, into all framebuffers.
+        MersenneTwister rng;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const float x = rand_float1(rng, -2.0f, Width + 2.0f);
+            const float y = rand_float1(rng, -2.0f, Height + 2.0f);
+
+            ShadingResult sample;
+            sample.m_main = Color4f(rand_float1(rng), rand_float1(rng), rand_float1(rng), 1.0f);
+
+            whole_framebuffer.add(x, y, sample);
+            left_framebuffer.add(x, y, sample);
+            right_framebuffer.add(x, y, sample);
+        }
+
+        TileStack aov_tiles;
+
+        Tile expected(Width, Height, 4, PixelFormatFloat);
+        whole_framebuffer.develop_to_tile(expected, aov_tiles);
+
+        Tile result(Width, Height, 4, PixelFormatFloat);
+        result.clear(Color4f(-1.0f));
+        left_framebuffer.develop_to_tile(result, aov_tiles, AABB2i(left));
+        right_framebuffer.develop_to_tile(result, aov_tiles, AABB2i(right));
+
+        for (size_t y = 0; y < Height; ++y)
+        {
+            for (size_t x = 0; x < Width; ++x)
+            {
+                Color4f expected_color, result_color;
+                expected.get_pixel(x, y, expected_color);
+                result.get_pixel(x, y, result_color);
+
+                EXPECT_EQ(expected_color, result_color);
+            }
+        }
+    }
+
+    TEST_CASE(Add_GivenSampleWithAOVs_AccumulatesMainOutputAndAOVs)
+    {
+        const BoxFilter2<float> filter(0.5f, 0.5f);
+        ShadingResultFrameBuffer framebuffer(2, 2, 2, filter);
+        framebuffer.clear();
+
+        ShadingResult sample(2);
+        sample.m_main = Color4f(1.0f, 2.0f, 3.0f, 1.0f);
+        sample.m_aovs[0] = Color4f(4.0f, 5.0f, 6.0f, 1.0f);
+        sample.m_aovs[1] = Color4f(7.0f, 8.0f, 9.0f, 1.0f);
+        framebuffer.add(1.5f, 0.5f, sample);
+
+        Tile tile(2, 2, 4, PixelFormatFloat);
+        Tile aov_tile1(2, 2, 4, PixelFormatFloat);
+        Tile aov_tile2(2, 2, 4, PixelFormatFloat);
+
+        TileStack aov_tiles;
+        aov_tiles.append(&aov_tile1);
+        aov_tiles.append(&aov_tile2);
+
+        framebuffer.develop_to_tile(tile, aov_tiles);
+
+        Color4f color;
+
+        tile.get_pixel(1, 0, color);
+        EXPECT_EQ(sample.m_main, color);
+
+        aov_tile1.get_pixel(1, 0, color);
+        EXPECT_EQ(sample.m_aovs[0], color);
+
+        aov_tile2.get_pixel(1, 0, color);
+        EXPECT_EQ(sample.m_aovs[1], color);
+    }
+}
@@ -0,0 +1,147 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/tessellation/statictessellation.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Tessellation_StaticTessellation)
+{
+    struct Fixture
+    {
+        StaticTriangleTess m_tess;
+
+        Fixture()
+        {
+            m_tess.push_vertex_normal(normalize(GVector3(1.0f, 2.0f, 3.0f)));
+            m_tess.push_vertex_normal(normalize(GVector3(-1.0f, 0.5f, -2.0f)));
+
+            m_tess.push_vertex_tangent(normalize(GVector3(0.0f, -3.0f, 1.0f)));
+            m_tess.push_vertex_tangent(normalize(GVector3(2.0f, 1.0f, -1.0f)));
+
+            m_tess.push_tex_coords(GVector2(0.25f, 0.5f));
+            m_tess.push_tex_coords(GVector2(1.0f, 0.75f));
+            m_tess.push_tex_coords(GVector2(0.125f, 1.5f));
+        }
+    };
+
+    TEST_CASE_F(CompressVertexAttributes_PreservesVertexAttributes, Fixture)
+    {
+        EXPECT_EQ(2 * sizeof(GVector3) + 2 * sizeof(GVector3) + 3 * sizeof(GVector2), m_tess.get_vertex_attributes_memory_size());
+
+        m_tess.compress_vertex_attributes();
+
+        EXPECT_TRUE(m_tess.has_compressed_vertex_attributes());
+        EXPECT_EQ(7 * sizeof(uint32), m_tess.get_vertex_attributes_memory_size());
+
+        ASSERT_EQ(2, m_tess.get_vertex_normal_count());
+        EXPECT_FEQ_EPS(normalize(GVector3(1.0f, 2.0f, 3.0f)), m_tess.get_vertex_normal(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(normalize(GVector3(-1.0f, 0.5f, -2.0f)), m_tess.get_vertex_normal(1), 1.0e-4f);
+
+        ASSERT_EQ(2, m_tess.get_vertex_tangent_count());
+        EXPECT_FEQ_EPS(normalize(GVector3(0.0f, -3.0f, 1.0f)), m_tess.get_vertex_tangent(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(normalize(GVector3(2.0f, 1.0f, -1.0f)), m_tess.get_vertex_tangent(1), 1.0e-4f);
+
+        ASSERT_EQ(3, m_tess.get_tex_coords_count());
+        EXPECT_FEQ_EPS(GVector2(0.25f, 0.5f), m_tess.get_tex_coords(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector2(1.0f, 0.75f), m_tess.get_tex_coords(1), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector2(0.125f, 1.5f), m_tess.get_tex_coords(2), 1.0e-4f);
+    }
+
+    TEST_CASE_F(PushVertexAttributes_AfterCompression_InsertsVertexAttributes, Fixture)
+    {
+        m_tess.compress_vertex_attributes();
+
+        EXPECT_EQ(2, m_tess.push_vertex_normal(GVector3(0.0f, 0.0f, -1.0f)));
+        EXPECT_EQ(2, m_tess.push_vertex_tangent(GVector3(1.0f, 0.0f, 0.0f)));
+        EXPECT_EQ(3, m_tess.push_tex_coords(GVector2(0.5f, 0.5f)));
+
+        EXPECT_FEQ_EPS(GVector3(0.0f, 0.0f, -1.0f), m_tess.get_vertex_normal(2), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector3(1.0f, 0.0f, 0.0f), m_tess.get_vertex_tangent(2), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector2(0.5f, 0.5f), m_tess.get_tex_coords(3), 1.0e-4f);
+    }
+
+    TEST_CASE_F(PushTexCoords_GivenTexCoordsOutOfCompressedRange_PreservesAllTexCoords, Fixture)
+    {
+        m_tess.compress_vertex_attributes();
+
+        EXPECT_EQ(3, m_tess.push_tex_coords(GVector2(10.0f, -4.0f)));
+
+        EXPECT_FEQ_EPS(GVector2(0.25f, 0.5f), m_tess.get_tex_coords(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector2(1.0f, 0.75f), m_tess.get_tex_coords(1), 1.0e-4f);
+        EXPECT_FEQ_EPS(GVector2(0.125f, 1.5f), m_tess.get_tex_coords(2), 1.0e-4f);
+        EXPECT_EQ(GVector2(10.0f, -4.0f), m_tess.get_tex_coords(3));
+    }
+
+    TEST_CASE_F(PushVertexTangent_GivenZeroTangentAfterCompression_PreservesAllTangents, Fixture)
+    {
+        m_tess.compress_vertex_attributes();
+
+        EXPECT_EQ(2, m_tess.push_vertex_tangent(GVector3(0.0f)));
+
+        EXPECT_FEQ_EPS(normalize(GVector3(0.0f, -3.0f, 1.0f)), m_tess.get_vertex_tangent(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(normalize(GVector3(2.0f, 1.0f, -1.0f)), m_tess.get_vertex_tangent(1), 1.0e-4f);
+        EXPECT_EQ(GVector3(0.0f), m_tess.get_vertex_tangent(2));
+    }
+
+    TEST_CASE_F(PushVertexTangent_GivenScaledTangentAfterCompression_PreservesAllTangents, Fixture)
+    {
+        m_tess.compress_vertex_attributes();
+
+        EXPECT_EQ(2, m_tess.push_vertex_tangent(GVector3(0.0f, 3.0f, 0.0f)));
+
+        EXPECT_FEQ_EPS(normalize(GVector3(0.0f, -3.0f, 1.0f)), m_tess.get_vertex_tangent(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(normalize(GVector3(2.0f, 1.0f, -1.0f)), m_tess.get_vertex_tangent(1), 1.0e-4f);
+        EXPECT_EQ(GVector3(0.0f, 3.0f, 0.0f), m_tess.get_vertex_tangent(2));
+    }
+
+    TEST_CASE(CompressVertexAttributes_GivenZeroAndScaledTangents_PreservesAllTangents)
+    {
+        StaticTriangleTess tess;
+        tess.push_vertex_normal(GVector3(0.0f));
+        tess.push_vertex_tangent(GVector3(0.0f));
+        tess.push_vertex_tangent(GVector3(0.0f, 0.0f, 2.0f));
+
+        tess.compress_vertex_attributes();
+
+        ASSERT_EQ(1, tess.get_vertex_normal_count());
+        EXPECT_FEQ_EPS(GVector3(1.0f, 0.0f, 0.0f), tess.get_vertex_normal(0), 1.0e-4f);
+
+        ASSERT_EQ(2, tess.get_vertex_tangent_count());
+        EXPECT_EQ(GVector3(0.0f), tess.get_vertex_tangent(0));
+        EXPECT_EQ(GVector3(0.0f, 0.0f, 2.0f), tess.get_vertex_tangent(1));
+    }
+}
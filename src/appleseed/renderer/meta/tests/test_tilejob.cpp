@@ -0,0 +1,199 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/rendering/generic/tilejob.h"
+#include "renderer/kernel/rendering/itilerenderer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Generic_TileJob)
+{
+    // Tile renderer that takes a fixed time per row of pixels, much longer in tile (0, 0),
+    // and records the regions of tile (0, 0) it rendered.
+    class SleepingTileRenderer
+      : public ITileRenderer
+    {
+      public:
+        vector<AABB2u> m_slow_tile_regions;
+
+        SleepingTileRenderer(
+            const uint32    slow_tile_row_time,
+            const uint32    row_time)
+          : m_slow_tile_row_time(slow_tile_row_time)
+          , m_row_time(row_time)
+        {
+        }
+
+        virtual void release() override
+        {
+            delete this;
+        }
+
+        virtual void render_tile(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const size_t    pass_hash,
+            IAbortSwitch&   abort_switch) override
+        {
+        }
+
+        virtual bool supports_tile_regions() const override
+        {
+            return true;
+        }
+
+        virtual void render_tile_region(
+            const Frame&    frame,
+            const size_t    tile_x,
+            const size_t    tile_y,
+            const AABB2u&   region,
+            const size_t    pass_hash,
+            IAbortSwitch&   abort_switch) override
+        {
+            const bool slow_tile = tile_x == 0 && tile_y == 0;
+
+            for (size_t y = region.min.y; y <= region.max.y; ++y)
+                foundation::sleep(slow_tile ? m_slow_tile_row_time : m_row_time);
+
+            if (slow_tile)
+                m_slow_tile_regions.push_back(region);
+        }
+
+        virtual StatisticsVector get_statistics() const override
+        {
+            return StatisticsVector();
+        }
+
+      private:
+        const uint32    m_slow_tile_row_time;
+        const uint32    m_row_time;
+    };
+
+    TEST_CASE(Execute_GivenTileMuchLongerToRenderThanOthers_SpreadsItsPixelsOverAllThreads)
+    {
+        const size_t ThreadCount = 2;
+        const size_t TileSize = 64;
+
+        auto_release_ptr<Frame> frame(
+            FrameFactory::create(
+                "frame",
+                ParamArray()
+                    .insert("resolution", "128 64")
+                    .insert("tile_size", "64 64")));
+
+        vector<SleepingTileRenderer*> renderers;
+        TileJob::TileRendererVector tile_renderers;
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            renderers.push_back(new SleepingTileRenderer(4, 1));
+            tile_renderers.push_back(renderers.back());
+        }
+
+        const TileJob::TileCallbackVector tile_callbacks;
+        const AABB2u tile_region(Vector2u(0, 0), Vector2u(TileSize - 1, TileSize - 1));
+
+        Logger logger;
+        JobQueue job_queue;
+        JobManager job_manager(logger, job_queue, ThreadCount, JobManager::KeepRunningOnEmptyQueue);
+        AbortSwitch abort_switch;
+
+        // The slow tile comes first so that it starts rendering while the other thread is busy.
+        for (size_t tile_x = 0; tile_x < 2; ++tile_x)
+        {
+            job_queue.schedule(
+                new TileJob(
+                    tile_renderers,
+                    tile_callbacks,
+                    frame.ref(),
+                    tile_x,
+                    0,
+                    tile_region,
+                    0,
+                    Spectrum::RGB,
+                    &job_queue,
+                    abort_switch));
+        }
+
+        job_manager.start();
+        job_queue.wait_until_completion();
+
+        vector<size_t> render_counts(TileSize * TileSize, 0);
+        size_t busy_renderer_count = 0;
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            const vector<AABB2u>& regions = renderers[i]->m_slow_tile_regions;
+
+            for (size_t j = 0; j < regions.size(); ++j)
+            {
+                for (size_t y = regions[j].min.y; y <= regions[j].max.y; ++y)
+                {
+                    for (size_t x = regions[j].min.x; x <= regions[j].max.x; ++x)
+                        ++render_counts[y * TileSize + x];
+                }
+            }
+
+            if (!regions.empty())
+                ++busy_renderer_count;
+        }
+
+        // Every pixel of the slow tile was rendered exactly once.
+        size_t miscounted_pixel_count = 0;
+        for (size_t i = 0; i < render_counts.size(); ++i)
+        {
+            if (render_counts[i] != 1)
+                ++miscounted_pixel_count;
+        }
+
+        EXPECT_EQ(0, miscounted_pixel_count);
+        EXPECT_EQ(ThreadCount, busy_renderer_count);
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+            renderers[i]->release();
+    }
+}
@@ -46,22 +46,29 @@
 #include "renderer/modeling/entity/onframebeginrecorder.h"
 #include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/material/genericmaterial.h"
+#include "renderer/modeling/material/material.h"
 #include "renderer/modeling/object/meshobject.h"
 #include "renderer/modeling/object/triangle.h"
 #include "renderer/modeling/project/project.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/scene/textureinstance.h"
 #include "renderer/modeling/scene/visibilityflags.h"
 #include "renderer/modeling/surfaceshader/constantsurfaceshader.h"
 #include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/modeling/texture/memorytexture2d.h"
+#include "renderer/modeling/texture/texture.h"
 #include "renderer/utility/iostreamop.h"
 #include "renderer/utility/paramarray.h"
 #include "renderer/utility/testutils.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
 #include "foundation/math/matrix.h"
 #include "foundation/math/transform.h"
 #include "foundation/math/vector.h"
@@ -166,6 +173,34 @@ TEST_SUITE(Renderer_Kernel_Lighting_Tracer)
                 GenericMaterialFactory().create(material_name, params));
         }
 
+        void create_textured_material(const char* material_name, const char* surface_shader_name, const float alpha)
+        {
+            // The texture is uniform, but texture sources are always considered varying.
+            auto_release_ptr<Image> image(new Image(1, 1, 1, 1, 4, PixelFormatFloat));
+            image->set_pixel(0, 0, Color4f(alpha));
+
+            const string texture_name = string(material_name) + "_texture";
+            const string texture_instance_name = texture_name + "_inst";
+
+            m_assembly->textures().insert(
+                MemoryTexture2dFactory::static_create(
+                    texture_name.c_str(),
+                    ParamArray().insert("color_space", "linear_rgb"),
+                    image));
+            m_assembly->texture_instances().insert(
+                TextureInstanceFactory::create(
+                    texture_instance_name.c_str(),
+                    ParamArray(),
+                    texture_name.c_str()));
+
+            ParamArray params;
+            params.insert("surface_shader", surface_shader_name);
+            params.insert("alpha_map", texture_instance_name);
+
+            m_assembly->materials().insert(
+                GenericMaterialFactory().create(material_name, params));
+        }
+
         void create_plane_object()
         {
             auto_release_ptr<MeshObject> mesh_object =
@@ -491,6 +526,96 @@ TEST_SUITE(Renderer_Kernel_Lighting_Tracer)
         EXPECT_FEQ(Spectrum(0.5f), transmission);
     }
 
+    struct SceneWithMaterialsOfEveryOpacity
+      : public SceneBase
+    {
+        SceneWithMaterialsOfEveryOpacity()
+        {
+            create_textured_material("textured_material", "constant_white_surface_shader", 0.25f);
+
+            ParamArray params;
+            params.insert("surface_shader", "constant_white_surface_shader");
+            m_assembly->materials().insert(
+                GenericMaterialFactory().create("material_without_alpha_map", params));
+        }
+    };
+
+    TEST_CASE_F(OnFrameBegin_ClassifiesOpacityOfMaterials, Fixture<SceneWithMaterialsOfEveryOpacity>)
+    {
+        const MaterialContainer& materials = m_assembly->materials();
+
+        EXPECT_EQ(
+            Material::OpacityOpaque,
+            materials.get_by_name("material_without_alpha_map")->get_render_data().m_opacity);
+        EXPECT_EQ(
+            Material::OpacityOpaque,
+            materials.get_by_name("opaque_material")->get_render_data().m_opacity);
+
+        const Material::RenderData& transparent =
+            materials.get_by_name("transparent_material")->get_render_data();
+        EXPECT_EQ(Material::OpacityUniform, transparent.m_opacity);
+        EXPECT_EQ(0.5f, transparent.m_uniform_alpha);
+
+        EXPECT_EQ(
+            Material::OpacityTextured,
+            materials.get_by_name("textured_material")->get_render_data().m_opacity);
+    }
+
+    struct SceneWithSingleTexturedOccluder
+      : public SceneBase
+    {
+        SceneWithSingleTexturedOccluder()
+        {
+            create_textured_material("textured_material", "constant_white_surface_shader", 0.25f);
+            create_plane_object_instance("plane_inst", Vector3d(2.0, 0.0, 0.0), "textured_material");
+        }
+    };
+
+    TEST_CASE_F(TraceSimple_GivenSingleTexturedOccluder, Fixture<SceneWithSingleTexturedOccluder>)
+    {
+        Spectrum transmission;
+        ShadingRay ray(
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 0.0, 0.0),
+            ShadingRay::Time(),
+            VisibilityFlags::ShadowRay,
+            0);
+        m_tracer.trace_simple(
+            *m_shading_context,
+            ray,
+            transmission);
+
+        EXPECT_FEQ(Spectrum(0.75f), transmission);
+    }
+
+    struct SceneWithOpaqueMaterialOnTransparentObject
+      : public SceneBase
+    {
+        SceneWithOpaqueMaterialOnTransparentObject()
+        {
+            // The alpha map of the object must prevail over the opacity of the material.
+            m_assembly->objects().get_by_name("plane")->get_parameters().insert("alpha_map", 0.5f);
+            create_plane_object_instance("plane_inst", Vector3d(2.0, 0.0, 0.0), "opaque_material");
+        }
+    };
+
+    TEST_CASE_F(TraceSimple_GivenOpaqueMaterialOnObjectWithAlphaMap, Fixture<SceneWithOpaqueMaterialOnTransparentObject>)
+    {
+        Spectrum transmission;
+        ShadingRay ray(
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 0.0, 0.0),
+            ShadingRay::Time(),
+            VisibilityFlags::ShadowRay,
+            0);
+        m_tracer.trace_simple(
+            *m_shading_context,
+            ray,
+            transmission);
+
+        EXPECT_FEQ(Spectrum(0.5f), transmission);
+    }
+
     struct SceneWithTransparentThenOpaqueOccluders
       : public SceneBase
     {
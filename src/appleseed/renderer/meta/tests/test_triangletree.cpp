@@ -0,0 +1,245 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersectionsettings.h"
+#include "renderer/kernel/intersection/regioninfo.h"
+#include "renderer/kernel/intersection/triangletree.h"
+#include "renderer/modeling/object/iregion.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/regionkit.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/testutils.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/transform.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/test.h"
+
+// Boost headers.
+#include "boost/filesystem.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+namespace bf = boost::filesystem;
+
+TEST_SUITE(Renderer_Kernel_Intersection_TriangleTree)
+{
+    const char* CacheDirectory = "unit tests/outputs/test_triangletree_cache";
+
+    struct TestScene
+    {
+        auto_release_ptr<Scene> m_scene;
+
+        TestScene()
+          : m_scene(SceneFactory::create())
+        {
+            bf::remove_all(bf::path(CacheDirectory));
+
+            auto_release_ptr<Assembly> assembly(
+                AssemblyFactory().create(
+                    "assembly",
+                    ParamArray()
+                        .insert_path("acceleration_structure.cache_directory", CacheDirectory)));
+
+            auto_release_ptr<MeshObject> mesh_object =
+                MeshObjectFactory::create("mesh", ParamArray());
+
+            // A 4x4 grid of quads, enough for the tree to have interior nodes.
+            const size_t GridSize = 4;
+            for (size_t y = 0; y <= GridSize; ++y)
+            {
+                for (size_t x = 0; x <= GridSize; ++x)
+                    mesh_object->push_vertex(GVector3(static_cast<GScalar>(x), static_cast<GScalar>(y), 0.0f));
+            }
+
+            for (size_t y = 0; y < GridSize; ++y)
+            {
+                for (size_t x = 0; x < GridSize; ++x)
+                {
+                    const size_t v0 = y * (GridSize + 1) + x;
+                    const size_t v1 = v0 + 1;
+                    const size_t v2 = v1 + GridSize + 1;
+                    const size_t v3 = v0 + GridSize + 1;
+                    mesh_object->push_triangle(Triangle(v0, v1, v2));
+                    mesh_object->push_triangle(Triangle(v2, v3, v0));
+                }
+            }
+
+            assembly->objects().insert(auto_release_ptr<Object>(mesh_object));
+
+            assembly->object_instances().insert(
+                ObjectInstanceFactory::create(
+                    "object_instance",
+                    ParamArray(),
+                    "mesh",
+                    Transformd::identity(),
+                    StringDictionary()));
+
+            m_scene->assembly_instances().insert(
+                auto_release_ptr<AssemblyInstance>(
+                    AssemblyInstanceFactory::create(
+                        "assembly_instance",
+                        ParamArray(),
+                        "assembly")));
+
+            m_scene->assemblies().insert(assembly);
+        }
+    };
+
+    struct Fixture
+      : public BindInputs<TestScene>
+    {
+        const Assembly& m_assembly;
+
+        Fixture()
+          : m_assembly(*m_scene->assemblies().get_by_name("assembly"))
+        {
+        }
+
+        TriangleTree::Arguments make_arguments() const
+        {
+            const ObjectInstance* object_instance = m_assembly.object_instances().get_by_index(0);
+            const Transformd& transform = object_instance->get_transform();
+            Access<RegionKit> region_kit(&object_instance->get_object().get_region_kit());
+
+            GAABB3 bbox;
+            bbox.invalidate();
+
+            RegionInfoVector regions;
+            for (size_t i = 0; i < region_kit->size(); ++i)
+            {
+                const GAABB3 region_bbox = transform.to_parent((*region_kit)[i]->compute_local_bbox());
+                regions.push_back(RegionInfo(0, i, region_bbox));
+                bbox.insert(region_bbox);
+            }
+
+            return
+                TriangleTree::Arguments(
+                    m_scene.ref(),
+                    m_assembly.get_uid(),
+                    bbox,
+                    m_assembly,
+                    regions);
+        }
+
+        static string get_cache_file_path()
+        {
+            string path;
+
+            for (bf::directory_iterator i(CacheDirectory), e; i != e; ++i)
+            {
+                if (i->path().extension() == ".bin")
+                    path = i->path().string();
+            }
+
+            return path;
+        }
+    };
+
+    template <typename Vector>
+    bool have_same_bytes(const Vector& lhs, const Vector& rhs)
+    {
+        return
+            lhs.size() == rhs.size() &&
+            (lhs.empty() || memcmp(&lhs[0], &rhs[0], lhs.size() * sizeof(lhs[0])) == 0);
+    }
+
+    TEST_CASE_F(LoadFromCache_GivenTreeSavedToCache_RestoresTree, Fixture)
+    {
+        // Building the first tree saves it to the cache, the second one is loaded from it.
+        const TriangleTree built_tree(make_arguments());
+        TriangleTree loaded_tree(make_arguments());
+
+        const string path = get_cache_file_path();
+        ASSERT_FALSE(path.empty());
+
+        const ParamArray& params = m_assembly.get_parameters().child("acceleration_structure");
+        const uint64 key = built_tree.compute_cache_key(params, 0.5);
+        ASSERT_TRUE(loaded_tree.load_from_cache(path, key));
+
+        EXPECT_FALSE(built_tree.m_nodes.empty());
+        EXPECT_TRUE(have_same_bytes(built_tree.m_nodes, loaded_tree.m_nodes));
+        EXPECT_TRUE(have_same_bytes(built_tree.m_node_bboxes, loaded_tree.m_node_bboxes));
+        EXPECT_TRUE(have_same_bytes(built_tree.m_triangle_keys, loaded_tree.m_triangle_keys));
+        EXPECT_TRUE(have_same_bytes(built_tree.m_leaf_data, loaded_tree.m_leaf_data));
+        EXPECT_EQ(32, loaded_tree.m_static_triangle_count);
+        EXPECT_EQ(built_tree.m_static_triangle_count, loaded_tree.m_static_triangle_count);
+        EXPECT_EQ(built_tree.m_moving_triangle_count, loaded_tree.m_moving_triangle_count);
+    }
+
+    TEST_CASE_F(LoadFromCache_GivenMismatchingVersion_ReturnsFalse, Fixture)
+    {
+        TriangleTree tree(make_arguments());
+
+        const string path = get_cache_file_path();
+        ASSERT_FALSE(path.empty());
+
+        // Overwrite the format version, which follows the 8-byte magic string.
+        {
+            fstream file(path.c_str(), ios_base::in | ios_base::out | ios_base::binary);
+            const uint32 version = TriangleTreeCacheFormatVersion + 1;
+            file.seekp(8);
+            file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        }
+
+        const ParamArray& params = m_assembly.get_parameters().child("acceleration_structure");
+        const uint64 key = tree.compute_cache_key(params, 0.5);
+        EXPECT_FALSE(tree.load_from_cache(path, key));
+    }
+
+    TEST_CASE_F(LoadFromCache_GivenMismatchingKey_ReturnsFalse, Fixture)
+    {
+        TriangleTree tree(make_arguments());
+
+        const string path = get_cache_file_path();
+        ASSERT_FALSE(path.empty());
+
+        const ParamArray& params = m_assembly.get_parameters().child("acceleration_structure");
+        const uint64 key = tree.compute_cache_key(params, 0.5);
+        EXPECT_TRUE(tree.load_from_cache(path, key));
+        EXPECT_FALSE(tree.load_from_cache(path, key + 1));
+    }
+}
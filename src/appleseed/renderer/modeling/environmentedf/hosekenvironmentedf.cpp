@@ -36,8 +36,12 @@
 #include "renderer/modeling/color/colorspace.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/environmentedf/tabulatedsky.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -61,7 +65,6 @@
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
-namespace renderer      { class Project; }
 
 using namespace foundation;
 using namespace std;
@@ -91,6 +94,9 @@ namespace
     // The smallest valid turbidity value.
     const float BaseTurbidity = 2.0f;
 
+    // Default width of the tabulated sky; its height is half its width.
+    const size_t DefaultTableResolution = 512;
+
     class HosekEnvironmentEDF
       : public EnvironmentEDF
     {
@@ -109,6 +115,8 @@ namespace
             m_inputs.declare("luminance_gamma", InputFormatFloat, "1.0");
             m_inputs.declare("saturation_multiplier", InputFormatFloat, "1.0");
             m_inputs.declare("horizon_shift", InputFormatFloat, "0.0");
+
+            m_table_resolution = m_params.get_optional<size_t>("table_resolution", DefaultTableResolution);
         }
 
         virtual void release() override
@@ -155,6 +163,21 @@ namespace
                     m_uniform_master_Y);
             }
 
+            // Tabulate the sky if turbidity is uniform and this is the active environment EDF.
+            m_table.clear();
+            if (m_uniform_turbidity)
+            {
+                const UniformSkyRadianceFunction<HosekEnvironmentEDF> function(*this);
+                tabulate_sky(
+                    *this,
+                    static_cast<const Scene*>(parent),
+                    function,
+                    m_table_resolution,
+                    project.get_rendering_thread_count(),
+                    abort_switch,
+                    m_table);
+            }
+
             return true;
         }
 
@@ -165,20 +188,29 @@ namespace
             Spectrum&               value,
             float&                  probability) const override
         {
-            const Vector3f local_outgoing = sample_hemisphere_cosine(s);
+            Vector3f local_outgoing;
+            RegularSpectrum31f radiance;
+
+            if (m_table.is_built())
+                m_table.sample(s, local_outgoing, radiance, probability);
+            else
+            {
+                local_outgoing = sample_hemisphere_cosine(s);
+
+                const Vector3f shifted_outgoing = shift(local_outgoing);
+
+                if (shifted_outgoing.y > 0.0f)
+                    compute_sky_radiance(shading_context, shifted_outgoing, radiance);
+                else radiance.set(0.0f);
+
+                probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            }
 
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             outgoing = transform.vector_to_parent(local_outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
-
-            RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
-            probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
         }
 
         virtual void evaluate(
@@ -191,12 +223,9 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
             RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
+            lookup_sky_radiance(shading_context, local_outgoing, radiance);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
         }
@@ -212,15 +241,12 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
             RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
+            lookup_sky_radiance(shading_context, local_outgoing, radiance);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
-            probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            probability = compute_pdf(local_outgoing);
         }
 
         virtual float evaluate_pdf(
@@ -231,9 +257,8 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
-            return shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            return compute_pdf(local_outgoing);
         }
 
       private:
@@ -260,6 +285,11 @@ namespace
         float                       m_uniform_coeffs[3 * 9];
         float                       m_uniform_master_Y[3];
 
+        size_t                      m_table_resolution;
+        TabulatedSky                m_table;
+
+        friend class UniformSkyRadianceFunction<HosekEnvironmentEDF>;
+
         // Compute the coefficients of the radiance distribution function and the master luminance value.
         static void compute_coefficients(
             const float             turbidity,
@@ -373,31 +403,43 @@ namespace
             return u * v;
         }
 
-        // Compute the sky radiance along a given direction.
-        void compute_sky_radiance(
+        // Return the sky radiance along a given local space direction.
+        void lookup_sky_radiance(
             const ShadingContext&   shading_context,
-            const Vector3f&         outgoing,
+            const Vector3f&         local_outgoing,
             RegularSpectrum31f&     radiance) const
         {
-            if (m_uniform_values.m_luminance_multiplier == 0.0f)
+            if (m_table.is_built())
             {
-                radiance.set(0.0f);
+                m_table.evaluate(local_outgoing, radiance);
                 return;
             }
 
-            const float sqrt_cos_theta = sqrt(outgoing.y);
-            const float cos_gamma = dot(outgoing, m_sun_dir);
-            const float gamma = acos(cos_gamma);
+            const Vector3f shifted_outgoing = shift(local_outgoing);
 
-            Color3f ciexyz;
+            if (shifted_outgoing.y > 0.0f)
+                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
+            else radiance.set(0.0f);
+        }
+
+        // Return the probability density of a given local space direction.
+        float compute_pdf(const Vector3f& local_outgoing) const
+        {
+            if (m_table.is_built())
+                return m_table.evaluate_pdf(local_outgoing);
+
+            const Vector3f shifted_outgoing = shift(local_outgoing);
+            return shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+        }
 
+        // Compute the sky radiance along a given direction.
+        void compute_sky_radiance(
+            const ShadingContext&   shading_context,
+            const Vector3f&         outgoing,
+            RegularSpectrum31f&     radiance) const
+        {
             if (m_uniform_turbidity)
-            {
-                // Compute the sky color in the CIE XYZ color space.
-                ciexyz[0] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, m_uniform_coeffs + 0 * 9) * m_uniform_master_Y[0];
-                ciexyz[1] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, m_uniform_coeffs + 1 * 9) * m_uniform_master_Y[1];
-                ciexyz[2] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, m_uniform_coeffs + 2 * 9) * m_uniform_master_Y[2];
-            }
+                compute_uniform_sky_radiance(outgoing, radiance);
             else
             {
                 // Evaluate turbidity.
@@ -422,11 +464,41 @@ namespace
                     coeffs,
                     master_Y);
 
-                // Compute the sky color in the CIE XYZ color space.
-                ciexyz[0] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 0 * 9) * master_Y[0];
-                ciexyz[1] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 1 * 9) * master_Y[1];
-                ciexyz[2] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 2 * 9) * master_Y[2];
+                compute_sky_radiance(outgoing, coeffs, master_Y, radiance);
             }
+        }
+
+        // Compute the sky radiance along a given direction when turbidity is uniform.
+        void compute_uniform_sky_radiance(
+            const Vector3f&         outgoing,
+            RegularSpectrum31f&     radiance) const
+        {
+            compute_sky_radiance(outgoing, m_uniform_coeffs, m_uniform_master_Y, radiance);
+        }
+
+        // Compute the sky radiance along a given direction, given the coefficients of
+        // the radiance distribution function and the master luminance value.
+        void compute_sky_radiance(
+            const Vector3f&         outgoing,
+            const float             coeffs[3 * 9],
+            const float             master_Y[3],
+            RegularSpectrum31f&     radiance) const
+        {
+            if (m_uniform_values.m_luminance_multiplier == 0.0f)
+            {
+                radiance.set(0.0f);
+                return;
+            }
+
+            const float sqrt_cos_theta = sqrt(outgoing.y);
+            const float cos_gamma = dot(outgoing, m_sun_dir);
+            const float gamma = acos(cos_gamma);
+
+            // Compute the sky color in the CIE XYZ color space.
+            Color3f ciexyz;
+            ciexyz[0] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 0 * 9) * master_Y[0];
+            ciexyz[1] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 1 * 9) * master_Y[1];
+            ciexyz[2] = perez(outgoing.y, sqrt_cos_theta, gamma, cos_gamma, coeffs + 2 * 9) * master_Y[2];
 
             // Apply an optional saturation correction.
             if (m_uniform_values.m_saturation_multiplier != 1.0f)
@@ -161,6 +161,23 @@ void IEnvironmentEDFFactory::add_common_sky_input_metadata(DictionaryArray& meta
             .insert("use", "optional")
             .insert("default", "0.0")
             .insert("help", "Rotate the sky horizontally by a given number of degrees"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "table_resolution")
+            .insert("label", "Table Resolution")
+            .insert("type", "integer")
+            .insert("min",
+                Dictionary()
+                    .insert("value", "0")
+                    .insert("type", "hard"))
+            .insert("max",
+                Dictionary()
+                    .insert("value", "4096")
+                    .insert("type", "soft"))
+            .insert("use", "optional")
+            .insert("default", "512")
+            .insert("help", "Width of the table the sky is precomputed into, or 0 to evaluate the sky model directly"));
 }
 
 }   // namespace renderer
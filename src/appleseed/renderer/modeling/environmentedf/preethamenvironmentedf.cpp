@@ -36,8 +36,12 @@
 #include "renderer/modeling/color/colorspace.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/environmentedf/tabulatedsky.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
 #include "renderer/utility/transformsequence.h"
 
 // appleseed.foundation headers.
@@ -56,10 +60,10 @@
 // Standard headers.
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
-namespace renderer      { class Project; }
 
 using namespace foundation;
 using namespace std;
@@ -85,6 +89,9 @@ namespace
     // The smallest valid turbidity value.
     const float BaseTurbidity = 2.0f;
 
+    // Default width of the tabulated sky; its height is half its width.
+    const size_t DefaultTableResolution = 512;
+
     class PreethamEnvironmentEDF
       : public EnvironmentEDF
     {
@@ -102,6 +109,8 @@ namespace
             m_inputs.declare("luminance_gamma", InputFormatFloat, "1.0");
             m_inputs.declare("saturation_multiplier", InputFormatFloat, "1.0");
             m_inputs.declare("horizon_shift", InputFormatFloat, "0.0");
+
+            m_table_resolution = m_params.get_optional<size_t>("table_resolution", DefaultTableResolution);
         }
 
         virtual void release() override
@@ -151,6 +160,21 @@ namespace
                 m_uniform_Y_zenith = compute_zenith_Y(m_uniform_values.m_turbidity, m_sun_theta);
             }
 
+            // Tabulate the sky if turbidity is uniform and this is the active environment EDF.
+            m_table.clear();
+            if (m_uniform_turbidity)
+            {
+                const UniformSkyRadianceFunction<PreethamEnvironmentEDF> function(*this);
+                tabulate_sky(
+                    *this,
+                    static_cast<const Scene*>(parent),
+                    function,
+                    m_table_resolution,
+                    project.get_rendering_thread_count(),
+                    abort_switch,
+                    m_table);
+            }
+
             return true;
         }
 
@@ -161,20 +185,29 @@ namespace
             Spectrum&               value,
             float&                  probability) const override
         {
-            const Vector3f local_outgoing = sample_hemisphere_cosine(s);
+            Vector3f local_outgoing;
+            RegularSpectrum31f radiance;
+
+            if (m_table.is_built())
+                m_table.sample(s, local_outgoing, radiance, probability);
+            else
+            {
+                local_outgoing = sample_hemisphere_cosine(s);
+
+                const Vector3f shifted_outgoing = shift(local_outgoing);
+
+                if (shifted_outgoing.y > 0.0f)
+                    compute_sky_radiance(shading_context, shifted_outgoing, radiance);
+                else radiance.set(0.0f);
+
+                probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            }
 
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             outgoing = transform.vector_to_parent(local_outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
-
-            RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
-            probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
         }
 
         virtual void evaluate(
@@ -187,12 +220,9 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
             RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
+            lookup_sky_radiance(shading_context, local_outgoing, radiance);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
         }
@@ -208,15 +238,12 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
             RegularSpectrum31f radiance;
-            if (shifted_outgoing.y > 0.0f)
-                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
-            else radiance.set(0.0f);
+            lookup_sky_radiance(shading_context, local_outgoing, radiance);
 
             value.set(radiance, g_std_lighting_conditions, Spectrum::Illuminance);
-            probability = shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            probability = compute_pdf(local_outgoing);
         }
 
         virtual float evaluate_pdf(
@@ -227,9 +254,8 @@ namespace
             Transformd scratch;
             const Transformd& transform = m_transform_sequence.evaluate(0.0f, scratch);
             const Vector3f local_outgoing = transform.vector_to_local(outgoing);
-            const Vector3f shifted_outgoing = shift(local_outgoing);
 
-            return shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+            return compute_pdf(local_outgoing);
         }
 
       private:
@@ -260,6 +286,11 @@ namespace
         float                       m_uniform_y_zenith;
         float                       m_uniform_Y_zenith;
 
+        size_t                      m_table_resolution;
+        TabulatedSky                m_table;
+
+        friend class UniformSkyRadianceFunction<PreethamEnvironmentEDF>;
+
         // Compute the coefficients of the luminance distribution function.
         static void compute_Y_coefficients(
             const float             turbidity,
@@ -358,31 +389,43 @@ namespace
                 / perez(1.0f, sun_theta, cos_sun_theta, coeffs);     // todo: build into zenith_val
         }
 
-        // Compute the sky radiance along a given direction.
-        void compute_sky_radiance(
+        // Return the sky radiance along a given local space direction.
+        void lookup_sky_radiance(
             const ShadingContext&   shading_context,
-            const Vector3f&         outgoing,
+            const Vector3f&         local_outgoing,
             RegularSpectrum31f&     radiance) const
         {
-            if (m_uniform_values.m_luminance_multiplier == 0.0f)
+            if (m_table.is_built())
             {
-                radiance.set(0.0f);
+                m_table.evaluate(local_outgoing, radiance);
                 return;
             }
 
-            const float rcp_cos_theta = 1.0f / outgoing.y;
-            const float cos_gamma = clamp(dot(outgoing, m_sun_dir), -1.0f, 1.0f);
-            const float gamma = acos(cos_gamma);
+            const Vector3f shifted_outgoing = shift(local_outgoing);
 
-            Color3f xyY;
+            if (shifted_outgoing.y > 0.0f)
+                compute_sky_radiance(shading_context, shifted_outgoing, radiance);
+            else radiance.set(0.0f);
+        }
+
+        // Return the probability density of a given local space direction.
+        float compute_pdf(const Vector3f& local_outgoing) const
+        {
+            if (m_table.is_built())
+                return m_table.evaluate_pdf(local_outgoing);
+
+            const Vector3f shifted_outgoing = shift(local_outgoing);
+            return shifted_outgoing.y > 0.0f ? shifted_outgoing.y * RcpPi<float>() : 0.0f;
+        }
 
+        // Compute the sky radiance along a given direction.
+        void compute_sky_radiance(
+            const ShadingContext&   shading_context,
+            const Vector3f&         outgoing,
+            RegularSpectrum31f&     radiance) const
+        {
             if (m_uniform_turbidity)
-            {
-                // Compute the sky color in the xyY color space.
-                xyY[0] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, m_uniform_x_zenith, m_uniform_x_coeffs);
-                xyY[1] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, m_uniform_y_zenith, m_uniform_y_coeffs);
-                xyY[2] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, m_uniform_Y_zenith, m_uniform_Y_coeffs);
-            }
+                compute_uniform_sky_radiance(outgoing, radiance);
             else
             {
                 // Evaluate turbidity.
@@ -409,11 +452,61 @@ namespace
                 const float y_zenith = compute_zenith_y(turbidity, m_sun_theta);
                 const float Y_zenith = compute_zenith_Y(turbidity, m_sun_theta);
 
-                // Compute the sky color in the xyY color space.
-                xyY[0] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, x_zenith, x_coeffs);
-                xyY[1] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, y_zenith, y_coeffs);
-                xyY[2] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, Y_zenith, Y_coeffs);
+                compute_sky_radiance(
+                    outgoing,
+                    x_zenith,
+                    y_zenith,
+                    Y_zenith,
+                    x_coeffs,
+                    y_coeffs,
+                    Y_coeffs,
+                    radiance);
             }
+        }
+
+        // Compute the sky radiance along a given direction when turbidity is uniform.
+        void compute_uniform_sky_radiance(
+            const Vector3f&         outgoing,
+            RegularSpectrum31f&     radiance) const
+        {
+            compute_sky_radiance(
+                outgoing,
+                m_uniform_x_zenith,
+                m_uniform_y_zenith,
+                m_uniform_Y_zenith,
+                m_uniform_x_coeffs,
+                m_uniform_y_coeffs,
+                m_uniform_Y_coeffs,
+                radiance);
+        }
+
+        // Compute the sky radiance along a given direction, given the luminance and
+        // chromaticity at zenith and the coefficients of their distribution functions.
+        void compute_sky_radiance(
+            const Vector3f&         outgoing,
+            const float             x_zenith,
+            const float             y_zenith,
+            const float             Y_zenith,
+            const float             x_coeffs[5],
+            const float             y_coeffs[5],
+            const float             Y_coeffs[5],
+            RegularSpectrum31f&     radiance) const
+        {
+            if (m_uniform_values.m_luminance_multiplier == 0.0f)
+            {
+                radiance.set(0.0f);
+                return;
+            }
+
+            const float rcp_cos_theta = 1.0f / outgoing.y;
+            const float cos_gamma = clamp(dot(outgoing, m_sun_dir), -1.0f, 1.0f);
+            const float gamma = acos(cos_gamma);
+
+            // Compute the sky color in the xyY color space.
+            Color3f xyY;
+            xyY[0] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, x_zenith, x_coeffs);
+            xyY[1] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, y_zenith, y_coeffs);
+            xyY[2] = compute_quantity(rcp_cos_theta, gamma, cos_gamma, m_sun_theta, m_cos_sun_theta, Y_zenith, Y_coeffs);
 
             // Apply an optional saturation correction.
             if (m_uniform_values.m_saturation_multiplier != 1.0f)
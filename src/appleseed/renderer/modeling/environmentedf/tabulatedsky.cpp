@@ -0,0 +1,367 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "tabulatedsky.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/environmentedf/environmentedf.h"
+#include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/colorspace.h"
+#include "foundation/math/scalar.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/api/apistring.h"
+#include "foundation/utility/job.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    // Compute the sine of the angle between a unit vector and the Y axis. This is
+    // computed from the vector itself such that sampling and evaluating agree.
+    float compute_sin_theta(const Vector3f& v)
+    {
+        return sqrt(square(v.x) + square(v.z));
+    }
+
+    // Return the local space direction through the center of a given texel.
+    Vector3f texel_center_direction(
+        const size_t                x,
+        const size_t                y,
+        const size_t                width,
+        const size_t                height)
+    {
+        const float u = (x + 0.5f) / width;
+        const float v = (y + 0.5f) / height;
+
+        float theta, phi;
+        unit_square_to_angles(u, v, theta, phi);
+
+        return Vector3f::make_unit_vector(cos(theta), sin(theta), cos(phi), sin(phi));
+    }
+
+    class TabulateRowJob
+      : public IJob
+    {
+      public:
+        TabulateRowJob(
+            const TabulatedSky::IRadianceFunction&  function,
+            RegularSpectrum31f*                     row,
+            const size_t                            y,
+            const size_t                            width,
+            const size_t                            height,
+            IAbortSwitch*                           abort_switch)
+          : m_function(function)
+          , m_row(row)
+          , m_y(y)
+          , m_width(width)
+          , m_height(height)
+          , m_abort_switch(abort_switch)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) override
+        {
+            if (is_aborted(m_abort_switch))
+                return;
+
+            for (size_t x = 0; x < m_width; ++x)
+            {
+                const Vector3f local_outgoing = texel_center_direction(x, m_y, m_width, m_height);
+                m_function.evaluate(local_outgoing, m_row[x]);
+            }
+        }
+
+      private:
+        const TabulatedSky::IRadianceFunction&      m_function;
+        RegularSpectrum31f*                         m_row;
+        const size_t                                m_y;
+        const size_t                                m_width;
+        const size_t                                m_height;
+        IAbortSwitch*                               m_abort_switch;
+    };
+}
+
+
+//
+// TabulatedSky class implementation.
+//
+
+class TabulatedSky::ImportanceFunction
+{
+  public:
+    ImportanceFunction(
+        const vector<RegularSpectrum31f>&   texels,
+        const size_t                        width,
+        const size_t                        height)
+      : m_texels(texels)
+      , m_width(width)
+      , m_rcp_height(1.0f / height)
+    {
+    }
+
+    void sample(const size_t x, const size_t y, Payload& payload, float& importance) const
+    {
+        // Weight luminance by the solid angle subtended by the texel, such that the
+        // resulting probability density with respect to solid angle follows luminance.
+        const float lum = sum_value(m_texels[y * m_width + x] * XYZCMFCIE19312Deg[1]);
+        const float sin_theta = sin(Pi<float>() * (y + 0.5f) * m_rcp_height);
+        importance = lum > 0.0f ? lum * sin_theta : 0.0f;
+    }
+
+  private:
+    const vector<RegularSpectrum31f>&       m_texels;
+    const size_t                            m_width;
+    const float                             m_rcp_height;
+};
+
+TabulatedSky::TabulatedSky()
+  : m_width(0)
+  , m_height(0)
+  , m_probability_scale(0.0f)
+{
+}
+
+bool TabulatedSky::build(
+    const IRadianceFunction&                function,
+    const size_t                            width,
+    const size_t                            height,
+    const size_t                            thread_count,
+    IAbortSwitch*                           abort_switch)
+{
+    assert(width > 0);
+    assert(height > 0);
+
+    clear();
+
+    m_width = width;
+    m_height = height;
+    m_texels.resize(width * height);
+
+    // Evaluate the radiance function at the center of every texel, one row per job.
+    JobQueue job_queue;
+    for (size_t y = 0; y < height; ++y)
+    {
+        job_queue.schedule(
+            new TabulateRowJob(
+                function,
+                &m_texels[y * width],
+                y,
+                width,
+                height,
+                abort_switch));
+    }
+
+    JobManager job_manager(
+        global_logger(),
+        job_queue,
+        max<size_t>(thread_count, 1));
+    job_manager.start();
+    job_queue.wait_until_completion();
+
+    if (is_aborted(abort_switch))
+    {
+        clear();
+        return false;
+    }
+
+    // Build the importance sampler from the luminance of the table.
+    ImportanceFunction importance_function(m_texels, width, height);
+    m_importance_sampler.reset(new ImportanceSamplerType(width, height));
+    m_importance_sampler->rebuild(importance_function, abort_switch);
+
+    if (is_aborted(abort_switch))
+    {
+        clear();
+        return false;
+    }
+
+    m_probability_scale = (width * height) / (2.0f * PiSquare<float>());
+
+    return true;
+}
+
+void TabulatedSky::clear()
+{
+    m_width = 0;
+    m_height = 0;
+    m_probability_scale = 0.0f;
+    vector<RegularSpectrum31f>().swap(m_texels);
+    m_importance_sampler.reset();
+}
+
+void TabulatedSky::sample(
+    const Vector2f&                         s,
+    Vector3f&                               local_outgoing,
+    RegularSpectrum31f&                     radiance,
+    float&                                  probability) const
+{
+    assert(is_built());
+
+    // Sample the importance map.
+    size_t x, y;
+    float prob_xy;
+    m_importance_sampler->sample(s, x, y, prob_xy);
+
+    // Compute the spherical coordinates of the center of the texel.
+    float theta, phi;
+    unit_square_to_angles(
+        (x + 0.5f) / m_width,
+        (y + 0.5f) / m_height,
+        theta,
+        phi);
+
+    local_outgoing = Vector3f::make_unit_vector(cos(theta), sin(theta), cos(phi), sin(phi));
+
+    // Return the filtered radiance and the probability density of this direction.
+    evaluate(local_outgoing, radiance);
+    probability = prob_xy * m_probability_scale / compute_sin_theta(local_outgoing);
+}
+
+void TabulatedSky::evaluate(
+    const Vector3f&                         local_outgoing,
+    RegularSpectrum31f&                     radiance) const
+{
+    assert(is_built());
+
+    float theta, phi, u, v;
+    unit_vector_to_angles(local_outgoing, theta, phi);
+    angles_to_unit_square(theta, phi, u, v);
+
+    // Compute the four texels surrounding the lookup point. The table wraps around
+    // horizontally and is clamped vertically.
+    const float fx = u * m_width - 0.5f;
+    const float fy = v * m_height - 0.5f;
+    const float fx0 = floor(fx);
+    const float fy0 = floor(fy);
+    const float tx = fx - fx0;
+    const float ty = fy - fy0;
+    const long x0 = static_cast<long>(fx0);
+    const long y0 = static_cast<long>(fy0);
+    const long w = static_cast<long>(m_width);
+    const long h = static_cast<long>(m_height);
+    const size_t ix0 = static_cast<size_t>(x0 < 0 ? w - 1 : min(x0, w - 1));
+    const size_t ix1 = static_cast<size_t>(x0 + 1 >= w ? 0 : x0 + 1);
+    const size_t iy0 = static_cast<size_t>(max(y0, 0L));
+    const size_t iy1 = static_cast<size_t>(min(y0 + 1, h - 1));
+
+    const RegularSpectrum31f* row0 = &m_texels[iy0 * m_width];
+    const RegularSpectrum31f* row1 = &m_texels[iy1 * m_width];
+
+    radiance = row0[ix0] * ((1.0f - tx) * (1.0f - ty));
+    radiance += row0[ix1] * (tx * (1.0f - ty));
+    radiance += row1[ix0] * ((1.0f - tx) * ty);
+    radiance += row1[ix1] * (tx * ty);
+}
+
+float TabulatedSky::evaluate_pdf(
+    const Vector3f&                         local_outgoing) const
+{
+    assert(is_built());
+
+    float theta, phi, u, v;
+    unit_vector_to_angles(local_outgoing, theta, phi);
+    angles_to_unit_square(theta, phi, u, v);
+
+    size_t x, y;
+    compute_texel(u, v, x, y);
+
+    const float sin_theta = compute_sin_theta(local_outgoing);
+    if (sin_theta == 0.0f)
+        return 0.0f;
+
+    const float prob_xy = m_importance_sampler->get_pdf(x, y);
+    return prob_xy * m_probability_scale / sin_theta;
+}
+
+void TabulatedSky::compute_texel(
+    const float                             u,
+    const float                             v,
+    size_t&                                 x,
+    size_t&                                 y) const
+{
+    x = min(truncate<size_t>(u * m_width), m_width - 1);
+    y = min(truncate<size_t>(v * m_height), m_height - 1);
+}
+
+
+
+//
+// tabulate_sky() function implementation.
+//
+
+void tabulate_sky(
+    const EnvironmentEDF&                   edf,
+    const Scene*                            scene,
+    const TabulatedSky::IRadianceFunction&  function,
+    const size_t                            width,
+    const size_t                            thread_count,
+    IAbortSwitch*                           abort_switch,
+    TabulatedSky&                           table)
+{
+    table.clear();
+
+    if (width == 0 || scene == 0)
+        return;
+
+    // Only the active environment EDF is worth tabulating.
+    const Environment* environment = scene->get_environment();
+    if (environment == 0 || environment->get_uncached_environment_edf() != &edf)
+        return;
+
+    const size_t height = max<size_t>(width / 2, 1);
+
+    RENDERER_LOG_INFO(
+        "tabulating " FMT_SIZE_T "x" FMT_SIZE_T " sky for environment edf \"%s\"...",
+        width,
+        height,
+        edf.get_path().c_str());
+
+    if (table.build(function, width, height, thread_count, abort_switch))
+    {
+        RENDERER_LOG_INFO(
+            "tabulated sky for environment edf \"%s\".",
+            edf.get_path().c_str());
+    }
+}
+
+}   // namespace renderer
@@ -0,0 +1,205 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2017 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
+#define APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/image/regularspectrum.h"
+#include "foundation/math/sampling/imageimportancesampler.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/job/iabortswitch.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class EnvironmentEDF; }
+namespace renderer  { class Scene; }
+
+namespace renderer
+{
+
+//
+// A sky radiance distribution tabulated over a latitude-longitude grid of local
+// space directions. Evaluating a tabulated sky is a bilinear table fetch, and
+// directions are importance sampled according to the luminance of the table.
+//
+
+class TabulatedSky
+  : public foundation::NonCopyable
+{
+  public:
+    // Interface of the radiance function that gets tabulated.
+    class IRadianceFunction
+    {
+      public:
+        // Destructor.
+        virtual ~IRadianceFunction() {}
+
+        // Compute the radiance along a given local space direction.
+        // This method is called concurrently from multiple threads.
+        virtual void evaluate(
+            const foundation::Vector3f&         local_outgoing,
+            foundation::RegularSpectrum31f&     radiance) const = 0;
+    };
+
+    // Constructor.
+    TabulatedSky();
+
+    // Tabulate a radiance function. Return false if the operation was aborted.
+    bool build(
+        const IRadianceFunction&                function,
+        const size_t                            width,
+        const size_t                            height,
+        const size_t                            thread_count,
+        foundation::IAbortSwitch*               abort_switch = 0);
+
+    // Release the table.
+    void clear();
+
+    // Return true if the table is built.
+    bool is_built() const;
+
+    // Sample the table and return a local space direction, the radiance along
+    // this direction and the probability density with respect to solid angle.
+    void sample(
+        const foundation::Vector2f&             s,
+        foundation::Vector3f&                   local_outgoing,
+        foundation::RegularSpectrum31f&         radiance,
+        float&                                  probability) const;
+
+    // Return the bilinearly filtered radiance along a given local space direction.
+    void evaluate(
+        const foundation::Vector3f&             local_outgoing,
+        foundation::RegularSpectrum31f&         radiance) const;
+
+    // Return the probability density of a given local space direction.
+    float evaluate_pdf(
+        const foundation::Vector3f&             local_outgoing) const;
+
+  private:
+    struct Payload {};
+    typedef foundation::ImageImportanceSampler<Payload, float> ImportanceSamplerType;
+
+    class ImportanceFunction;
+
+    size_t                                      m_width;
+    size_t                                      m_height;
+    float                                       m_probability_scale;
+    std::vector<foundation::RegularSpectrum31f> m_texels;
+    std::auto_ptr<ImportanceSamplerType>        m_importance_sampler;
+
+    void compute_texel(
+        const float                             u,
+        const float                             v,
+        size_t&                                 x,
+        size_t&                                 y) const;
+};
+
+
+//
+// Radiance function of the uniform sky of a physical sky environment EDF.
+//
+// The EDF must provide a shift() method applying its horizon shift to a local
+// space direction, and a compute_uniform_sky_radiance() method computing the
+// radiance along a shifted direction above the horizon.
+//
+
+template <typename SkyEDF>
+class UniformSkyRadianceFunction
+  : public TabulatedSky::IRadianceFunction
+{
+  public:
+    // Constructor.
+    explicit UniformSkyRadianceFunction(const SkyEDF& edf);
+
+    // Compute the radiance along a given local space direction.
+    virtual void evaluate(
+        const foundation::Vector3f&             local_outgoing,
+        foundation::RegularSpectrum31f&         radiance) const override;
+
+  private:
+    const SkyEDF&                               m_edf;
+};
+
+
+//
+// Tabulate the sky of a given environment EDF into a table whose height is half its
+// width, unless the EDF is not the active environment EDF of the scene (which may be
+// null) or the table width is 0. In these cases, the table is left empty.
+//
+
+void tabulate_sky(
+    const EnvironmentEDF&                       edf,
+    const Scene*                                scene,
+    const TabulatedSky::IRadianceFunction&      function,
+    const size_t                                width,
+    const size_t                                thread_count,
+    foundation::IAbortSwitch*                   abort_switch,
+    TabulatedSky&                               table);
+
+
+//
+// TabulatedSky class implementation.
+//
+
+inline bool TabulatedSky::is_built() const
+{
+    return m_importance_sampler.get() != 0;
+}
+
+
+//
+// UniformSkyRadianceFunction class implementation.
+//
+
+template <typename SkyEDF>
+inline UniformSkyRadianceFunction<SkyEDF>::UniformSkyRadianceFunction(const SkyEDF& edf)
+  : m_edf(edf)
+{
+}
+
+template <typename SkyEDF>
+inline void UniformSkyRadianceFunction<SkyEDF>::evaluate(
+    const foundation::Vector3f&                 local_outgoing,
+    foundation::RegularSpectrum31f&             radiance) const
+{
+    const foundation::Vector3f shifted_outgoing = m_edf.shift(local_outgoing);
+
+    if (shifted_outgoing.y > 0.0f)
+        m_edf.compute_uniform_sky_radiance(shifted_outgoing, radiance);
+    else radiance.set(0.0f);
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
@@ -68,6 +68,7 @@
 
 // Standard headers.
 #include <exception>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -112,6 +113,53 @@ void InputBinder::bind(const Scene& scene)
     }
 }
 
+void InputBinder::bind(const Scene& scene, const Assembly& assembly)
+{
+    try
+    {
+        // Build the symbol table of the scene.
+        SymbolTable scene_symbols;
+        build_scene_symbol_table(scene, scene_symbols);
+
+        // Collect the parent assemblies of the assembly, outermost first.
+        vector<const Assembly*> parents;
+        for (const Entity* parent = assembly.get_parent(); parent; parent = parent->get_parent())
+        {
+            const Assembly* parent_assembly = dynamic_cast<const Assembly*>(parent);
+            if (parent_assembly == 0)
+                break;
+            parents.insert(parents.begin(), parent_assembly);
+        }
+
+        // Push the parent assemblies and their symbol tables to the stack.
+        vector<SymbolTable> parent_symbols(parents.size());
+        assert(m_assembly_info.empty());
+        for (size_t i = 0; i < parents.size(); ++i)
+        {
+            build_assembly_symbol_table(*parents[i], parent_symbols[i]);
+
+            AssemblyInfo info;
+            info.m_assembly = parents[i];
+            info.m_assembly_symbols = &parent_symbols[i];
+            m_assembly_info.push_back(info);
+        }
+
+        // Bind all inputs of all entities in the assembly.
+        bind_assembly_entities_inputs(scene, scene_symbols, assembly);
+
+        m_assembly_info.clear();
+    }
+    catch (const ExceptionUnknownEntity& e)
+    {
+        RENDERER_LOG_ERROR(
+            "while binding inputs of \"%s\": could not locate entity \"%s\".",
+            e.get_context_path().c_str(),
+            e.string());
+        ++m_error_count;
+        m_assembly_info.clear();
+    }
+}
+
 size_t InputBinder::get_error_count() const
 {
     return m_error_count;
@@ -69,6 +69,9 @@ class InputBinder
     // Bind all inputs of all entities in a scene.
     void bind(const Scene& scene);
 
+    // Bind all inputs of all entities in a given assembly of a scene, and in its child assemblies.
+    void bind(const Scene& scene, const Assembly& assembly);
+
     // Return the number of reported binding errors.
     size_t get_error_count() const;
 
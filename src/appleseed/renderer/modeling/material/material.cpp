@@ -43,6 +43,7 @@
 #include "renderer/modeling/project/project.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/scene/textureinstance.h"
+#include "renderer/modeling/shadergroup/shadergroup.h"
 #include "renderer/modeling/surfaceshader/surfaceshader.h"
 #include "renderer/modeling/texture/texture.h"
 #include "renderer/modeling/volume/volume.h"
@@ -189,6 +190,7 @@ bool Material::on_frame_begin(
     m_render_data.m_shader_group = 0;
     m_render_data.m_basis_modifier = 0;
     m_render_data.m_volume = 0;
+    classify_opacity();
     m_has_render_data = true;
 
     return true;
@@ -222,6 +224,23 @@ const char* Material::get_non_empty(const ParamArray& params, const char* name)
     return is_empty_string(value) ? 0 : value;
 }
 
+void Material::classify_opacity()
+{
+    m_render_data.m_uniform_alpha = 1.0f;
+
+    if (m_render_data.m_shader_group && m_render_data.m_shader_group->has_transparency())
+        m_render_data.m_opacity = OpacityShaded;
+    else if (m_render_data.m_alpha_map == 0)
+        m_render_data.m_opacity = OpacityOpaque;
+    else if (m_render_data.m_alpha_map->is_uniform())
+    {
+        m_render_data.m_alpha_map->evaluate_uniform(m_render_data.m_uniform_alpha);
+        m_render_data.m_opacity =
+            m_render_data.m_uniform_alpha >= 1.0f ? OpacityOpaque : OpacityUniform;
+    }
+    else m_render_data.m_opacity = OpacityTextured;
+}
+
 IBasisModifier* Material::create_basis_modifier(const MessageContext& context) const
 {
     // Retrieve the source bound to the displacement map input.
@@ -135,6 +135,15 @@ class APPLESEED_DLLSYMBOL Material
         const Project&              project,
         const BaseGroup*            parent) override;
 
+    // How the opacity of a material must be evaluated, from cheapest to most expensive.
+    enum Opacity
+    {
+        OpacityOpaque,          // no alpha map (or a uniform alpha map of 1) and no OSL transparency
+        OpacityUniform,         // uniform alpha map and no OSL transparency
+        OpacityTextured,        // varying alpha map and no OSL transparency
+        OpacityShaded           // OSL transparency, possibly combined with an alpha map
+    };
+
     struct RenderData
     {
         const SurfaceShader*        m_surface_shader;
@@ -145,6 +154,8 @@ class APPLESEED_DLLSYMBOL Material
         const Source*               m_alpha_map;
         const ShaderGroup*          m_shader_group;
         const IBasisModifier*       m_basis_modifier;   // owned by RenderData
+        Opacity                     m_opacity;
+        float                       m_uniform_alpha;    // only valid if m_opacity is OpacityUniform
     };
 
     // Return render-time data of this entity.
@@ -162,6 +173,10 @@ class APPLESEED_DLLSYMBOL Material
 
     const char* get_non_empty(const ParamArray& params, const char* name) const;
 
+    // Classify the opacity of the material from its alpha map and shader group.
+    // Derived classes that change these in on_frame_begin() must call this again.
+    void classify_opacity();
+
     IBasisModifier* create_basis_modifier(const MessageContext& context) const;
 };
 
@@ -127,6 +127,8 @@ namespace
                     m_render_data.m_edf = m_osl_edf.get();
             }
 
+            classify_opacity();
+
             return true;
         }
 
@@ -31,11 +31,13 @@
 #include "meshobject.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/triangle.h"
 
 // appleseed.foundation headers.
+#include "foundation/utility/api/apistring.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/foreach.h"
@@ -135,6 +137,21 @@ bool MeshObject::on_frame_begin(
         return false;
 
     m_alpha_map = get_uncached_alpha_map();
+
+    if (m_params.get_optional<bool>("compress_vertex_attributes", false) &&
+        !impl->m_tess.has_compressed_vertex_attributes())
+    {
+        const size_t uncompressed_size = impl->m_tess.get_vertex_attributes_memory_size();
+        impl->m_tess.compress_vertex_attributes();
+        const size_t compressed_size = impl->m_tess.get_vertex_attributes_memory_size();
+
+        RENDERER_LOG_INFO(
+            "compressed vertex attributes of mesh object \"%s\" from %s to %s.",
+            get_path().c_str(),
+            pretty_size(uncompressed_size).c_str(),
+            pretty_size(compressed_size).c_str());
+    }
+
     return true;
 }
 
@@ -195,31 +212,29 @@ const GVector3& MeshObject::get_vertex(const size_t index) const
 
 void MeshObject::reserve_vertex_normals(const size_t count)
 {
-    impl->m_tess.m_vertex_normals.reserve(count);
+    impl->m_tess.reserve_vertex_normals(count);
 }
 
 size_t MeshObject::push_vertex_normal(const GVector3& normal)
 {
     assert(is_normalized(normal));
 
-    const size_t index = impl->m_tess.m_vertex_normals.size();
-    impl->m_tess.m_vertex_normals.push_back(normal);
-    return index;
+    return impl->m_tess.push_vertex_normal(normal);
 }
 
 size_t MeshObject::get_vertex_normal_count() const
 {
-    return impl->m_tess.m_vertex_normals.size();
+    return impl->m_tess.get_vertex_normal_count();
 }
 
-const GVector3& MeshObject::get_vertex_normal(const size_t index) const
+GVector3 MeshObject::get_vertex_normal(const size_t index) const
 {
-    return impl->m_tess.m_vertex_normals[index];
+    return impl->m_tess.get_vertex_normal(index);
 }
 
 void MeshObject::clear_vertex_normals()
 {
-    impl->m_tess.m_vertex_normals.clear();
+    impl->m_tess.clear_vertex_normals();
 }
 
 void MeshObject::reserve_vertex_tangents(const size_t count)
@@ -111,7 +111,7 @@ class APPLESEED_DLLSYMBOL MeshObject
     void reserve_vertex_normals(const size_t count);
     size_t push_vertex_normal(const GVector3& normal);      // the normal must be unit-length
     size_t get_vertex_normal_count() const;
-    const GVector3& get_vertex_normal(const size_t index) const;
+    GVector3 get_vertex_normal(const size_t index) const;
     void clear_vertex_normals();
 
     // Insert and access vertex tangents.
@@ -37,8 +37,13 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/vector.h"
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/system.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <vector>
@@ -49,178 +54,382 @@ using namespace std;
 namespace renderer
 {
 
-void compute_smooth_vertex_normals_base_pose(MeshObject& object)
-{
-    assert(object.get_vertex_normal_count() == 0);
-
-    const size_t vertex_count = object.get_vertex_count();
-    const size_t triangle_count = object.get_triangle_count();
+//
+// Smooth vertex vectors are computed in two passes. The vector of each triangle is
+// computed once, then each vertex gathers the vectors of the triangles adjacent to it.
+// Adjacent triangles are visited in increasing index order, so results do not depend
+// on the number of threads. Both passes process triangles or vertices in blocks, and
+// the blocks of all poses (the base pose and each motion segment) are processed
+// concurrently.
+//
 
-    vector<GVector3> normals(vertex_count, GVector3(0.0));
+namespace
+{
+    const size_t TriangleBlockSize = 16 * 1024;
+    const size_t VertexBlockSize = 16 * 1024;
 
-    for (size_t i = 0; i < triangle_count; ++i)
+    // Triangles adjacent to each vertex.
+    struct VertexToTriangleMap
     {
-        Triangle& triangle = object.get_triangle(i);
-        triangle.m_n0 = triangle.m_v0;
-        triangle.m_n1 = triangle.m_v1;
-        triangle.m_n2 = triangle.m_v2;
+        vector<uint32>  m_offsets;          // triangles adjacent to vertex i are in [m_offsets[i], m_offsets[i + 1])
+        vector<uint32>  m_triangles;        // indices of adjacent triangles
+    };
 
-        const GVector3& v0 = object.get_vertex(triangle.m_v0);
-        const GVector3& v1 = object.get_vertex(triangle.m_v1);
-        const GVector3& v2 = object.get_vertex(triangle.m_v2);
-        const GVector3 normal = normalize(compute_triangle_normal(v0, v1, v2));
+    void build_vertex_to_triangle_map(
+        const MeshObject&       object,
+        VertexToTriangleMap&    map)
+    {
+        const size_t vertex_count = object.get_vertex_count();
+        const size_t triangle_count = object.get_triangle_count();
+
+        // Count the triangles adjacent to each vertex.
+        map.m_offsets.assign(vertex_count + 1, 0);
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            const Triangle& triangle = object.get_triangle(i);
+            ++map.m_offsets[triangle.m_v0 + 1];
+            ++map.m_offsets[triangle.m_v1 + 1];
+            ++map.m_offsets[triangle.m_v2 + 1];
+        }
+
+        // Compute the offset of the first adjacent triangle of each vertex.
+        for (size_t i = 0; i < vertex_count; ++i)
+            map.m_offsets[i + 1] += map.m_offsets[i];
+
+        // Store adjacent triangles.
+        vector<uint32> cursors(map.m_offsets.begin(), map.m_offsets.end() - 1);
+        map.m_triangles.resize(map.m_offsets.back());
+        for (size_t i = 0; i < triangle_count; ++i)
+        {
+            const Triangle& triangle = object.get_triangle(i);
+            map.m_triangles[cursors[triangle.m_v0]++] = static_cast<uint32>(i);
+            map.m_triangles[cursors[triangle.m_v1]++] = static_cast<uint32>(i);
+            map.m_triangles[cursors[triangle.m_v2]++] = static_cast<uint32>(i);
+        }
+    }
 
-        normals[triangle.m_v0] += normal;
-        normals[triangle.m_v1] += normal;
-        normals[triangle.m_v2] += normal;
+    // Pose 0 is the base pose, pose i > 0 is motion segment i - 1.
+    GVector3 get_vertex(
+        const MeshObject&       object,
+        const size_t            vertex_index,
+        const size_t            pose)
+    {
+        return
+            pose == 0
+                ? object.get_vertex(vertex_index)
+                : object.get_vertex_pose(vertex_index, pose - 1);
     }
 
-    object.reserve_vertex_normals(vertex_count);
+    struct TriangleNormal
+    {
+        const MeshObject&   m_object;
 
-    for (size_t i = 0; i < vertex_count; ++i)
-        object.push_vertex_normal(safe_normalize(normals[i]));
-}
+        explicit TriangleNormal(const MeshObject& object)
+          : m_object(object)
+        {
+        }
 
-void compute_smooth_vertex_normals_pose(MeshObject& object, const size_t motion_segment_index)
-{
-    const size_t vertex_count = object.get_vertex_count();
-    const size_t triangle_count = object.get_triangle_count();
+        bool operator()(const Triangle& triangle, const size_t pose, GVector3& normal) const
+        {
+            const GVector3 v0 = get_vertex(m_object, triangle.m_v0, pose);
+            const GVector3 v1 = get_vertex(m_object, triangle.m_v1, pose);
+            const GVector3 v2 = get_vertex(m_object, triangle.m_v2, pose);
+            normal = normalize(compute_triangle_normal(v0, v1, v2));
 
-    vector<GVector3> normals(vertex_count, GVector3(0.0));
+            return true;
+        }
+    };
 
-    for (size_t i = 0; i < triangle_count; ++i)
+    struct TriangleTangent
     {
-        const Triangle& triangle = object.get_triangle(i);
-
-        const GVector3& v0 = object.get_vertex_pose(triangle.m_v0, motion_segment_index);
-        const GVector3& v1 = object.get_vertex_pose(triangle.m_v1, motion_segment_index);
-        const GVector3& v2 = object.get_vertex_pose(triangle.m_v2, motion_segment_index);
-        const GVector3 normal = normalize(compute_triangle_normal(v0, v1, v2));
-
-        normals[triangle.m_v0] += normal;
-        normals[triangle.m_v1] += normal;
-        normals[triangle.m_v2] += normal;
+        const MeshObject&   m_object;
+
+        explicit TriangleTangent(const MeshObject& object)
+          : m_object(object)
+        {
+        }
+
+        bool operator()(const Triangle& triangle, const size_t pose, GVector3& tangent) const
+        {
+            if (!triangle.has_vertex_attributes())
+                return false;
+
+            const GVector2 v0_uv = m_object.get_tex_coords(triangle.m_a0);
+            const GVector2 v1_uv = m_object.get_tex_coords(triangle.m_a1);
+            const GVector2 v2_uv = m_object.get_tex_coords(triangle.m_a2);
+
+            //
+            // Reference:
+            //
+            //   Physically Based Rendering, first edition, pp. 128-129
+            //
+
+            const GScalar du0 = v0_uv[0] - v2_uv[0];
+            const GScalar dv0 = v0_uv[1] - v2_uv[1];
+            const GScalar du1 = v1_uv[0] - v2_uv[0];
+            const GScalar dv1 = v1_uv[1] - v2_uv[1];
+            const GScalar det = du0 * dv1 - dv0 * du1;
+
+            if (det == GScalar(0.0))
+                return false;
+
+            const GVector3 v2 = get_vertex(m_object, triangle.m_v2, pose);
+            const GVector3 dp0 = get_vertex(m_object, triangle.m_v0, pose) - v2;
+            const GVector3 dp1 = get_vertex(m_object, triangle.m_v1, pose) - v2;
+            tangent = normalize(dv1 * dp0 - dv0 * dp1);
+
+            return true;
+        }
+    };
+
+    // Process items [0, item_count) on a given number of threads, handing items out one at a time.
+    template <typename ItemProcessor>
+    class ProcessItemsJob
+    {
+      public:
+        ProcessItemsJob(
+            ItemProcessor&              processor,
+            const size_t                item_count,
+            volatile uint32&            next_item)
+          : m_processor(processor)
+          , m_item_count(item_count)
+          , m_next_item(next_item)
+        {
+        }
+
+        void operator()()
+        {
+            while (true)
+            {
+                const size_t item = atomic_inc(&m_next_item);
+
+                if (item >= m_item_count)
+                    break;
+
+                m_processor(item);
+            }
+        }
+
+      private:
+        ItemProcessor&                  m_processor;
+        const size_t                    m_item_count;
+        volatile uint32&                m_next_item;
+    };
+
+    template <typename ItemProcessor>
+    void process_items(
+        ItemProcessor&                  processor,
+        const size_t                    item_count,
+        const size_t                    thread_count)
+    {
+        volatile uint32 next_item = 0;
+        ProcessItemsJob<ItemProcessor> job(processor, item_count, next_item);
+
+        const size_t used_thread_count = min(thread_count, item_count);
+
+        if (used_thread_count <= 1)
+            job();
+        else
+        {
+            boost::thread_group threads;
+            for (size_t i = 0; i < used_thread_count; ++i)
+                threads.create_thread(job);
+            threads.join_all();
+        }
     }
 
-    for (size_t i = 0; i < vertex_count; ++i)
-        object.set_vertex_normal_pose(i, motion_segment_index, safe_normalize(normals[i]));
+    // Compute the vector of each triangle, for each pose. Triangles without
+    // a valid vector get a null vector, which leaves vertex sums unchanged.
+    template <typename TriangleVector>
+    class ComputeTriangleVectors
+    {
+      public:
+        ComputeTriangleVectors(
+            const MeshObject&           object,
+            const TriangleVector&       triangle_vector,
+            vector<vector<GVector3>>&   vectors)
+          : m_object(object)
+          , m_triangle_vector(triangle_vector)
+          , m_vectors(vectors)
+          , m_triangle_count(object.get_triangle_count())
+          , m_block_count((m_triangle_count + TriangleBlockSize - 1) / TriangleBlockSize)
+        {
+        }
+
+        size_t get_item_count() const
+        {
+            return m_block_count * m_vectors.size();
+        }
+
+        void operator()(const size_t item)
+        {
+            const size_t pose = item / m_block_count;
+            const size_t triangle_begin = (item % m_block_count) * TriangleBlockSize;
+            const size_t triangle_end = min(triangle_begin + TriangleBlockSize, m_triangle_count);
+
+            vector<GVector3>& vectors = m_vectors[pose];
+
+            for (size_t i = triangle_begin; i < triangle_end; ++i)
+            {
+                if (!m_triangle_vector(m_object.get_triangle(i), pose, vectors[i]))
+                    vectors[i] = GVector3(0.0);
+            }
+        }
+
+      private:
+        const MeshObject&               m_object;
+        const TriangleVector&           m_triangle_vector;
+        vector<vector<GVector3>>&       m_vectors;
+        const size_t                    m_triangle_count;
+        const size_t                    m_block_count;
+    };
+
+    // Sum the vectors of the triangles adjacent to each vertex, for each pose.
+    class ComputeSmoothVertexVectors
+    {
+      public:
+        ComputeSmoothVertexVectors(
+            const VertexToTriangleMap&          map,
+            const vector<vector<GVector3>>&     triangle_vectors,
+            vector<vector<GVector3>>&           vectors)
+          : m_map(map)
+          , m_triangle_vectors(triangle_vectors)
+          , m_vectors(vectors)
+          , m_vertex_count(map.m_offsets.size() - 1)
+          , m_block_count((m_vertex_count + VertexBlockSize - 1) / VertexBlockSize)
+        {
+        }
+
+        size_t get_item_count() const
+        {
+            return m_block_count * m_vectors.size();
+        }
+
+        void operator()(const size_t item)
+        {
+            const size_t pose = item / m_block_count;
+            const size_t vertex_begin = (item % m_block_count) * VertexBlockSize;
+            const size_t vertex_end = min(vertex_begin + VertexBlockSize, m_vertex_count);
+
+            const vector<GVector3>& triangle_vectors = m_triangle_vectors[pose];
+            vector<GVector3>& vectors = m_vectors[pose];
+
+            for (size_t i = vertex_begin; i < vertex_end; ++i)
+            {
+                GVector3 sum(0.0);
+
+                for (size_t j = m_map.m_offsets[i], e = m_map.m_offsets[i + 1]; j < e; ++j)
+                    sum += triangle_vectors[m_map.m_triangles[j]];
+
+                vectors[i] = safe_normalize(sum);
+            }
+        }
+
+      private:
+        const VertexToTriangleMap&          m_map;
+        const vector<vector<GVector3>>&     m_triangle_vectors;
+        vector<vector<GVector3>>&           m_vectors;
+        const size_t                        m_vertex_count;
+        const size_t                        m_block_count;
+    };
+
+    // Compute one smooth vector per vertex for the base pose and for each motion segment.
+    template <typename TriangleVector>
+    void compute_smooth_vertex_vectors(
+        const MeshObject&               object,
+        const TriangleVector&           triangle_vector,
+        const size_t                    thread_count,
+        vector<vector<GVector3>>&       vectors)
+    {
+        const size_t pose_count = 1 + object.get_motion_segment_count();
+        const size_t used_thread_count =
+            thread_count > 0 ? thread_count : System::get_logical_cpu_core_count();
+
+        VertexToTriangleMap map;
+        build_vertex_to_triangle_map(object, map);
+
+        // Compute the vector of each triangle once.
+        vector<vector<GVector3>> triangle_vectors(
+            pose_count,
+            vector<GVector3>(object.get_triangle_count()));
+        ComputeTriangleVectors<TriangleVector> triangle_processor(
+            object,
+            triangle_vector,
+            triangle_vectors);
+        process_items(
+            triangle_processor,
+            triangle_processor.get_item_count(),
+            used_thread_count);
+
+        // Gather them at vertices.
+        vectors.assign(
+            pose_count,
+            vector<GVector3>(object.get_vertex_count()));
+        ComputeSmoothVertexVectors vertex_processor(
+            map,
+            triangle_vectors,
+            vectors);
+        process_items(
+            vertex_processor,
+            vertex_processor.get_item_count(),
+            used_thread_count);
+    }
 }
 
-void compute_smooth_vertex_normals(MeshObject& object)
+void compute_smooth_vertex_normals(
+    MeshObject&         object,
+    const size_t        thread_count)
 {
-    compute_smooth_vertex_normals_base_pose(object);
-
-    for (size_t i = 0; i < object.get_motion_segment_count(); ++i)
-        compute_smooth_vertex_normals_pose(object, i);
-}
+    assert(object.get_vertex_normal_count() == 0);
 
-void compute_smooth_vertex_tangents_base_pose(MeshObject& object)
-{
-    assert(object.get_vertex_tangent_count() == 0);
-    assert(object.get_tex_coords_count() > 0);
+    vector<vector<GVector3>> normals;
+    compute_smooth_vertex_vectors(object, TriangleNormal(object), thread_count, normals);
 
     const size_t vertex_count = object.get_vertex_count();
     const size_t triangle_count = object.get_triangle_count();
 
-    vector<GVector3> tangents(vertex_count, GVector3(0.0));
-
     for (size_t i = 0; i < triangle_count; ++i)
     {
-        const Triangle& triangle = object.get_triangle(i);
-
-        if (!triangle.has_vertex_attributes())
-            continue;
-
-        const GVector2 v0_uv = object.get_tex_coords(triangle.m_a0);
-        const GVector2 v1_uv = object.get_tex_coords(triangle.m_a1);
-        const GVector2 v2_uv = object.get_tex_coords(triangle.m_a2);
-
-        //
-        // Reference:
-        //
-        //   Physically Based Rendering, first edition, pp. 128-129
-        //
-
-        const GScalar du0 = v0_uv[0] - v2_uv[0];
-        const GScalar dv0 = v0_uv[1] - v2_uv[1];
-        const GScalar du1 = v1_uv[0] - v2_uv[0];
-        const GScalar dv1 = v1_uv[1] - v2_uv[1];
-        const GScalar det = du0 * dv1 - dv0 * du1;
-
-        if (det == GScalar(0.0))
-            continue;
-
-        const GVector3& v2 = object.get_vertex(triangle.m_v2);
-        const GVector3 dp0 = object.get_vertex(triangle.m_v0) - v2;
-        const GVector3 dp1 = object.get_vertex(triangle.m_v1) - v2;
-        const GVector3 tangent = normalize(dv1 * dp0 - dv0 * dp1);
-
-        tangents[triangle.m_v0] += tangent;
-        tangents[triangle.m_v1] += tangent;
-        tangents[triangle.m_v2] += tangent;
+        Triangle& triangle = object.get_triangle(i);
+        triangle.m_n0 = triangle.m_v0;
+        triangle.m_n1 = triangle.m_v1;
+        triangle.m_n2 = triangle.m_v2;
     }
 
-    object.reserve_vertex_tangents(vertex_count);
+    object.reserve_vertex_normals(vertex_count);
 
     for (size_t i = 0; i < vertex_count; ++i)
-        object.push_vertex_tangent(safe_normalize(tangents[i]));
+        object.push_vertex_normal(normals[0][i]);
+
+    for (size_t i = 0; i < object.get_motion_segment_count(); ++i)
+    {
+        for (size_t j = 0; j < vertex_count; ++j)
+            object.set_vertex_normal_pose(j, i, normals[i + 1][j]);
+    }
 }
 
-void compute_smooth_vertex_tangents_pose(MeshObject& object, const size_t motion_segment_index)
+void compute_smooth_vertex_tangents(
+    MeshObject&         object,
+    const size_t        thread_count)
 {
+    assert(object.get_vertex_tangent_count() == 0);
     assert(object.get_tex_coords_count() > 0);
 
-    const size_t vertex_count = object.get_vertex_count();
-    const size_t triangle_count = object.get_triangle_count();
+    vector<vector<GVector3>> tangents;
+    compute_smooth_vertex_vectors(object, TriangleTangent(object), thread_count, tangents);
 
-    vector<GVector3> tangents(vertex_count, GVector3(0.0));
+    const size_t vertex_count = object.get_vertex_count();
 
-    for (size_t i = 0; i < triangle_count; ++i)
-    {
-        const Triangle& triangle = object.get_triangle(i);
-
-        if (!triangle.has_vertex_attributes())
-            continue;
-
-        const GVector2 v0_uv = object.get_tex_coords(triangle.m_a0);
-        const GVector2 v1_uv = object.get_tex_coords(triangle.m_a1);
-        const GVector2 v2_uv = object.get_tex_coords(triangle.m_a2);
-
-        //
-        // Reference:
-        //
-        //   Physically Based Rendering, first edition, pp. 128-129
-        //
-
-        const GScalar du0 = v0_uv[0] - v2_uv[0];
-        const GScalar dv0 = v0_uv[1] - v2_uv[1];
-        const GScalar du1 = v1_uv[0] - v2_uv[0];
-        const GScalar dv1 = v1_uv[1] - v2_uv[1];
-        const GScalar det = du0 * dv1 - dv0 * du1;
-
-        if (det == GScalar(0.0))
-            continue;
-
-        const GVector3& v2 = object.get_vertex_pose(triangle.m_v2, motion_segment_index);
-        const GVector3 dp0 = object.get_vertex_pose(triangle.m_v0, motion_segment_index) - v2;
-        const GVector3 dp1 = object.get_vertex_pose(triangle.m_v1, motion_segment_index) - v2;
-        const GVector3 tangent = normalize(dv1 * dp0 - dv0 * dp1);
-
-        tangents[triangle.m_v0] += tangent;
-        tangents[triangle.m_v1] += tangent;
-        tangents[triangle.m_v2] += tangent;
-    }
+    object.reserve_vertex_tangents(vertex_count);
 
     for (size_t i = 0; i < vertex_count; ++i)
-        object.set_vertex_tangent_pose(i, motion_segment_index, safe_normalize(tangents[i]));
-}
-
-void compute_smooth_vertex_tangents(MeshObject& object)
-{
-    compute_smooth_vertex_tangents_base_pose(object);
+        object.push_vertex_tangent(tangents[0][i]);
 
     for (size_t i = 0; i < object.get_motion_segment_count(); ++i)
-        compute_smooth_vertex_tangents_pose(object, i);
+    {
+        for (size_t j = 0; j < vertex_count; ++j)
+            object.set_vertex_tangent_pose(j, i, tangents[i + 1][j]);
+    }
 }
 
 }   // namespace renderer
@@ -32,6 +32,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 namespace renderer  { class MeshObject; }
 
@@ -40,12 +43,18 @@ namespace renderer
 
 // Compute smooth vertex normal vectors for a mesh object.
 // The mesh object must not already have normals.
-APPLESEED_DLLSYMBOL void compute_smooth_vertex_normals(MeshObject& object);
+// A thread count of 0 uses one thread per logical CPU core.
+APPLESEED_DLLSYMBOL void compute_smooth_vertex_normals(
+    MeshObject&     object,
+    const size_t    thread_count = 0);
 
 // Compute smooth vertex tangent vectors for a mesh object.
 // The mesh object must not already have tangent vectors.
 // The mesh object must have texture coordinates.
-APPLESEED_DLLSYMBOL void compute_smooth_vertex_tangents(MeshObject& object);
+// A thread count of 0 uses one thread per logical CPU core.
+APPLESEED_DLLSYMBOL void compute_smooth_vertex_tangents(
+    MeshObject&     object,
+    const size_t    thread_count = 0);
 
 }       // namespace renderer
 
@@ -403,10 +403,17 @@ namespace
         const char*             filename,
         const char*             base_object_name,
         const ParamArray&       params,
-        MeshObjectArray&        objects)
+        MeshObjectArray&        objects,
+        const size_t            thread_count)
     {
         GenericMeshFileReader reader(filename);
 
+        if (thread_count > 1)
+        {
+            reader.set_obj_options(OBJMeshFileReader::ParallelParsing);
+            reader.set_obj_parsing_thread_count(thread_count);
+        }
+
         const string obj_parsing_mode = params.get_optional<string>("obj_parsing_mode", "fast");
 
         if (obj_parsing_mode == "fast")
@@ -714,7 +721,8 @@ namespace
         const StringDictionary& filenames,
         const char*             base_object_name,
         const ParamArray&       params,
-        MeshObjectArray&        objects)
+        MeshObjectArray&        objects,
+        const size_t            thread_count)
     {
         assert(filenames.size() >= 2);
 
@@ -734,7 +742,8 @@ namespace
                 search_paths.qualify(key_frames[0].m_filename).c_str(),
                 base_object_name,
                 params,
-                objects))
+                objects,
+                thread_count))
             return false;
 
         for (size_t i = 0; i < objects.size(); ++i)
@@ -756,7 +765,8 @@ namespace
                     search_paths.qualify(filename).c_str(),
                     base_object_name,
                     params,
-                    poses))
+                    poses,
+                    thread_count))
                 return false;
 
             for (size_t j = 0; j < poses.size(); ++j)
@@ -823,7 +833,8 @@ bool MeshObjectReader::read(
     const SearchPaths&  search_paths,
     const char*         base_object_name,
     const ParamArray&   params,
-    MeshObjectArray&    objects)
+    MeshObjectArray&    objects,
+    const size_t        thread_count)
 {
     assert(base_object_name);
 
@@ -859,7 +870,8 @@ bool MeshObjectReader::read(
                 search_paths.qualify(params.strings().get<string>("filename")).c_str(),
                 base_object_name,
                 completed_params,
-                objects))
+                objects,
+                thread_count))
             return false;
     }
     else if (params.dictionaries().exist("filename"))
@@ -884,7 +896,8 @@ bool MeshObjectReader::read(
                         search_paths.qualify(filenames.begin().value()).c_str(),
                         base_object_name,
                         completed_params,
-                        objects))
+                        objects,
+                        thread_count))
                     return false;
             }
             break;
@@ -907,7 +920,8 @@ bool MeshObjectReader::read(
                         filenames,
                         base_object_name,
                         completed_params,
-                        objects))
+                        objects,
+                        thread_count))
                     return false;
             }
             break;
@@ -36,6 +36,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 namespace foundation    { class SearchPaths; }
 namespace renderer      { class MeshObject; }
@@ -59,13 +62,15 @@ class APPLESEED_DLLSYMBOL MeshObjectReader
 {
   public:
     // Read mesh objects from disk. The filenames are defined in params.
+    // Wavefront OBJ files are parsed with up to thread_count threads.
     // Returns true on success, false otherwise. When false is returned,
     // nothing should be assumed on the state of the objects parameter.
     static bool read(
         const foundation::SearchPaths&  search_paths,
         const char*                     base_object_name,
         const ParamArray&               params,
-        MeshObjectArray&                objects);
+        MeshObjectArray&                objects,
+        const size_t                    thread_count = 1);
 };
 
 }       // namespace renderer
@@ -134,7 +134,7 @@ Dictionary Configuration::get_metadata()
         "sampling_mode",
         Dictionary()
             .insert("type", "enum")
-            .insert("values", "rng|qmc")
+            .insert("values", "rng|qmc|sobol")
             .insert("default", "rng")
             .insert("label", "Sampler")
             .insert("help", "Sampling algorithm used in Monte Carlo integration")
@@ -150,7 +150,12 @@ Dictionary Configuration::get_metadata()
                         "qmc",
                         Dictionary()
                             .insert("label", "QMC")
-                            .insert("help", "Quasi Monte Carlo sampler"))));
+                            .insert("help", "Quasi Monte Carlo sampler"))
+                    .insert(
+                        "sobol",
+                        Dictionary()
+                            .insert("label", "Sobol")
+                            .insert("help", "Quasi Monte Carlo sampler based on Owen-scrambled Sobol sequences"))));
 
     metadata.insert(
         "lighting_engine",
@@ -181,6 +186,33 @@ Dictionary Configuration::get_metadata()
             .insert("label", "Render Threads")
             .insert("help", "Number of threads to use for rendering"));
 
+    metadata.insert(
+        "thread_affinity",
+        Dictionary()
+            .insert("type", "enum")
+            .insert("values", "none|core|numa_node")
+            .insert("default", "none")
+            .insert("label", "Thread Affinity")
+            .insert("help", "Binding of rendering threads to CPU cores")
+            .insert(
+                "options",
+                Dictionary()
+                    .insert(
+                        "none",
+                        Dictionary()
+                            .insert("label", "None")
+                            .insert("help", "Let the operating system schedule rendering threads"))
+                    .insert(
+                        "core",
+                        Dictionary()
+                            .insert("label", "Core")
+                            .insert("help", "Bind each rendering thread to a single core"))
+                    .insert(
+                        "numa_node",
+                        Dictionary()
+                            .insert("label", "NUMA Node")
+                            .insert("help", "Bind each rendering thread to the cores of a NUMA node"))));
+
     metadata.dictionaries().insert(
         "light_sampler",
         BackwardLightSampler::get_params_metadata());
@@ -54,6 +54,7 @@
 #include "renderer/modeling/surfaceshader/surfaceshader.h"
 
 // appleseed.foundation headers.
+#include "foundation/platform/system.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/foreach.h"
@@ -94,10 +95,12 @@ struct Project::Impl
     ConfigurationContainer      m_configurations;
     SearchPaths                 m_search_paths;
     auto_ptr<TraceContext>      m_trace_context;
+    size_t                      m_rendering_thread_count;
 
     Impl()
       : m_format_revision(ProjectFormatRevision)
       , m_search_paths("APPLESEED_SEARCHPATH", SearchPaths::environment_path_separator())
+      , m_rendering_thread_count(System::get_logical_cpu_core_count())
     {
     }
 };
@@ -211,6 +214,17 @@ void Project::add_default_configurations()
     add_default_configuration("interactive", "base_interactive");
 }
 
+void Project::set_rendering_thread_count(const size_t thread_count)
+{
+    assert(thread_count > 0);
+    impl->m_rendering_thread_count = thread_count;
+}
+
+size_t Project::get_rendering_thread_count() const
+{
+    return impl->m_rendering_thread_count;
+}
+
 bool Project::has_trace_context() const
 {
     return impl->m_trace_context.get() != 0;
@@ -221,7 +235,8 @@ const TraceContext& Project::get_trace_context() const
     if (impl->m_trace_context.get() == 0)
     {
         assert(impl->m_scene.get());
-        impl->m_trace_context.reset(new TraceContext(*impl->m_scene));
+        impl->m_trace_context.reset(
+            new TraceContext(*impl->m_scene, impl->m_rendering_thread_count));
     }
 
     return *impl->m_trace_context;
@@ -230,7 +245,7 @@ const TraceContext& Project::get_trace_context() const
 void Project::update_trace_context()
 {
     if (impl->m_trace_context.get())
-        impl->m_trace_context->update();
+        impl->m_trace_context->update(impl->m_rendering_thread_count);
 }
 
 void Project::add_base_configurations()
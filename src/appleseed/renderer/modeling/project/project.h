@@ -119,6 +119,12 @@ class APPLESEED_DLLSYMBOL Project
     // Add the default configurations to the project.
     void add_default_configurations();
 
+    // Set/get the number of threads used to render the project, which is also used to
+    // build acceleration structures and precomputed tables during scene preparation.
+    // The default value is the number of logical CPU cores.
+    void set_rendering_thread_count(const size_t thread_count);
+    size_t get_rendering_thread_count() const;
+
     // Return true if the trace context has already been built.
     bool has_trace_context() const;
 
@@ -1625,7 +1625,8 @@ namespace
                                 m_context.get_project().search_paths(),
                                 m_name.c_str(),
                                 m_params,
-                                object_array))
+                                object_array,
+                                m_context.get_project().get_rendering_thread_count()))
                             m_objects = array_vector<ObjectVector>(object_array);
                         else m_context.get_event_counters().signal_error();
                     }
@@ -137,6 +137,14 @@ bool ArchiveAssembly::expand_contents(
     return true;
 }
 
+void ArchiveAssembly::clear_contents()
+{
+    ProceduralAssembly::clear_contents();
+
+    // Read the archive again at the next expansion.
+    m_archive_opened = false;
+}
+
 
 //
 // ArchiveAssemblyFactory class implementation.
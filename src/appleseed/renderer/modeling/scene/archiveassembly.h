@@ -83,6 +83,8 @@ class APPLESEED_DLLSYMBOL ArchiveAssembly
         const char*                 name,
         const ParamArray&           params);
 
+    virtual void clear_contents() override;
+
     bool m_archive_opened;
 };
 
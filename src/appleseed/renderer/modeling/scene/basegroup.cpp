@@ -31,6 +31,7 @@
 #include "basegroup.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #include "renderer/kernel/shading/oslshadingsystem.h"
 #include "renderer/modeling/color/colorentity.h"
 #include "renderer/modeling/scene/assembly.h"
@@ -40,10 +41,19 @@
 #include "renderer/modeling/texture/texture.h"
 
 // appleseed.foundation headers.
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/defaulttimers.h"
 #include "foundation/utility/foreach.h"
-#include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <algorithm>
+#include <vector>
 
 using namespace foundation;
+using namespace std;
 
 namespace renderer
 {
@@ -98,33 +108,160 @@ ShaderGroupContainer& BaseGroup::shader_groups() const
     return impl->m_shader_groups;
 }
 
-bool BaseGroup::create_optimized_osl_shader_groups(
-    OSLShadingSystem&   shading_system,
-    IAbortSwitch*       abort_switch)
+namespace
 {
-    bool success = true;
+    typedef vector<ShaderGroup*> ShaderGroupVector;
 
-    for (each<AssemblyContainer> i = assemblies(); i; ++i)
+    // Create the OSL shader groups of a group and of its assemblies, and collect
+    // the ones that were actually created by this call.
+    bool create_osl_shader_groups(
+        const BaseGroup&        group,
+        OSLShadingSystem&       shading_system,
+        ShaderGroupVector&      created_shader_groups,
+        IAbortSwitch*           abort_switch)
     {
-        if (is_aborted(abort_switch))
-            return true;
+        bool success = true;
 
-        success = success && i->create_optimized_osl_shader_groups(
-            shading_system,
-            abort_switch);
+        for (each<AssemblyContainer> i = group.assemblies(); i; ++i)
+        {
+            if (is_aborted(abort_switch))
+                return true;
+
+            success = success && create_osl_shader_groups(
+                *i,
+                shading_system,
+                created_shader_groups,
+                abort_switch);
+        }
+
+        for (each<ShaderGroupContainer> i = group.shader_groups(); i; ++i)
+        {
+            if (is_aborted(abort_switch))
+                return true;
+
+            if (!success || i->is_valid())
+                continue;
+
+            success = i->create_osl_shader_group(shading_system, abort_switch);
+
+            if (i->is_valid())
+                created_shader_groups.push_back(&*i);
+        }
+
+        return success;
     }
 
-    for (each<ShaderGroupContainer> i = shader_groups(); i; ++i)
+    class OptimizeShaderGroupJob
+      : public IJob
     {
-        if (is_aborted(abort_switch))
+      public:
+        OptimizeShaderGroupJob(
+            ShaderGroup&            shader_group,
+            OSLShadingSystem&       shading_system,
+            boost::atomic<bool>&    success,
+            IAbortSwitch*           abort_switch)
+          : m_shader_group(shader_group)
+          , m_shading_system(shading_system)
+          , m_success(success)
+          , m_abort_switch(abort_switch)
+        {
+        }
+
+        virtual void execute(const size_t thread_index) override
+        {
+            if (is_aborted(m_abort_switch))
+                return;
+
+            if (!m_shader_group.optimize_osl_shader_group(m_shading_system))
+                m_success = false;
+        }
+
+      private:
+        ShaderGroup&                m_shader_group;
+        OSLShadingSystem&           m_shading_system;
+        boost::atomic<bool>&        m_success;
+        IAbortSwitch*               m_abort_switch;
+    };
+
+    bool optimize_osl_shader_groups(
+        const ShaderGroupVector&    shader_groups,
+        OSLShadingSystem&           shading_system,
+        const size_t                thread_count,
+        IAbortSwitch*               abort_switch)
+    {
+        if (shader_groups.empty())
             return true;
 
-        success = success && i->create_optimized_osl_shader_group(
+        const size_t job_thread_count = min(thread_count, shader_groups.size());
+
+        RENDERER_LOG_INFO(
+            "optimizing %s osl shader group%s using %s thread%s...",
+            pretty_uint(shader_groups.size()).c_str(),
+            shader_groups.size() > 1 ? "s" : "",
+            pretty_uint(job_thread_count).c_str(),
+            job_thread_count > 1 ? "s" : "");
+
+        Stopwatch<DefaultWallclockTimer> stopwatch;
+        stopwatch.start();
+
+        boost::atomic<bool> success(true);
+
+        // Each job optimizes a single shader group: OSL only locks the shader group
+        // being optimized, so distinct shader groups can be processed concurrently.
+        JobQueue job_queue;
+        for (size_t i = 0; i < shader_groups.size(); ++i)
+        {
+            job_queue.schedule(
+                new OptimizeShaderGroupJob(
+                    *shader_groups[i],
+                    shading_system,
+                    success,
+                    abort_switch));
+        }
+
+        JobManager job_manager(
+            global_logger(),
+            job_queue,
+            job_thread_count);
+        job_manager.start();
+        job_queue.wait_until_completion();
+
+        stopwatch.measure();
+
+        RENDERER_LOG_INFO(
+            "optimized %s osl shader group%s in %s.",
+            pretty_uint(shader_groups.size()).c_str(),
+            shader_groups.size() > 1 ? "s" : "",
+            pretty_time(stopwatch.get_seconds()).c_str());
+
+        return success;
+    }
+}
+
+bool BaseGroup::create_optimized_osl_shader_groups(
+    OSLShadingSystem&   shading_system,
+    const size_t        thread_count,
+    IAbortSwitch*       abort_switch)
+{
+    // Shader groups are set up through per-shading system state, one at a time.
+    ShaderGroupVector created_shader_groups;
+    const bool success =
+        create_osl_shader_groups(
+            *this,
             shading_system,
+            created_shader_groups,
             abort_switch);
-    }
 
-    return success;
+    if (is_aborted(abort_switch))
+        return true;
+
+    // Optimization and JIT compilation is where most of the time goes.
+    return
+        optimize_osl_shader_groups(
+            created_shader_groups,
+            shading_system,
+            thread_count,
+            abort_switch) && success;
 }
 
 void BaseGroup::release_optimized_osl_shader_groups()
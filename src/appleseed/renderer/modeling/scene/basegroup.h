@@ -36,6 +36,9 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
 namespace foundation    { class StringArray; }
@@ -71,9 +74,11 @@ class APPLESEED_DLLSYMBOL BaseGroup
     // Access the OSL shader groups.
     ShaderGroupContainer& shader_groups() const;
 
-    // Create OSL shader groups and optimize them.
+    // Create OSL shader groups and optimize them. Shader groups are created one
+    // at a time, then optimized and JIT-compiled using thread_count threads.
     bool create_optimized_osl_shader_groups(
         OSLShadingSystem&           shading_system,
+        const size_t                thread_count = 1,
         foundation::IAbortSwitch*   abort_switch = 0);
 
     // Release internal OSL shader groups.
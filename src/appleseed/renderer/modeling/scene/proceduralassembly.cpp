@@ -29,11 +29,32 @@
 // Interface header.
 #include "proceduralassembly.h"
 
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/entity/onframebeginrecorder.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/platform/atomic.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/api/apistring.h"
+#include "foundation/utility/foreach.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
 // Standard headers.
 #include <string>
 
-// appleseed.renderer headers.
-#include "renderer/utility/paramarray.h"
+using namespace foundation;
+using namespace std;
 
 namespace renderer
 {
@@ -42,11 +63,235 @@ namespace renderer
 // ProceduralAssembly class implementation.
 //
 
+ProceduralAssembly::ExpansionContext::ExpansionContext(
+    const Project&          project,
+    OSLShadingSystem&       shading_system,
+    OnFrameBeginRecorder&   recorder)
+  : m_project(project)
+  , m_shading_system(shading_system)
+  , m_recorder(recorder)
+{
+}
+
+struct ProceduralAssembly::Impl
+{
+    enum ExpansionState
+    {
+        NotDeferred,
+        Pending,
+        Expanded,
+        Failed
+    };
+
+    boost::mutex            m_mutex;
+    volatile uint32         m_expansion_state;
+    ExpansionContext*       m_expansion_context;
+    GAABB3                  m_bbox;
+    bool                    m_expand_eagerly;
+};
+
+namespace
+{
+    bool has_emitting_entities(const Assembly& assembly)
+    {
+        if (!assembly.lights().empty())
+            return true;
+
+        for (const_each<MaterialContainer> i = assembly.materials(); i; ++i)
+        {
+            if (i->has_emission())
+                return true;
+        }
+
+        for (const_each<AssemblyContainer> i = assembly.assemblies(); i; ++i)
+        {
+            if (has_emitting_entities(*i))
+                return true;
+        }
+
+        return false;
+    }
+}
+
 ProceduralAssembly::ProceduralAssembly(
     const char*         name,
     const ParamArray&   params)
   : Assembly(name, params)
+  , impl(new Impl())
+{
+    impl->m_expansion_state = Impl::NotDeferred;
+    impl->m_expansion_context = 0;
+    impl->m_expand_eagerly = false;
+
+    if (m_params.get_optional<bool>("deferred_expansion", false))
+    {
+        if (!m_params.strings().exist("bbox_min") || !m_params.strings().exist("bbox_max"))
+        {
+            RENDERER_LOG_WARNING(
+                "procedural assembly \"%s\" requires a bounding box for its expansion to be deferred; "
+                "it will be expanded before rendering.",
+                name);
+        }
+        else if (is_flushable())
+        {
+            RENDERER_LOG_WARNING(
+                "the expansion of flushable procedural assembly \"%s\" cannot be deferred; "
+                "it will be expanded before rendering.",
+                name);
+        }
+        else
+        {
+            impl->m_bbox.min = m_params.get_required<GVector3>("bbox_min", GVector3(0.0f));
+            impl->m_bbox.max = m_params.get_required<GVector3>("bbox_max", GVector3(0.0f));
+            impl->m_expansion_state = Impl::Pending;
+        }
+    }
+}
+
+ProceduralAssembly::~ProceduralAssembly()
+{
+    delete impl;
+}
+
+bool ProceduralAssembly::is_expansion_pending() const
+{
+    return atomic_read(&impl->m_expansion_state) == Impl::Pending;
+}
+
+void ProceduralAssembly::set_expansion_context(ExpansionContext* context)
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    impl->m_expansion_context = context;
+}
+
+bool ProceduralAssembly::expand_deferred_contents()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    if (impl->m_expansion_state != Impl::Pending)
+        return impl->m_expansion_state != Impl::Failed;
+
+    ExpansionContext* context = impl->m_expansion_context;
+
+    if (context == 0)
+    {
+        // Assemblies hit outside of a frame rendered by the master renderer cannot be expanded.
+        return false;
+    }
+
+    // Expansions touch state shared with the rest of the scene (the shading system, the recorder,
+    // the entities the new ones bind to): perform them one at a time. Other threads never read
+    // the contents of this assembly meanwhile since rays only reach them through its deferred
+    // triangle tree, which is published once this method has returned.
+    boost::mutex::scoped_lock context_lock(context->m_mutex);
+
+    RENDERER_LOG_INFO("expanding deferred assembly \"%s\"...", get_path().c_str());
+
+    Stopwatch<DefaultWallclockTimer> stopwatch;
+    stopwatch.start();
+
+    const Project& project = context->m_project;
+    const Scene& scene = *project.get_scene();
+    const Assembly* parent = dynamic_cast<const Assembly*>(get_parent());
+
+    // Expand the contents of the assembly.
+    bool success = expand_contents(project, parent);
+
+    // Bind the inputs of the new entities.
+    if (success)
+    {
+        InputBinder input_binder;
+        input_binder.bind(scene, *this);
+        success = input_binder.get_error_count() == 0;
+    }
+
+    // Prepare the new entities for rendering.
+    if (success)
+    {
+        success =
+            create_optimized_osl_shader_groups(context->m_shading_system) &&
+            invoke_on_frame_begin_on_contents(project, context->m_recorder, 0);
+    }
+
+    // The light sampler was built before rendering started and won't see new lights.
+    if (success && has_emitting_entities(*this))
+    {
+        RENDERER_LOG_WARNING(
+            "deferred assembly \"%s\" contains lights or emitting materials that cannot be sampled "
+            "in this render; it will be expanded before rendering in subsequent renders.",
+            get_path().c_str());
+        impl->m_expand_eagerly = true;
+    }
+
+    // The child trees of this assembly must be rebuilt at the next update.
+    bump_version_id();
+
+    stopwatch.measure();
+
+    if (success)
+    {
+        RENDERER_LOG_INFO(
+            "expanded deferred assembly \"%s\" in %s.",
+            get_path().c_str(),
+            pretty_time(stopwatch.get_seconds()).c_str());
+    }
+    else RENDERER_LOG_ERROR("failed to expand deferred assembly \"%s\".", get_path().c_str());
+
+    atomic_write(&impl->m_expansion_state, success ? Impl::Expanded : Impl::Failed);
+
+    return success;
+}
+
+void ProceduralAssembly::discard_deferred_contents()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    if (impl->m_expansion_state != Impl::Expanded && impl->m_expansion_state != Impl::Failed)
+        return;
+
+    clear_contents();
+
+    // The child trees of this assembly, including its deferred triangle tree, must be recreated.
+    bump_version_id();
+
+    atomic_write(
+        &impl->m_expansion_state,
+        impl->m_expand_eagerly ? Impl::NotDeferred : Impl::Pending);
+}
+
+GAABB3 ProceduralAssembly::compute_local_bbox() const
+{
+    return
+        is_expansion_pending()
+            ? impl->m_bbox
+            : Assembly::compute_local_bbox();
+}
+
+GAABB3 ProceduralAssembly::compute_non_hierarchical_local_bbox() const
+{
+    return
+        is_expansion_pending()
+            ? impl->m_bbox
+            : Assembly::compute_non_hierarchical_local_bbox();
+}
+
+void ProceduralAssembly::clear_contents()
 {
+    assembly_instances().clear();
+    assemblies().clear();
+    object_instances().clear();
+    objects().clear();
+    volumes().clear();
+    lights().clear();
+    materials().clear();
+    surface_shaders().clear();
+    edfs().clear();
+    bssrdfs().clear();
+    bsdfs().clear();
+    shader_groups().clear();
+    texture_instances().clear();
+    textures().clear();
+    colors().clear();
 }
 
 }   // namespace renderer
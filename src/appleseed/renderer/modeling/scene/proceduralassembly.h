@@ -34,14 +34,19 @@
 #include "renderer/modeling/scene/assembly.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/thread.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
+namespace renderer      { class OnFrameBeginRecorder; }
+namespace renderer      { class OSLShadingSystem; }
 namespace renderer      { class ParamArray; }
+namespace renderer      { class Project; }
 
 namespace renderer
 {
@@ -60,11 +65,69 @@ class APPLESEED_DLLSYMBOL ProceduralAssembly
         const Assembly*             parent,
         foundation::IAbortSwitch*   abort_switch = 0) = 0;
 
+    //
+    // Deferred expansion.
+    //
+    // When the deferred_expansion parameter is set, the assembly is not expanded before
+    // rendering. Instead, it enters the assembly tree as a proxy bounded by the box given
+    // by the bbox_min and bbox_max parameters, and its contents are expanded the first time
+    // a ray hits this box. The expanded contents only live until the end of the render.
+    //
+    // Lights are collected before rendering starts, so lights and emitting materials found
+    // in deferred contents cannot be sampled: such assemblies are expanded before rendering
+    // in subsequent renders.
+    //
+
+    // Rendering context required to expand assemblies during rendering.
+    struct ExpansionContext
+      : public foundation::NonCopyable
+    {
+        const Project&              m_project;
+        OSLShadingSystem&           m_shading_system;
+        OnFrameBeginRecorder&       m_recorder;
+        boost::mutex                m_mutex;            // serializes expansions
+
+        ExpansionContext(
+            const Project&          project,
+            OSLShadingSystem&       shading_system,
+            OnFrameBeginRecorder&   recorder);
+    };
+
+    // Return true if the expansion of this assembly is deferred until a ray hits it
+    // and has not happened yet.
+    bool is_expansion_pending() const;
+
+    // Set the context used to expand this assembly during rendering, or 0 to clear it.
+    void set_expansion_context(ExpansionContext* context);
+
+    // Expand the contents of this assembly and prepare them for rendering, unless this
+    // has already been done. This method is thread-safe: only threads tracing rays into
+    // this assembly wait while it is being expanded. Returns true on success.
+    bool expand_deferred_contents();
+
+    // Drop the contents expanded during rendering and make the expansion pending again.
+    // Must not be called while rendering.
+    void discard_deferred_contents();
+
+    // Until the assembly is expanded, its bounding box is the user-provided one.
+    virtual GAABB3 compute_local_bbox() const override;
+    virtual GAABB3 compute_non_hierarchical_local_bbox() const override;
+
   protected:
     // Constructor.
     ProceduralAssembly(
         const char*                 name,
         const ParamArray&           params);
+
+    // Destructor.
+    ~ProceduralAssembly();
+
+    // Remove all the entities of this assembly.
+    virtual void clear_contents();
+
+  private:
+    struct Impl;
+    Impl* impl;
 };
 
 }       // namespace renderer
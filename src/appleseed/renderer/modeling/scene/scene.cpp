@@ -166,6 +166,14 @@ GAABB3 Scene::compute_bbox() const
 
 namespace
 {
+    bool is_expansion_pending(const Assembly& assembly)
+    {
+        const ProceduralAssembly* proc_assembly =
+            dynamic_cast<const ProceduralAssembly*>(&assembly);
+
+        return proc_assembly && proc_assembly->is_expansion_pending();
+    }
+
     bool assembly_instances_use_alpha_mapping(
         const AssemblyInstanceContainer&  assembly_instances,
         set<UniqueID>&                    visited_assemblies)
@@ -192,6 +200,10 @@ namespace
             {
                 visited_assemblies.insert(assembly.get_uid());
 
+                // The contents of assemblies that are not expanded yet are unknown.
+                if (is_expansion_pending(assembly))
+                    return true;
+
                 // Check the assembly contents.
                 for (const_each<ObjectInstanceContainer> i = assembly.object_instances(); i; ++i)
                 {
@@ -238,6 +250,10 @@ namespace
             {
                 visited_assemblies.insert(assembly.get_uid());
 
+                // The contents of assemblies that are not expanded yet are unknown.
+                if (is_expansion_pending(assembly))
+                    return true;
+
                 // Check the assembly contents.
                 for (const_each<ObjectInstanceContainer> i = assembly.object_instances(); i; ++i)
                 {
@@ -332,11 +348,31 @@ bool Scene::on_render_begin(
     return success;
 }
 
+namespace
+{
+    void discard_deferred_contents(AssemblyContainer& assemblies)
+    {
+        for (each<AssemblyContainer> i = assemblies; i; ++i)
+        {
+            ProceduralAssembly* proc_assembly =
+                dynamic_cast<ProceduralAssembly*>(&*i);
+
+            if (proc_assembly)
+                proc_assembly->discard_deferred_contents();
+
+            discard_deferred_contents(i->assemblies());
+        }
+    }
+}
+
 void Scene::on_render_end(const Project& project)
 {
     for (each<CameraContainer> i = cameras(); i; ++i)
         i->on_render_end(project);
 
+    // Contents expanded during rendering don't outlive the render.
+    discard_deferred_contents(assemblies());
+
     m_has_render_data = false;
 }
 
@@ -353,6 +389,10 @@ namespace
 
         if (proc_assembly)
         {
+            // Assemblies whose expansion is deferred are expanded during rendering.
+            if (proc_assembly->is_expansion_pending())
+                return true;
+
             if (!proc_assembly->expand_contents(project, parent, abort_switch))
                 return false;
         }
@@ -380,6 +420,31 @@ bool Scene::expand_procedural_assemblies(
     return true;
 }
 
+namespace
+{
+    void set_expansion_context(
+        AssemblyContainer&                      assemblies,
+        ProceduralAssembly::ExpansionContext*   context)
+    {
+        for (each<AssemblyContainer> i = assemblies; i; ++i)
+        {
+            ProceduralAssembly* proc_assembly =
+                dynamic_cast<ProceduralAssembly*>(&*i);
+
+            if (proc_assembly)
+                proc_assembly->set_expansion_context(context);
+
+            set_expansion_context(i->assemblies(), context);
+        }
+    }
+}
+
+void Scene::set_procedural_assembly_expansion_context(
+    ProceduralAssembly::ExpansionContext*   context)
+{
+    set_expansion_context(assemblies(), context);
+}
+
 namespace
 {
     template <typename EntityCollection>
@@ -37,6 +37,7 @@
 #include "renderer/modeling/environment/environment.h"
 #include "renderer/modeling/scene/basegroup.h"
 #include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/proceduralassembly.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
@@ -120,11 +121,16 @@ class APPLESEED_DLLSYMBOL Scene
     // Perform post-render rendering actions.
     void on_render_end(const Project& project);
 
-    // Expand all procedural assemblies in the scene.
+    // Expand all procedural assemblies in the scene, except those whose expansion is deferred.
     virtual bool expand_procedural_assemblies(
         const Project&              project,
         foundation::IAbortSwitch*   abort_switch = 0);
 
+    // Set the context used to expand procedural assemblies whose expansion is deferred
+    // until a ray hits them, or 0 to clear it.
+    void set_procedural_assembly_expansion_context(
+        ProceduralAssembly::ExpansionContext* context);
+
     // This method is called once before rendering each frame.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
@@ -162,6 +162,20 @@ bool ShaderGroup::create_optimized_osl_shader_group(
     if (is_valid())
         return true;
 
+    if (!create_osl_shader_group(shading_system, abort_switch))
+        return false;
+
+    // The shader group is left invalid if shader group creation was aborted.
+    return !is_valid() || optimize_osl_shader_group(shading_system);
+}
+
+bool ShaderGroup::create_osl_shader_group(
+    OSLShadingSystem&   shading_system,
+    IAbortSwitch*       abort_switch)
+{
+    if (is_valid())
+        return true;
+
     RENDERER_LOG_DEBUG("setting up shader group \"%s\"...", get_path().c_str());
 
     try
@@ -206,6 +220,25 @@ bool ShaderGroup::create_optimized_osl_shader_group(
 
         impl->m_shader_group_ref = shader_group_ref;
 
+        return true;
+    }
+    catch (const exception& e)
+    {
+        RENDERER_LOG_ERROR("failed to setup shader group \"%s\": %s.", get_path().c_str(), e.what());
+        return false;
+    }
+}
+
+bool ShaderGroup::optimize_osl_shader_group(OSLShadingSystem& shading_system)
+{
+    assert(is_valid());
+
+    RENDERER_LOG_DEBUG("optimizing shader group \"%s\"...", get_path().c_str());
+
+    try
+    {
+        shading_system.optimize_group(impl->m_shader_group_ref.get());
+
         get_shadergroup_closures_info(shading_system);
         report_has_closure("bsdf", HasBSDFs);
         report_has_closure("emission", HasEmission);
@@ -221,7 +254,7 @@ bool ShaderGroup::create_optimized_osl_shader_group(
     }
     catch (const exception& e)
     {
-        RENDERER_LOG_ERROR("failed to setup shader group \"%s\": %s.", get_path().c_str(), e.what());
+        RENDERER_LOG_ERROR("failed to optimize shader group \"%s\": %s.", get_path().c_str(), e.what());
         return false;
     }
 }
@@ -82,11 +82,21 @@ class APPLESEED_DLLSYMBOL ShaderGroup
         const char*                 dst_layer,
         const char*                 dst_param);
 
-    // Create internal OSL shader group.
+    // Create internal OSL shader group and optimize it.
     bool create_optimized_osl_shader_group(
         OSLShadingSystem&           shading_system,
         foundation::IAbortSwitch*   abort_switch = 0);
 
+    // Create internal OSL shader group without optimizing it.
+    // Shader groups must be created one at a time.
+    bool create_osl_shader_group(
+        OSLShadingSystem&           shading_system,
+        foundation::IAbortSwitch*   abort_switch = 0);
+
+    // Optimize and JIT-compile internal OSL shader group, then query the closures
+    // and globals it uses. Distinct shader groups can be optimized concurrently.
+    bool optimize_osl_shader_group(OSLShadingSystem& shading_system);
+
     // Release internal OSL shader group.
     void release_optimized_osl_shader_group();
 
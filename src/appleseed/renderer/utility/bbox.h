@@ -56,6 +56,15 @@ BBox compute_union(const Iterator begin, const Iterator end);
 template <typename BBox, typename Iterator>
 BBox interpolate(const Iterator begin, const Iterator end, const double time);
 
+// Enlarge a path of equidistant bounding boxes such that it bounds, at any time value,
+// another path of equidistant bounding boxes with the same number of keys or fewer.
+template <typename BBox, typename InputIterator, typename OutputIterator>
+void insert_path(
+    const InputIterator     begin,
+    const InputIterator     end,
+    const OutputIterator    path_begin,
+    const OutputIterator    path_end);
+
 
 //
 // Implementation.
@@ -116,6 +125,60 @@ BBox interpolate(const Iterator begin, const Iterator end, const double time)
     return foundation::lerp(first[prev_index], first[prev_index + 1], k);
 }
 
+template <typename BBox, typename InputIterator, typename OutputIterator>
+void insert_path(
+    const InputIterator     begin,
+    const InputIterator     end,
+    const OutputIterator    path_begin,
+    const OutputIterator    path_end)
+{
+    const size_t bbox_count = end - begin;
+    const size_t path_bbox_count = path_end - path_begin;
+
+    assert(bbox_count > 0);
+    assert(bbox_count <= path_bbox_count);
+
+    if (bbox_count == 1)
+    {
+        for (OutputIterator i = path_begin; i != path_end; ++i)
+            i->insert(*begin);
+        return;
+    }
+
+    if (bbox_count == path_bbox_count)
+    {
+        InputIterator j = begin;
+        for (OutputIterator i = path_begin; i != path_end; ++i, ++j)
+            i->insert(*j);
+        return;
+    }
+
+    const size_t motion_segment_count = bbox_count - 1;
+    const size_t path_motion_segment_count = path_bbox_count - 1;
+
+    // Insert the path evaluated at each key of the finer path.
+    for (size_t i = 0; i < path_motion_segment_count; ++i)
+    {
+        const double time = static_cast<double>(i) / path_motion_segment_count;
+        path_begin[i].insert(interpolate<BBox>(begin, end, time));
+    }
+    path_begin[path_motion_segment_count].insert(begin[motion_segment_count]);
+
+    // Both paths are linear in between their keys. A key of the path that falls inside
+    // a segment of the finer path is bounded over that segment if it is inserted into
+    // the bounding boxes at both ends of the segment.
+    for (size_t i = 1; i < motion_segment_count; ++i)
+    {
+        const size_t position = i * path_motion_segment_count;
+        if (position % motion_segment_count != 0)
+        {
+            const size_t segment = position / motion_segment_count;
+            path_begin[segment].insert(begin[i]);
+            path_begin[segment + 1].insert(begin[i]);
+        }
+    }
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_UTILITY_BBOX_H
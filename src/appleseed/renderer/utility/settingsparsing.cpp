@@ -78,12 +78,12 @@ SamplingContext::Mode get_sampling_context_mode(const ParamArray& params)
         params.get_required<string>(
             "sampling_mode",
             "rng",
-            make_vector("rng", "qmc"));
+            make_vector("rng", "qmc", "sobol"));
 
     return
-        sampling_mode == "rng"
-            ? SamplingContext::RNGMode
-            : SamplingContext::QMCMode;
+        sampling_mode == "rng" ? SamplingContext::RNGMode :
+        sampling_mode == "qmc" ? SamplingContext::QMCMode :
+        SamplingContext::SobolMode;
 }
 
 string get_sampling_context_mode_name(const SamplingContext::Mode mode)
@@ -92,6 +92,7 @@ string get_sampling_context_mode_name(const SamplingContext::Mode mode)
     {
       case SamplingContext::RNGMode: return "rng";
       case SamplingContext::QMCMode: return "qmc";
+      case SamplingContext::SobolMode: return "sobol";
       default: return "unknown";
     }
 }
@@ -143,4 +144,57 @@ size_t get_rendering_thread_count(const ParamArray& params)
     return thread_count;
 }
 
+void get_rendering_thread_affinities(
+    const ParamArray&           params,
+    vector<vector<size_t>>&     cpu_sets)
+{
+    cpu_sets.clear();
+
+    const string affinity =
+        params.get_optional<string>(
+            "thread_affinity",
+            "none",
+            make_vector("none", "core", "numa_node"));
+
+    if (affinity == "none")
+        return;
+
+    const size_t node_count = System::get_numa_node_count();
+
+    vector<vector<size_t>> node_cpus(node_count);
+    for (size_t i = 0; i < node_count; ++i)
+        System::get_numa_node_cpus(i, node_cpus[i]);
+
+    if (affinity == "core")
+    {
+        // Bind each thread to a single core. Interleave cores from all NUMA nodes so that
+        // using fewer threads than there are cores still spreads threads over all nodes.
+        for (size_t i = 0; ; ++i)
+        {
+            bool found = false;
+
+            for (size_t node = 0; node < node_count; ++node)
+            {
+                if (i < node_cpus[node].size())
+                {
+                    cpu_sets.push_back(vector<size_t>(1, node_cpus[node][i]));
+                    found = true;
+                }
+            }
+
+            if (!found)
+                break;
+        }
+    }
+    else
+    {
+        // Bind each thread to all the cores of a NUMA node, going round-robin over nodes.
+        for (size_t node = 0; node < node_count; ++node)
+        {
+            if (!node_cpus[node].empty())
+                cpu_sets.push_back(node_cpus[node]);
+        }
+    }
+}
+
 }   // namespace renderer
@@ -38,6 +38,7 @@
 // Standard headers.
 #include <cstddef>
 #include <string>
+#include <vector>
 
 // Forward declarations.
 namespace renderer  { class ParamArray; }
@@ -56,6 +57,13 @@ std::string get_sampling_context_mode_name(const SamplingContext::Mode mode);
 // Rendering threads.
 APPLESEED_DLLSYMBOL size_t get_rendering_thread_count(const ParamArray& params);
 
+// Rendering threads affinity. Retrieve the sets of logical CPU cores rendering threads
+// should be bound to (see foundation::JobManager::set_thread_affinities()), or an empty
+// vector if rendering threads should not be bound to specific cores.
+APPLESEED_DLLSYMBOL void get_rendering_thread_affinities(
+    const ParamArray&                       params,
+    std::vector<std::vector<size_t>>&       cpu_sets);
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_UTILITY_SETTINGSPARSING_H
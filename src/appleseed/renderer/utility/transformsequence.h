@@ -119,6 +119,9 @@ class APPLESEED_DLLSYMBOL TransformSequence
     // Compose two transform sequences.
     TransformSequence operator*(const TransformSequence& rhs) const;
 
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
     // Transform a 3D axis-aligned bounding box across the whole motion described by this sequence.
     // If the bounding box is invalid, it is returned unmodified.
     template <typename T>
@@ -170,6 +173,14 @@ inline size_t TransformSequence::size() const
     return m_size;
 }
 
+inline size_t TransformSequence::get_memory_size() const
+{
+    return
+          sizeof(*this)
+        + m_capacity * sizeof(TransformKey)
+        + (m_interpolators != 0 ? (m_size - 1) * sizeof(foundation::TransformInterpolatord) : 0);
+}
+
 inline bool TransformSequence::can_swap_handedness() const
 {
     return m_can_swap_handedness;
@@ -57,6 +57,14 @@ CommandLineHandler::CommandLineHandler()
             .add_name("--print-bounding-boxes")
             .add_name("-b")
             .set_description("print mesh bounding boxes"));
+
+    parser().add_option_handler(
+        &m_threads
+            .add_name("--threads")
+            .add_name("-t")
+            .set_description("set the number of threads parsing OBJ files")
+            .set_syntax("n")
+            .set_exact_value_count(1));
 }
 
 void CommandLineHandler::print_program_usage(
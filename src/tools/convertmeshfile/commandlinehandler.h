@@ -55,6 +55,7 @@ class CommandLineHandler
   public:
     foundation::ValueOptionHandler<std::string> m_filenames;
     foundation::FlagOptionHandler               m_print_bboxes;
+    foundation::ValueOptionHandler<int>         m_threads;
 
     // Constructor.
     CommandLineHandler();
@@ -41,6 +41,7 @@
 #include "foundation/mesh/genericmeshfilewriter.h"
 #include "foundation/mesh/imeshbuilder.h"
 #include "foundation/mesh/imeshwalker.h"
+#include "foundation/mesh/objmeshfilereader.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/foreach.h"
@@ -308,6 +309,11 @@ int main(int argc, const char* argv[])
     try
     {
         GenericMeshFileReader reader(input_filepath.c_str());
+        if (cl.m_threads.is_set() && cl.m_threads.value() > 1)
+        {
+            reader.set_obj_options(OBJMeshFileReader::ParallelParsing);
+            reader.set_obj_parsing_thread_count(static_cast<size_t>(cl.m_threads.value()));
+        }
         reader.read(builder);
     }
     catch (const exception& e)